@@ -0,0 +1,269 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneInteractionDriver.h"
+
+//VTK Includes
+#include <vtkCommand.h>
+#include <vtkInteractorObserver.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkTimerLog.h>
+
+//STL includes
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(vtkBoneInteractionDriver);
+
+//----------------------------------------------------------------------------
+vtkBoneInteractionDriver::vtkBoneInteractionDriver()
+{
+  this->Interactor = NULL;
+  this->Renderer = NULL;
+  this->Timer = vtkTimerLog::New();
+}
+
+//----------------------------------------------------------------------------
+vtkBoneInteractionDriver::~vtkBoneInteractionDriver()
+{
+  this->SetInteractor(NULL);
+  this->SetRenderer(NULL);
+  this->Timer->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver
+::SetInteractor(vtkRenderWindowInteractor* interactor)
+{
+  if (interactor == this->Interactor)
+    {
+    return;
+    }
+
+  if (this->Interactor)
+    {
+    this->Interactor->UnRegister(this);
+    }
+  this->Interactor = interactor;
+  if (this->Interactor)
+    {
+    this->Interactor->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver::SetRenderer(vtkRenderer* renderer)
+{
+  if (renderer == this->Renderer)
+    {
+    return;
+    }
+
+  if (this->Renderer)
+    {
+    this->Renderer->UnRegister(this);
+    }
+  this->Renderer = renderer;
+  if (this->Renderer)
+    {
+    this->Renderer->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver::Initialize()
+{
+  if (!this->Interactor)
+    {
+    vtkErrorMacro("No interactor to initialize.");
+    return;
+    }
+
+  // Enable() is enough for the interactor to dispatch events and render.
+  // Initialize() would create the window and Start() would block.
+  this->Interactor->Enable();
+  if (this->Interactor->GetRenderWindow())
+    {
+    this->Interactor->GetRenderWindow()->Render();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver::WorldToDisplay(const double world[3],
+                                              double display[2])
+{
+  double displayPoint[4] = {0.0, 0.0, 0.0, 0.0};
+  if (this->Renderer)
+    {
+    vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer,
+      world[0], world[1], world[2], displayPoint);
+    }
+  display[0] = displayPoint[0];
+  display[1] = displayPoint[1];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneInteractionDriver::InvokeEvent(int event, double x, double y)
+{
+  if (!this->Interactor)
+    {
+    vtkErrorMacro("No interactor to invoke the event on.");
+    return 0.0;
+    }
+
+  static const unsigned long eventIds[NumberOfEvents] =
+    {
+    vtkCommand::LeftButtonPressEvent,
+    vtkCommand::MouseMoveEvent,
+    vtkCommand::LeftButtonReleaseEvent
+    };
+
+  this->Interactor->SetEventInformation(static_cast<int>(floor(x + 0.5)),
+                                        static_cast<int>(floor(y + 0.5)),
+                                        0, 0);
+  this->Timer->StartTimer();
+  this->Interactor->InvokeEvent(eventIds[event], NULL);
+  this->Timer->StopTimer();
+
+  double latency = this->Timer->GetElapsedTime();
+  this->Latencies[event].push_back(latency);
+  return latency;
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneInteractionDriver::Press(double x, double y)
+{
+  return this->InvokeEvent(vtkBoneInteractionDriver::PressEvent, x, y);
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneInteractionDriver::Move(double x, double y)
+{
+  return this->InvokeEvent(vtkBoneInteractionDriver::MoveEvent, x, y);
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneInteractionDriver::Release(double x, double y)
+{
+  return this->InvokeEvent(vtkBoneInteractionDriver::ReleaseEvent, x, y);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver::Drag(const double start[2],
+                                    const double end[2], int numberOfMoves)
+{
+  this->Press(start[0], start[1]);
+  for (int i = 1; i <= numberOfMoves; ++i)
+    {
+    double t = static_cast<double>(i) / numberOfMoves;
+    this->Move(start[0] + t * (end[0] - start[0]),
+               start[1] + t * (end[1] - start[1]));
+    }
+  this->Release(end[0], end[1]);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver::Rotate(const double start[2],
+                                      const double center[2], double angle,
+                                      int numberOfMoves)
+{
+  double offset[2];
+  offset[0] = start[0] - center[0];
+  offset[1] = start[1] - center[1];
+
+  double position[2] = {start[0], start[1]};
+  this->Press(position[0], position[1]);
+  for (int i = 1; i <= numberOfMoves; ++i)
+    {
+    double a = angle * i / numberOfMoves;
+    position[0] = center[0] + cos(a) * offset[0] - sin(a) * offset[1];
+    position[1] = center[1] + sin(a) * offset[0] + cos(a) * offset[1];
+    this->Move(position[0], position[1]);
+    }
+  this->Release(position[0], position[1]);
+}
+
+//----------------------------------------------------------------------------
+const std::vector<double>& vtkBoneInteractionDriver::GetLatencies(int event)
+{
+  return this->Latencies[event];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneInteractionDriver::GetLatencyPercentile(int event,
+                                                      double percentile)
+{
+  if (this->Latencies[event].empty())
+    {
+    return 0.0;
+    }
+
+  // Nearest rank
+  std::vector<double> latencies = this->Latencies[event];
+  std::sort(latencies.begin(), latencies.end());
+  size_t rank = static_cast<size_t>(
+    ceil(percentile / 100.0 * latencies.size()));
+  rank = std::min(std::max(rank, static_cast<size_t>(1)), latencies.size());
+  return latencies[rank - 1];
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver::ResetLatencies()
+{
+  for (int i = 0; i < NumberOfEvents; ++i)
+    {
+    this->Latencies[i].clear();
+    }
+}
+
+//----------------------------------------------------------------------------
+const char* vtkBoneInteractionDriver::GetEventTypeAsString(int event)
+{
+  switch (event)
+    {
+    case vtkBoneInteractionDriver::PressEvent:
+      return "Press";
+    case vtkBoneInteractionDriver::MoveEvent:
+      return "Move";
+    case vtkBoneInteractionDriver::ReleaseEvent:
+      return "Release";
+    default:
+      return "Unknown";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneInteractionDriver::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Interactor: " << this->Interactor << "\n";
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  for (int i = 0; i < NumberOfEvents; ++i)
+    {
+    os << indent << GetEventTypeAsString(i) << " Latencies: "
+       << this->Latencies[i].size() << "\n";
+    }
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneInteractionDriver_h
+#define __vtkBoneInteractionDriver_h
+
+// .NAME vtkBoneInteractionDriver - Inject synthetic mouse events
+// .SECTION Description
+// vtkBoneInteractionDriver plays mouse interactions on an interactor
+// without any user: the LeftButtonPressEvent, MouseMoveEvent and
+// LeftButtonReleaseEvent are invoked on the interactor, so they reach the
+// widgets (e.g. vtkBoneWidget::AddPointAction(), MoveAction() and
+// EndSelectAction()) through their usual observers.
+//
+// The time spent in each event, renders requested by the widgets included,
+// is recorded. The latencies are kept per event type and can be summarized
+// with percentiles.
+//
+// The driver works with an offscreen render window: Initialize() enables
+// the interactor without starting its event loop.
+
+#include "vtkObject.h"
+
+#include <vector>
+
+class vtkRenderer;
+class vtkRenderWindowInteractor;
+class vtkTimerLog;
+
+class vtkBoneInteractionDriver : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneInteractionDriver *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneInteractionDriver, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the interactor the events are invoked on.
+  void SetInteractor(vtkRenderWindowInteractor* interactor);
+  vtkGetObjectMacro(Interactor, vtkRenderWindowInteractor);
+
+  // Description:
+  // Set/Get the renderer used to convert world positions to display
+  // positions.
+  void SetRenderer(vtkRenderer* renderer);
+  vtkGetObjectMacro(Renderer, vtkRenderer);
+
+  // Description:
+  // Enable the interactor (without starting its event loop) and render
+  // the window once.
+  void Initialize();
+
+  // Description:
+  // Convert a world position into a display position with the renderer.
+  void WorldToDisplay(const double world[3], double display[2]);
+
+  // Description:
+  // Invoke a single event at the given display position.
+  // Return the time spent in the event, in seconds.
+  double Press(double x, double y);
+  double Move(double x, double y);
+  double Release(double x, double y);
+
+  // Description:
+  // Press at the start, move in numberOfMoves steps along the line to
+  // the end and release at the end.
+  void Drag(const double start[2], const double end[2], int numberOfMoves);
+
+  // Description:
+  // Press at the start, move in numberOfMoves steps along the arc of
+  // circle around the center by the given angle (in radians) and release.
+  void Rotate(const double start[2], const double center[2], double angle,
+              int numberOfMoves);
+
+  //BTX
+  enum EventType {PressEvent = 0, MoveEvent, ReleaseEvent, NumberOfEvents};
+  //ETX
+
+  // Description:
+  // Get the latencies (in seconds) recorded for an event type.
+  const std::vector<double>& GetLatencies(int event);
+
+  // Description:
+  // Get the percentile (between 0 and 100) of the recorded latencies of
+  // an event type. 0 if no latency was recorded.
+  double GetLatencyPercentile(int event, double percentile);
+
+  // Description:
+  // Forget the recorded latencies.
+  void ResetLatencies();
+
+  // Description:
+  // Get the name of an event type.
+  static const char* GetEventTypeAsString(int event);
+
+protected:
+  vtkBoneInteractionDriver();
+  ~vtkBoneInteractionDriver();
+
+  // Description:
+  // Invoke the event at the position and record its latency.
+  double InvokeEvent(int event, double x, double y);
+
+  vtkRenderWindowInteractor* Interactor;
+  vtkRenderer* Renderer;
+  vtkTimerLog* Timer;
+  std::vector<double> Latencies[NumberOfEvents];
+
+private:
+  vtkBoneInteractionDriver(const vtkBoneInteractionDriver&);  //Not implemented
+  void operator=(const vtkBoneInteractionDriver&);  //Not implemented
+};
+
+#endif
@@ -0,0 +1,933 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+// Headless benchmarks of the bone operations on synthetic skeletons.
+// No render window is created: the bones only have their representation.
+// With --interaction, the bones are also enabled in an offscreen render
+// window and mouse drags are played on them with synthetic events. The
+// latency of each event is reported, so that it can be compared to the
+// frame budget.
+// With --replay, a session saved by vtkBoneSessionRecorder is replayed
+// instead and the CPU time of its events is reported.
+// Run with --help for the options. The results are written as JSON or CSV
+// so that they can be compared from one release to the next.
+
+#include <vtkCamera.h>
+#include <vtkMath.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtkVersion.h>
+
+#include "vtkBoneInteractionDriver.h"
+#include "vtkBoneSessionRecorder.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct BenchmarkOptions
+{
+  std::string Format;
+  std::string Output;
+  std::string Filter;
+  std::string Replay;
+  std::vector<int> Sizes;
+  int Repetitions;
+  int Samples;
+  bool Interaction;
+  int InteractionMoves;
+  double FrameBudget;
+  bool Help;
+};
+
+//----------------------------------------------------------------------------
+struct BenchmarkResult
+{
+  std::string Name;
+  std::string Topology;
+  int NumberOfBones;
+  int NumberOfOperations;
+  double BestTime;
+  double MeanTime;
+  double P50Time;
+  double P99Time;
+};
+
+//----------------------------------------------------------------------------
+// Chain: every bone is the child of the previous one.
+// Tree: binary tree, the parent of the bone i is the bone (i - 1) / 2.
+// The head of a bone is linked to the tail of its parent.
+class SyntheticSkeleton
+{
+public:
+  enum TopologyType {Chain = 0, Tree};
+
+  // When an interactor is given, the bones are enabled on it and drawn in
+  // the renderer.
+  void Build(int topology, int numberOfBones,
+             vtkRenderWindowInteractor* interactor = NULL,
+             vtkRenderer* renderer = NULL)
+    {
+    this->Bones.clear();
+    this->Skeleton = vtkSmartPointer<vtkBoneSkeleton>::New();
+
+    for (int i = 0; i < numberOfBones; ++i)
+      {
+      int parent = -1;
+      if (i > 0)
+        {
+        parent = topology == Chain ? i - 1 : (i - 1) / 2;
+        }
+
+      double head[3] = {0.0, 0.0, 0.0};
+      if (parent >= 0)
+        {
+        this->Bones[parent]->GetTailRestWorldPosition(head);
+        }
+      // Vary the direction so that no two consecutive bones are aligned
+      double tail[3];
+      tail[0] = head[0] + 0.1;
+      tail[1] = head[1] + 0.05 * sin(static_cast<double>(i));
+      tail[2] = head[2] + 0.05 * cos(static_cast<double>(i));
+
+      vtkSmartPointer<vtkBoneWidget> bone =
+        vtkSmartPointer<vtkBoneWidget>::New();
+      if (interactor)
+        {
+        bone->SetInteractor(interactor);
+        bone->SetCurrentRenderer(renderer);
+        }
+      bone->CreateDefaultRepresentation();
+      bone->SetWidgetStateToRest();
+      bone->SetHeadRestWorldPosition(head);
+      bone->SetTailRestWorldPosition(tail);
+      if (parent >= 0)
+        {
+        bone->SetBoneParent(this->Bones[parent]);
+        bone->SetHeadLinkedToParent(1);
+        }
+      if (interactor)
+        {
+        bone->On();
+        }
+      this->Skeleton->AddBone(bone);
+      this->Bones.push_back(bone);
+      }
+    }
+
+  void SetWidgetState(int state)
+    {
+    for (size_t i = 0; i < this->Bones.size(); ++i)
+      {
+      this->Bones[i]->SetWidgetState(state);
+      }
+    }
+
+  // Evenly spaced bones, at most maximum of them
+  std::vector<vtkBoneWidget*> Sample(int maximum)
+    {
+    std::vector<vtkBoneWidget*> sample;
+    int numberOfBones = static_cast<int>(this->Bones.size());
+    int step = std::max(1, numberOfBones / std::max(1, maximum));
+    for (int i = 0; i < numberOfBones
+         && static_cast<int>(sample.size()) < maximum; i += step)
+      {
+      sample.push_back(this->Bones[i]);
+      }
+    return sample;
+    }
+
+  std::vector<vtkSmartPointer<vtkBoneWidget> > Bones;
+  vtkSmartPointer<vtkBoneSkeleton> Skeleton;
+};
+
+const char* GetTopologyAsString(int topology)
+{
+  return topology == SyntheticSkeleton::Chain ? "chain" : "tree";
+}
+
+//----------------------------------------------------------------------------
+// Each benchmark runs one timed repetition and returns the number of
+// operations it timed.
+typedef int (*BenchmarkFunction)(SyntheticSkeleton& skeleton,
+                                 const BenchmarkOptions& options,
+                                 int repetition, vtkTimerLog* timer);
+
+//----------------------------------------------------------------------------
+int BenchmarkSetHeadRestWorldPosition(SyntheticSkeleton& skeleton,
+                                      const BenchmarkOptions& options,
+                                      int repetition, vtkTimerLog* timer)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  std::vector<vtkBoneWidget*> bones = skeleton.Sample(options.Samples);
+  double offset = repetition % 2 ? -1e-3 : 1e-3;
+
+  timer->StartTimer();
+  for (size_t i = 0; i < bones.size(); ++i)
+    {
+    double head[3];
+    bones[i]->GetHeadRestWorldPosition(head);
+    head[2] += offset;
+    bones[i]->SetHeadRestWorldPosition(head);
+    }
+  timer->StopTimer();
+  return static_cast<int>(bones.size());
+}
+
+//----------------------------------------------------------------------------
+int BenchmarkSetTailRestWorldPosition(SyntheticSkeleton& skeleton,
+                                      const BenchmarkOptions& options,
+                                      int repetition, vtkTimerLog* timer)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  std::vector<vtkBoneWidget*> bones = skeleton.Sample(options.Samples);
+  double offset = repetition % 2 ? -1e-3 : 1e-3;
+
+  timer->StartTimer();
+  for (size_t i = 0; i < bones.size(); ++i)
+    {
+    double tail[3];
+    bones[i]->GetTailRestWorldPosition(tail);
+    tail[2] += offset;
+    bones[i]->SetTailRestWorldPosition(tail);
+    }
+  timer->StopTimer();
+  return static_cast<int>(bones.size());
+}
+
+//----------------------------------------------------------------------------
+int BenchmarkRotateTailWXYZ(SyntheticSkeleton& skeleton,
+                            const BenchmarkOptions& options,
+                            int repetition, vtkTimerLog* timer)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Pose);
+  std::vector<vtkBoneWidget*> bones = skeleton.Sample(options.Samples);
+  double angle = repetition % 2 ? -1e-2 : 1e-2;
+
+  timer->StartTimer();
+  for (size_t i = 0; i < bones.size(); ++i)
+    {
+    bones[i]->RotateTailWXYZ(angle, 0.0, 0.0, 1.0);
+    }
+  timer->StopTimer();
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  return static_cast<int>(bones.size());
+}
+
+//----------------------------------------------------------------------------
+int BenchmarkSetWidgetState(SyntheticSkeleton& skeleton,
+                            const BenchmarkOptions& vtkNotUsed(options),
+                            int vtkNotUsed(repetition), vtkTimerLog* timer)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+
+  timer->StartTimer();
+  skeleton.SetWidgetState(vtkBoneWidget::Pose);
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  timer->StopTimer();
+  return 2 * static_cast<int>(skeleton.Bones.size());
+}
+
+//----------------------------------------------------------------------------
+// Moving the root tail in rest mode moves the linked heads of the children
+int BenchmarkRestPropagation(SyntheticSkeleton& skeleton,
+                             const BenchmarkOptions& vtkNotUsed(options),
+                             int repetition, vtkTimerLog* timer)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  vtkBoneWidget* root = skeleton.Bones[0];
+  double offset = repetition % 2 ? -1e-3 : 1e-3;
+  const int numberOfCalls = 10;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfCalls; ++i)
+    {
+    double tail[3];
+    root->GetTailRestWorldPosition(tail);
+    tail[1] += offset;
+    root->SetTailRestWorldPosition(tail);
+    }
+  timer->StopTimer();
+  return numberOfCalls;
+}
+
+//----------------------------------------------------------------------------
+// Rotating the root in pose mode moves all the bones
+int BenchmarkPosePropagation(SyntheticSkeleton& skeleton,
+                             const BenchmarkOptions& vtkNotUsed(options),
+                             int repetition, vtkTimerLog* timer)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Pose);
+  vtkBoneWidget* root = skeleton.Bones[0];
+  double angle = repetition % 2 ? -1e-2 : 1e-2;
+  const int numberOfCalls = 10;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfCalls; ++i)
+    {
+    root->RotateTailWXYZ(angle, 0.0, 1.0, 0.0);
+    }
+  timer->StopTimer();
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  return numberOfCalls;
+}
+
+//----------------------------------------------------------------------------
+struct Benchmark
+{
+  const char* Name;
+  BenchmarkFunction Function;
+};
+
+const Benchmark Benchmarks[] =
+{
+  {"SetHeadRestWorldPosition", BenchmarkSetHeadRestWorldPosition},
+  {"SetTailRestWorldPosition", BenchmarkSetTailRestWorldPosition},
+  {"RotateTailWXYZ", BenchmarkRotateTailWXYZ},
+  {"SetWidgetState", BenchmarkSetWidgetState},
+  {"RestPropagation", BenchmarkRestPropagation},
+  {"PosePropagation", BenchmarkPosePropagation}
+};
+const int NumberOfBenchmarks = sizeof(Benchmarks) / sizeof(Benchmark);
+
+//----------------------------------------------------------------------------
+// Each interaction plays one mouse drag on the root bone with the driver.
+// The drags go back and forth so that the skeleton stays in view.
+typedef void (*InteractionFunction)(SyntheticSkeleton& skeleton,
+                                    vtkBoneInteractionDriver* driver,
+                                    const BenchmarkOptions& options,
+                                    int repetition);
+
+// Length of the drags, in pixels
+const double DragLength = 40.0;
+
+//----------------------------------------------------------------------------
+void InteractionRestHeadDrag(SyntheticSkeleton& skeleton,
+                             vtkBoneInteractionDriver* driver,
+                             const BenchmarkOptions& options, int repetition)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  double start[2], end[2];
+  driver->WorldToDisplay(
+    skeleton.Bones[0]->GetHeadRestWorldPosition(), start);
+  end[0] = start[0];
+  end[1] = start[1] + (repetition % 2 ? -DragLength : DragLength);
+  driver->Drag(start, end, options.InteractionMoves);
+}
+
+//----------------------------------------------------------------------------
+void InteractionRestTailDrag(SyntheticSkeleton& skeleton,
+                             vtkBoneInteractionDriver* driver,
+                             const BenchmarkOptions& options, int repetition)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  double start[2], end[2];
+  driver->WorldToDisplay(
+    skeleton.Bones[0]->GetTailRestWorldPosition(), start);
+  end[0] = start[0];
+  end[1] = start[1] + (repetition % 2 ? -DragLength : DragLength);
+  driver->Drag(start, end, options.InteractionMoves);
+}
+
+//----------------------------------------------------------------------------
+void InteractionRestLineDrag(SyntheticSkeleton& skeleton,
+                             vtkBoneInteractionDriver* driver,
+                             const BenchmarkOptions& options, int repetition)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+  double head[2], tail[2], start[2], end[2];
+  driver->WorldToDisplay(
+    skeleton.Bones[0]->GetHeadRestWorldPosition(), head);
+  driver->WorldToDisplay(
+    skeleton.Bones[0]->GetTailRestWorldPosition(), tail);
+  start[0] = 0.5 * (head[0] + tail[0]);
+  start[1] = 0.5 * (head[1] + tail[1]);
+  end[0] = start[0];
+  end[1] = start[1] + (repetition % 2 ? -DragLength : DragLength);
+  driver->Drag(start, end, options.InteractionMoves);
+}
+
+//----------------------------------------------------------------------------
+void InteractionPoseTailRotation(SyntheticSkeleton& skeleton,
+                                 vtkBoneInteractionDriver* driver,
+                                 const BenchmarkOptions& options,
+                                 int repetition)
+{
+  skeleton.SetWidgetState(vtkBoneWidget::Pose);
+  double head[2], tail[2];
+  driver->WorldToDisplay(
+    skeleton.Bones[0]->GetHeadPoseWorldPosition(), head);
+  driver->WorldToDisplay(
+    skeleton.Bones[0]->GetTailPoseWorldPosition(), tail);
+  double angle = vtkMath::Pi() / 2.0;
+  driver->Rotate(tail, head, repetition % 2 ? -angle : angle,
+                 options.InteractionMoves);
+  skeleton.SetWidgetState(vtkBoneWidget::Rest);
+}
+
+//----------------------------------------------------------------------------
+struct Interaction
+{
+  const char* Name;
+  InteractionFunction Function;
+};
+
+const Interaction Interactions[] =
+{
+  {"RestHeadDrag", InteractionRestHeadDrag},
+  {"RestTailDrag", InteractionRestTailDrag},
+  {"RestLineDrag", InteractionRestLineDrag},
+  {"PoseTailRotation", InteractionPoseTailRotation}
+};
+const int NumberOfInteractions = sizeof(Interactions) / sizeof(Interaction);
+
+//----------------------------------------------------------------------------
+bool IsSelected(const BenchmarkOptions& options, const char* name)
+{
+  return options.Filter.empty()
+    || std::string(name).find(options.Filter) != std::string::npos;
+}
+
+//----------------------------------------------------------------------------
+// Nearest rank percentile of sorted times
+double Percentile(const std::vector<double>& sortedTimes, double percentile)
+{
+  size_t rank = static_cast<size_t>(
+    ceil(percentile / 100.0 * sortedTimes.size()));
+  rank = std::min(std::max(rank, static_cast<size_t>(1)), sortedTimes.size());
+  return sortedTimes[rank - 1];
+}
+
+//----------------------------------------------------------------------------
+void AddResult(std::vector<BenchmarkResult>& results, const std::string& name,
+               const std::string& topology, int numberOfBones,
+               int numberOfOperations, const std::vector<double>& times)
+{
+  if (times.empty())
+    {
+    return;
+    }
+
+  std::vector<double> sortedTimes = times;
+  std::sort(sortedTimes.begin(), sortedTimes.end());
+
+  BenchmarkResult result;
+  result.Name = name;
+  result.Topology = topology;
+  result.NumberOfBones = numberOfBones;
+  result.NumberOfOperations = numberOfOperations;
+  result.BestTime = sortedTimes.front();
+  result.MeanTime = 0.0;
+  for (size_t i = 0; i < times.size(); ++i)
+    {
+    result.MeanTime += times[i] / times.size();
+    }
+  result.P50Time = Percentile(sortedTimes, 50.0);
+  result.P99Time = Percentile(sortedTimes, 99.0);
+  results.push_back(result);
+
+  std::cerr << name << " (" << result.Topology << ", " << numberOfBones
+            << " bones): " << result.BestTime << " s" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+void RunBenchmarks(const BenchmarkOptions& options,
+                   std::vector<BenchmarkResult>& results)
+{
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+
+  for (int topology = SyntheticSkeleton::Chain;
+       topology <= SyntheticSkeleton::Tree; ++topology)
+    {
+    for (size_t s = 0; s < options.Sizes.size(); ++s)
+      {
+      int numberOfBones = options.Sizes[s];
+
+      // Building is timed as well, the last skeleton is used by the others
+      SyntheticSkeleton skeleton;
+      std::vector<double> times;
+      for (int r = 0; r < options.Repetitions; ++r)
+        {
+        timer->StartTimer();
+        skeleton.Build(topology, numberOfBones);
+        timer->StopTimer();
+        times.push_back(timer->GetElapsedTime());
+        }
+      if (IsSelected(options, "Build"))
+        {
+        AddResult(results, "Build", GetTopologyAsString(topology),
+                  numberOfBones, numberOfBones, times);
+        }
+
+      for (int b = 0; b < NumberOfBenchmarks; ++b)
+        {
+        if (!IsSelected(options, Benchmarks[b].Name))
+          {
+          continue;
+          }
+
+        times.clear();
+        int numberOfOperations = 0;
+        for (int r = 0; r < options.Repetitions; ++r)
+          {
+          numberOfOperations =
+            Benchmarks[b].Function(skeleton, options, r, timer);
+          times.push_back(timer->GetElapsedTime());
+          }
+        AddResult(results, Benchmarks[b].Name, GetTopologyAsString(topology),
+                  numberOfBones, numberOfOperations, times);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Every event of the drags is one operation: the latencies are per event.
+void RunInteractions(const BenchmarkOptions& options,
+                     std::vector<BenchmarkResult>& results)
+{
+  for (int topology = SyntheticSkeleton::Chain;
+       topology <= SyntheticSkeleton::Tree; ++topology)
+    {
+    for (size_t s = 0; s < options.Sizes.size(); ++s)
+      {
+      int numberOfBones = options.Sizes[s];
+
+      vtkSmartPointer<vtkRenderer> renderer =
+        vtkSmartPointer<vtkRenderer>::New();
+      vtkSmartPointer<vtkRenderWindow> renderWindow =
+        vtkSmartPointer<vtkRenderWindow>::New();
+      renderWindow->SetOffScreenRendering(1);
+      renderWindow->SetSize(800, 600);
+      renderWindow->AddRenderer(renderer);
+      vtkSmartPointer<vtkRenderWindowInteractor> interactor =
+        vtkSmartPointer<vtkRenderWindowInteractor>::New();
+      interactor->SetRenderWindow(renderWindow);
+
+      vtkSmartPointer<vtkBoneInteractionDriver> driver =
+        vtkSmartPointer<vtkBoneInteractionDriver>::New();
+      driver->SetInteractor(interactor);
+      driver->SetRenderer(renderer);
+
+      // Destroyed before the scene
+      SyntheticSkeleton skeleton;
+      skeleton.Build(topology, numberOfBones, interactor, renderer);
+
+      // Look at the root bone from the side, large enough to be picked
+      double center[3], head[3], tail[3];
+      skeleton.Bones[0]->GetHeadRestWorldPosition(head);
+      skeleton.Bones[0]->GetTailRestWorldPosition(tail);
+      for (int i = 0; i < 3; ++i)
+        {
+        center[i] = 0.5 * (head[i] + tail[i]);
+        }
+      vtkCamera* camera = renderer->GetActiveCamera();
+      camera->SetParallelProjection(1);
+      camera->SetParallelScale(0.1);
+      camera->SetFocalPoint(center);
+      camera->SetPosition(center[0], center[1] + 1.0, center[2]);
+      camera->SetViewUp(0.0, 0.0, 1.0);
+      renderer->ResetCameraClippingRange();
+      driver->Initialize();
+
+      for (int i = 0; i < NumberOfInteractions; ++i)
+        {
+        if (!IsSelected(options, Interactions[i].Name))
+          {
+          continue;
+          }
+
+        driver->ResetLatencies();
+        for (int r = 0; r < options.Repetitions; ++r)
+          {
+          Interactions[i].Function(skeleton, driver, options, r);
+          }
+        for (int event = 0; event < vtkBoneInteractionDriver::NumberOfEvents;
+             ++event)
+          {
+          const std::vector<double>& latencies = driver->GetLatencies(event);
+          std::string name = std::string(Interactions[i].Name) + "."
+            + vtkBoneInteractionDriver::GetEventTypeAsString(event);
+          AddResult(results, name, GetTopologyAsString(topology),
+                    numberOfBones, static_cast<int>(latencies.size()),
+                    latencies);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Replay a recorded session in an offscreen render window. The CPU time of
+// the events is reported per event type and for the whole session.
+// Return false if the session could not be replayed or did not end in
+// the recorded state.
+bool RunReplay(const BenchmarkOptions& options,
+               std::vector<BenchmarkResult>& results)
+{
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  vtkSmartPointer<vtkRenderWindow> renderWindow =
+    vtkSmartPointer<vtkRenderWindow>::New();
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->AddRenderer(renderer);
+  vtkSmartPointer<vtkRenderWindowInteractor> interactor =
+    vtkSmartPointer<vtkRenderWindowInteractor>::New();
+  interactor->SetRenderWindow(renderWindow);
+
+  vtkSmartPointer<vtkBoneSessionRecorder> recorder =
+    vtkSmartPointer<vtkBoneSessionRecorder>::New();
+  recorder->SetInteractor(interactor);
+  recorder->SetRenderer(renderer);
+  if (!recorder->Read(options.Replay.c_str()) || !recorder->BuildSkeleton())
+    {
+    std::cerr << "Could not load the session " << options.Replay
+              << std::endl;
+    return false;
+    }
+
+  int numberOfBones = static_cast<int>(recorder->GetNumberOfBones());
+  std::vector<double> sessionTimes;
+  std::vector<double> eventTimes[vtkBoneInteractionDriver::NumberOfEvents];
+  for (int r = 0; r < options.Repetitions; ++r)
+    {
+    if (!recorder->Replay())
+      {
+      std::cerr << "The replay of " << options.Replay << " does not match "
+                << "the recording: " << recorder->GetNumberOfMismatchedBones()
+                << " bones differ." << std::endl;
+      return false;
+      }
+
+    sessionTimes.push_back(recorder->GetReplayTime());
+    for (vtkIdType i = 0; i < recorder->GetNumberOfEvents(); ++i)
+      {
+      int event = vtkBoneInteractionDriver::MoveEvent;
+      if (recorder->GetEventId(i) == vtkCommand::LeftButtonPressEvent)
+        {
+        event = vtkBoneInteractionDriver::PressEvent;
+        }
+      else if (recorder->GetEventId(i) == vtkCommand::LeftButtonReleaseEvent)
+        {
+        event = vtkBoneInteractionDriver::ReleaseEvent;
+        }
+      eventTimes[event].push_back(recorder->GetEventTime(i));
+      }
+    }
+
+  AddResult(results, "Replay", "session", numberOfBones,
+            static_cast<int>(recorder->GetNumberOfEvents()), sessionTimes);
+  for (int event = 0; event < vtkBoneInteractionDriver::NumberOfEvents;
+       ++event)
+    {
+    std::string name = std::string("Replay.")
+      + vtkBoneInteractionDriver::GetEventTypeAsString(event);
+    AddResult(results, name, "session", numberOfBones,
+              static_cast<int>(eventTimes[event].size()), eventTimes[event]);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Interaction and replayed events whose p99 latency is over the frame budget
+int CountOverBudget(const BenchmarkOptions& options,
+                    const std::vector<BenchmarkResult>& results)
+{
+  int count = 0;
+  for (size_t i = 0; i < results.size(); ++i)
+    {
+    const BenchmarkResult& result = results[i];
+    bool isEvent = result.Name.find("Replay.") == 0;
+    for (int j = 0; j < NumberOfInteractions && !isEvent; ++j)
+      {
+      isEvent = result.Name.find(Interactions[j].Name) == 0;
+      }
+    if (isEvent && result.P99Time > options.FrameBudget)
+      {
+      std::cerr << result.Name << " (" << result.Topology << ", "
+                << result.NumberOfBones << " bones): p99 of "
+                << result.P99Time << " s is over the frame budget"
+                << std::endl;
+      ++count;
+      }
+    }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void WriteJSON(const BenchmarkOptions& options,
+               const std::vector<BenchmarkResult>& results, std::ostream& os)
+{
+  os.precision(9);
+  os << "{\n"
+     << "  \"suite\": \"vtkBoneWidgetBenchmarks\",\n"
+     << "  \"vtk_version\": \"" << vtkVersion::GetVTKVersion() << "\",\n"
+     << "  \"repetitions\": " << options.Repetitions << ",\n"
+     << "  \"frame_budget_seconds\": " << options.FrameBudget << ",\n"
+     << "  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i)
+    {
+    const BenchmarkResult& result = results[i];
+    os << "    {\"name\": \"" << result.Name << "\""
+       << ", \"topology\": \"" << result.Topology << "\""
+       << ", \"bones\": " << result.NumberOfBones
+       << ", \"operations\": " << result.NumberOfOperations
+       << ", \"best_seconds\": " << result.BestTime
+       << ", \"mean_seconds\": " << result.MeanTime
+       << ", \"best_seconds_per_operation\": "
+       << result.BestTime / std::max(1, result.NumberOfOperations)
+       << ", \"p50_seconds\": " << result.P50Time
+       << ", \"p99_seconds\": " << result.P99Time
+       << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+  os << "  ]\n"
+     << "}\n";
+}
+
+//----------------------------------------------------------------------------
+void WriteCSV(const std::vector<BenchmarkResult>& results, std::ostream& os)
+{
+  os.precision(9);
+  os << "name,topology,bones,operations,best_seconds,mean_seconds,"
+     << "best_seconds_per_operation,p50_seconds,p99_seconds\n";
+  for (size_t i = 0; i < results.size(); ++i)
+    {
+    const BenchmarkResult& result = results[i];
+    os << result.Name << "," << result.Topology << ","
+       << result.NumberOfBones << "," << result.NumberOfOperations << ","
+       << result.BestTime << "," << result.MeanTime << ","
+       << result.BestTime / std::max(1, result.NumberOfOperations) << ","
+       << result.P50Time << "," << result.P99Time << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void PrintUsage(const char* program)
+{
+  std::cout
+    << "Usage: " << program << " [options]\n"
+    << "  --format json|csv     Output format, json by default.\n"
+    << "  --output <file>       Write the results to the file instead of\n"
+    << "                        the standard output.\n"
+    << "  --sizes <n1,n2,...>   Number of bones of the synthetic chains and\n"
+    << "                        trees, 10,100,1000,10000 by default.\n"
+    << "  --repetitions <n>     Timed runs per benchmark, 3 by default.\n"
+    << "                        The best, mean, p50 and p99 times are\n"
+    << "                        reported.\n"
+    << "  --samples <n>         Maximum number of bones operated on by the\n"
+    << "                        per bone benchmarks, 100 by default.\n"
+    << "  --filter <text>       Only run the benchmarks whose name contains\n"
+    << "                        the text.\n"
+    << "  --interaction         Also play mouse drags on the skeletons in an\n"
+    << "                        offscreen render window and report the\n"
+    << "                        latency of each event.\n"
+    << "  --interaction-moves <n>\n"
+    << "                        Mouse moves per drag, 100 by default.\n"
+    << "  --frame-budget <ms>   Fail if the p99 latency of an interaction\n"
+    << "                        event is over the budget (e.g. 8).\n"
+    << "  --replay <file>       Only replay the session recorded by\n"
+    << "                        vtkBoneSessionRecorder in the file, check\n"
+    << "                        its final state and report the CPU time of\n"
+    << "                        its events.\n"
+    << "  --help                Print this message.\n";
+}
+
+//----------------------------------------------------------------------------
+bool ParseSizes(const char* text, std::vector<int>& sizes)
+{
+  sizes.clear();
+  std::stringstream stream(text);
+  std::string size;
+  while (std::getline(stream, size, ','))
+    {
+    int value = atoi(size.c_str());
+    if (value <= 0)
+      {
+      return false;
+      }
+    sizes.push_back(value);
+    }
+  return !sizes.empty();
+}
+
+//----------------------------------------------------------------------------
+bool ParseArguments(int argc, char* argv[], BenchmarkOptions& options)
+{
+  options.Format = "json";
+  options.Repetitions = 3;
+  options.Samples = 100;
+  options.Interaction = false;
+  options.InteractionMoves = 100;
+  options.FrameBudget = 0.0;
+  options.Help = false;
+  options.Sizes.push_back(10);
+  options.Sizes.push_back(100);
+  options.Sizes.push_back(1000);
+  options.Sizes.push_back(10000);
+
+  for (int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (argument == "--format" && hasValue)
+      {
+      options.Format = argv[++i];
+      if (options.Format != "json" && options.Format != "csv")
+        {
+        return false;
+        }
+      }
+    else if (argument == "--output" && hasValue)
+      {
+      options.Output = argv[++i];
+      }
+    else if (argument == "--sizes" && hasValue)
+      {
+      if (!ParseSizes(argv[++i], options.Sizes))
+        {
+        return false;
+        }
+      }
+    else if (argument == "--repetitions" && hasValue)
+      {
+      options.Repetitions = atoi(argv[++i]);
+      if (options.Repetitions <= 0)
+        {
+        return false;
+        }
+      }
+    else if (argument == "--samples" && hasValue)
+      {
+      options.Samples = atoi(argv[++i]);
+      if (options.Samples <= 0)
+        {
+        return false;
+        }
+      }
+    else if (argument == "--filter" && hasValue)
+      {
+      options.Filter = argv[++i];
+      }
+    else if (argument == "--replay" && hasValue)
+      {
+      options.Replay = argv[++i];
+      }
+    else if (argument == "--interaction")
+      {
+      options.Interaction = true;
+      }
+    else if (argument == "--interaction-moves" && hasValue)
+      {
+      options.InteractionMoves = atoi(argv[++i]);
+      if (options.InteractionMoves <= 0)
+        {
+        return false;
+        }
+      }
+    else if (argument == "--frame-budget" && hasValue)
+      {
+      options.FrameBudget = atof(argv[++i]) / 1000.0;
+      if (options.FrameBudget <= 0.0)
+        {
+        return false;
+        }
+      }
+    else if (argument == "--help")
+      {
+      options.Help = true;
+      return false;
+      }
+    else
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  BenchmarkOptions options;
+  if (!ParseArguments(argc, argv, options))
+    {
+    PrintUsage(argv[0]);
+    return options.Help ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+  std::vector<BenchmarkResult> results;
+  if (!options.Replay.empty())
+    {
+    if (!RunReplay(options, results))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  else
+    {
+    RunBenchmarks(options, results);
+    if (options.Interaction)
+      {
+      RunInteractions(options, results);
+      }
+    }
+
+  std::ofstream file;
+  if (!options.Output.empty())
+    {
+    file.open(options.Output.c_str());
+    if (!file)
+      {
+      std::cerr << "Could not open " << options.Output << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  std::ostream& os = options.Output.empty() ? std::cout : file;
+
+  if (options.Format == "csv")
+    {
+    WriteCSV(results, os);
+    }
+  else
+    {
+    WriteJSON(options, results, os);
+    }
+
+  if (options.FrameBudget > 0.0 && CountOverBudget(options, results) > 0)
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
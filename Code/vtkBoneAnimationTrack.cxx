@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneAnimationTrack.h"
+
+//My includes
+#include "vtkBoneBatchMath.h"
+#include "vtkBoneSkeleton.h"
+
+//VTK Includes
+#include <vtkObjectFactory.h>
+
+//STL includes
+#include <algorithm>
+
+vtkStandardNewMacro(vtkBoneAnimationTrack);
+
+namespace
+{
+
+void CopyQuaternion(const double* quad, double* copyQuad)
+{
+  copyQuad[0] = quad[0];
+  copyQuad[1] = quad[1];
+  copyQuad[2] = quad[2];
+  copyQuad[3] = quad[3];
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBoneAnimationTrack::vtkBoneAnimationTrack()
+{
+  this->InterpolationMode = vtkBoneAnimationTrack::Slerp;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneAnimationTrack::~vtkBoneAnimationTrack()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::SetNumberOfBones(vtkIdType numberOfBones)
+{
+  if (numberOfBones < 0 || numberOfBones == this->GetNumberOfBones())
+    {
+    return;
+    }
+
+  this->Times.resize(numberOfBones);
+  this->PoseTransforms.resize(numberOfBones);
+  this->Cursors.resize(numberOfBones, 0);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneAnimationTrack::GetNumberOfBones()
+{
+  return static_cast<vtkIdType>(this->Times.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::AddKeyframe(vtkIdType bone, double time,
+                                        const double poseTransform[4])
+{
+  if (bone < 0)
+    {
+    return;
+    }
+  if (bone >= this->GetNumberOfBones())
+    {
+    this->SetNumberOfBones(bone + 1);
+    }
+
+  std::vector<double>& times = this->Times[bone];
+  std::vector<double>& poseTransforms = this->PoseTransforms[bone];
+  vtkIdType keyframe = static_cast<vtkIdType>(
+    std::lower_bound(times.begin(), times.end(), time) - times.begin());
+  if (keyframe == static_cast<vtkIdType>(times.size())
+      || times[keyframe] != time)
+    {
+    times.insert(times.begin() + keyframe, time);
+    poseTransforms.insert(poseTransforms.begin() + 4*keyframe, 4, 0.0);
+    }
+  CopyQuaternion(poseTransform, &poseTransforms[4*keyframe]);
+
+  this->Cursors[bone] = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::AddKeyframes(double time,
+                                         vtkBoneSkeleton* skeleton)
+{
+  if (!skeleton)
+    {
+    return;
+    }
+
+  for (vtkIdType i = 0; i < skeleton->GetNumberOfBones(); ++i)
+    {
+    this->AddKeyframe(i, time, skeleton->GetPoseTransform(i));
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneAnimationTrack::GetNumberOfKeyframes(vtkIdType bone)
+{
+  return static_cast<vtkIdType>(this->Times[bone].size());
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneAnimationTrack::GetKeyframeTime(vtkIdType bone,
+                                              vtkIdType keyframe)
+{
+  return this->Times[bone][keyframe];
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneAnimationTrack::GetKeyframePoseTransform(vtkIdType bone,
+                                                       vtkIdType keyframe)
+{
+  return &this->PoseTransforms[bone][4*keyframe];
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::RemoveAllKeyframes()
+{
+  for (vtkIdType i = 0; i < this->GetNumberOfBones(); ++i)
+    {
+    this->Times[i].clear();
+    this->PoseTransforms[i].clear();
+    this->Cursors[i] = 0;
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::GetTimeRange(double range[2])
+{
+  range[0] = range[1] = 0.0;
+  bool empty = true;
+  for (vtkIdType i = 0; i < this->GetNumberOfBones(); ++i)
+    {
+    const std::vector<double>& times = this->Times[i];
+    if (times.empty())
+      {
+      continue;
+      }
+    range[0] = empty ? times.front() : std::min(range[0], times.front());
+    range[1] = empty ? times.back() : std::max(range[1], times.back());
+    empty = false;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneAnimationTrack::FindKeyframe(vtkIdType bone, double time)
+{
+  const std::vector<double>& times = this->Times[bone];
+  vtkIdType last = static_cast<vtkIdType>(times.size()) - 1;
+  vtkIdType keyframe = this->Cursors[bone];
+
+  // Sequential playback: same interval or one of its neighbours
+  if (keyframe >= last || times[keyframe] > time
+      || times[keyframe + 1] <= time)
+    {
+    if (keyframe + 2 <= last && times[keyframe + 1] <= time
+        && time < times[keyframe + 2])
+      {
+      ++keyframe;
+      }
+    else if (keyframe >= 1 && keyframe <= last
+             && times[keyframe - 1] <= time && time < times[keyframe])
+      {
+      --keyframe;
+      }
+    else
+      {
+      keyframe = static_cast<vtkIdType>(
+        std::upper_bound(times.begin(), times.end(), time)
+        - times.begin()) - 1;
+      }
+    }
+
+  this->Cursors[bone] = keyframe;
+  return keyframe;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::EvaluateBones(double time,
+                                          vtkIdType numberOfBones,
+                                          double* poseTransforms)
+{
+  if (numberOfBones <= 0)
+    {
+    return;
+    }
+
+  // Gather the ends of the intervals
+  this->StartPoseTransforms.resize(4*numberOfBones);
+  this->EndPoseTransforms.resize(4*numberOfBones);
+  this->Alphas.resize(numberOfBones);
+  static const double identity[4] = {1.0, 0.0, 0.0, 0.0};
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    const std::vector<double>& times = this->Times[i];
+    const double* start = identity;
+    const double* end = identity;
+    double alpha = 0.0;
+    if (!times.empty())
+      {
+      if (time <= times.front())
+        {
+        start = end = &this->PoseTransforms[i][0];
+        }
+      else if (time >= times.back())
+        {
+        start = end = &this->PoseTransforms[i][4*(times.size() - 1)];
+        }
+      else
+        {
+        vtkIdType keyframe = this->FindKeyframe(i, time);
+        start = &this->PoseTransforms[i][4*keyframe];
+        end = start + 4;
+        alpha = (time - times[keyframe])
+          / (times[keyframe + 1] - times[keyframe]);
+        }
+      }
+    CopyQuaternion(start, &this->StartPoseTransforms[4*i]);
+    CopyQuaternion(end, &this->EndPoseTransforms[4*i]);
+    this->Alphas[i] = alpha;
+    }
+
+  if (this->InterpolationMode == vtkBoneAnimationTrack::Nlerp)
+    {
+    vtkBoneBatchMath::NlerpQuaternions(&this->StartPoseTransforms[0],
+                                       &this->EndPoseTransforms[0],
+                                       &this->Alphas[0], poseTransforms,
+                                       numberOfBones);
+    }
+  else
+    {
+    vtkBoneBatchMath::SlerpQuaternions(&this->StartPoseTransforms[0],
+                                       &this->EndPoseTransforms[0],
+                                       &this->Alphas[0], poseTransforms,
+                                       numberOfBones);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::Evaluate(double time, double* poseTransforms)
+{
+  this->EvaluateBones(time, this->GetNumberOfBones(), poseTransforms);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::ApplyToSkeleton(double time,
+                                            vtkBoneSkeleton* skeleton)
+{
+  if (!skeleton || skeleton->GetNumberOfBones() == 0)
+    {
+    return;
+    }
+
+  // The bones the track does not know keep their pose
+  vtkIdType numberOfBones = skeleton->GetNumberOfBones();
+  this->EvaluatedPoseTransforms.assign(skeleton->GetPoseTransforms(),
+    skeleton->GetPoseTransforms() + 4*numberOfBones);
+  this->EvaluateBones(time, std::min(numberOfBones, this->GetNumberOfBones()),
+                      &this->EvaluatedPoseTransforms[0]);
+  skeleton->SetPoseTransforms(&this->EvaluatedPoseTransforms[0]);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneAnimationTrack::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  double range[2];
+  this->GetTimeRange(range);
+  os << indent << "Interpolation Mode: "
+     << (this->InterpolationMode == vtkBoneAnimationTrack::Nlerp ?
+         "Nlerp" : "Slerp") << "\n";
+  os << indent << "Number Of Bones: " << this->GetNumberOfBones() << "\n";
+  os << indent << "Time Range: " << range[0] << " " << range[1] << "\n";
+}
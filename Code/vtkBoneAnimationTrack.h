@@ -0,0 +1,156 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneAnimationTrack_h
+#define __vtkBoneAnimationTrack_h
+
+// .NAME vtkBoneAnimationTrack - Keyframed pose transforms of a skeleton
+// .SECTION Description
+// vtkBoneAnimationTrack stores, for each bone of a skeleton, a list of
+// keyframes: a time and a pose transform (quaternion (w, x, y, z), see
+// vtkBoneWidget::GetPoseTransform()). The bone indices are the bone ids in
+// the vtkBoneSkeleton the track is applied to.
+//
+// Evaluate() interpolates the pose transforms of all the bones at a given
+// time with vtkBoneBatchMath (Slerp or Nlerp). Before the first keyframe
+// and after the last one, the pose transform is the one of the first/last
+// keyframe. Bones without keyframes have the identity pose transform.
+// ApplyToSkeleton() sets the evaluated transforms to a skeleton with
+// vtkBoneSkeleton::SetPoseTransforms().
+//
+// Each bone keeps a cursor on the keyframes interval of its last
+// evaluation. Playing the track forward (or backward) only moves the
+// cursors to the next interval, the keyframes are only searched when
+// jumping in time.
+// .SECTION See Also
+// vtkBoneSkeleton vtkBoneBatchMath
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vector>
+//ETX
+
+class vtkBoneSkeleton;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneAnimationTrack : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneAnimationTrack *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneAnimationTrack, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  enum InterpolationModeType {Slerp = 0, Nlerp};
+  //ETX
+
+  // Description:
+  // Set/Get the interpolation between two keyframes. Slerp by default.
+  vtkSetClampMacro(InterpolationMode, int, Slerp, Nlerp);
+  vtkGetMacro(InterpolationMode, int);
+  void SetInterpolationModeToSlerp()
+    { this->SetInterpolationMode(vtkBoneAnimationTrack::Slerp); }
+  void SetInterpolationModeToNlerp()
+    { this->SetInterpolationMode(vtkBoneAnimationTrack::Nlerp); }
+
+  // Description:
+  // Set/Get the number of bones. Removing bones removes their keyframes.
+  void SetNumberOfBones(vtkIdType numberOfBones);
+  vtkIdType GetNumberOfBones();
+
+  // Description:
+  // Add a keyframe to a bone. A keyframe at the same time is replaced.
+  // The number of bones is increased if needed.
+  void AddKeyframe(vtkIdType bone, double time, const double poseTransform[4]);
+
+  // Description:
+  // Add a keyframe to all the bones from the current pose transforms of
+  // the bones of the skeleton.
+  void AddKeyframes(double time, vtkBoneSkeleton* skeleton);
+
+  // Description:
+  // Get the number of keyframes of a bone, and the keyframes.
+  // No bound checking is done.
+  vtkIdType GetNumberOfKeyframes(vtkIdType bone);
+  double GetKeyframeTime(vtkIdType bone, vtkIdType keyframe);
+  double* GetKeyframePoseTransform(vtkIdType bone, vtkIdType keyframe);
+
+  // Description:
+  // Remove the keyframes of all the bones.
+  void RemoveAllKeyframes();
+
+  // Description:
+  // Get the time range of the keyframes. (0, 0) if there is no keyframe.
+  void GetTimeRange(double range[2]);
+
+  // Description:
+  // Interpolate the pose transforms of all the bones at the given time.
+  // The poseTransforms array must hold 4*GetNumberOfBones() values.
+  void Evaluate(double time, double* poseTransforms);
+
+  // Description:
+  // Evaluate the track and set the pose transforms of the skeleton bones.
+  // Only the bones of the skeleton with an id lower than the number of
+  // bones of the track are changed.
+  void ApplyToSkeleton(double time, vtkBoneSkeleton* skeleton);
+
+protected:
+  vtkBoneAnimationTrack();
+  ~vtkBoneAnimationTrack();
+
+  // Description:
+  // Find the keyframe interval [keyframe, keyframe + 1] holding the time,
+  // starting at the cursor of the bone. The time must be strictly inside
+  // the keyframes time range.
+  vtkIdType FindKeyframe(vtkIdType bone, double time);
+
+  // Description:
+  // Evaluate the first numberOfBones bones.
+  void EvaluateBones(double time, vtkIdType numberOfBones,
+                     double* poseTransforms);
+
+  int InterpolationMode;
+
+//BTX
+  // Per bone keyframes. PoseTransforms holds 4 values per keyframe.
+  std::vector<std::vector<double> > Times;
+  std::vector<std::vector<double> > PoseTransforms;
+  std::vector<vtkIdType>            Cursors;
+
+  // Evaluation buffers: both ends of the interval of each bone and the
+  // interpolation parameter.
+  std::vector<double>               StartPoseTransforms;
+  std::vector<double>               EndPoseTransforms;
+  std::vector<double>               Alphas;
+  std::vector<double>               EvaluatedPoseTransforms;
+//ETX
+
+private:
+  vtkBoneAnimationTrack(const vtkBoneAnimationTrack&);  //Not implemented
+  void operator=(const vtkBoneAnimationTrack&);  //Not implemented
+};
+
+#endif
@@ -0,0 +1,637 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneBatchMath.h"
+
+//My includes
+#include "vtkBoneBatchMathKernels.h"
+#include "vtkBoneWidgetConfigure.h"
+
+//VTK Includes
+#include <vtkObjectFactory.h>
+
+//STD includes
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) \
+  || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define VTK_BONE_BATCH_MATH_USE_SSE2
+# include <emmintrin.h>
+#endif
+
+#if defined(VTK_BONE_WIDGET_USE_AVX2) && defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+vtkStandardNewMacro(vtkBoneBatchMath);
+
+int vtkBoneBatchMath::InstructionSet = -1;
+
+//----------------------------------------------------------------------------
+// Scalar implementation
+//----------------------------------------------------------------------------
+namespace vtkBoneBatchMathScalar
+{
+
+//----------------------------------------------------------------------------
+void MultiplyQuaternions(const double* quads1, const double* quads2,
+                         double* result, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; ++i, quads1 += 4, quads2 += 4, result += 4)
+    {
+    double w = quads1[0]*quads2[0] - quads1[1]*quads2[1]
+               - quads1[2]*quads2[2] - quads1[3]*quads2[3];
+    double x = quads1[0]*quads2[1] + quads1[1]*quads2[0]
+               + quads1[2]*quads2[3] - quads1[3]*quads2[2];
+    double y = quads1[0]*quads2[2] + quads1[2]*quads2[0]
+               + quads1[3]*quads2[1] - quads1[1]*quads2[3];
+    double z = quads1[0]*quads2[3] + quads1[3]*quads2[0]
+               + quads1[1]*quads2[2] - quads1[2]*quads2[1];
+
+    result[0] = w;
+    result[1] = x;
+    result[2] = y;
+    result[3] = z;
+    }
+}
+
+//----------------------------------------------------------------------------
+void NormalizeQuaternions(double* quads, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; ++i, quads += 4)
+    {
+    double norm2 = quads[0]*quads[0] + quads[1]*quads[1]
+                   + quads[2]*quads[2] + quads[3]*quads[3];
+    if (norm2 > 0.0)
+      {
+      double invNorm = 1.0 / sqrt(norm2);
+      quads[0] *= invNorm;
+      quads[1] *= invNorm;
+      quads[2] *= invNorm;
+      quads[3] *= invNorm;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void ConjugateQuaternions(const double* quads, double* result, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; ++i, quads += 4, result += 4)
+    {
+    result[0] = quads[0];
+    result[1] = -quads[1];
+    result[2] = -quads[2];
+    result[3] = -quads[3];
+    }
+}
+
+//----------------------------------------------------------------------------
+void TransformPoints(const double* quads, const double* translations,
+                     const double* points, double* result, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; ++i, quads += 4, points += 3, result += 3)
+    {
+    // t = 2 * (u x v), v' = v + w*t + u x t, u being the vector part
+    double t[3];
+    t[0] = 2.0 * (quads[2]*points[2] - quads[3]*points[1]);
+    t[1] = 2.0 * (quads[3]*points[0] - quads[1]*points[2]);
+    t[2] = 2.0 * (quads[1]*points[1] - quads[2]*points[0]);
+
+    double x = points[0] + quads[0]*t[0] + (quads[2]*t[2] - quads[3]*t[1]);
+    double y = points[1] + quads[0]*t[1] + (quads[3]*t[0] - quads[1]*t[2]);
+    double z = points[2] + quads[0]*t[2] + (quads[1]*t[1] - quads[2]*t[0]);
+
+    if (translations)
+      {
+      x += translations[0];
+      y += translations[1];
+      z += translations[2];
+      translations += 3;
+      }
+
+    result[0] = x;
+    result[1] = y;
+    result[2] = z;
+    }
+}
+
+//----------------------------------------------------------------------------
+void ComposeRigidTransforms(const double* parentQuads,
+                            const double* parentTranslations,
+                            const double* localQuads,
+                            const double* localTranslations,
+                            double* quads, double* translations,
+                            vtkIdType n)
+{
+  // The translations first: the quads output may be the parent quads
+  TransformPoints(parentQuads, parentTranslations, localTranslations,
+                  translations, n);
+  MultiplyQuaternions(parentQuads, localQuads, quads, n);
+}
+
+//----------------------------------------------------------------------------
+void NlerpQuaternions(const double* quads1, const double* quads2,
+                      const double* alphas, double* result, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; ++i, quads1 += 4, quads2 += 4, result += 4)
+    {
+    double dot = quads1[0]*quads2[0] + quads1[1]*quads2[1]
+                 + quads1[2]*quads2[2] + quads1[3]*quads2[3];
+    double alpha1 = 1.0 - alphas[i];
+    double alpha2 = dot < 0.0 ? -alphas[i] : alphas[i];
+    double w = alpha1*quads1[0] + alpha2*quads2[0];
+    double x = alpha1*quads1[1] + alpha2*quads2[1];
+    double y = alpha1*quads1[2] + alpha2*quads2[2];
+    double z = alpha1*quads1[3] + alpha2*quads2[3];
+
+    double norm2 = w*w + x*x + y*y + z*z;
+    double invNorm = norm2 > 0.0 ? 1.0 / sqrt(norm2) : 1.0;
+    result[0] = w * invNorm;
+    result[1] = x * invNorm;
+    result[2] = y * invNorm;
+    result[3] = z * invNorm;
+    }
+}
+
+}// end namespace vtkBoneBatchMathScalar
+
+#ifdef VTK_BONE_BATCH_MATH_USE_SSE2
+//----------------------------------------------------------------------------
+// SSE2 implementation, 2 elements at a time
+//----------------------------------------------------------------------------
+namespace
+{
+
+// Load 2 quaternions as (w0 w1), (x0 x1), (y0 y1), (z0 z1)
+inline void LoadQuaternions(const double* quads,
+                            __m128d& w, __m128d& x, __m128d& y, __m128d& z)
+{
+  __m128d wx0 = _mm_loadu_pd(quads);
+  __m128d yz0 = _mm_loadu_pd(quads + 2);
+  __m128d wx1 = _mm_loadu_pd(quads + 4);
+  __m128d yz1 = _mm_loadu_pd(quads + 6);
+  w = _mm_unpacklo_pd(wx0, wx1);
+  x = _mm_unpackhi_pd(wx0, wx1);
+  y = _mm_unpacklo_pd(yz0, yz1);
+  z = _mm_unpackhi_pd(yz0, yz1);
+}
+
+inline void StoreQuaternions(double* quads,
+                             __m128d w, __m128d x, __m128d y, __m128d z)
+{
+  _mm_storeu_pd(quads, _mm_unpacklo_pd(w, x));
+  _mm_storeu_pd(quads + 2, _mm_unpacklo_pd(y, z));
+  _mm_storeu_pd(quads + 4, _mm_unpackhi_pd(w, x));
+  _mm_storeu_pd(quads + 6, _mm_unpackhi_pd(y, z));
+}
+
+// Load 2 points as (x0 x1), (y0 y1), (z0 z1)
+inline void LoadPoints(const double* points,
+                       __m128d& x, __m128d& y, __m128d& z)
+{
+  __m128d xy0 = _mm_loadu_pd(points);
+  __m128d z0x1 = _mm_loadu_pd(points + 2);
+  __m128d y1z1 = _mm_loadu_pd(points + 4);
+  x = _mm_shuffle_pd(xy0, z0x1, 2);
+  y = _mm_shuffle_pd(xy0, y1z1, 1);
+  z = _mm_shuffle_pd(z0x1, y1z1, 2);
+}
+
+inline void StorePoints(double* points, __m128d x, __m128d y, __m128d z)
+{
+  _mm_storeu_pd(points, _mm_unpacklo_pd(x, y));
+  _mm_storeu_pd(points + 2, _mm_shuffle_pd(z, x, 2));
+  _mm_storeu_pd(points + 4, _mm_unpackhi_pd(y, z));
+}
+
+inline void MultiplyQuaternions(__m128d w1, __m128d x1, __m128d y1, __m128d z1,
+                                __m128d w2, __m128d x2, __m128d y2, __m128d z2,
+                                __m128d& w, __m128d& x, __m128d& y, __m128d& z)
+{
+  w = _mm_sub_pd(_mm_sub_pd(_mm_sub_pd(_mm_mul_pd(w1, w2), _mm_mul_pd(x1, x2)),
+                            _mm_mul_pd(y1, y2)), _mm_mul_pd(z1, z2));
+  x = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(w1, x2), _mm_mul_pd(x1, w2)),
+                            _mm_mul_pd(y1, z2)), _mm_mul_pd(z1, y2));
+  y = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(w1, y2), _mm_mul_pd(y1, w2)),
+                            _mm_mul_pd(z1, x2)), _mm_mul_pd(x1, z2));
+  z = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(w1, z2), _mm_mul_pd(z1, w2)),
+                            _mm_mul_pd(x1, y2)), _mm_mul_pd(y1, x2));
+}
+
+inline void RotateVectors(__m128d qw, __m128d qx, __m128d qy, __m128d qz,
+                          __m128d& x, __m128d& y, __m128d& z)
+{
+  const __m128d two = _mm_set1_pd(2.0);
+  __m128d tx = _mm_mul_pd(two, _mm_sub_pd(_mm_mul_pd(qy, z), _mm_mul_pd(qz, y)));
+  __m128d ty = _mm_mul_pd(two, _mm_sub_pd(_mm_mul_pd(qz, x), _mm_mul_pd(qx, z)));
+  __m128d tz = _mm_mul_pd(two, _mm_sub_pd(_mm_mul_pd(qx, y), _mm_mul_pd(qy, x)));
+
+  x = _mm_add_pd(_mm_add_pd(x, _mm_mul_pd(qw, tx)),
+                 _mm_sub_pd(_mm_mul_pd(qy, tz), _mm_mul_pd(qz, ty)));
+  y = _mm_add_pd(_mm_add_pd(y, _mm_mul_pd(qw, ty)),
+                 _mm_sub_pd(_mm_mul_pd(qz, tx), _mm_mul_pd(qx, tz)));
+  z = _mm_add_pd(_mm_add_pd(z, _mm_mul_pd(qw, tz)),
+                 _mm_sub_pd(_mm_mul_pd(qx, ty), _mm_mul_pd(qy, tx)));
+}
+
+}// end namespace
+
+namespace vtkBoneBatchMathSSE2
+{
+
+//----------------------------------------------------------------------------
+void MultiplyQuaternions(const double* quads1, const double* quads2,
+                         double* result, vtkIdType n)
+{
+  vtkIdType i = 0;
+  for (; i + 2 <= n; i += 2, quads1 += 8, quads2 += 8, result += 8)
+    {
+    __m128d w1, x1, y1, z1, w2, x2, y2, z2, w, x, y, z;
+    LoadQuaternions(quads1, w1, x1, y1, z1);
+    LoadQuaternions(quads2, w2, x2, y2, z2);
+    ::MultiplyQuaternions(w1, x1, y1, z1, w2, x2, y2, z2, w, x, y, z);
+    StoreQuaternions(result, w, x, y, z);
+    }
+  vtkBoneBatchMathScalar::MultiplyQuaternions(quads1, quads2, result, n - i);
+}
+
+//----------------------------------------------------------------------------
+void NormalizeQuaternions(double* quads, vtkIdType n)
+{
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d one = _mm_set1_pd(1.0);
+
+  vtkIdType i = 0;
+  for (; i + 2 <= n; i += 2, quads += 8)
+    {
+    __m128d w, x, y, z;
+    LoadQuaternions(quads, w, x, y, z);
+    __m128d norm2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(w, w), _mm_mul_pd(x, x)),
+                               _mm_add_pd(_mm_mul_pd(y, y), _mm_mul_pd(z, z)));
+    // Null quaternions are left untouched: their scale is 1
+    __m128d valid = _mm_cmpgt_pd(norm2, zero);
+    __m128d invNorm = _mm_div_pd(one, _mm_sqrt_pd(norm2));
+    invNorm = _mm_or_pd(_mm_and_pd(valid, invNorm), _mm_andnot_pd(valid, one));
+    StoreQuaternions(quads, _mm_mul_pd(w, invNorm), _mm_mul_pd(x, invNorm),
+                     _mm_mul_pd(y, invNorm), _mm_mul_pd(z, invNorm));
+    }
+  vtkBoneBatchMathScalar::NormalizeQuaternions(quads, n - i);
+}
+
+//----------------------------------------------------------------------------
+void ConjugateQuaternions(const double* quads, double* result, vtkIdType n)
+{
+  // Flip the sign bit of x, y and z
+  const __m128d signWX = _mm_set_pd(-0.0, 0.0);
+  const __m128d signYZ = _mm_set1_pd(-0.0);
+
+  for (vtkIdType i = 0; i < n; ++i, quads += 4, result += 4)
+    {
+    __m128d wx = _mm_xor_pd(_mm_loadu_pd(quads), signWX);
+    __m128d yz = _mm_xor_pd(_mm_loadu_pd(quads + 2), signYZ);
+    _mm_storeu_pd(result, wx);
+    _mm_storeu_pd(result + 2, yz);
+    }
+}
+
+//----------------------------------------------------------------------------
+void TransformPoints(const double* quads, const double* translations,
+                     const double* points, double* result, vtkIdType n)
+{
+  vtkIdType i = 0;
+  for (; i + 2 <= n; i += 2, quads += 8, points += 6, result += 6)
+    {
+    __m128d qw, qx, qy, qz, x, y, z;
+    LoadQuaternions(quads, qw, qx, qy, qz);
+    LoadPoints(points, x, y, z);
+    RotateVectors(qw, qx, qy, qz, x, y, z);
+    if (translations)
+      {
+      __m128d tx, ty, tz;
+      LoadPoints(translations, tx, ty, tz);
+      x = _mm_add_pd(x, tx);
+      y = _mm_add_pd(y, ty);
+      z = _mm_add_pd(z, tz);
+      translations += 6;
+      }
+    StorePoints(result, x, y, z);
+    }
+  vtkBoneBatchMathScalar::TransformPoints(quads, translations, points,
+                                          result, n - i);
+}
+
+//----------------------------------------------------------------------------
+void ComposeRigidTransforms(const double* parentQuads,
+                            const double* parentTranslations,
+                            const double* localQuads,
+                            const double* localTranslations,
+                            double* quads, double* translations,
+                            vtkIdType n)
+{
+  vtkIdType i = 0;
+  for (; i + 2 <= n; i += 2, parentQuads += 8, localQuads += 8,
+       localTranslations += 6, quads += 8, translations += 6)
+    {
+    __m128d pw, px, py, pz, lw, lx, ly, lz, w, x, y, z;
+    LoadQuaternions(parentQuads, pw, px, py, pz);
+    LoadQuaternions(localQuads, lw, lx, ly, lz);
+
+    __m128d tx, ty, tz;
+    LoadPoints(localTranslations, tx, ty, tz);
+    RotateVectors(pw, px, py, pz, tx, ty, tz);
+    if (parentTranslations)
+      {
+      __m128d ptx, pty, ptz;
+      LoadPoints(parentTranslations, ptx, pty, ptz);
+      tx = _mm_add_pd(tx, ptx);
+      ty = _mm_add_pd(ty, pty);
+      tz = _mm_add_pd(tz, ptz);
+      parentTranslations += 6;
+      }
+
+    ::MultiplyQuaternions(pw, px, py, pz, lw, lx, ly, lz, w, x, y, z);
+    StoreQuaternions(quads, w, x, y, z);
+    StorePoints(translations, tx, ty, tz);
+    }
+  vtkBoneBatchMathScalar::ComposeRigidTransforms(parentQuads,
+    parentTranslations, localQuads, localTranslations, quads, translations,
+    n - i);
+}
+
+//----------------------------------------------------------------------------
+void NlerpQuaternions(const double* quads1, const double* quads2,
+                      const double* alphas, double* result, vtkIdType n)
+{
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d one = _mm_set1_pd(1.0);
+  const __m128d sign = _mm_set1_pd(-0.0);
+
+  vtkIdType i = 0;
+  for (; i + 2 <= n; i += 2, quads1 += 8, quads2 += 8, alphas += 2,
+       result += 8)
+    {
+    __m128d w1, x1, y1, z1, w2, x2, y2, z2;
+    LoadQuaternions(quads1, w1, x1, y1, z1);
+    LoadQuaternions(quads2, w2, x2, y2, z2);
+    __m128d dot = _mm_add_pd(
+      _mm_add_pd(_mm_mul_pd(w1, w2), _mm_mul_pd(x1, x2)),
+      _mm_add_pd(_mm_mul_pd(y1, y2), _mm_mul_pd(z1, z2)));
+
+    // Negate the second quaternion weight for the shortest path
+    __m128d alpha2 = _mm_loadu_pd(alphas);
+    __m128d alpha1 = _mm_sub_pd(one, alpha2);
+    alpha2 = _mm_xor_pd(alpha2, _mm_and_pd(_mm_cmplt_pd(dot, zero), sign));
+
+    __m128d w = _mm_add_pd(_mm_mul_pd(alpha1, w1), _mm_mul_pd(alpha2, w2));
+    __m128d x = _mm_add_pd(_mm_mul_pd(alpha1, x1), _mm_mul_pd(alpha2, x2));
+    __m128d y = _mm_add_pd(_mm_mul_pd(alpha1, y1), _mm_mul_pd(alpha2, y2));
+    __m128d z = _mm_add_pd(_mm_mul_pd(alpha1, z1), _mm_mul_pd(alpha2, z2));
+
+    __m128d norm2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(w, w), _mm_mul_pd(x, x)),
+                               _mm_add_pd(_mm_mul_pd(y, y), _mm_mul_pd(z, z)));
+    __m128d valid = _mm_cmpgt_pd(norm2, zero);
+    __m128d invNorm = _mm_div_pd(one, _mm_sqrt_pd(norm2));
+    invNorm = _mm_or_pd(_mm_and_pd(valid, invNorm), _mm_andnot_pd(valid, one));
+    StoreQuaternions(result, _mm_mul_pd(w, invNorm), _mm_mul_pd(x, invNorm),
+                     _mm_mul_pd(y, invNorm), _mm_mul_pd(z, invNorm));
+    }
+  vtkBoneBatchMathScalar::NlerpQuaternions(quads1, quads2, alphas, result,
+                                           n - i);
+}
+
+}// end namespace vtkBoneBatchMathSSE2
+#endif
+
+//----------------------------------------------------------------------------
+// Dispatch
+//----------------------------------------------------------------------------
+namespace
+{
+
+bool IsAVX2Supported()
+{
+#if !defined(VTK_BONE_WIDGET_USE_AVX2)
+  return false;
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    {
+    return false;
+    }
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  __cpuidex(info, 7, 0);
+  bool avx2 = (info[1] & (1 << 5)) != 0;
+  // The OS must save the AVX registers
+  return osxsave && avx && avx2 && (_xgetbv(0) & 6) == 6;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+int vtkBoneBatchMath::GetBestInstructionSet()
+{
+  static int bestInstructionSet = -1;
+  if (bestInstructionSet < 0)
+    {
+    bestInstructionSet = vtkBoneBatchMath::Scalar;
+#ifdef VTK_BONE_BATCH_MATH_USE_SSE2
+    bestInstructionSet = vtkBoneBatchMath::SSE2;
+#endif
+    if (IsAVX2Supported())
+      {
+      bestInstructionSet = vtkBoneBatchMath::AVX2;
+      }
+    }
+  return bestInstructionSet;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::SetInstructionSet(int instructionSet)
+{
+  int best = vtkBoneBatchMath::GetBestInstructionSet();
+  if (instructionSet < vtkBoneBatchMath::Scalar || instructionSet > best)
+    {
+    instructionSet = best;
+    }
+  vtkBoneBatchMath::InstructionSet = instructionSet;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneBatchMath::GetInstructionSet()
+{
+  if (vtkBoneBatchMath::InstructionSet < 0)
+    {
+    vtkBoneBatchMath::InstructionSet =
+      vtkBoneBatchMath::GetBestInstructionSet();
+    }
+  return vtkBoneBatchMath::InstructionSet;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkBoneBatchMath::GetInstructionSetAsString(int instructionSet)
+{
+  switch (instructionSet)
+    {
+    case vtkBoneBatchMath::Scalar: return "Scalar";
+    case vtkBoneBatchMath::SSE2: return "SSE2";
+    case vtkBoneBatchMath::AVX2: return "AVX2";
+    default: return "Unknown";
+    }
+}
+
+// Call the kernel of the current instruction set
+#if defined(VTK_BONE_WIDGET_USE_AVX2)
+# define vtkBoneBatchMathAVX2Case(call) \
+    case vtkBoneBatchMath::AVX2: vtkBoneBatchMathAVX2::call; return;
+#else
+# define vtkBoneBatchMathAVX2Case(call)
+#endif
+#if defined(VTK_BONE_BATCH_MATH_USE_SSE2)
+# define vtkBoneBatchMathSSE2Case(call) \
+    case vtkBoneBatchMath::SSE2: vtkBoneBatchMathSSE2::call; return;
+#else
+# define vtkBoneBatchMathSSE2Case(call)
+#endif
+#define vtkBoneBatchMathDispatch(call)                 \
+  switch (vtkBoneBatchMath::GetInstructionSet())       \
+    {                                                  \
+    vtkBoneBatchMathAVX2Case(call)                     \
+    vtkBoneBatchMathSSE2Case(call)                     \
+    default: vtkBoneBatchMathScalar::call; return;     \
+    }
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::MultiplyQuaternions(const double* quads1,
+                                           const double* quads2,
+                                           double* result, vtkIdType n)
+{
+  vtkBoneBatchMathDispatch(MultiplyQuaternions(quads1, quads2, result, n));
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::NormalizeQuaternions(double* quads, vtkIdType n)
+{
+  vtkBoneBatchMathDispatch(NormalizeQuaternions(quads, n));
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::ConjugateQuaternions(const double* quads,
+                                            double* result, vtkIdType n)
+{
+  vtkBoneBatchMathDispatch(ConjugateQuaternions(quads, result, n));
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::RotatePoints(const double* quads, const double* points,
+                                    double* result, vtkIdType n)
+{
+  vtkBoneBatchMathDispatch(TransformPoints(quads, NULL, points, result, n));
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::TransformPoints(const double* quads,
+                                       const double* translations,
+                                       const double* points, double* result,
+                                       vtkIdType n)
+{
+  vtkBoneBatchMathDispatch(
+    TransformPoints(quads, translations, points, result, n));
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::ComposeRigidTransforms(const double* parentQuads,
+                                              const double* parentTranslations,
+                                              const double* localQuads,
+                                              const double* localTranslations,
+                                              double* quads,
+                                              double* translations,
+                                              vtkIdType n)
+{
+  vtkBoneBatchMathDispatch(
+    ComposeRigidTransforms(parentQuads, parentTranslations, localQuads,
+                           localTranslations, quads, translations, n));
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::NlerpQuaternions(const double* quads1,
+                                        const double* quads2,
+                                        const double* alphas, double* result,
+                                        vtkIdType n)
+{
+  vtkBoneBatchMathDispatch(
+    NlerpQuaternions(quads1, quads2, alphas, result, n));
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::SlerpQuaternions(const double* quads1,
+                                        const double* quads2,
+                                        const double* alphas, double* result,
+                                        vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; ++i, quads1 += 4, quads2 += 4, result += 4)
+    {
+    double dot = quads1[0]*quads2[0] + quads1[1]*quads2[1]
+                 + quads1[2]*quads2[2] + quads1[3]*quads2[3];
+    double sign = 1.0;
+    if (dot < 0.0)
+      {
+      dot = -dot;
+      sign = -1.0;
+      }
+
+    // Close quaternions: the linear interpolation is accurate and avoids
+    // dividing by a vanishing sine.
+    if (dot > 0.9995)
+      {
+      vtkBoneBatchMathScalar::NlerpQuaternions(quads1, quads2, alphas + i,
+                                               result, 1);
+      continue;
+      }
+
+    double angle = acos(dot);
+    double invSin = 1.0 / sin(angle);
+    double alpha1 = sin((1.0 - alphas[i]) * angle) * invSin;
+    double alpha2 = sign * sin(alphas[i] * angle) * invSin;
+    for (int j = 0; j < 4; ++j)
+      {
+      result[j] = alpha1*quads1[j] + alpha2*quads2[j];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneBatchMath::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Instruction Set: "
+     << vtkBoneBatchMath::GetInstructionSetAsString(
+          vtkBoneBatchMath::GetInstructionSet()) << "\n";
+  os << indent << "Best Instruction Set: "
+     << vtkBoneBatchMath::GetInstructionSetAsString(
+          vtkBoneBatchMath::GetBestInstructionSet()) << "\n";
+}
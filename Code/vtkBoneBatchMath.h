@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneBatchMath_h
+#define __vtkBoneBatchMath_h
+
+// .NAME vtkBoneBatchMath - Quaternion and rigid transform math on arrays
+// .SECTION Description
+// vtkBoneBatchMath provides static methods applying the same quaternion or
+// rigid transform operation to whole arrays, e.g. the packed buffers of a
+// vtkBoneSkeleton. Quaternions are stored as 4 consecutive doubles
+// (w, x, y, z), points and translations as 3 consecutive doubles.
+//
+// The methods are vectorized with SSE2 and AVX2 when the library was built
+// with them. The fastest instruction set supported by the processor is
+// chosen at runtime; it can be forced with SetInstructionSet(), for
+// example to compare against the scalar implementation.
+//
+// Unless noted otherwise, the output arrays can be the same as the input
+// arrays, but must not partially overlap them.
+// .SECTION See Also
+// vtkBoneSkeleton vtkMath
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneBatchMath : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneBatchMath *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneBatchMath, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  enum InstructionSetType {Scalar = 0, SSE2, AVX2};
+  //ETX
+
+  // Description:
+  // Get the fastest instruction set available on this processor among
+  // the ones the library was compiled with.
+  static int GetBestInstructionSet();
+
+  // Description:
+  // Set/Get the instruction set used by the batch methods. By default, the
+  // best instruction set is used. An instruction set that is not available
+  // falls back to the best available one.
+  static void SetInstructionSet(int instructionSet);
+  static int GetInstructionSet();
+  static const char* GetInstructionSetAsString(int instructionSet);
+
+  // Description:
+  // result[i] = quads1[i] * quads2[i]
+  static void MultiplyQuaternions(const double* quads1, const double* quads2,
+                                  double* result, vtkIdType n);
+
+  // Description:
+  // Normalize the quaternions in place. Null quaternions are left as is.
+  static void NormalizeQuaternions(double* quads, vtkIdType n);
+
+  // Description:
+  // result[i] = conjugate(quads[i]), i.e. the inverse of unit quaternions.
+  static void ConjugateQuaternions(const double* quads, double* result,
+                                   vtkIdType n);
+
+  // Description:
+  // Rotate each point by the corresponding unit quaternion:
+  // result[i] = quads[i] * points[i] * conjugate(quads[i])
+  static void RotatePoints(const double* quads, const double* points,
+                           double* result, vtkIdType n);
+
+  // Description:
+  // Apply the rigid transforms (quads, translations) to the points:
+  // result[i] = quads[i] * points[i] * conjugate(quads[i]) + translations[i]
+  // translations may be NULL, for null translations.
+  static void TransformPoints(const double* quads, const double* translations,
+                              const double* points, double* result,
+                              vtkIdType n);
+
+  // Description:
+  // Compose rigid transforms, the local transforms being applied first:
+  // quads[i] = parentQuads[i] * localQuads[i]
+  // translations[i] = parentQuads[i] * localTranslations[i]
+  //                   + parentTranslations[i]
+  // parentTranslations may be NULL, for null translations. The result is
+  // not normalized.
+  static void ComposeRigidTransforms(const double* parentQuads,
+                                     const double* parentTranslations,
+                                     const double* localQuads,
+                                     const double* localTranslations,
+                                     double* quads, double* translations,
+                                     vtkIdType n);
+
+  // Description:
+  // Interpolate between quads1[i] (alphas[i] = 0) and quads2[i]
+  // (alphas[i] = 1) along the shortest path, i.e. quads2[i] is negated
+  // when the two quaternions are in opposite hemispheres. The quaternions
+  // must be unit quaternions.
+  // NlerpQuaternions normalizes the linear interpolation: it is the fastest
+  // but the angular speed is not constant. SlerpQuaternions interpolates
+  // with a constant angular speed; it is not vectorized and falls back to
+  // the normalized linear interpolation for close quaternions.
+  static void NlerpQuaternions(const double* quads1, const double* quads2,
+                               const double* alphas, double* result,
+                               vtkIdType n);
+  static void SlerpQuaternions(const double* quads1, const double* quads2,
+                               const double* alphas, double* result,
+                               vtkIdType n);
+
+protected:
+  vtkBoneBatchMath() {};
+  ~vtkBoneBatchMath() {};
+
+  static int InstructionSet;
+
+private:
+  vtkBoneBatchMath(const vtkBoneBatchMath&);  //Not implemented
+  void operator=(const vtkBoneBatchMath&);  //Not implemented
+};
+
+#endif
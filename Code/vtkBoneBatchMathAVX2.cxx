@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+// AVX2 kernels of vtkBoneBatchMath, 4 elements at a time.
+// This file is compiled with the AVX2 flags and its functions are only
+// called after checking the processor supports AVX2. Do not include any
+// header defining inline functions here (see vtkBoneBatchMathKernels.h).
+
+#include "vtkBoneBatchMathKernels.h"
+
+#include <immintrin.h>
+
+namespace
+{
+
+// 4x4 transpose: 4 quaternions <-> (w0..w3), (x0..x3), (y0..y3), (z0..z3)
+inline void Transpose(__m256d r0, __m256d r1, __m256d r2, __m256d r3,
+                      __m256d& c0, __m256d& c1, __m256d& c2, __m256d& c3)
+{
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+  c0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+  c1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+  c2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+  c3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+inline void LoadQuaternions(const double* quads,
+                            __m256d& w, __m256d& x, __m256d& y, __m256d& z)
+{
+  Transpose(_mm256_loadu_pd(quads), _mm256_loadu_pd(quads + 4),
+            _mm256_loadu_pd(quads + 8), _mm256_loadu_pd(quads + 12),
+            w, x, y, z);
+}
+
+inline void StoreQuaternions(double* quads,
+                             __m256d w, __m256d x, __m256d y, __m256d z)
+{
+  __m256d q0, q1, q2, q3;
+  Transpose(w, x, y, z, q0, q1, q2, q3);
+  _mm256_storeu_pd(quads, q0);
+  _mm256_storeu_pd(quads + 4, q1);
+  _mm256_storeu_pd(quads + 8, q2);
+  _mm256_storeu_pd(quads + 12, q3);
+}
+
+// Load 4 points as (x0..x3), (y0..y3), (z0..z3)
+inline void LoadPoints(const double* points,
+                       __m256d& x, __m256d& y, __m256d& z)
+{
+  // a = (x0 y0 z0 x1), b = (y1 z1 x2 y2), c = (z2 x3 y3 z3)
+  __m256d a = _mm256_loadu_pd(points);
+  __m256d b = _mm256_loadu_pd(points + 4);
+  __m256d c = _mm256_loadu_pd(points + 8);
+
+  // (x0 y0 x2 y2), (z0 x1 z2 x3), (y1 z1 y3 z3)
+  __m256d xy02 = _mm256_permute2f128_pd(a, b, 0x30);
+  __m256d zx = _mm256_permute2f128_pd(a, c, 0x21);
+  __m256d yz13 = _mm256_permute2f128_pd(b, c, 0x30);
+
+  x = _mm256_shuffle_pd(xy02, zx, 0xA);
+  y = _mm256_shuffle_pd(xy02, yz13, 0x5);
+  z = _mm256_shuffle_pd(zx, yz13, 0xA);
+}
+
+inline void StorePoints(double* points, __m256d x, __m256d y, __m256d z)
+{
+  __m256d xy02 = _mm256_unpacklo_pd(x, y);
+  __m256d zx = _mm256_shuffle_pd(z, x, 0xA);
+  __m256d yz13 = _mm256_unpackhi_pd(y, z);
+
+  _mm256_storeu_pd(points, _mm256_permute2f128_pd(xy02, zx, 0x20));
+  _mm256_storeu_pd(points + 4, _mm256_permute2f128_pd(yz13, xy02, 0x30));
+  _mm256_storeu_pd(points + 8, _mm256_permute2f128_pd(zx, yz13, 0x31));
+}
+
+inline void Multiply(__m256d w1, __m256d x1, __m256d y1, __m256d z1,
+                     __m256d w2, __m256d x2, __m256d y2, __m256d z2,
+                     __m256d& w, __m256d& x, __m256d& y, __m256d& z)
+{
+  w = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(
+        _mm256_mul_pd(w1, w2), _mm256_mul_pd(x1, x2)),
+        _mm256_mul_pd(y1, y2)), _mm256_mul_pd(z1, z2));
+  x = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(w1, x2), _mm256_mul_pd(x1, w2)),
+        _mm256_mul_pd(y1, z2)), _mm256_mul_pd(z1, y2));
+  y = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(w1, y2), _mm256_mul_pd(y1, w2)),
+        _mm256_mul_pd(z1, x2)), _mm256_mul_pd(x1, z2));
+  z = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(w1, z2), _mm256_mul_pd(z1, w2)),
+        _mm256_mul_pd(x1, y2)), _mm256_mul_pd(y1, x2));
+}
+
+inline void RotateVectors(__m256d qw, __m256d qx, __m256d qy, __m256d qz,
+                          __m256d& x, __m256d& y, __m256d& z)
+{
+  const __m256d two = _mm256_set1_pd(2.0);
+  __m256d tx = _mm256_mul_pd(two,
+    _mm256_sub_pd(_mm256_mul_pd(qy, z), _mm256_mul_pd(qz, y)));
+  __m256d ty = _mm256_mul_pd(two,
+    _mm256_sub_pd(_mm256_mul_pd(qz, x), _mm256_mul_pd(qx, z)));
+  __m256d tz = _mm256_mul_pd(two,
+    _mm256_sub_pd(_mm256_mul_pd(qx, y), _mm256_mul_pd(qy, x)));
+
+  x = _mm256_add_pd(_mm256_add_pd(x, _mm256_mul_pd(qw, tx)),
+    _mm256_sub_pd(_mm256_mul_pd(qy, tz), _mm256_mul_pd(qz, ty)));
+  y = _mm256_add_pd(_mm256_add_pd(y, _mm256_mul_pd(qw, ty)),
+    _mm256_sub_pd(_mm256_mul_pd(qz, tx), _mm256_mul_pd(qx, tz)));
+  z = _mm256_add_pd(_mm256_add_pd(z, _mm256_mul_pd(qw, tz)),
+    _mm256_sub_pd(_mm256_mul_pd(qx, ty), _mm256_mul_pd(qy, tx)));
+}
+
+}// end namespace
+
+namespace vtkBoneBatchMathAVX2
+{
+
+//----------------------------------------------------------------------------
+void MultiplyQuaternions(const double* quads1, const double* quads2,
+                         double* result, vtkIdType n)
+{
+  vtkIdType i = 0;
+  for (; i + 4 <= n; i += 4, quads1 += 16, quads2 += 16, result += 16)
+    {
+    __m256d w1, x1, y1, z1, w2, x2, y2, z2, w, x, y, z;
+    LoadQuaternions(quads1, w1, x1, y1, z1);
+    LoadQuaternions(quads2, w2, x2, y2, z2);
+    Multiply(w1, x1, y1, z1, w2, x2, y2, z2, w, x, y, z);
+    StoreQuaternions(result, w, x, y, z);
+    }
+  vtkBoneBatchMathScalar::MultiplyQuaternions(quads1, quads2, result, n - i);
+}
+
+//----------------------------------------------------------------------------
+void NormalizeQuaternions(double* quads, vtkIdType n)
+{
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+
+  vtkIdType i = 0;
+  for (; i + 4 <= n; i += 4, quads += 16)
+    {
+    __m256d w, x, y, z;
+    LoadQuaternions(quads, w, x, y, z);
+    __m256d norm2 = _mm256_add_pd(
+      _mm256_add_pd(_mm256_mul_pd(w, w), _mm256_mul_pd(x, x)),
+      _mm256_add_pd(_mm256_mul_pd(y, y), _mm256_mul_pd(z, z)));
+    // Null quaternions are left untouched: their scale is 1
+    __m256d valid = _mm256_cmp_pd(norm2, zero, _CMP_GT_OQ);
+    __m256d invNorm = _mm256_div_pd(one, _mm256_sqrt_pd(norm2));
+    invNorm = _mm256_blendv_pd(one, invNorm, valid);
+    StoreQuaternions(quads,
+                     _mm256_mul_pd(w, invNorm), _mm256_mul_pd(x, invNorm),
+                     _mm256_mul_pd(y, invNorm), _mm256_mul_pd(z, invNorm));
+    }
+  vtkBoneBatchMathScalar::NormalizeQuaternions(quads, n - i);
+}
+
+//----------------------------------------------------------------------------
+void ConjugateQuaternions(const double* quads, double* result, vtkIdType n)
+{
+  // Flip the sign bit of x, y and z
+  const __m256d sign = _mm256_set_pd(-0.0, -0.0, -0.0, 0.0);
+
+  for (vtkIdType i = 0; i < n; ++i, quads += 4, result += 4)
+    {
+    _mm256_storeu_pd(result, _mm256_xor_pd(_mm256_loadu_pd(quads), sign));
+    }
+}
+
+//----------------------------------------------------------------------------
+void TransformPoints(const double* quads, const double* translations,
+                     const double* points, double* result, vtkIdType n)
+{
+  vtkIdType i = 0;
+  for (; i + 4 <= n; i += 4, quads += 16, points += 12, result += 12)
+    {
+    __m256d qw, qx, qy, qz, x, y, z;
+    LoadQuaternions(quads, qw, qx, qy, qz);
+    LoadPoints(points, x, y, z);
+    RotateVectors(qw, qx, qy, qz, x, y, z);
+    if (translations)
+      {
+      __m256d tx, ty, tz;
+      LoadPoints(translations, tx, ty, tz);
+      x = _mm256_add_pd(x, tx);
+      y = _mm256_add_pd(y, ty);
+      z = _mm256_add_pd(z, tz);
+      translations += 12;
+      }
+    StorePoints(result, x, y, z);
+    }
+  vtkBoneBatchMathScalar::TransformPoints(quads, translations, points,
+                                          result, n - i);
+}
+
+//----------------------------------------------------------------------------
+void ComposeRigidTransforms(const double* parentQuads,
+                            const double* parentTranslations,
+                            const double* localQuads,
+                            const double* localTranslations,
+                            double* quads, double* translations,
+                            vtkIdType n)
+{
+  vtkIdType i = 0;
+  for (; i + 4 <= n; i += 4, parentQuads += 16, localQuads += 16,
+       localTranslations += 12, quads += 16, translations += 12)
+    {
+    __m256d pw, px, py, pz, lw, lx, ly, lz, w, x, y, z;
+    LoadQuaternions(parentQuads, pw, px, py, pz);
+    LoadQuaternions(localQuads, lw, lx, ly, lz);
+
+    __m256d tx, ty, tz;
+    LoadPoints(localTranslations, tx, ty, tz);
+    RotateVectors(pw, px, py, pz, tx, ty, tz);
+    if (parentTranslations)
+      {
+      __m256d ptx, pty, ptz;
+      LoadPoints(parentTranslations, ptx, pty, ptz);
+      tx = _mm256_add_pd(tx, ptx);
+      ty = _mm256_add_pd(ty, pty);
+      tz = _mm256_add_pd(tz, ptz);
+      parentTranslations += 12;
+      }
+
+    Multiply(pw, px, py, pz, lw, lx, ly, lz, w, x, y, z);
+    StoreQuaternions(quads, w, x, y, z);
+    StorePoints(translations, tx, ty, tz);
+    }
+  vtkBoneBatchMathScalar::ComposeRigidTransforms(parentQuads,
+    parentTranslations, localQuads, localTranslations, quads, translations,
+    n - i);
+}
+
+//----------------------------------------------------------------------------
+void NlerpQuaternions(const double* quads1, const double* quads2,
+                      const double* alphas, double* result, vtkIdType n)
+{
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d sign = _mm256_set1_pd(-0.0);
+
+  vtkIdType i = 0;
+  for (; i + 4 <= n; i += 4, quads1 += 16, quads2 += 16, alphas += 4,
+       result += 16)
+    {
+    __m256d w1, x1, y1, z1, w2, x2, y2, z2;
+    LoadQuaternions(quads1, w1, x1, y1, z1);
+    LoadQuaternions(quads2, w2, x2, y2, z2);
+    __m256d dot = _mm256_add_pd(
+      _mm256_add_pd(_mm256_mul_pd(w1, w2), _mm256_mul_pd(x1, x2)),
+      _mm256_add_pd(_mm256_mul_pd(y1, y2), _mm256_mul_pd(z1, z2)));
+
+    // Negate the second quaternion weight for the shortest path
+    __m256d alpha2 = _mm256_loadu_pd(alphas);
+    __m256d alpha1 = _mm256_sub_pd(one, alpha2);
+    alpha2 = _mm256_xor_pd(alpha2,
+      _mm256_and_pd(_mm256_cmp_pd(dot, zero, _CMP_LT_OQ), sign));
+
+    __m256d w = _mm256_add_pd(_mm256_mul_pd(alpha1, w1),
+                              _mm256_mul_pd(alpha2, w2));
+    __m256d x = _mm256_add_pd(_mm256_mul_pd(alpha1, x1),
+                              _mm256_mul_pd(alpha2, x2));
+    __m256d y = _mm256_add_pd(_mm256_mul_pd(alpha1, y1),
+                              _mm256_mul_pd(alpha2, y2));
+    __m256d z = _mm256_add_pd(_mm256_mul_pd(alpha1, z1),
+                              _mm256_mul_pd(alpha2, z2));
+
+    __m256d norm2 = _mm256_add_pd(
+      _mm256_add_pd(_mm256_mul_pd(w, w), _mm256_mul_pd(x, x)),
+      _mm256_add_pd(_mm256_mul_pd(y, y), _mm256_mul_pd(z, z)));
+    __m256d valid = _mm256_cmp_pd(norm2, zero, _CMP_GT_OQ);
+    __m256d invNorm = _mm256_div_pd(one, _mm256_sqrt_pd(norm2));
+    invNorm = _mm256_blendv_pd(one, invNorm, valid);
+    StoreQuaternions(result,
+                     _mm256_mul_pd(w, invNorm), _mm256_mul_pd(x, invNorm),
+                     _mm256_mul_pd(y, invNorm), _mm256_mul_pd(z, invNorm));
+    }
+  vtkBoneBatchMathScalar::NlerpQuaternions(quads1, quads2, alphas, result,
+                                           n - i);
+}
+
+}// end namespace vtkBoneBatchMathAVX2
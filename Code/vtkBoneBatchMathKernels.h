@@ -0,0 +1,59 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+// Internal header, not installed.
+// Declares the per instruction set implementations of vtkBoneBatchMath.
+// The AVX2 kernels live in their own translation unit compiled with the
+// AVX2 flags. This header must not define any inline function: they could
+// be compiled with AVX2 instructions and picked by the linker for the
+// other translation units.
+
+#ifndef __vtkBoneBatchMathKernels_h
+#define __vtkBoneBatchMathKernels_h
+
+#include "vtkType.h"
+
+#define VTK_BONE_BATCH_MATH_KERNELS(ns)                                       \
+namespace ns                                                                  \
+{                                                                             \
+void MultiplyQuaternions(const double* quads1, const double* quads2,          \
+                         double* result, vtkIdType n);                        \
+void NormalizeQuaternions(double* quads, vtkIdType n);                        \
+void ConjugateQuaternions(const double* quads, double* result, vtkIdType n);  \
+void TransformPoints(const double* quads, const double* translations,         \
+                     const double* points, double* result, vtkIdType n);      \
+void ComposeRigidTransforms(const double* parentQuads,                        \
+                            const double* parentTranslations,                 \
+                            const double* localQuads,                         \
+                            const double* localTranslations,                  \
+                            double* quads, double* translations,              \
+                            vtkIdType n);                                     \
+void NlerpQuaternions(const double* quads1, const double* quads2,             \
+                      const double* alphas, double* result, vtkIdType n);     \
+}
+
+// A NULL translations array means no translation.
+VTK_BONE_BATCH_MATH_KERNELS(vtkBoneBatchMathScalar)
+VTK_BONE_BATCH_MATH_KERNELS(vtkBoneBatchMathSSE2)
+VTK_BONE_BATCH_MATH_KERNELS(vtkBoneBatchMathAVX2)
+
+#undef VTK_BONE_BATCH_MATH_KERNELS
+
+#endif
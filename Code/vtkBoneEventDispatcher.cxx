@@ -0,0 +1,254 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneEventDispatcher.h"
+
+//My includes
+#include "vtkBonePickingTree.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderWindowInteractor.h>
+
+vtkStandardNewMacro(vtkBoneEventDispatcher);
+
+//----------------------------------------------------------------------------
+vtkBoneEventDispatcher::vtkBoneEventDispatcher()
+{
+  this->Skeleton = NULL;
+  this->Interactor = NULL;
+  this->Priority = 0.5;
+  this->EventCallbackCommand = vtkCallbackCommand::New();
+  this->EventCallbackCommand->SetClientData(this);
+  this->EventCallbackCommand->SetCallback(
+    vtkBoneEventDispatcher::ProcessEvents);
+
+  this->ActiveBone = NULL;
+  this->NumberOfEvents = 0;
+  this->NumberOfRoutedEvents = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneEventDispatcher::~vtkBoneEventDispatcher()
+{
+  this->SetInteractor(NULL);
+  this->SetActiveBone(NULL);
+  this->EventCallbackCommand->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneEventDispatcher
+::SetInteractor(vtkRenderWindowInteractor* interactor)
+{
+  if (interactor == this->Interactor)
+    {
+    return;
+    }
+
+  if (this->Interactor)
+    {
+    this->Interactor->RemoveObserver(this->EventCallbackCommand);
+    }
+  this->SetActiveBone(NULL);
+  this->Interactor = interactor;
+  if (this->Interactor)
+    {
+    this->Interactor->AddObserver(vtkCommand::LeftButtonPressEvent,
+      this->EventCallbackCommand, this->Priority);
+    this->Interactor->AddObserver(vtkCommand::MouseMoveEvent,
+      this->EventCallbackCommand, this->Priority);
+    this->Interactor->AddObserver(vtkCommand::LeftButtonReleaseEvent,
+      this->EventCallbackCommand, this->Priority);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneEventDispatcher::SetPriority(float priority)
+{
+  if (priority == this->Priority)
+    {
+    return;
+    }
+
+  this->Priority = priority;
+  if (this->Interactor)
+    {
+    // Observe again with the new priority
+    vtkRenderWindowInteractor* interactor = this->Interactor;
+    this->SetInteractor(NULL);
+    this->SetInteractor(interactor);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneEventDispatcher::SetActiveBone(vtkBoneWidget* bone)
+{
+  if (bone == this->ActiveBone)
+    {
+    return;
+    }
+
+  if (this->ActiveBone)
+    {
+    this->ActiveBone->UnRegister(this);
+    }
+  this->ActiveBone = bone;
+  if (this->ActiveBone)
+    {
+    this->ActiveBone->Register(this);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneEventDispatcher::ResetStatistics()
+{
+  this->NumberOfEvents = 0;
+  this->NumberOfRoutedEvents = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneEventDispatcher::Route(vtkBoneWidget* bone, unsigned long event)
+{
+  if (!bone || !bone->GetEnabled() || bone->GetInteractor() != this->Interactor)
+    {
+    return 0;
+    }
+
+  ++this->NumberOfRoutedEvents;
+  return bone->ProcessEvent(event);
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneEventDispatcher::LeftButtonPress()
+{
+  // The bone being placed gets all the presses
+  if (this->ActiveBone)
+    {
+    return this->Route(this->ActiveBone, vtkCommand::LeftButtonPressEvent);
+    }
+
+  if (!this->Skeleton)
+    {
+    return 0;
+    }
+
+  vtkBonePickingTree* pickingTree = this->Skeleton->GetPickingTree();
+  if (pickingTree)
+    {
+    // The tree may have picked the press already
+    if (pickingTree->GetInteractor() != this->Interactor)
+      {
+      int X = this->Interactor->GetEventPosition()[0];
+      int Y = this->Interactor->GetEventPosition()[1];
+      pickingTree->Pick(this->Interactor->FindPokedRenderer(X, Y), X, Y);
+      }
+    vtkBoneWidget* bone =
+      this->Skeleton->GetBone(pickingTree->GetPickedBoneId());
+    if (this->Route(bone, vtkCommand::LeftButtonPressEvent))
+      {
+      this->SetActiveBone(bone);
+      return 1;
+      }
+    }
+
+  // Without tree, the bones are tried one by one. With a tree, only the
+  // bones to place remain.
+  for (vtkIdType id = 0; id < this->Skeleton->GetNumberOfBones(); ++id)
+    {
+    vtkBoneWidget* bone = this->Skeleton->GetBone(id);
+    if ((!pickingTree || bone->GetWidgetState() == vtkBoneWidget::Start)
+        && this->Route(bone, vtkCommand::LeftButtonPressEvent))
+      {
+      this->SetActiveBone(bone);
+      return 1;
+      }
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneEventDispatcher::ProcessEvents(vtkObject* vtkNotUsed(caller),
+                                           unsigned long event,
+                                           void* clientdata,
+                                           void* vtkNotUsed(calldata))
+{
+  vtkBoneEventDispatcher* self =
+    reinterpret_cast<vtkBoneEventDispatcher*>(clientdata);
+  ++self->NumberOfEvents;
+
+  int processed = 0;
+  switch (event)
+    {
+    case vtkCommand::LeftButtonPressEvent:
+      processed = self->LeftButtonPress();
+      if (processed)
+        {
+        // The bone grabbed the focus for itself: the next events must
+        // come to the dispatcher instead.
+        self->Interactor->GrabFocus(self->EventCallbackCommand);
+        }
+      break;
+    case vtkCommand::MouseMoveEvent:
+      // Hovering without active bone costs nothing
+      if (self->ActiveBone)
+        {
+        processed = self->Route(self->ActiveBone, event);
+        }
+      break;
+    case vtkCommand::LeftButtonReleaseEvent:
+      if (self->ActiveBone)
+        {
+        vtkBoneWidget* bone = self->ActiveBone;
+        processed = self->Route(bone, event);
+        // A bone being placed stays active until its tail is placed
+        if (bone->GetWidgetState() != vtkBoneWidget::Start
+            && bone->GetWidgetState() != vtkBoneWidget::Define)
+          {
+          self->SetActiveBone(NULL);
+          }
+        }
+      break;
+    }
+
+  if (processed)
+    {
+    self->EventCallbackCommand->SetAbortFlag(1);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneEventDispatcher::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Skeleton: " << this->Skeleton << "\n";
+  os << indent << "Interactor: " << this->Interactor << "\n";
+  os << indent << "Priority: " << this->Priority << "\n";
+  os << indent << "Active Bone: " << this->ActiveBone << "\n";
+  os << indent << "Number Of Events: " << this->NumberOfEvents << "\n";
+  os << indent << "Number Of Routed Events: "
+     << this->NumberOfRoutedEvents << "\n";
+}
@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneEventDispatcher_h
+#define __vtkBoneEventDispatcher_h
+
+// .NAME vtkBoneEventDispatcher - Route the interactor events to the bones
+// .SECTION Description
+// vtkBoneEventDispatcher observes the left button press, mouse move and
+// left button release events of the interactor once for all the bones of
+// a skeleton, instead of each bone widget observing them. It is shared by
+// the bones with vtkBoneSkeleton::SetEventDispatcher(); the bones then
+// stop observing the interactor.
+//
+// A press is routed to the bone hit: the bone picked by the
+// vtkBonePickingTree of the skeleton if any, otherwise the first bone
+// whose representation is hit. Bones being placed (Start state) get the
+// presses that hit no bone. The bone that accepted the press becomes the
+// active bone: the moves and the release are routed to it only, until the
+// end of the interaction. Without active bone, a mouse move is dropped:
+// hovering costs the same whatever the number of bones.
+// .SECTION See Also
+// vtkBoneSkeleton vtkBoneWidget vtkBonePickingTree
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+class vtkBoneSkeleton;
+class vtkBoneWidget;
+class vtkCallbackCommand;
+class vtkRenderWindowInteractor;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneEventDispatcher : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneEventDispatcher *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneEventDispatcher, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get the skeleton whose bones receive the events. It is set by
+  // vtkBoneSkeleton::SetEventDispatcher().
+  vtkGetObjectMacro(Skeleton, vtkBoneSkeleton);
+
+  // Description:
+  // Set/Get the interactor whose events are routed. Only the bones using
+  // this interactor receive the events. The interactor is not registered,
+  // like for the widgets.
+  void SetInteractor(vtkRenderWindowInteractor* interactor);
+  vtkGetObjectMacro(Interactor, vtkRenderWindowInteractor);
+
+  // Description:
+  // Set/Get the priority of the interactor observer. Default is 0.5, the
+  // priority of the widgets.
+  void SetPriority(float priority);
+  vtkGetMacro(Priority, float);
+
+  // Description:
+  // Get the bone receiving the events of the current interaction. NULL
+  // if no bone is being manipulated.
+  vtkGetObjectMacro(ActiveBone, vtkBoneWidget);
+
+  // Description:
+  // Number of events received from the interactor and of events routed to
+  // a bone since the creation or the last call to ResetStatistics().
+  vtkGetMacro(NumberOfEvents, vtkIdType);
+  vtkGetMacro(NumberOfRoutedEvents, vtkIdType);
+  void ResetStatistics();
+
+protected:
+  vtkBoneEventDispatcher();
+  ~vtkBoneEventDispatcher();
+
+  vtkBoneSkeleton* Skeleton;
+  vtkRenderWindowInteractor* Interactor;
+  float Priority;
+  vtkCallbackCommand* EventCallbackCommand;
+
+  vtkBoneWidget* ActiveBone;
+  vtkIdType NumberOfEvents;
+  vtkIdType NumberOfRoutedEvents;
+
+  // Description:
+  // Set the active bone. It is registered during the interaction.
+  void SetActiveBone(vtkBoneWidget* bone);
+
+  // Description:
+  // Route the press to the bone hit. Return 1 if a bone accepted it.
+  int LeftButtonPress();
+
+  // Description:
+  // Run the action of a bone for the current event. Return 1 if the bone
+  // processed the event.
+  int Route(vtkBoneWidget* bone, unsigned long event);
+
+  static void ProcessEvents(vtkObject* caller, unsigned long event,
+                            void* clientdata, void* calldata);
+
+//BTX
+  friend class vtkBoneSkeleton;
+//ETX
+
+private:
+  vtkBoneEventDispatcher(const vtkBoneEventDispatcher&);  //Not implemented
+  void operator=(const vtkBoneEventDispatcher&);  //Not implemented
+};
+
+#endif
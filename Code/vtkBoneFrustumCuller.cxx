@@ -0,0 +1,325 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneFrustumCuller.h"
+
+//My includes
+#include "vtkBoneRepresentation.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkAxesActor.h>
+#include <vtkCamera.h>
+#include <vtkLineRepresentation.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointHandleRepresentation3D.h>
+#include <vtkProp.h>
+#include <vtkRenderer.h>
+
+//STL includes
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(vtkBoneFrustumCuller);
+
+namespace
+{
+
+bool PropLess(const std::pair<vtkProp*, vtkIdType>& a,
+              const std::pair<vtkProp*, vtkIdType>& b)
+{
+  return a.first < b.first;
+}
+
+// The frustum planes normals point inward: the box is out if its corner
+// the furthest along the normal of one plane is behind it.
+bool IsBoxOutside(const double planes[24], const double bounds[6])
+{
+  for (int i = 0; i < 6; ++i)
+    {
+    const double* plane = planes + 4 * i;
+    double x = plane[0] > 0.0 ? bounds[1] : bounds[0];
+    double y = plane[1] > 0.0 ? bounds[3] : bounds[2];
+    double z = plane[2] > 0.0 ? bounds[5] : bounds[4];
+    if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBoneFrustumCuller::vtkBoneFrustumCuller()
+{
+  this->Skeleton = NULL;
+  this->BoundsPadding = 0.25;
+  this->NumberOfCulledBones = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneFrustumCuller::~vtkBoneFrustumCuller()
+{
+  this->SetSkeleton(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneFrustumCuller::SetSkeleton(vtkBoneSkeleton* skeleton)
+{
+  if (skeleton == this->Skeleton)
+    {
+    return;
+    }
+
+  if (this->Skeleton)
+    {
+    this->Skeleton->UnRegister(this);
+    }
+  this->Skeleton = skeleton;
+  if (this->Skeleton)
+    {
+    this->Skeleton->Register(this);
+    }
+
+  this->BoneBoundsBones.clear();
+  this->BoneProps.clear();
+  this->SortedBoneProps.clear();
+  this->BoneCulled.clear();
+  this->NumberOfCulledBones = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneFrustumCuller::UpdateBoneProps()
+{
+  vtkIdType numberOfBones = this->Skeleton->GetNumberOfBones();
+  this->NewBoneProps.assign(NumberOfPropsPerBone * numberOfBones, NULL);
+  for (vtkIdType id = 0; id < numberOfBones; ++id)
+    {
+    vtkBoneWidget* bone = this->Skeleton->GetBone(id);
+    vtkProp** props = &this->NewBoneProps[NumberOfPropsPerBone * id];
+
+    vtkBoneRepresentation* rep = bone->GetBoneRepresentation();
+    if (rep)
+      {
+      props[0] = rep;
+      props[1] = rep->GetHeadRepresentation();
+      props[2] = rep->GetTailRepresentation();
+      }
+    props[3] = bone->GetAxesActor();
+
+    vtkLineRepresentation* link = bone->GetParentageLinkRepresentation();
+    if (link)
+      {
+      props[4] = link;
+      props[5] = link->GetPoint1Representation();
+      props[6] = link->GetPoint2Representation();
+      props[7] = link->GetLineHandleRepresentation();
+      }
+    }
+
+  if (this->NewBoneProps == this->BoneProps)
+    {
+    return;
+    }
+
+  this->BoneProps.swap(this->NewBoneProps);
+  this->SortedBoneProps.clear();
+  for (size_t i = 0; i < this->BoneProps.size(); ++i)
+    {
+    if (this->BoneProps[i])
+      {
+      this->SortedBoneProps.push_back(std::make_pair(
+        this->BoneProps[i], static_cast<vtkIdType>(i / NumberOfPropsPerBone)));
+      }
+    }
+  std::sort(this->SortedBoneProps.begin(), this->SortedBoneProps.end(),
+            PropLess);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneFrustumCuller::FindBone(vtkProp* prop)
+{
+  std::vector<std::pair<vtkProp*, vtkIdType> >::iterator it =
+    std::lower_bound(this->SortedBoneProps.begin(),
+                     this->SortedBoneProps.end(),
+                     std::make_pair(prop, static_cast<vtkIdType>(-1)),
+                     PropLess);
+  if (it == this->SortedBoneProps.end() || it->first != prop)
+    {
+    return -1;
+    }
+  return it->second;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneFrustumCuller::UpdateBoneBounds()
+{
+  if (!this->Skeleton)
+    {
+    return;
+    }
+
+  vtkIdType numberOfBones = this->Skeleton->GetNumberOfBones();
+  this->BoneBounds.resize(6 * numberOfBones);
+  this->BoneBoundsBones.resize(numberOfBones, NULL);
+  this->BoneBoundsTimes.resize(numberOfBones, 0);
+
+  for (vtkIdType id = 0; id < numberOfBones; ++id)
+    {
+    vtkBoneWidget* bone = this->Skeleton->GetBone(id);
+    double* bounds = &this->BoneBounds[6 * id];
+    vtkBoneRepresentation* rep = bone->GetBoneRepresentation();
+    if (!rep)
+      {
+      // Invalid bounds, never culled
+      bounds[0] = bounds[2] = bounds[4] = 1.0;
+      bounds[1] = bounds[3] = bounds[5] = -1.0;
+      this->BoneBoundsBones[id] = NULL;
+      continue;
+      }
+
+    vtkBoneRepresentation* parentRep = bone->GetBoneParent() ?
+      bone->GetBoneParent()->GetBoneRepresentation() : NULL;
+    unsigned long time = rep->GetMTime();
+    if (parentRep)
+      {
+      time = std::max(time, parentRep->GetMTime());
+      }
+    if (this->BoneBoundsBones[id] == bone
+        && time <= this->BoneBoundsTimes[id])
+      {
+      continue;
+      }
+
+    double head[3], tail[3];
+    rep->GetHeadWorldPosition(head);
+    rep->GetTailWorldPosition(tail);
+    double padding = this->BoundsPadding
+      * sqrt(vtkMath::Distance2BetweenPoints(head, tail));
+    for (int i = 0; i < 3; ++i)
+      {
+      bounds[2*i] = std::min(head[i], tail[i]);
+      bounds[2*i+1] = std::max(head[i], tail[i]);
+      }
+    if (parentRep && bone->GetShowParentage())
+      {
+      double parentTail[3];
+      parentRep->GetTailWorldPosition(parentTail);
+      for (int i = 0; i < 3; ++i)
+        {
+        bounds[2*i] = std::min(bounds[2*i], parentTail[i]);
+        bounds[2*i+1] = std::max(bounds[2*i+1], parentTail[i]);
+        }
+      }
+    for (int i = 0; i < 3; ++i)
+      {
+      bounds[2*i] -= padding;
+      bounds[2*i+1] += padding;
+      }
+
+    this->BoneBoundsBones[id] = bone;
+    this->BoneBoundsTimes[id] = time;
+    }
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneFrustumCuller::GetBoneBounds(vtkIdType id)
+{
+  if (id < 0 || 6 * id >= static_cast<vtkIdType>(this->BoneBounds.size()))
+    {
+    return NULL;
+    }
+  return &this->BoneBounds[6 * id];
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneFrustumCuller::GetBoneCulled(vtkIdType id)
+{
+  if (id < 0 || id >= static_cast<vtkIdType>(this->BoneCulled.size()))
+    {
+    return 0;
+    }
+  return this->BoneCulled[id];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneFrustumCuller::Cull(vtkRenderer* renderer, vtkProp** propList,
+                                  int& listLength, int& initialized)
+{
+  this->NumberOfCulledBones = 0;
+  if (this->Skeleton && renderer && renderer->GetActiveCamera())
+    {
+    this->UpdateBoneProps();
+    this->UpdateBoneBounds();
+
+    double planes[24];
+    renderer->GetActiveCamera()->GetFrustumPlanes(
+      renderer->GetTiledAspectRatio(), planes);
+
+    vtkIdType numberOfBones = this->Skeleton->GetNumberOfBones();
+    this->BoneCulled.assign(numberOfBones, 0);
+    for (vtkIdType id = 0; id < numberOfBones; ++id)
+      {
+      const double* bounds = &this->BoneBounds[6 * id];
+      if (bounds[0] <= bounds[1] && IsBoxOutside(planes, bounds))
+        {
+        this->BoneCulled[id] = 1;
+        ++this->NumberOfCulledBones;
+        }
+      }
+    }
+
+  // Compact the list without the culled props
+  int length = 0;
+  double totalTime = 0.0;
+  for (int i = 0; i < listLength; ++i)
+    {
+    vtkProp* prop = propList[i];
+    if (this->NumberOfCulledBones > 0)
+      {
+      vtkIdType id = this->FindBone(prop);
+      if (id >= 0 && this->BoneCulled[id])
+        {
+        continue;
+        }
+      }
+    propList[length++] = prop;
+    totalTime += initialized ? prop->GetRenderTimeMultiplier() : 1.0;
+    }
+  listLength = length;
+
+  return totalTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneFrustumCuller::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Skeleton: " << this->Skeleton << "\n";
+  os << indent << "Bounds Padding: " << this->BoundsPadding << "\n";
+  os << indent << "Number Of Culled Bones: "
+     << this->NumberOfCulledBones << "\n";
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneFrustumCuller_h
+#define __vtkBoneFrustumCuller_h
+
+// .NAME vtkBoneFrustumCuller - Cull the bones of a skeleton out of the view
+// .SECTION Description
+// vtkBoneFrustumCuller removes from the props to render all the props of
+// the bones of a skeleton that are outside of the camera frustum: the bone
+// representation and its head and tail handles, the axes actor and the
+// parentage link with its handles. The culled props are neither built nor
+// rendered.
+//
+// The bounds of a bone cover its head, its tail and, if the parentage is
+// shown, the tail of its parent. They are padded by BoundsPadding times the
+// bone length for the bone mesh and the axes. They are cached per bone and
+// only recomputed when the representation of the bone (or of its parent)
+// is modified.
+//
+// The culler is added to a renderer with vtkRenderer::AddCuller(). The
+// default vtkFrustumCoverageCuller of the renderer asks every prop for its
+// bounds, which builds the bone representations: add the bone culler
+// first to avoid it, e.g.:
+// \code
+// renderer->GetCullers()->RemoveAllItems();
+// renderer->AddCuller(boneCuller);
+// renderer->AddCuller(frustumCoverageCuller);
+// \endcode
+// .SECTION See Also
+// vtkBoneSkeleton vtkCuller
+
+#include "vtkCuller.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <utility>
+#include <vector>
+//ETX
+
+class vtkBoneSkeleton;
+class vtkBoneWidget;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneFrustumCuller : public vtkCuller
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneFrustumCuller *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneFrustumCuller, vtkCuller);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the skeleton whose bones are culled.
+  void SetSkeleton(vtkBoneSkeleton* skeleton);
+  vtkGetObjectMacro(Skeleton, vtkBoneSkeleton);
+
+  // Description:
+  // Set/Get the padding of the bone bounds, relative to the bone length.
+  // Default is 0.25.
+  vtkSetClampMacro(BoundsPadding, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(BoundsPadding, double);
+
+  // Description:
+  // Remove the props of the bones out of the view frustum from the list.
+  virtual double Cull(vtkRenderer* renderer, vtkProp** propList,
+                      int& listLength, int& initialized);
+
+  // Description:
+  // Recompute the bounds of the bones that moved since the last call.
+  // Called by Cull().
+  void UpdateBoneBounds();
+
+  // Description:
+  // Get the bounds of a bone, as of the last UpdateBoneBounds().
+  // NULL if out of range.
+  double* GetBoneBounds(vtkIdType id);
+
+  // Description:
+  // Return 1 if the bone was culled by the last Cull().
+  int GetBoneCulled(vtkIdType id);
+
+  // Description:
+  // Number of bones culled by the last Cull().
+  vtkGetMacro(NumberOfCulledBones, vtkIdType);
+
+protected:
+  vtkBoneFrustumCuller();
+  ~vtkBoneFrustumCuller();
+
+  // Description:
+  // Collect the props of the bones and rebuild the prop lookup if they
+  // changed.
+  void UpdateBoneProps();
+
+  // Description:
+  // Return the id of the bone owning the prop, -1 if none.
+  vtkIdType FindBone(vtkProp* prop);
+
+  vtkBoneSkeleton* Skeleton;
+  double BoundsPadding;
+  vtkIdType NumberOfCulledBones;
+
+//BTX
+  enum {NumberOfPropsPerBone = 8};
+
+  // 6 values per bone, and what they were computed from
+  std::vector<double> BoneBounds;
+  std::vector<vtkBoneWidget*> BoneBoundsBones;
+  std::vector<unsigned long> BoneBoundsTimes;
+
+  std::vector<unsigned char> BoneCulled;
+
+  // NumberOfPropsPerBone props per bone (NULL if missing), and the same
+  // sorted by prop for the lookup
+  std::vector<vtkProp*> BoneProps;
+  std::vector<vtkProp*> NewBoneProps;
+  std::vector<std::pair<vtkProp*, vtkIdType> > SortedBoneProps;
+//ETX
+
+private:
+  vtkBoneFrustumCuller(const vtkBoneFrustumCuller&);  //Not implemented
+  void operator=(const vtkBoneFrustumCuller&);  //Not implemented
+};
+
+#endif
@@ -0,0 +1,351 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneGlyphInstancer.h"
+
+//My includes
+#include "vtkDoubleConeSource.h"
+#include "vtkInstancedBoneRepresentation.h"
+
+//VTK Includes
+#include <vtkActor.h>
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkProperty.h>
+#include <vtkUnsignedCharArray.h>
+
+//STL includes
+#include <cmath>
+
+vtkStandardNewMacro(vtkBoneGlyphInstancer);
+
+namespace
+{
+
+// Radius of the glyphs relative to the bone length, as in the
+// cylinder and double cone representations.
+const double GlyphRadius = 0.1;
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBoneGlyphInstancer::vtkBoneGlyphInstancer()
+{
+  this->GlyphType = vtkBoneGlyphInstancer::DoubleCone;
+  this->Ratio = 0.25;
+  this->NumberOfSides = 12;
+  this->Capping = 1;
+
+  this->Glyph = vtkPolyData::New();
+  this->BuildGlyph();
+
+  // One point per bone
+  this->Instances = vtkPolyData::New();
+  vtkPoints* points = vtkPoints::New();
+  points->SetDataTypeToDouble();
+  this->Instances->SetPoints(points);
+  points->Delete();
+
+  this->Directions = vtkDoubleArray::New();
+  this->Directions->SetName("Directions");
+  this->Directions->SetNumberOfComponents(3);
+  this->Instances->GetPointData()->AddArray(this->Directions);
+
+  this->Lengths = vtkDoubleArray::New();
+  this->Lengths->SetName("Lengths");
+  this->Lengths->SetNumberOfComponents(1);
+  this->Instances->GetPointData()->AddArray(this->Lengths);
+
+  this->Colors = vtkUnsignedCharArray::New();
+  this->Colors->SetName("Colors");
+  this->Colors->SetNumberOfComponents(3);
+  this->Instances->GetPointData()->AddArray(this->Colors);
+
+  this->Mapper = vtkGlyph3DMapper::New();
+  this->Mapper->SetInput(this->Instances);
+  this->Mapper->SetSource(this->Glyph);
+  this->Mapper->SetOrientationArray("Directions");
+  this->Mapper->SetOrientationModeToDirection();
+  this->Mapper->SetScaleArray("Lengths");
+  this->Mapper->SetScaleModeToScaleByMagnitude();
+  this->Mapper->SetScaling(1);
+  this->Mapper->SetScaleFactor(1.0);
+  this->Mapper->SetScalarModeToUsePointFieldData();
+  this->Mapper->SelectColorArray("Colors");
+  this->Mapper->ScalarVisibilityOn();
+
+  this->Actor = vtkActor::New();
+  this->Actor->SetMapper(this->Mapper);
+  this->Actor->GetProperty()->SetAmbient(1.0);
+}
+
+//----------------------------------------------------------------------------
+vtkBoneGlyphInstancer::~vtkBoneGlyphInstancer()
+{
+  // The representations hold a reference on the instancer: there are
+  // none left at this point.
+  this->Actor->Delete();
+  this->Mapper->Delete();
+  this->Colors->Delete();
+  this->Lengths->Delete();
+  this->Directions->Delete();
+  this->Instances->Delete();
+  this->Glyph->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::SetGlyphType(int type)
+{
+  if (type == this->GlyphType)
+    {
+    return;
+    }
+
+  this->GlyphType = type;
+  this->BuildGlyph();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::SetGlyphTypeToCylinder()
+{
+  this->SetGlyphType(vtkBoneGlyphInstancer::Cylinder);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::SetGlyphTypeToDoubleCone()
+{
+  this->SetGlyphType(vtkBoneGlyphInstancer::DoubleCone);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::SetRatio(double ratio)
+{
+  if (ratio > 0.0001 && ratio <= 1.0 && this->Ratio != ratio)
+    {
+    this->Ratio = ratio;
+    this->BuildGlyph();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::SetNumberOfSides(int numberOfSides)
+{
+  if (numberOfSides >= 3 && this->NumberOfSides != numberOfSides)
+    {
+    this->NumberOfSides = numberOfSides;
+    this->BuildGlyph();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::SetCapping(int capping)
+{
+  if (this->Capping != capping)
+    {
+    this->Capping = capping;
+    this->BuildGlyph();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::BuildGlyph()
+{
+  if (this->GlyphType == vtkBoneGlyphInstancer::DoubleCone)
+    {
+    vtkDoubleConeSource* cones = vtkDoubleConeSource::New();
+    cones->SetRadius(GlyphRadius);
+    cones->SetRatio(this->Ratio);
+    cones->SetNumberOfSides(this->NumberOfSides);
+    cones->Update();
+    this->Glyph->ShallowCopy(cones->GetOutput());
+    cones->Delete();
+    return;
+    }
+
+  vtkPoints* points = vtkPoints::New();
+  vtkCellArray* polys = vtkCellArray::New();
+  const int n = this->NumberOfSides;
+
+  // Two rings, at the head and at the tail
+  for (int ring = 0; ring < 2; ++ring)
+    {
+    for (int i = 0; i < n; ++i)
+      {
+      double angle = 2.0 * vtkMath::Pi() * i / n;
+      points->InsertNextPoint(ring, GlyphRadius * cos(angle),
+                              GlyphRadius * sin(angle));
+      }
+    }
+  for (int i = 0; i < n; ++i)
+    {
+    vtkIdType quad[4] = {i, n + i, n + (i + 1) % n, (i + 1) % n};
+    polys->InsertNextCell(4, quad);
+    }
+  if (this->Capping)
+    {
+    polys->InsertNextCell(n);
+    for (int i = n - 1; i >= 0; --i)
+      {
+      polys->InsertCellPoint(i);
+      }
+    polys->InsertNextCell(n);
+    for (int i = 0; i < n; ++i)
+      {
+      polys->InsertCellPoint(n + i);
+      }
+    }
+
+  this->Glyph->Initialize();
+  this->Glyph->SetPoints(points);
+  this->Glyph->SetPolys(polys);
+  points->Delete();
+  polys->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneGlyphInstancer::GetNumberOfInstances()
+{
+  return static_cast<vtkIdType>(this->Representations.size());
+}
+
+//----------------------------------------------------------------------------
+vtkInstancedBoneRepresentation* vtkBoneGlyphInstancer
+::GetRepresentation(vtkIdType id)
+{
+  if (id < 0 || id >= this->GetNumberOfInstances())
+    {
+    return NULL;
+    }
+  return this->Representations[id];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneGlyphInstancer::AddInstance(vtkInstancedBoneRepresentation* rep)
+{
+  this->Representations.push_back(rep);
+
+  double zero[3] = {0.0, 0.0, 0.0};
+  double direction[3] = {1.0, 0.0, 0.0};
+  unsigned char white[3] = {255, 255, 255};
+  this->Instances->GetPoints()->InsertNextPoint(zero);
+  this->Directions->InsertNextTuple(direction);
+  this->Lengths->InsertNextValue(0.0);
+  this->Colors->InsertNextTupleValue(white);
+  this->Instances->Modified();
+
+  return this->GetNumberOfInstances() - 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::RemoveInstance(vtkIdType id)
+{
+  vtkIdType last = this->GetNumberOfInstances() - 1;
+  if (id < 0 || id > last)
+    {
+    return;
+    }
+
+  if (id != last)
+    {
+    vtkPoints* points = this->Instances->GetPoints();
+    points->SetPoint(id, points->GetPoint(last));
+    this->Directions->SetTuple(id, this->Directions->GetTuple(last));
+    this->Lengths->SetValue(id, this->Lengths->GetValue(last));
+    this->Colors->SetTupleValue(id, this->Colors->GetPointer(3 * last));
+
+    this->Representations[id] = this->Representations[last];
+    this->Representations[id]->InstanceId = id;
+    }
+  this->Representations.pop_back();
+
+  this->Instances->GetPoints()->SetNumberOfPoints(last);
+  this->Directions->SetNumberOfTuples(last);
+  this->Lengths->SetNumberOfTuples(last);
+  this->Colors->SetNumberOfTuples(last);
+  this->Instances->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::SetInstance(vtkIdType id,
+                                        const double head[3],
+                                        const double tail[3],
+                                        const double color[3],
+                                        int visible)
+{
+  double direction[3];
+  vtkMath::Subtract(tail, head, direction);
+  double length = vtkMath::Norm(direction);
+
+  unsigned char rgb[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    double c = color[i] < 0.0 ? 0.0 : (color[i] > 1.0 ? 1.0 : color[i]);
+    rgb[i] = static_cast<unsigned char>(c * 255.0 + 0.5);
+    }
+
+  // Leave the instances untouched (no mapper execution) if nothing
+  // changed, e.g. when the representations are rebuilt for a camera move.
+  double* oldHead = this->Instances->GetPoints()->GetPoint(id);
+  double* oldDirection = this->Directions->GetPointer(3 * id);
+  unsigned char* oldColor = this->Colors->GetPointer(3 * id);
+  if (oldHead[0] == head[0] && oldHead[1] == head[1] && oldHead[2] == head[2]
+      && oldDirection[0] == direction[0] && oldDirection[1] == direction[1]
+      && oldDirection[2] == direction[2]
+      && this->Lengths->GetValue(id) == (visible ? length : 0.0)
+      && oldColor[0] == rgb[0] && oldColor[1] == rgb[1]
+      && oldColor[2] == rgb[2])
+    {
+    return;
+    }
+
+  this->Instances->GetPoints()->SetPoint(id, head);
+  this->Directions->SetTuple(id, direction);
+  this->Lengths->SetValue(id, visible ? length : 0.0);
+  this->Colors->SetTupleValue(id, rgb);
+
+  this->Instances->GetPoints()->Modified();
+  this->Directions->Modified();
+  this->Lengths->Modified();
+  this->Colors->Modified();
+  this->Instances->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneGlyphInstancer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Glyph Type: " << this->GlyphType << "\n";
+  os << indent << "Ratio: " << this->Ratio << "\n";
+  os << indent << "Number Of Sides: " << this->NumberOfSides << "\n";
+  os << indent << "Capping: " << this->Capping << "\n";
+  os << indent << "Number Of Instances: "
+     << this->GetNumberOfInstances() << "\n";
+}
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneGlyphInstancer_h
+#define __vtkBoneGlyphInstancer_h
+
+// .NAME vtkBoneGlyphInstancer - Draw many bones with a single actor
+// .SECTION Description
+// vtkBoneGlyphInstancer draws the bones of vtkInstancedBoneRepresentation
+// as instances of one unit glyph (a cylinder or a double cone) with a
+// single actor and a vtkGlyph3DMapper. Each bone is an instance: a point
+// at the bone head with its direction (head to tail), its length (the
+// glyph scale) and its color in per instance arrays.
+//
+// The actor returned by GetActor() must be added to the renderer once;
+// the bone representations sharing the instancer render nothing by
+// themselves.
+// .SECTION See Also
+// vtkInstancedBoneRepresentation vtkCylinderBoneRepresentation
+// vtkDoubleConeBoneRepresentation
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vector>
+//ETX
+
+class vtkActor;
+class vtkDoubleArray;
+class vtkGlyph3DMapper;
+class vtkInstancedBoneRepresentation;
+class vtkPolyData;
+class vtkUnsignedCharArray;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneGlyphInstancer : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneGlyphInstancer *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneGlyphInstancer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Shape of the bones. The glyphs have the proportions of the
+  // vtkCylinderBoneRepresentation and vtkDoubleConeBoneRepresentation:
+  // their radius is a tenth of the bone length.
+  //BTX
+  enum GlyphType {Cylinder = 0, DoubleCone};
+  //ETX
+  void SetGlyphType(int type);
+  vtkGetMacro(GlyphType, int);
+  void SetGlyphTypeToCylinder();
+  void SetGlyphTypeToDoubleCone();
+
+  // Description:
+  // Position of the cones junction along the bone for DoubleCone glyphs,
+  // between 0 (head) and 1 (tail). Default is 0.25.
+  void SetRatio(double ratio);
+  vtkGetMacro(Ratio, double);
+
+  // Description:
+  // Number of sides of the glyph. Minimum 3, default is 12.
+  void SetNumberOfSides(int numberOfSides);
+  vtkGetMacro(NumberOfSides, int);
+
+  // Description:
+  // Close the cylinder glyph ends. Default is 1.
+  void SetCapping(int capping);
+  vtkGetMacro(Capping, int);
+
+  // Description:
+  // Get the actor drawing all the bones. It must be added to the renderer.
+  vtkGetObjectMacro(Actor, vtkActor);
+
+  // Description:
+  // Get the instances: one point per bone with the "Directions",
+  // "Lengths" and "Colors" point data arrays.
+  vtkGetObjectMacro(Instances, vtkPolyData);
+
+  // Description:
+  // Get the unit glyph, along X from 0 to 1.
+  vtkGetObjectMacro(Glyph, vtkPolyData);
+
+  // Description:
+  // Get the number of bones drawn.
+  vtkIdType GetNumberOfInstances();
+
+  // Description:
+  // Get the representation of an instance. NULL if out of range.
+  vtkInstancedBoneRepresentation* GetRepresentation(vtkIdType id);
+
+  // Description:
+  // Update an instance. A hidden instance has a null length.
+  void SetInstance(vtkIdType id, const double head[3], const double tail[3],
+                   const double color[3], int visible);
+
+protected:
+  vtkBoneGlyphInstancer();
+  ~vtkBoneGlyphInstancer();
+
+  int    GlyphType;
+  double Ratio;
+  int    NumberOfSides;
+  int    Capping;
+
+  vtkPolyData*          Glyph;
+  vtkPolyData*          Instances;
+  vtkDoubleArray*       Directions;
+  vtkDoubleArray*       Lengths;
+  vtkUnsignedCharArray* Colors;
+  vtkGlyph3DMapper*     Mapper;
+  vtkActor*             Actor;
+
+  // Description:
+  // Add a representation, return its instance id.
+  vtkIdType AddInstance(vtkInstancedBoneRepresentation* rep);
+
+  // Description:
+  // Remove an instance. The last instance is moved into the freed one.
+  void RemoveInstance(vtkIdType id);
+
+  // Description:
+  // Rebuild the unit glyph.
+  void BuildGlyph();
+
+//BTX
+  std::vector<vtkInstancedBoneRepresentation*> Representations;
+
+  friend class vtkInstancedBoneRepresentation;
+//ETX
+
+private:
+  vtkBoneGlyphInstancer(const vtkBoneGlyphInstancer&);  //Not implemented
+  void operator=(const vtkBoneGlyphInstancer&);  //Not implemented
+};
+
+#endif
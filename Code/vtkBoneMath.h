@@ -0,0 +1,494 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneMath_h
+#define __vtkBoneMath_h
+
+// .NAME vtkBoneMath - Header only vector, quaternion and rigid motion types
+// .SECTION Description
+// vtkBoneMath.h defines small value types templated over the scalar type:
+//  - vtkBoneVector3<T>: a 3D vector,
+//  - vtkBoneQuaternion<T>: a quaternion stored as (w, x, y, z),
+//  - vtkBoneRigidMotion<T>: a rotation (unit quaternion) plus a translation.
+// Everything is inline so that the compiler can inline and fold the math
+// in the callers. The types wrap plain arrays and can be built from and
+// copied to the double* buffers used by the bones.
+//
+// The float and double instantiations run the exact same operations.
+// For unit quaternions and values of the order of 1, their results agree
+// within 1e-6 (relative); the difference only comes from the float
+// rounding.
+//
+// Typedefs are provided for the float and double instantiations, e.g.
+// vtkBoneQuaternionf and vtkBoneQuaterniond.
+// .SECTION See Also
+// vtkBoneRigidTransform vtkBoneBatchMath
+
+#include <cmath>
+#include <limits>
+
+//----------------------------------------------------------------------------
+template <class T>
+class vtkBoneVector3
+{
+public:
+  vtkBoneVector3()
+    {
+    this->Data[0] = this->Data[1] = this->Data[2] = T(0);
+    }
+  vtkBoneVector3(T x, T y, T z)
+    {
+    this->Data[0] = x;
+    this->Data[1] = y;
+    this->Data[2] = z;
+    }
+  explicit vtkBoneVector3(const T* v)
+    {
+    this->Data[0] = v[0];
+    this->Data[1] = v[1];
+    this->Data[2] = v[2];
+    }
+
+  // Description:
+  // Copy the vector into an array of any scalar type.
+  template <class U> void CopyTo(U* v) const
+    {
+    v[0] = static_cast<U>(this->Data[0]);
+    v[1] = static_cast<U>(this->Data[1]);
+    v[2] = static_cast<U>(this->Data[2]);
+    }
+
+  T& operator[](int i) { return this->Data[i]; }
+  const T& operator[](int i) const { return this->Data[i]; }
+  T* GetData() { return this->Data; }
+  const T* GetData() const { return this->Data; }
+
+  vtkBoneVector3 operator+(const vtkBoneVector3& v) const
+    {
+    return vtkBoneVector3(this->Data[0] + v[0], this->Data[1] + v[1],
+                          this->Data[2] + v[2]);
+    }
+  vtkBoneVector3 operator-(const vtkBoneVector3& v) const
+    {
+    return vtkBoneVector3(this->Data[0] - v[0], this->Data[1] - v[1],
+                          this->Data[2] - v[2]);
+    }
+  vtkBoneVector3 operator-() const
+    {
+    return vtkBoneVector3(-this->Data[0], -this->Data[1], -this->Data[2]);
+    }
+  vtkBoneVector3 operator*(T s) const
+    {
+    return vtkBoneVector3(this->Data[0] * s, this->Data[1] * s,
+                          this->Data[2] * s);
+    }
+
+  T Dot(const vtkBoneVector3& v) const
+    {
+    return this->Data[0]*v[0] + this->Data[1]*v[1] + this->Data[2]*v[2];
+    }
+  vtkBoneVector3 Cross(const vtkBoneVector3& v) const
+    {
+    return vtkBoneVector3(this->Data[1]*v[2] - this->Data[2]*v[1],
+                          this->Data[2]*v[0] - this->Data[0]*v[2],
+                          this->Data[0]*v[1] - this->Data[1]*v[0]);
+    }
+  T SquaredNorm() const { return this->Dot(*this); }
+  T Norm() const { return std::sqrt(this->SquaredNorm()); }
+
+  // Description:
+  // Normalize in place and return the previous norm.
+  // A null vector is left unchanged.
+  T Normalize()
+    {
+    T norm = this->Norm();
+    if (norm > T(0))
+      {
+      this->Data[0] /= norm;
+      this->Data[1] /= norm;
+      this->Data[2] /= norm;
+      }
+    return norm;
+    }
+  vtkBoneVector3 Normalized() const
+    {
+    vtkBoneVector3 v(*this);
+    v.Normalize();
+    return v;
+    }
+
+protected:
+  T Data[3];
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+class vtkBoneQuaternion
+{
+public:
+  // Description:
+  // The default quaternion is the identity rotation.
+  vtkBoneQuaternion()
+    {
+    this->Data[0] = T(1);
+    this->Data[1] = this->Data[2] = this->Data[3] = T(0);
+    }
+  vtkBoneQuaternion(T w, T x, T y, T z)
+    {
+    this->Data[0] = w;
+    this->Data[1] = x;
+    this->Data[2] = y;
+    this->Data[3] = z;
+    }
+  explicit vtkBoneQuaternion(const T* q)
+    {
+    this->Data[0] = q[0];
+    this->Data[1] = q[1];
+    this->Data[2] = q[2];
+    this->Data[3] = q[3];
+    }
+
+  // Description:
+  // Rotation of angle (in radians) around axis. The axis does not need to
+  // be normalized. A null axis gives the identity.
+  static vtkBoneQuaternion FromAxisAngle(T angle, const vtkBoneVector3<T>& axis)
+    {
+    T norm = axis.Norm();
+    if (norm <= T(0))
+      {
+      return vtkBoneQuaternion();
+      }
+    T f = std::sin(angle / T(2)) / norm;
+    return vtkBoneQuaternion(std::cos(angle / T(2)),
+                             axis[0] * f, axis[1] * f, axis[2] * f);
+    }
+
+  // Description:
+  // Shortest arc rotation taking the direction of from onto the direction
+  // of to. The vectors do not need to be normalized. No trigonometric
+  // function is involved: q = (|from||to| + from.to, from x to) normalized.
+  // When the vectors are opposite, the rotation is a half turn around
+  // halfTurnAxis made orthogonal to from. If halfTurnAxis is not given or
+  // is parallel to from, from x Z (or from x X) is used.
+  // A null vector gives the identity.
+  static vtkBoneQuaternion FromTwoVectors(const vtkBoneVector3<T>& from,
+                                          const vtkBoneVector3<T>& to)
+    {
+    return vtkBoneQuaternion::FromTwoVectors(from, to, vtkBoneVector3<T>());
+    }
+  static vtkBoneQuaternion FromTwoVectors(const vtkBoneVector3<T>& from,
+                                          const vtkBoneVector3<T>& to,
+                                          const vtkBoneVector3<T>& halfTurnAxis)
+    {
+    T fromNorm2 = from.SquaredNorm();
+    T normProduct = std::sqrt(fromNorm2 * to.SquaredNorm());
+    if (normProduct <= T(0))
+      {
+      return vtkBoneQuaternion();
+      }
+
+    T w = normProduct + from.Dot(to);
+    if (w > normProduct * std::numeric_limits<T>::epsilon())
+      {
+      vtkBoneVector3<T> axis = from.Cross(to);
+      return vtkBoneQuaternion(w, axis[0], axis[1], axis[2]).Normalized();
+      }
+
+    // Opposite vectors, any axis orthogonal to from works
+    T minAxisNorm2 = fromNorm2 * std::numeric_limits<T>::epsilon();
+    vtkBoneVector3<T> axis =
+      halfTurnAxis - from * (halfTurnAxis.Dot(from) / fromNorm2);
+    if (axis.SquaredNorm() <= minAxisNorm2)
+      {
+      axis = from.Cross(vtkBoneVector3<T>(T(0), T(0), T(1)));
+      if (axis.SquaredNorm() <= minAxisNorm2)
+        {
+        axis = from.Cross(vtkBoneVector3<T>(T(1), T(0), T(0)));
+        }
+      }
+    axis.Normalize();
+    return vtkBoneQuaternion(T(0), axis[0], axis[1], axis[2]);
+    }
+
+  // Description:
+  // Copy the quaternion into an array of any scalar type.
+  template <class U> void CopyTo(U* q) const
+    {
+    q[0] = static_cast<U>(this->Data[0]);
+    q[1] = static_cast<U>(this->Data[1]);
+    q[2] = static_cast<U>(this->Data[2]);
+    q[3] = static_cast<U>(this->Data[3]);
+    }
+
+  T& operator[](int i) { return this->Data[i]; }
+  const T& operator[](int i) const { return this->Data[i]; }
+  T* GetData() { return this->Data; }
+  const T* GetData() const { return this->Data; }
+
+  T GetW() const { return this->Data[0]; }
+  vtkBoneVector3<T> GetVector() const
+    {
+    return vtkBoneVector3<T>(this->Data[1], this->Data[2], this->Data[3]);
+    }
+
+  // Description:
+  // Hamilton product. (q1 * q2) rotates by q2 first, then by q1.
+  vtkBoneQuaternion operator*(const vtkBoneQuaternion& q) const
+    {
+    const T* q1 = this->Data;
+    const T* q2 = q.Data;
+    return vtkBoneQuaternion(
+      q1[0]*q2[0] - q1[1]*q2[1] - q1[2]*q2[2] - q1[3]*q2[3],
+      q1[0]*q2[1] + q1[1]*q2[0] + q1[2]*q2[3] - q1[3]*q2[2],
+      q1[0]*q2[2] + q1[2]*q2[0] + q1[3]*q2[1] - q1[1]*q2[3],
+      q1[0]*q2[3] + q1[3]*q2[0] + q1[1]*q2[2] - q1[2]*q2[1]);
+    }
+
+  T Dot(const vtkBoneQuaternion& q) const
+    {
+    return this->Data[0]*q[0] + this->Data[1]*q[1]
+           + this->Data[2]*q[2] + this->Data[3]*q[3];
+    }
+  T SquaredNorm() const { return this->Dot(*this); }
+  T Norm() const { return std::sqrt(this->SquaredNorm()); }
+
+  // Description:
+  // Normalize in place and return the previous norm.
+  // A null quaternion is left unchanged.
+  T Normalize()
+    {
+    T norm = this->Norm();
+    if (norm > T(0))
+      {
+      this->Data[0] /= norm;
+      this->Data[1] /= norm;
+      this->Data[2] /= norm;
+      this->Data[3] /= norm;
+      }
+    return norm;
+    }
+  vtkBoneQuaternion Normalized() const
+    {
+    vtkBoneQuaternion q(*this);
+    q.Normalize();
+    return q;
+    }
+
+  // Description:
+  // The conjugate is the inverse rotation of a unit quaternion.
+  vtkBoneQuaternion Conjugated() const
+    {
+    return vtkBoneQuaternion(this->Data[0], -this->Data[1],
+                             -this->Data[2], -this->Data[3]);
+    }
+
+  // Description:
+  // Rotate a vector by the unit quaternion: q * v * conjugate(q).
+  vtkBoneVector3<T> Rotate(const vtkBoneVector3<T>& v) const
+    {
+    // t = 2 * (u x v), v' = v + w*t + u x t, u being the vector part
+    vtkBoneVector3<T> u = this->GetVector();
+    vtkBoneVector3<T> t = u.Cross(v) * T(2);
+    return v + t * this->Data[0] + u.Cross(t);
+    }
+
+  // Description:
+  // Rotation angle (radians, in [0, 2pi]) and unit axis of the unit
+  // quaternion. The axis is X for a null rotation.
+  T GetAxisAngle(vtkBoneVector3<T>& axis) const
+    {
+    vtkBoneVector3<T> u = this->GetVector();
+    T sinHalfAngle = u.Norm();
+    if (sinHalfAngle > T(0))
+      {
+      axis = u * (T(1) / sinHalfAngle);
+      }
+    else
+      {
+      axis = vtkBoneVector3<T>(T(1), T(0), T(0));
+      }
+    return T(2) * std::atan2(sinHalfAngle, this->Data[0]);
+    }
+
+  // Description:
+  // Rotation matrix of the quaternion, M * v = q * v * conjugate(q).
+  // Like vtkMath::QuaternionToMatrix3x3(), the quaternion does not need
+  // to be normalized. A null quaternion gives the identity.
+  void ToMatrix3x3(T m[3][3]) const
+    {
+    T w = this->Data[0], x = this->Data[1];
+    T y = this->Data[2], z = this->Data[3];
+    T norm2 = w*w + x*x + y*y + z*z;
+    T s = norm2 > T(0) ? T(2) / norm2 : T(0);
+    T xx = x*x*s, yy = y*y*s, zz = z*z*s;
+    T xy = x*y*s, xz = x*z*s, yz = y*z*s;
+    T wx = w*x*s, wy = w*y*s, wz = w*z*s;
+
+    m[0][0] = T(1) - (yy + zz);
+    m[0][1] = xy - wz;
+    m[0][2] = xz + wy;
+    m[1][0] = xy + wz;
+    m[1][1] = T(1) - (xx + zz);
+    m[1][2] = yz - wx;
+    m[2][0] = xz - wy;
+    m[2][1] = yz + wx;
+    m[2][2] = T(1) - (xx + yy);
+    }
+
+protected:
+  T Data[4];
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+class vtkBoneRigidMotion
+{
+public:
+  // Description:
+  // Construct the identity transform.
+  vtkBoneRigidMotion() {}
+
+  // Description:
+  // Construct a transform from a unit quaternion (w, x, y, z) and
+  // a translation.
+  vtkBoneRigidMotion(const vtkBoneQuaternion<T>& rotation,
+                     const vtkBoneVector3<T>& translation)
+    : Rotation(rotation), Translation(translation) {}
+  vtkBoneRigidMotion(const T rotation[4], const T translation[3])
+    : Rotation(rotation), Translation(translation) {}
+
+  // Description:
+  // Reset the transform to identity.
+  void Identity()
+    {
+    this->Rotation = vtkBoneQuaternion<T>();
+    this->Translation = vtkBoneVector3<T>();
+    }
+
+  // Description:
+  // Set/Get the rotation quaternion (w, x, y, z).
+  void SetRotation(const vtkBoneQuaternion<T>& rotation)
+    { this->Rotation = rotation; }
+  void SetRotation(const T rotation[4])
+    { this->Rotation = vtkBoneQuaternion<T>(rotation); }
+  const T* GetRotation() const { return this->Rotation.GetData(); }
+  const vtkBoneQuaternion<T>& GetRotationQuaternion() const
+    { return this->Rotation; }
+
+  // Description:
+  // Set the rotation from an axis and an angle in radians.
+  void SetRotationWXYZ(T angle, const T axis[3])
+    {
+    this->Rotation = vtkBoneQuaternion<T>::FromAxisAngle(
+      angle, vtkBoneVector3<T>(axis));
+    }
+
+  // Description:
+  // Set/Get the translation.
+  void SetTranslation(const vtkBoneVector3<T>& translation)
+    { this->Translation = translation; }
+  void SetTranslation(const T translation[3])
+    { this->Translation = vtkBoneVector3<T>(translation); }
+  const T* GetTranslation() const { return this->Translation.GetData(); }
+  const vtkBoneVector3<T>& GetTranslationVector() const
+    { return this->Translation; }
+
+  // Description:
+  // Renormalize the rotation quaternion to fight the drift of
+  // successive compositions.
+  void Normalize() { this->Rotation.Normalize(); }
+
+  // Description:
+  // Rotate a vector (no translation).
+  vtkBoneVector3<T> TransformVector(const vtkBoneVector3<T>& v) const
+    {
+    return this->Rotation.Rotate(v);
+    }
+  void TransformVector(const T in[3], T out[3]) const
+    {
+    this->TransformVector(vtkBoneVector3<T>(in)).CopyTo(out);
+    }
+
+  // Description:
+  // Rotate and translate a point.
+  vtkBoneVector3<T> TransformPoint(const vtkBoneVector3<T>& p) const
+    {
+    return this->Rotation.Rotate(p) + this->Translation;
+    }
+  void TransformPoint(const T in[3], T out[3]) const
+    {
+    this->TransformPoint(vtkBoneVector3<T>(in)).CopyTo(out);
+    }
+
+  // Description:
+  // Return the inverse transform: p = R^-1 * (p' - T).
+  vtkBoneRigidMotion GetInverse() const
+    {
+    vtkBoneQuaternion<T> inverseRotation = this->Rotation.Conjugated();
+    return vtkBoneRigidMotion(inverseRotation,
+                              -inverseRotation.Rotate(this->Translation));
+    }
+
+  // Description:
+  // Invert the transform in place.
+  void Inverse() { *this = this->GetInverse(); }
+
+  // Description:
+  // Composition: (this * other)(p) = this(other(p)), i.e. other is
+  // applied first.
+  vtkBoneRigidMotion operator*(const vtkBoneRigidMotion& other) const
+    {
+    return vtkBoneRigidMotion(this->Rotation * other.Rotation,
+                              this->TransformPoint(other.Translation));
+    }
+
+  // Description:
+  // Fill a row major 4x4 homogeneous matrix, e.g. for vtkMatrix4x4.
+  void GetMatrix(T elements[16]) const
+    {
+    T rotation[3][3];
+    this->Rotation.ToMatrix3x3(rotation);
+    for (int i = 0; i < 3; ++i)
+      {
+      elements[4*i + 0] = rotation[i][0];
+      elements[4*i + 1] = rotation[i][1];
+      elements[4*i + 2] = rotation[i][2];
+      elements[4*i + 3] = this->Translation[i];
+      }
+    elements[12] = T(0);
+    elements[13] = T(0);
+    elements[14] = T(0);
+    elements[15] = T(1);
+    }
+
+protected:
+  vtkBoneQuaternion<T> Rotation;
+  vtkBoneVector3<T> Translation;
+};
+
+//----------------------------------------------------------------------------
+typedef vtkBoneVector3<float> vtkBoneVector3f;
+typedef vtkBoneVector3<double> vtkBoneVector3d;
+typedef vtkBoneQuaternion<float> vtkBoneQuaternionf;
+typedef vtkBoneQuaternion<double> vtkBoneQuaterniond;
+typedef vtkBoneRigidMotion<float> vtkBoneRigidMotionf;
+typedef vtkBoneRigidMotion<double> vtkBoneRigidMotiond;
+
+#endif
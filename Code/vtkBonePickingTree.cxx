@@ -0,0 +1,586 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBonePickingTree.h"
+
+//My includes
+#include "vtkBoneRepresentation.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkCallbackCommand.h>
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkLine.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindowInteractor.h>
+
+//STL includes
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(vtkBonePickingTree);
+
+namespace
+{
+
+// Order the bones along an axis of their box centers
+struct CentroidLess
+{
+  CentroidLess(const double* centroids, int axis)
+    : Centroids(centroids), Axis(axis) {}
+
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    return this->Centroids[3*a + this->Axis]
+      < this->Centroids[3*b + this->Axis];
+    }
+
+  const double* Centroids;
+  int Axis;
+};
+
+void InitializeBounds(double* bounds)
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    bounds[2*i] = VTK_DOUBLE_MAX;
+    bounds[2*i+1] = -VTK_DOUBLE_MAX;
+    }
+}
+
+void AddBounds(double* bounds, const double* other)
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    bounds[2*i] = std::min(bounds[2*i], other[2*i]);
+    bounds[2*i+1] = std::max(bounds[2*i+1], other[2*i+1]);
+    }
+}
+
+void DisplayToWorld(vtkRenderer* renderer, double x, double y, double z,
+                    double world[3])
+{
+  renderer->SetDisplayPoint(x, y, z);
+  renderer->DisplayToWorld();
+  double* point = renderer->GetWorldPoint();
+  double w = point[3] != 0.0 ? point[3] : 1.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    world[i] = point[i] / w;
+    }
+}
+
+void WorldToDisplay(vtkRenderer* renderer, const double world[3],
+                    double display[3])
+{
+  renderer->SetWorldPoint(world[0], world[1], world[2], 1.0);
+  renderer->WorldToDisplay();
+  renderer->GetDisplayPoint(display);
+}
+
+// Depth along the direction of projection of the box corner the farthest
+// from the camera.
+double FarthestDepth(const double* bounds, const double position[3],
+                     const double directionOfProjection[3])
+{
+  double depth = 0.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    double corner = directionOfProjection[i] >= 0.0 ?
+      bounds[2*i+1] : bounds[2*i];
+    depth += (corner - position[i]) * directionOfProjection[i];
+    }
+  return std::max(depth, 0.0);
+}
+
+// Slab test of the segment origin + t * direction, t in [0,1], against
+// the box padded on all sides.
+bool IntersectSegmentWithBox(const double origin[3],
+                             const double direction[3],
+                             const double* bounds, double padding)
+{
+  double tMin = 0.0;
+  double tMax = 1.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    double min = bounds[2*i] - padding;
+    double max = bounds[2*i+1] + padding;
+    if (fabs(direction[i]) < 1e-12)
+      {
+      if (origin[i] < min || origin[i] > max)
+        {
+        return false;
+        }
+      continue;
+      }
+    double t1 = (min - origin[i]) / direction[i];
+    double t2 = (max - origin[i]) / direction[i];
+    if (t1 > t2)
+      {
+      std::swap(t1, t2);
+      }
+    tMin = std::max(tMin, t1);
+    tMax = std::min(tMax, t2);
+    if (tMin > tMax)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBonePickingTree::vtkBonePickingTree()
+{
+  this->Skeleton = NULL;
+  this->Interactor = NULL;
+  this->Priority = 1.0;
+  this->EventCallbackCommand = vtkCallbackCommand::New();
+  this->EventCallbackCommand->SetClientData(this);
+  this->EventCallbackCommand->SetCallback(
+    vtkBonePickingTree::ProcessEvents);
+
+  this->PickedBoneId = -1;
+  this->PickedState = vtkBoneRepresentation::Outside;
+  this->NumberOfVisitedNodes = 0;
+  this->NumberOfTestedBones = 0;
+  this->NumberOfBuilds = 0;
+  this->MaximumTolerance = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBonePickingTree::~vtkBonePickingTree()
+{
+  this->SetInteractor(NULL);
+  this->EventCallbackCommand->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBonePickingTree::SetInteractor(vtkRenderWindowInteractor* interactor)
+{
+  if (interactor == this->Interactor)
+    {
+    return;
+    }
+
+  if (this->Interactor)
+    {
+    this->Interactor->RemoveObserver(this->EventCallbackCommand);
+    }
+  this->Interactor = interactor;
+  if (this->Interactor)
+    {
+    this->Interactor->AddObserver(vtkCommand::LeftButtonPressEvent,
+      this->EventCallbackCommand, this->Priority);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBonePickingTree::SetPriority(float priority)
+{
+  if (priority == this->Priority)
+    {
+    return;
+    }
+
+  this->Priority = priority;
+  if (this->Interactor)
+    {
+    // Observe again with the new priority
+    vtkRenderWindowInteractor* interactor = this->Interactor;
+    this->SetInteractor(NULL);
+    this->SetInteractor(interactor);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBonePickingTree::GetNumberOfNodes()
+{
+  return static_cast<vtkIdType>(this->NodeParents.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkBonePickingTree::GetNodeBounds(vtkIdType node, double bounds[6])
+{
+  if (node < 0 || node >= this->GetNumberOfNodes())
+    {
+    InitializeBounds(bounds);
+    return;
+    }
+  std::copy(&this->NodeBounds[6*node], &this->NodeBounds[6*node] + 6,
+            bounds);
+}
+
+//----------------------------------------------------------------------------
+void vtkBonePickingTree::Update()
+{
+  vtkIdType numberOfBones =
+    this->Skeleton ? this->Skeleton->GetNumberOfBones() : 0;
+
+  bool rebuild =
+    numberOfBones != static_cast<vtkIdType>(this->LeafBones.size());
+  if (rebuild)
+    {
+    this->LeafBones.resize(numberOfBones, NULL);
+    this->LeafTimes.resize(numberOfBones, 0);
+    this->LeafBounds.resize(6 * numberOfBones);
+    this->LeafNodes.resize(numberOfBones, -1);
+    this->LeafTolerances.resize(numberOfBones, 0);
+    }
+
+  bool modified = false;
+  for (vtkIdType id = 0; id < numberOfBones; ++id)
+    {
+    vtkBoneWidget* bone = this->Skeleton->GetBone(id);
+    if (bone != this->LeafBones[id])
+      {
+      // The slots of the removed bones are reused
+      this->LeafBones[id] = bone;
+      this->LeafTimes[id] = 0;
+      rebuild = true;
+      }
+    if (!this->UpdateLeafBounds(id))
+      {
+      continue;
+      }
+    modified = true;
+
+    if (!rebuild)
+      {
+      // Refit the leaf and its ancestors
+      vtkIdType node = this->LeafNodes[id];
+      std::copy(&this->LeafBounds[6*id], &this->LeafBounds[6*id] + 6,
+                &this->NodeBounds[6*node]);
+      for (node = this->NodeParents[node]; node >= 0;
+           node = this->NodeParents[node])
+        {
+        this->RefitNode(node);
+        }
+      }
+    }
+
+  if (modified)
+    {
+    this->MaximumTolerance = 0;
+    for (vtkIdType id = 0; id < numberOfBones; ++id)
+      {
+      this->MaximumTolerance =
+        std::max(this->MaximumTolerance, this->LeafTolerances[id]);
+      }
+    }
+
+  if (!rebuild)
+    {
+    return;
+    }
+
+  this->NodeBounds.clear();
+  this->NodeChildren.clear();
+  this->NodeParents.clear();
+  this->NodeBones.clear();
+  this->BuildOrder.resize(numberOfBones);
+  this->Centroids.resize(3 * numberOfBones);
+  for (vtkIdType id = 0; id < numberOfBones; ++id)
+    {
+    this->BuildOrder[id] = id;
+    for (int i = 0; i < 3; ++i)
+      {
+      this->Centroids[3*id + i] = 0.5 * (this->LeafBounds[6*id + 2*i]
+                                         + this->LeafBounds[6*id + 2*i+1]);
+      }
+    }
+  if (numberOfBones > 0)
+    {
+    this->BuildNode(0, numberOfBones, -1);
+    }
+  ++this->NumberOfBuilds;
+}
+
+//----------------------------------------------------------------------------
+bool vtkBonePickingTree::UpdateLeafBounds(vtkIdType id)
+{
+  vtkBoneWidget* bone = this->LeafBones[id];
+  vtkBoneRepresentation* rep = bone ? bone->GetBoneRepresentation() : NULL;
+
+  // The representation MTime includes its handles: it changes when the
+  // bone moves.
+  unsigned long time = bone ? bone->GetMTime() : 0;
+  if (rep)
+    {
+    time = std::max(time, rep->GetMTime());
+    }
+  if (time == this->LeafTimes[id] && time != 0)
+    {
+    return false;
+    }
+  this->LeafTimes[id] = time;
+
+  double* bounds = &this->LeafBounds[6*id];
+  if (!rep || !bone->GetEnabled() || !rep->GetVisibility())
+    {
+    // Never picked
+    InitializeBounds(bounds);
+    this->LeafTolerances[id] = 0;
+    return true;
+    }
+
+  double head[3], tail[3];
+  rep->GetHeadWorldPosition(head);
+  rep->GetTailWorldPosition(tail);
+  for (int i = 0; i < 3; ++i)
+    {
+    bounds[2*i] = std::min(head[i], tail[i]);
+    bounds[2*i+1] = std::max(head[i], tail[i]);
+    }
+  this->LeafTolerances[id] = rep->GetTolerance();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBonePickingTree
+::BuildNode(vtkIdType begin, vtkIdType end, vtkIdType parent)
+{
+  vtkIdType node = this->GetNumberOfNodes();
+  this->NodeParents.push_back(parent);
+  this->NodeChildren.push_back(-1);
+  this->NodeChildren.push_back(-1);
+  this->NodeBones.push_back(-1);
+  for (int i = 0; i < 6; ++i)
+    {
+    this->NodeBounds.push_back(0.0);
+    }
+
+  if (end - begin == 1)
+    {
+    vtkIdType id = this->BuildOrder[begin];
+    this->NodeBones[node] = id;
+    this->LeafNodes[id] = node;
+    std::copy(&this->LeafBounds[6*id], &this->LeafBounds[6*id] + 6,
+              &this->NodeBounds[6*node]);
+    return node;
+    }
+
+  // Median split along the longest axis of the box centers
+  double centers[6];
+  InitializeBounds(centers);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    const double* centroid = &this->Centroids[3*this->BuildOrder[i]];
+    for (int j = 0; j < 3; ++j)
+      {
+      centers[2*j] = std::min(centers[2*j], centroid[j]);
+      centers[2*j+1] = std::max(centers[2*j+1], centroid[j]);
+      }
+    }
+  int axis = 0;
+  for (int j = 1; j < 3; ++j)
+    {
+    if (centers[2*j+1] - centers[2*j]
+        > centers[2*axis+1] - centers[2*axis])
+      {
+      axis = j;
+      }
+    }
+  vtkIdType middle = (begin + end) / 2;
+  std::nth_element(this->BuildOrder.begin() + begin,
+                   this->BuildOrder.begin() + middle,
+                   this->BuildOrder.begin() + end,
+                   CentroidLess(&this->Centroids[0], axis));
+
+  // The buffers grow during the recursion: no reference is kept
+  vtkIdType left = this->BuildNode(begin, middle, node);
+  vtkIdType right = this->BuildNode(middle, end, node);
+  this->NodeChildren[2*node] = left;
+  this->NodeChildren[2*node+1] = right;
+  this->RefitNode(node);
+  return node;
+}
+
+//----------------------------------------------------------------------------
+void vtkBonePickingTree::RefitNode(vtkIdType node)
+{
+  double* bounds = &this->NodeBounds[6*node];
+  InitializeBounds(bounds);
+  AddBounds(bounds, &this->NodeBounds[6*this->NodeChildren[2*node]]);
+  AddBounds(bounds, &this->NodeBounds[6*this->NodeChildren[2*node+1]]);
+}
+
+//----------------------------------------------------------------------------
+int vtkBonePickingTree::Pick(vtkRenderer* renderer, int X, int Y)
+{
+  this->PickedBoneId = -1;
+  this->PickedState = vtkBoneRepresentation::Outside;
+  this->NumberOfVisitedNodes = 0;
+  this->NumberOfTestedBones = 0;
+
+  if (!renderer || !renderer->GetActiveCamera())
+    {
+    return this->PickedState;
+    }
+
+  this->Update();
+  if (this->GetNumberOfNodes() == 0)
+    {
+    return this->PickedState;
+    }
+
+  // The ray under the position, from the near to the far clipping plane
+  double origin[3], end[3], direction[3];
+  DisplayToWorld(renderer, X, Y, 0.0, origin);
+  DisplayToWorld(renderer, X, Y, 1.0, end);
+  vtkMath::Subtract(end, origin, direction);
+
+  // World size of a pixel, at a unit depth in perspective. The boxes are
+  // padded with the largest bone tolerance, plus a pixel for the rounding.
+  vtkCamera* camera = renderer->GetActiveCamera();
+  int* size = renderer->GetSize();
+  double height = (size && size[1] > 0) ? size[1] : 1.0;
+  int parallel = camera->GetParallelProjection();
+  double pixelSize = parallel ?
+    2.0 * camera->GetParallelScale() / height :
+    2.0 * tan(camera->GetViewAngle() * vtkMath::Pi() / 360.0) / height;
+  double padding = (this->MaximumTolerance + 1.0) * pixelSize;
+  double position[3], directionOfProjection[3];
+  camera->GetPosition(position);
+  camera->GetDirectionOfProjection(directionOfProjection);
+
+  double nearestDepth = VTK_DOUBLE_MAX;
+  this->Stack.clear();
+  this->Stack.push_back(0);
+  while (!this->Stack.empty())
+    {
+    vtkIdType node = this->Stack.back();
+    this->Stack.pop_back();
+    ++this->NumberOfVisitedNodes;
+
+    const double* bounds = &this->NodeBounds[6*node];
+    if (bounds[0] > bounds[1])
+      {
+      // Only hidden bones
+      continue;
+      }
+    double nodePadding = parallel ? padding :
+      padding * FarthestDepth(bounds, position, directionOfProjection);
+    if (!IntersectSegmentWithBox(origin, direction, bounds, nodePadding))
+      {
+      continue;
+      }
+
+    vtkIdType id = this->NodeBones[node];
+    if (id < 0)
+      {
+      this->Stack.push_back(this->NodeChildren[2*node]);
+      this->Stack.push_back(this->NodeChildren[2*node+1]);
+      continue;
+      }
+
+    ++this->NumberOfTestedBones;
+    double depth;
+    int state = this->PickBone(renderer, id, X, Y, depth);
+    if (state != vtkBoneRepresentation::Outside && depth < nearestDepth)
+      {
+      nearestDepth = depth;
+      this->PickedBoneId = id;
+      this->PickedState = state;
+      }
+    }
+
+  return this->PickedState;
+}
+
+//----------------------------------------------------------------------------
+int vtkBonePickingTree::PickBone(vtkRenderer* renderer, vtkIdType id,
+                                 int X, int Y, double& depth)
+{
+  vtkBoneRepresentation* rep = this->LeafBones[id]->GetBoneRepresentation();
+
+  double head[3], tail[3], p1[3], p2[3];
+  rep->GetHeadWorldPosition(head);
+  rep->GetTailWorldPosition(tail);
+  WorldToDisplay(renderer, head, p1);
+  WorldToDisplay(renderer, tail, p2);
+  double depth1 = p1[2];
+  double depth2 = p2[2];
+
+  double xyz[3], closest[3], t;
+  xyz[0] = X;
+  xyz[1] = Y;
+  xyz[2] = p1[2] = p2[2] = 0.0;
+  double tolerance2 = static_cast<double>(this->LeafTolerances[id])
+    * this->LeafTolerances[id];
+
+  if (vtkMath::Distance2BetweenPoints(xyz, p1) <= tolerance2)
+    {
+    depth = depth1;
+    return vtkBoneRepresentation::OnP1;
+    }
+  if (vtkMath::Distance2BetweenPoints(xyz, p2) <= tolerance2)
+    {
+    depth = depth2;
+    return vtkBoneRepresentation::OnP2;
+    }
+  if (vtkLine::DistanceToLine(xyz, p1, p2, t, closest) <= tolerance2
+      && t >= 0.0 && t <= 1.0)
+    {
+    depth = depth1 + t * (depth2 - depth1);
+    return vtkBoneRepresentation::OnLine;
+    }
+  return vtkBoneRepresentation::Outside;
+}
+
+//----------------------------------------------------------------------------
+void vtkBonePickingTree::ProcessEvents(vtkObject* vtkNotUsed(caller),
+                                       unsigned long vtkNotUsed(event),
+                                       void* clientdata,
+                                       void* vtkNotUsed(calldata))
+{
+  vtkBonePickingTree* self =
+    reinterpret_cast<vtkBonePickingTree*>(clientdata);
+
+  int X = self->Interactor->GetEventPosition()[0];
+  int Y = self->Interactor->GetEventPosition()[1];
+  self->Pick(self->Interactor->FindPokedRenderer(X, Y), X, Y);
+}
+
+//----------------------------------------------------------------------------
+void vtkBonePickingTree::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Skeleton: " << this->Skeleton << "\n";
+  os << indent << "Interactor: " << this->Interactor << "\n";
+  os << indent << "Priority: " << this->Priority << "\n";
+  os << indent << "Number Of Nodes: " << this->GetNumberOfNodes() << "\n";
+  os << indent << "Picked Bone Id: " << this->PickedBoneId << "\n";
+  os << indent << "Picked State: " << this->PickedState << "\n";
+  os << indent << "Number Of Visited Nodes: "
+     << this->NumberOfVisitedNodes << "\n";
+  os << indent << "Number Of Tested Bones: "
+     << this->NumberOfTestedBones << "\n";
+  os << indent << "Number Of Builds: " << this->NumberOfBuilds << "\n";
+}
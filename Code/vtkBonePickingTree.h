@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBonePickingTree_h
+#define __vtkBonePickingTree_h
+
+// .NAME vtkBonePickingTree - Bounding volume hierarchy picking the bones
+// .SECTION Description
+// vtkBonePickingTree is a bounding volume hierarchy over the bones of a
+// skeleton: each leaf boxes the segment of a bone (head to tail), each
+// inner node boxes its two children. Pick() casts the ray under a display
+// position through the tree, the boxes being padded with the pixel
+// tolerance of the bones at their depth so that the handles and the line
+// are found like vtkBoneRepresentation::ComputeInteractionState() finds
+// them. Only the bones whose box is crossed by the ray are tested, and the
+// nearest hit bone is returned with the part hit (OnP1, OnP2 or OnLine).
+//
+// The tree is shared by the bones of a skeleton with
+// vtkBoneSkeleton::SetPickingTree(). It is rebuilt when bones are added
+// or removed, otherwise only the leaves of the bones that moved since the
+// last pick, and their ancestors, are refit.
+//
+// Once the interactor is set, the tree picks each left button press ahead
+// of the bone widgets, and only the picked bone widget tests the event.
+// Pick() can also be called directly, e.g. on mouse move to hover bones.
+// .SECTION See Also
+// vtkBoneSkeleton vtkBoneWidget vtkBoneRepresentation
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vector>
+//ETX
+
+class vtkBoneSkeleton;
+class vtkBoneWidget;
+class vtkCallbackCommand;
+class vtkRenderer;
+class vtkRenderWindowInteractor;
+
+class VTK_BONEWIDGETS_EXPORT vtkBonePickingTree : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBonePickingTree *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBonePickingTree, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get the skeleton whose bones are picked. It is set by
+  // vtkBoneSkeleton::SetPickingTree(). A tree picks a single skeleton.
+  vtkGetObjectMacro(Skeleton, vtkBoneSkeleton);
+
+  // Description:
+  // Set/Get the interactor whose left button presses are picked before
+  // the bone widgets process them. The interactor is not registered,
+  // like for the widgets.
+  void SetInteractor(vtkRenderWindowInteractor* interactor);
+  vtkGetObjectMacro(Interactor, vtkRenderWindowInteractor);
+
+  // Description:
+  // Set/Get the priority of the interactor observer. It must be higher
+  // than the priority of the bone widgets. Default is 1.0.
+  void SetPriority(float priority);
+  vtkGetMacro(Priority, float);
+
+  // Description:
+  // Pick the bone at the display position (X,Y) in the renderer.
+  // Return the part of the bone hit: vtkBoneRepresentation::OnP1, OnP2,
+  // OnLine, or Outside if no bone is hit. When several bones are hit, the
+  // nearest one is picked.
+  int Pick(vtkRenderer* renderer, int X, int Y);
+
+  // Description:
+  // Get the result of the last pick: the id of the bone in the skeleton
+  // (-1 if none) and the part hit.
+  vtkGetMacro(PickedBoneId, vtkIdType);
+  vtkGetMacro(PickedState, int);
+
+  // Description:
+  // Bring the tree up to date with the bones of the skeleton. The tree is
+  // rebuilt if the bones changed, otherwise the leaves of the bones
+  // modified since the last update are refit. Called by Pick().
+  void Update();
+
+  // Description:
+  // Get the number of nodes of the tree. The root is the node 0.
+  vtkIdType GetNumberOfNodes();
+
+  // Description:
+  // Get the bounds of a node, without the tolerance padding.
+  void GetNodeBounds(vtkIdType node, double bounds[6]);
+
+  // Description:
+  // Statistics: the number of nodes visited and of bones tested by the
+  // last pick, and the number of times the tree was built.
+  vtkGetMacro(NumberOfVisitedNodes, vtkIdType);
+  vtkGetMacro(NumberOfTestedBones, vtkIdType);
+  vtkGetMacro(NumberOfBuilds, vtkIdType);
+
+protected:
+  vtkBonePickingTree();
+  ~vtkBonePickingTree();
+
+  vtkBoneSkeleton* Skeleton;
+  vtkRenderWindowInteractor* Interactor;
+  float Priority;
+  vtkCallbackCommand* EventCallbackCommand;
+
+  vtkIdType PickedBoneId;
+  int PickedState;
+  vtkIdType NumberOfVisitedNodes;
+  vtkIdType NumberOfTestedBones;
+  vtkIdType NumberOfBuilds;
+
+  // Largest pixel tolerance of the bones
+  int MaximumTolerance;
+
+  // Description:
+  // Recompute the box of a bone. Return true if it changed.
+  bool UpdateLeafBounds(vtkIdType id);
+
+  // Description:
+  // Build the subtree of the bones between begin and end in the build
+  // order. Return the node created.
+  vtkIdType BuildNode(vtkIdType begin, vtkIdType end, vtkIdType parent);
+
+  // Description:
+  // Recompute the box of an inner node from its children.
+  void RefitNode(vtkIdType node);
+
+  // Description:
+  // Exact test of a bone, as in vtkLineRepresentation. Return the part
+  // hit and its display depth.
+  int PickBone(vtkRenderer* renderer, vtkIdType id, int X, int Y,
+               double& depth);
+
+  static void ProcessEvents(vtkObject* caller, unsigned long event,
+                            void* clientdata, void* calldata);
+
+//BTX
+  // Per bone
+  std::vector<vtkBoneWidget*> LeafBones;
+  std::vector<unsigned long>  LeafTimes;
+  std::vector<double>         LeafBounds;
+  std::vector<vtkIdType>      LeafNodes;
+  std::vector<int>            LeafTolerances;
+
+  // Per node. The leaves have no children and the id of their bone.
+  std::vector<double>         NodeBounds;
+  std::vector<vtkIdType>      NodeChildren;
+  std::vector<vtkIdType>      NodeParents;
+  std::vector<vtkIdType>      NodeBones;
+
+  // Build and traversal buffers
+  std::vector<vtkIdType>      BuildOrder;
+  std::vector<double>         Centroids;
+  std::vector<vtkIdType>      Stack;
+
+  friend class vtkBoneSkeleton;
+//ETX
+
+private:
+  vtkBonePickingTree(const vtkBonePickingTree&);  //Not implemented
+  void operator=(const vtkBonePickingTree&);  //Not implemented
+};
+
+#endif
@@ -0,0 +1,225 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneProfiler.h"
+
+//VTK Includes
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+//STL includes
+#include <algorithm>
+#include <cmath>
+
+#if defined(_WIN32) || defined(WIN32)
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+vtkStandardNewMacro(vtkBoneProfiler);
+
+//----------------------------------------------------------------------------
+vtkBoneProfiler::vtkBoneProfiler()
+{
+  this->Reset();
+}
+
+//----------------------------------------------------------------------------
+vtkBoneProfiler::~vtkBoneProfiler()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkBoneProfiler* vtkBoneProfiler::GetGlobalProfiler()
+{
+  static vtkSmartPointer<vtkBoneProfiler> globalProfiler =
+    vtkSmartPointer<vtkBoneProfiler>::New();
+  return globalProfiler;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneProfiler::IsProfilingCompiledIn()
+{
+#ifdef VTK_BONE_WIDGET_ENABLE_PROFILING
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneProfiler::GetTime()
+{
+#if defined(_WIN32) || defined(WIN32)
+  static LARGE_INTEGER frequency;
+  static bool initialized = false;
+  if (!initialized)
+    {
+    QueryPerformanceFrequency(&frequency);
+    initialized = true;
+    }
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart)
+    / static_cast<double>(frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + 1e-9 * now.tv_nsec;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneProfiler::AddSample(int section, double time)
+{
+  if (section < 0 || section >= NumberOfSections)
+    {
+    return;
+    }
+
+  // Bin of the time in nanoseconds: bin i holds [2^(i-1), 2^i[
+  double nanoseconds = time * 1e9;
+  int bin = 0;
+  if (nanoseconds >= 1.0)
+    {
+    int exponent;
+    frexp(nanoseconds, &exponent);
+    bin = std::min(exponent, static_cast<int>(NumberOfBins) - 1);
+    }
+
+  if (this->Counts[section] == 0)
+    {
+    this->MinimumTimes[section] = this->MaximumTimes[section] = time;
+    }
+  else
+    {
+    this->MinimumTimes[section] = std::min(this->MinimumTimes[section], time);
+    this->MaximumTimes[section] = std::max(this->MaximumTimes[section], time);
+    }
+  ++this->Counts[section];
+  this->TotalTimes[section] += time;
+  ++this->Histograms[section][bin];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneProfiler::GetCount(int section)
+{
+  return this->Counts[section];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneProfiler::GetTotalTime(int section)
+{
+  return this->TotalTimes[section];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneProfiler::GetMeanTime(int section)
+{
+  return this->Counts[section] > 0 ?
+    this->TotalTimes[section] / this->Counts[section] : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneProfiler::GetMinimumTime(int section)
+{
+  return this->MinimumTimes[section];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneProfiler::GetMaximumTime(int section)
+{
+  return this->MaximumTimes[section];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneProfiler::GetHistogramBin(int section, int bin)
+{
+  return this->Histograms[section][bin];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneProfiler::GetBinUpperBound(int bin)
+{
+  return ldexp(1e-9, bin);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneProfiler::Reset()
+{
+  for (int i = 0; i < NumberOfSections; ++i)
+    {
+    this->Counts[i] = 0;
+    this->TotalTimes[i] = 0.0;
+    this->MinimumTimes[i] = 0.0;
+    this->MaximumTimes[i] = 0.0;
+    std::fill(this->Histograms[i], this->Histograms[i] + NumberOfBins, 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+const char* vtkBoneProfiler::GetSectionAsString(int section)
+{
+  switch (section)
+    {
+    case vtkBoneProfiler::RebuildRestTransform:
+      return "RebuildRestTransform";
+    case vtkBoneProfiler::RebuildPoseTransform:
+      return "RebuildPoseTransform";
+    case vtkBoneProfiler::RebuildLocalRestPoints:
+      return "RebuildLocalRestPoints";
+    case vtkBoneProfiler::RebuildLocalPosePoints:
+      return "RebuildLocalPosePoints";
+    case vtkBoneProfiler::RebuildAxes:
+      return "RebuildAxes";
+    case vtkBoneProfiler::RebuildParentageLink:
+      return "RebuildParentageLink";
+    case vtkBoneProfiler::RebuildCylinder:
+      return "RebuildCylinder";
+    case vtkBoneProfiler::RebuildCones:
+      return "RebuildCones";
+    case vtkBoneProfiler::BuildRepresentation:
+      return "BuildRepresentation";
+    case vtkBoneProfiler::ObserverDispatch:
+      return "ObserverDispatch";
+    default:
+      return "Unknown";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneProfiler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  for (int i = 0; i < NumberOfSections; ++i)
+    {
+    if (this->Counts[i] == 0)
+      {
+      continue;
+      }
+    os << indent << GetSectionAsString(i) << ": "
+       << this->Counts[i] << " calls, "
+       << this->TotalTimes[i] << " s total, "
+       << this->GetMeanTime(i) << " s mean, "
+       << this->MaximumTimes[i] << " s max\n";
+    }
+}
@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneProfiler_h
+#define __vtkBoneProfiler_h
+
+// .NAME vtkBoneProfiler - Counters and timing histograms of the bone code
+// .SECTION Description
+// vtkBoneProfiler counts and times the hot paths of the bone widgets and
+// of their representations (see SectionType). For each section, it keeps
+// the number of calls, the total, minimum and maximum times and a
+// histogram of the times with power of 2 bins (see GetBinUpperBound()).
+//
+// Every bone widget has its own profiler, shared with its representation,
+// and all the samples are also added to the global profiler.
+//
+// The instrumentation is only compiled in when the
+// VTK_BONE_WIDGET_ENABLE_PROFILING option is ON. Otherwise
+// vtkBoneProfileScopeMacro expands to nothing and the widgets have no
+// profiler: the profiling costs nothing.
+// .SECTION See Also
+// vtkBoneWidget vtkBoneRepresentation
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneProfiler : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneProfiler *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneProfiler, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  // Description:
+  // The profiled sections. BuildRepresentation does not include the
+  // RebuildCylinder and RebuildCones sections.
+  enum SectionType {RebuildRestTransform = 0,
+                    RebuildPoseTransform,
+                    RebuildLocalRestPoints,
+                    RebuildLocalPosePoints,
+                    RebuildAxes,
+                    RebuildParentageLink,
+                    RebuildCylinder,
+                    RebuildCones,
+                    BuildRepresentation,
+                    ObserverDispatch,
+                    NumberOfSections};
+  enum {NumberOfBins = 32};
+  //ETX
+
+  // Description:
+  // Profiler receiving the samples of all the bones.
+  static vtkBoneProfiler* GetGlobalProfiler();
+
+  // Description:
+  // Return 1 if the instrumentation is compiled in.
+  static int IsProfilingCompiledIn();
+
+  // Description:
+  // Add a timing sample (in seconds) to a section.
+  void AddSample(int section, double time);
+
+  // Description:
+  // Get the statistics of a section. The times are in seconds.
+  vtkIdType GetCount(int section);
+  double GetTotalTime(int section);
+  double GetMeanTime(int section);
+  double GetMinimumTime(int section);
+  double GetMaximumTime(int section);
+
+  // Description:
+  // Get the number of samples of a section in a histogram bin. The bin i
+  // holds the times in [GetBinUpperBound(i - 1), GetBinUpperBound(i)[,
+  // the last bin holds all the longer times.
+  vtkIdType GetHistogramBin(int section, int bin);
+
+  // Description:
+  // Upper bound of a histogram bin: 2^bin nanoseconds, in seconds.
+  static double GetBinUpperBound(int bin);
+
+  // Description:
+  // Forget all the samples.
+  void Reset();
+
+  // Description:
+  // Get the name of a section.
+  static const char* GetSectionAsString(int section);
+
+  // Description:
+  // High resolution monotonic clock, in seconds.
+  static double GetTime();
+
+protected:
+  vtkBoneProfiler();
+  ~vtkBoneProfiler();
+
+  vtkIdType Counts[NumberOfSections];
+  double    TotalTimes[NumberOfSections];
+  double    MinimumTimes[NumberOfSections];
+  double    MaximumTimes[NumberOfSections];
+  vtkIdType Histograms[NumberOfSections][NumberOfBins];
+
+private:
+  vtkBoneProfiler(const vtkBoneProfiler&);  //Not implemented
+  void operator=(const vtkBoneProfiler&);  //Not implemented
+};
+
+//BTX
+// Description:
+// Time the enclosing scope and add the sample to the given profiler (may
+// be NULL) and to the global profiler.
+class vtkBoneProfilerScope
+{
+public:
+  vtkBoneProfilerScope(vtkBoneProfiler* profiler, int section)
+    {
+    this->Profiler = profiler;
+    this->Section = section;
+    this->Start = vtkBoneProfiler::GetTime();
+    }
+  ~vtkBoneProfilerScope()
+    {
+    double time = vtkBoneProfiler::GetTime() - this->Start;
+    if (this->Profiler)
+      {
+      this->Profiler->AddSample(this->Section, time);
+      }
+    vtkBoneProfiler::GetGlobalProfiler()->AddSample(this->Section, time);
+    }
+
+private:
+  vtkBoneProfiler* Profiler;
+  int Section;
+  double Start;
+};
+//ETX
+
+#ifdef VTK_BONE_WIDGET_ENABLE_PROFILING
+# define vtkBoneProfileScopeMacro(profiler, section) \
+  vtkBoneProfilerScope vtkBoneProfilerScopeInstance( \
+    profiler, vtkBoneProfiler::section)
+#else
+# define vtkBoneProfileScopeMacro(profiler, section)
+#endif
+
+#endif
@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneRenderScheduler.h"
+
+//VTK Includes
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkTimerLog.h>
+
+//STL includes
+#include <cmath>
+
+vtkStandardNewMacro(vtkBoneRenderScheduler);
+
+//----------------------------------------------------------------------------
+vtkBoneRenderScheduler::vtkBoneRenderScheduler()
+{
+  this->MaximumFrameRate = 60.0;
+  this->RenderPending = 0;
+  this->NumberOfRequests = 0;
+  this->NumberOfRenders = 0;
+  this->LastRenderTime = 0.0;
+
+  this->Interactor = NULL;
+  this->TimerId = 0;
+  this->TimerObserverTag = 0;
+  this->TimerCallbackCommand = vtkCallbackCommand::New();
+  this->TimerCallbackCommand->SetClientData(this);
+  this->TimerCallbackCommand->SetCallback(
+    vtkBoneRenderScheduler::ProcessTimerEvent);
+}
+
+//----------------------------------------------------------------------------
+vtkBoneRenderScheduler::~vtkBoneRenderScheduler()
+{
+  this->CancelPendingRender();
+  this->TimerCallbackCommand->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRenderScheduler
+::RequestRender(vtkRenderWindowInteractor* interactor)
+{
+  ++this->NumberOfRequests;
+  if (!interactor)
+    {
+    return;
+    }
+
+  // Only the renders of a same interactor are merged
+  if (this->RenderPending && interactor != this->Interactor)
+    {
+    this->Flush();
+    }
+
+  double period =
+    this->MaximumFrameRate > 0.0 ? 1.0 / this->MaximumFrameRate : 0.0;
+  double wait =
+    this->LastRenderTime + period - vtkTimerLog::GetUniversalTime();
+  if (wait <= 0.0)
+    {
+    this->CancelPendingRender();
+    this->Render(interactor);
+    return;
+    }
+
+  if (this->RenderPending)
+    {
+    // Merged into the pending render
+    return;
+    }
+
+  // Without event loop, the timers would never expire: the render can
+  // not be delayed.
+  int timerId = 0;
+  if (interactor->GetInitialized())
+    {
+    unsigned long duration =
+      static_cast<unsigned long>(ceil(wait * 1000.0));
+    timerId = interactor->CreateOneShotTimer(duration);
+    }
+  if (timerId == 0)
+    {
+    this->Render(interactor);
+    return;
+    }
+
+  this->Interactor = interactor;
+  this->Interactor->Register(this);
+  this->RenderPending = 1;
+  this->TimerId = timerId;
+  this->TimerObserverTag =
+    this->Interactor->AddObserver(vtkCommand::TimerEvent,
+                                  this->TimerCallbackCommand);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRenderScheduler::Flush()
+{
+  if (!this->RenderPending)
+    {
+    return;
+    }
+
+  vtkRenderWindowInteractor* interactor = this->Interactor;
+  interactor->Register(this);
+  this->CancelPendingRender();
+  this->Render(interactor);
+  interactor->UnRegister(this);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRenderScheduler::ResetStatistics()
+{
+  this->NumberOfRequests = 0;
+  this->NumberOfRenders = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRenderScheduler::Render(vtkRenderWindowInteractor* interactor)
+{
+  this->LastRenderTime = vtkTimerLog::GetUniversalTime();
+  ++this->NumberOfRenders;
+  interactor->Render();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRenderScheduler::CancelPendingRender()
+{
+  if (this->Interactor)
+    {
+    if (this->TimerId != 0)
+      {
+      this->Interactor->DestroyTimer(this->TimerId);
+      this->Interactor->RemoveObserver(this->TimerObserverTag);
+      }
+    this->Interactor->UnRegister(this);
+    this->Interactor = NULL;
+    }
+  this->TimerId = 0;
+  this->RenderPending = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRenderScheduler::ProcessTimerEvent(vtkObject* vtkNotUsed(caller),
+                                               unsigned long vtkNotUsed(event),
+                                               void* clientdata,
+                                               void* calldata)
+{
+  vtkBoneRenderScheduler* self =
+    reinterpret_cast<vtkBoneRenderScheduler*>(clientdata);
+  if (self->TimerId == 0 || !calldata
+      || *static_cast<int*>(calldata) != self->TimerId)
+    {
+    return;
+    }
+
+  // The one shot timer is already gone
+  self->Interactor->RemoveObserver(self->TimerObserverTag);
+  self->TimerId = 0;
+  self->Flush();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRenderScheduler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumFrameRate: " << this->MaximumFrameRate << "\n";
+  os << indent << "RenderPending: " << this->RenderPending << "\n";
+  os << indent << "NumberOfRequests: " << this->NumberOfRequests << "\n";
+  os << indent << "NumberOfRenders: " << this->NumberOfRenders << "\n";
+}
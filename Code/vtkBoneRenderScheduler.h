@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneRenderScheduler_h
+#define __vtkBoneRenderScheduler_h
+
+// .NAME vtkBoneRenderScheduler - Merge and throttle the renders of bones
+// .SECTION Description
+// vtkBoneRenderScheduler caps the number of renders requested by the bone
+// widgets to MaximumFrameRate. A request received less than a frame period
+// after the last render is merged into a single pending render, run by a
+// one shot interactor timer at the end of the period. All the requests
+// received while a render is pending cost nothing.
+//
+// A scheduler is shared by all the bones of a skeleton with
+// vtkBoneSkeleton::SetRenderScheduler(). Without scheduler, the bones
+// render at each interaction like any other widget.
+//
+// If no timer can be created (e.g. the interactor is not initialized),
+// the requests are rendered immediately.
+// .SECTION See Also
+// vtkBoneSkeleton vtkBoneWidget
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+class vtkCallbackCommand;
+class vtkRenderWindowInteractor;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneRenderScheduler : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneRenderScheduler *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneRenderScheduler, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the maximum number of renders per second. Typically the
+  // refresh rate of the display. 0 disables the throttling.
+  // Default is 60.
+  vtkSetClampMacro(MaximumFrameRate, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(MaximumFrameRate, double);
+
+  // Description:
+  // Render the interactor now if the last render is older than a frame
+  // period, otherwise schedule a render at the end of the period unless
+  // one is already pending. Without timer, the interactor is rendered now.
+  void RequestRender(vtkRenderWindowInteractor* interactor);
+
+  // Description:
+  // Run the pending render now, if any.
+  void Flush();
+
+  // Description:
+  // Return 1 if a render is scheduled.
+  vtkGetMacro(RenderPending, int);
+
+  // Description:
+  // Number of render requests received and of renders actually done since
+  // the creation or the last call to ResetStatistics().
+  vtkGetMacro(NumberOfRequests, vtkIdType);
+  vtkGetMacro(NumberOfRenders, vtkIdType);
+  void ResetStatistics();
+
+protected:
+  vtkBoneRenderScheduler();
+  ~vtkBoneRenderScheduler();
+
+  double MaximumFrameRate;
+  int RenderPending;
+  vtkIdType NumberOfRequests;
+  vtkIdType NumberOfRenders;
+  double LastRenderTime;
+
+  // The interactor of the pending render and its timer
+  vtkRenderWindowInteractor* Interactor;
+  int TimerId;
+  unsigned long TimerObserverTag;
+  vtkCallbackCommand* TimerCallbackCommand;
+
+  void Render(vtkRenderWindowInteractor* interactor);
+  void CancelPendingRender();
+
+  static void ProcessTimerEvent(vtkObject* caller, unsigned long event,
+                                void* clientdata, void* calldata);
+
+private:
+  vtkBoneRenderScheduler(const vtkBoneRenderScheduler&);  //Not implemented
+  void operator=(const vtkBoneRenderScheduler&);  //Not implemented
+};
+
+#endif
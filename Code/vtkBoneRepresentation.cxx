@@ -20,6 +20,8 @@
 
 #include "vtkBoneRepresentation.h"
 
+#include "vtkBoneProfiler.h"
+
 #include <vtkActor.h>
 #include <vtkBox.h>
 #include <vtkCallbackCommand.h>
@@ -30,6 +32,7 @@
 #include <vtkLine.h>
 #include <vtkLineSource.h>
 #include <vtkMath.h>
+#include <vtkMatrix4x4.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointHandleRepresentation3D.h>
 #include <vtkPolyDataMapper.h>
@@ -39,18 +42,58 @@
 #include <vtkRenderer.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkVectorText.h>
+#include <vtkViewport.h>
 #include <vtkWindow.h>
 
+#include <algorithm>
+
 vtkStandardNewMacro(vtkBoneRepresentation);
 
 //----------------------------------------------------------------------------
 vtkBoneRepresentation::vtkBoneRepresentation()
 {
+  this->Profiler = NULL;
+  this->HandlesVisibility = 1;
+  this->LevelOfDetail = 0;
+  this->LinePixelThreshold = 8.0;
+  this->HiddenPixelThreshold = 1.0;
+  this->PixelsPerSide = 4.0;
+  this->UnitBoneMatrixBuilt = 0;
+  this->UnitBoneHead[0] = this->UnitBoneHead[1] = this->UnitBoneHead[2] = 0.0;
+  this->UnitBoneTail[0] = this->UnitBoneTail[1] = this->UnitBoneTail[2] = 0.0;
 }
 
 //----------------------------------------------------------------------------
 vtkBoneRepresentation::~vtkBoneRepresentation()
 {
+  this->SetProfiler(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRepresentation::SetProfiler(vtkBoneProfiler* profiler)
+{
+  if (profiler == this->Profiler)
+    {
+    return;
+    }
+
+  if (this->Profiler)
+    {
+    this->Profiler->UnRegister(this);
+    }
+  this->Profiler = profiler;
+  if (this->Profiler)
+    {
+    this->Profiler->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneRepresentation::BuildRepresentation()
+{
+  vtkBoneProfileScopeMacro(this->Profiler, BuildRepresentation);
+  this->Superclass::BuildRepresentation();
 }
 
 //----------------------------------------------------------------------
@@ -147,8 +190,138 @@ vtkPointHandleRepresentation3D* vtkBoneRepresentation::GetTailRepresentation()
   return this->GetPoint2Representation();
 }
 
+//----------------------------------------------------------------------
+void vtkBoneRepresentation::GetUnitBoneMatrix(vtkMatrix4x4* matrix)
+{
+  double head[3], tail[3], direction[3];
+  this->GetHeadWorldPosition(head);
+  this->GetTailWorldPosition(tail);
+  vtkMath::Subtract(tail, head, direction);
+  double length = vtkMath::Normalize(direction);
+
+  for (int i = 0; i < 3; ++i)
+    {
+    this->UnitBoneHead[i] = head[i];
+    this->UnitBoneTail[i] = tail[i];
+    }
+  this->UnitBoneMatrixBuilt = 1;
+
+  // Shortest rotation of X onto the direction (Rodrigues formula with
+  // v = X x direction and c = X . direction):
+  // R = I + [v]x + [v]x^2 / (1 + c)
+  double rotation[3][3];
+  vtkMath::Identity3x3(rotation);
+  if (length <= 0.0)
+    {
+    // Degenerated bone, the scale collapses the mesh anyway
+    }
+  else if (direction[0] < -1.0 + 1e-12)
+    {
+    // Half turn around Z
+    rotation[0][0] = -1.0;
+    rotation[1][1] = -1.0;
+    }
+  else
+    {
+    double v[3] = {0.0, -direction[2], direction[1]};
+    double k = 1.0 / (1.0 + direction[0]);
+    double skew[3][3] = {{0.0, -v[2], v[1]},
+                         {v[2], 0.0, -v[0]},
+                         {-v[1], v[0], 0.0}};
+    double skew2[3][3];
+    vtkMath::Multiply3x3(skew, skew, skew2);
+    for (int i = 0; i < 3; ++i)
+      {
+      for (int j = 0; j < 3; ++j)
+        {
+        rotation[i][j] += skew[i][j] + k * skew2[i][j];
+        }
+      }
+    }
+
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      matrix->SetElement(i, j, length * rotation[i][j]);
+      }
+    matrix->SetElement(i, 3, head[i]);
+    matrix->SetElement(3, i, 0.0);
+    }
+  matrix->SetElement(3, 3, 1.0);
+}
+
+//----------------------------------------------------------------------
+int vtkBoneRepresentation::UnitBoneMatrixNeedsUpdate()
+{
+  if (!this->UnitBoneMatrixBuilt)
+    {
+    return 1;
+    }
+
+  double head[3], tail[3];
+  this->GetHeadWorldPosition(head);
+  this->GetTailWorldPosition(tail);
+  return head[0] != this->UnitBoneHead[0]
+    || head[1] != this->UnitBoneHead[1]
+    || head[2] != this->UnitBoneHead[2]
+    || tail[0] != this->UnitBoneTail[0]
+    || tail[1] != this->UnitBoneTail[1]
+    || tail[2] != this->UnitBoneTail[2];
+}
+
+//----------------------------------------------------------------------
+int vtkBoneRepresentation
+::ComputeLevelOfDetail(vtkViewport* viewport, int maximumNumberOfSides)
+{
+  if (!this->LevelOfDetail || !viewport)
+    {
+    return maximumNumberOfSides;
+    }
+
+  double head[3], tail[3], headDisplay[3], tailDisplay[3];
+  this->GetHeadWorldPosition(head);
+  this->GetTailWorldPosition(tail);
+  viewport->SetWorldPoint(head[0], head[1], head[2], 1.0);
+  viewport->WorldToDisplay();
+  viewport->GetDisplayPoint(headDisplay);
+  viewport->SetWorldPoint(tail[0], tail[1], tail[2], 1.0);
+  viewport->WorldToDisplay();
+  viewport->GetDisplayPoint(tailDisplay);
+  double pixels = sqrt(
+    (tailDisplay[0] - headDisplay[0]) * (tailDisplay[0] - headDisplay[0])
+    + (tailDisplay[1] - headDisplay[1]) * (tailDisplay[1] - headDisplay[1]));
+
+  if (pixels < this->HiddenPixelThreshold)
+    {
+    return -1;
+    }
+  if (pixels < this->LinePixelThreshold)
+    {
+    return 0;
+    }
+
+  // The radius of the meshes is a tenth of the bone length
+  double circumference = 2.0 * vtkMath::Pi() * 0.1 * pixels;
+  int numberOfSides = 3;
+  while (numberOfSides < maximumNumberOfSides
+         && numberOfSides * this->PixelsPerSide < circumference)
+    {
+    numberOfSides *= 2;
+    }
+  return std::min(numberOfSides, maximumNumberOfSides);
+}
+
 //----------------------------------------------------------------------
 void vtkBoneRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Profiler: " << this->Profiler << "\n";
+  os << indent << "HandlesVisibility: " << this->HandlesVisibility << "\n";
+  os << indent << "LevelOfDetail: " << this->LevelOfDetail << "\n";
+  os << indent << "LinePixelThreshold: " << this->LinePixelThreshold << "\n";
+  os << indent << "HiddenPixelThreshold: "
+     << this->HiddenPixelThreshold << "\n";
+  os << indent << "PixelsPerSide: " << this->PixelsPerSide << "\n";
 }
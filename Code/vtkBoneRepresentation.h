@@ -26,7 +26,10 @@
 #include "vtkLineRepresentation.h"
 #include "vtkBoneWidgetHeader.h"
 
+class vtkBoneProfiler;
+class vtkMatrix4x4;
 class vtkPointHandleRepresentation3D;
+class vtkViewport;
 
 class VTK_BONEWIDGETS_EXPORT vtkBoneRepresentation : public vtkLineRepresentation
 {
@@ -67,10 +70,87 @@ public:
     this->HighlightPoint(1, highlight);
     }
 
+  // Description:
+  // Build the line and the handles.
+  virtual void BuildRepresentation();
+
+  // Description:
+  // Set/Get the profiler the representation reports its timings to.
+  // The bone widget gives its own profiler to its representation.
+  // See vtkBoneProfiler.
+  void SetProfiler(vtkBoneProfiler* profiler);
+  vtkGetObjectMacro(Profiler, vtkBoneProfiler);
+
+  // Description:
+  // Return 0 if the head and tail handle representations must not be
+  // rendered by the bone widget handles, e.g. when the representation
+  // draws the bone by other means. Default is 1.
+  vtkGetMacro(HandlesVisibility, int);
+
+  // Description:
+  // Set/Get the automatic level of detail of the bone geometry. When on,
+  // the representations drawing a mesh (cylinder, double cone) pick its
+  // number of sides from the length of the bone on screen instead of
+  // always using NumberOfSides, which becomes the maximum. Default is off.
+  vtkSetMacro(LevelOfDetail, int);
+  vtkGetMacro(LevelOfDetail, int);
+  vtkBooleanMacro(LevelOfDetail, int);
+
+  // Description:
+  // Set/Get the length on screen, in pixels, under which only the line of
+  // the bone is drawn. Default is 8.
+  vtkSetClampMacro(LinePixelThreshold, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(LinePixelThreshold, double);
+
+  // Description:
+  // Set/Get the length on screen, in pixels, under which nothing is drawn.
+  // Default is 1.
+  vtkSetClampMacro(HiddenPixelThreshold, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(HiddenPixelThreshold, double);
+
+  // Description:
+  // Set/Get the target length on screen, in pixels, of the sides of the
+  // mesh. Default is 4.
+  vtkSetClampMacro(PixelsPerSide, double, 1.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(PixelsPerSide, double);
+
+  // Description:
+  // Return the number of sides of the bone mesh for its length in the
+  // viewport: -1 if nothing is drawn, 0 if only the line is drawn and
+  // between 3 and maximumNumberOfSides otherwise. The levels are
+  // 3 * 2^k sides, so that few meshes are cached. Without level of
+  // detail, return maximumNumberOfSides.
+  int ComputeLevelOfDetail(vtkViewport* viewport, int maximumNumberOfSides);
+
 protected:
   vtkBoneRepresentation();
   ~vtkBoneRepresentation();
 
+  vtkBoneProfiler* Profiler;
+  int HandlesVisibility;
+  int LevelOfDetail;
+  double LinePixelThreshold;
+  double HiddenPixelThreshold;
+  double PixelsPerSide;
+
+  // Description:
+  // Fill the matrix placing a unit bone, along X from 0 to 1, onto the
+  // bone: rotation of X onto the head to tail direction, uniform scale by
+  // the bone length and translation to the head. The representations
+  // drawing a fixed mesh only update their actor with it when the bone
+  // moves.
+  void GetUnitBoneMatrix(vtkMatrix4x4* matrix);
+
+  // Description:
+  // Return 1 if the head or the tail moved since the last call to
+  // GetUnitBoneMatrix(). The geometry placed with the unit bone matrix
+  // does not depend on the camera: it only needs an update then.
+  int UnitBoneMatrixNeedsUpdate();
+
+  int UnitBoneMatrixBuilt;
+  double UnitBoneHead[3];
+  double UnitBoneTail[3];
+
 private:
   vtkBoneRepresentation(const vtkBoneRepresentation&);  //Not implemented
   void operator=(const vtkBoneRepresentation&);  //Not implemented
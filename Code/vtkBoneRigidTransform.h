@@ -0,0 +1,40 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneRigidTransform_h
+#define __vtkBoneRigidTransform_h
+
+// .NAME vtkBoneRigidTransform - Lightweight rotation plus translation
+// .SECTION Description
+// vtkBoneRigidTransform is a small value type holding a rigid transform
+// as a unit quaternion (w, x, y, z) and a translation. A point p is
+// transformed into R*p + T.
+// Unlike vtkTransform, it is not a vtkObject: it lives on the stack, has no
+// matrix, no concatenation and no modified time. It is meant for the bone
+// computations that apply a single rotation and translation.
+// It is the double precision instantiation of vtkBoneRigidMotion.
+// .SECTION See Also
+// vtkBoneWidget vtkTransform vtkBoneMath.h
+
+#include "vtkBoneMath.h"
+
+typedef vtkBoneRigidMotion<double> vtkBoneRigidTransform;
+
+#endif
@@ -0,0 +1,776 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneSessionRecorder.h"
+
+//My includes
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkCallbackCommand.h>
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+//STL includes
+#include <cmath>
+#include <fstream>
+#include <string>
+
+vtkStandardNewMacro(vtkBoneSessionRecorder);
+
+namespace
+{
+
+// The recorded events, in the order of their type in the file
+const unsigned long RecordedEventIds[] =
+  {
+  vtkCommand::LeftButtonPressEvent,
+  vtkCommand::MouseMoveEvent,
+  vtkCommand::LeftButtonReleaseEvent
+  };
+const int NumberOfRecordedEvents =
+  sizeof(RecordedEventIds) / sizeof(unsigned long);
+
+// Position, focal point, view up, parallel scale, view angle and
+// parallel projection
+const int CameraSize = 12;
+
+const char* FileHeader = "vtkBoneSession";
+const int FileVersion = 1;
+
+int GetEventType(unsigned long eventId)
+{
+  for (int i = 0; i < NumberOfRecordedEvents; ++i)
+    {
+    if (RecordedEventIds[i] == eventId)
+      {
+      return i;
+      }
+    }
+  return -1;
+}
+
+bool CompareQuaternions(const double* quad1, const double* quad2,
+                        double tolerance)
+{
+  // q and -q are the same rotation
+  bool same = true;
+  bool opposite = true;
+  for (int i = 0; i < 4; ++i)
+    {
+    same = same && fabs(quad1[i] - quad2[i]) <= tolerance;
+    opposite = opposite && fabs(quad1[i] + quad2[i]) <= tolerance;
+    }
+  return same || opposite;
+}
+
+// Read a keyword followed by a count, e.g. "bones 3"
+bool ReadSection(std::istream& is, const char* keyword, size_t& count)
+{
+  std::string word;
+  return (is >> word >> count) && word == keyword;
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBoneSessionRecorder::vtkBoneSessionRecorder()
+{
+  this->Interactor = NULL;
+  this->Renderer = NULL;
+  this->Skeleton = NULL;
+
+  this->EventCallbackCommand = vtkCallbackCommand::New();
+  this->EventCallbackCommand->SetClientData(this);
+  this->EventCallbackCommand->SetCallback(
+    vtkBoneSessionRecorder::ProcessEvents);
+
+  this->Recording = 0;
+  this->Tolerance = 1e-6;
+  this->CameraTime = 0;
+  this->WindowSize[0] = this->WindowSize[1] = 0;
+  this->ReplayTime = 0.0;
+  this->NumberOfMismatchedBones = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneSessionRecorder::~vtkBoneSessionRecorder()
+{
+  this->StopRecording();
+  this->SetInteractor(NULL);
+  this->SetRenderer(NULL);
+  this->SetSkeleton(NULL);
+  this->EventCallbackCommand->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder
+::SetInteractor(vtkRenderWindowInteractor* interactor)
+{
+  if (interactor == this->Interactor)
+    {
+    return;
+    }
+
+  this->StopRecording();
+  if (this->Interactor)
+    {
+    this->Interactor->UnRegister(this);
+    }
+  this->Interactor = interactor;
+  if (this->Interactor)
+    {
+    this->Interactor->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::SetRenderer(vtkRenderer* renderer)
+{
+  if (renderer == this->Renderer)
+    {
+    return;
+    }
+
+  if (this->Renderer)
+    {
+    this->Renderer->UnRegister(this);
+    }
+  this->Renderer = renderer;
+  if (this->Renderer)
+    {
+    this->Renderer->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::SetSkeleton(vtkBoneSkeleton* skeleton)
+{
+  if (skeleton == this->Skeleton)
+    {
+    return;
+    }
+
+  this->StopRecording();
+  if (this->Skeleton)
+    {
+    this->Skeleton->UnRegister(this);
+    }
+  this->Skeleton = skeleton;
+  if (this->Skeleton)
+    {
+    this->Skeleton->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::ClearRecording()
+{
+  this->ParentIds.clear();
+  this->Flags.clear();
+  this->RestPositions.clear();
+  this->InitialPoseTransforms.clear();
+  this->WindowSize[0] = this->WindowSize[1] = 0;
+  this->Events.clear();
+  this->CameraEvents.clear();
+  this->Cameras.clear();
+  this->StateChanges.clear();
+  this->FinalRestTransforms.clear();
+  this->FinalPoseTransforms.clear();
+  this->EventTimes.clear();
+  this->ReplayTime = 0.0;
+  this->NumberOfMismatchedBones = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::StartRecording()
+{
+  if (!this->Interactor || !this->Skeleton)
+    {
+    vtkErrorMacro("An interactor and a skeleton are needed to record.");
+    return;
+    }
+
+  this->StopRecording();
+  this->ClearRecording();
+
+  vtkIdType numberOfBones = this->Skeleton->GetNumberOfBones();
+  this->CurrentStates.resize(numberOfBones);
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    vtkBoneWidget* bone = this->Skeleton->GetBone(i);
+    double* head = bone->GetHeadRestWorldPosition();
+    double* tail = bone->GetTailRestWorldPosition();
+    double* poseTransform = this->Skeleton->GetPoseTransform(i);
+
+    this->ParentIds.push_back(this->Skeleton->GetBoneParentId(i));
+    this->Flags.push_back(bone->GetWidgetState());
+    this->Flags.push_back(bone->GetHeadLinkedToParent());
+    this->RestPositions.insert(this->RestPositions.end(), head, head + 3);
+    this->RestPositions.insert(this->RestPositions.end(), tail, tail + 3);
+    this->InitialPoseTransforms.insert(this->InitialPoseTransforms.end(),
+                                       poseTransform, poseTransform + 4);
+    this->CurrentStates[i] = bone->GetWidgetState();
+    }
+
+  vtkRenderWindow* renderWindow = this->Interactor->GetRenderWindow();
+  if (renderWindow)
+    {
+    this->WindowSize[0] = renderWindow->GetSize()[0];
+    this->WindowSize[1] = renderWindow->GetSize()[1];
+    }
+
+  // Record the events before the widgets, they may abort them
+  this->CameraTime = 0;
+  for (int i = 0; i < NumberOfRecordedEvents; ++i)
+    {
+    this->Interactor->AddObserver(RecordedEventIds[i],
+                                  this->EventCallbackCommand, 10.0);
+    }
+  this->Recording = 1;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::StopRecording()
+{
+  if (!this->Recording)
+    {
+    return;
+    }
+
+  this->Interactor->RemoveObserver(this->EventCallbackCommand);
+  this->Recording = 0;
+
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+  if (this->Skeleton->GetNumberOfBones() != numberOfBones)
+    {
+    vtkErrorMacro("Bones were added or removed during the recording.");
+    this->ClearRecording();
+    return;
+    }
+
+  if (numberOfBones > 0)
+    {
+    this->FinalRestTransforms.assign(this->Skeleton->GetRestTransforms(),
+      this->Skeleton->GetRestTransforms() + 4*numberOfBones);
+    this->FinalPoseTransforms.assign(this->Skeleton->GetPoseTransforms(),
+      this->Skeleton->GetPoseTransforms() + 4*numberOfBones);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::ProcessEvents(vtkObject* vtkNotUsed(caller),
+                                           unsigned long event,
+                                           void* clientdata,
+                                           void* vtkNotUsed(calldata))
+{
+  vtkBoneSessionRecorder* self =
+    reinterpret_cast<vtkBoneSessionRecorder*>(clientdata);
+  self->RecordEvent(event);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::RecordEvent(unsigned long eventId)
+{
+  int eventType = GetEventType(eventId);
+  if (eventType < 0)
+    {
+    return;
+    }
+  int event = static_cast<int>(this->GetNumberOfEvents());
+
+  vtkCamera* camera =
+    this->Renderer ? this->Renderer->GetActiveCamera() : NULL;
+  if (camera && camera->GetMTime() != this->CameraTime)
+    {
+    this->CameraTime = camera->GetMTime();
+    this->CameraEvents.push_back(event);
+    this->Cameras.resize(this->Cameras.size() + CameraSize);
+    this->SaveCamera(&this->Cameras[this->Cameras.size() - CameraSize]);
+    }
+
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+  for (vtkIdType i = 0;
+       i < numberOfBones && i < this->Skeleton->GetNumberOfBones(); ++i)
+    {
+    int state = this->Skeleton->GetBone(i)->GetWidgetState();
+    if (state != this->CurrentStates[i])
+      {
+      this->StateChanges.push_back(event);
+      this->StateChanges.push_back(static_cast<int>(i));
+      this->StateChanges.push_back(state);
+      this->CurrentStates[i] = state;
+      }
+    }
+
+  int* position = this->Interactor->GetEventPosition();
+  this->Events.push_back(eventType);
+  this->Events.push_back(position[0]);
+  this->Events.push_back(position[1]);
+  this->Events.push_back(this->Interactor->GetControlKey());
+  this->Events.push_back(this->Interactor->GetShiftKey());
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::SaveCamera(double* values)
+{
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+  camera->GetPosition(values);
+  camera->GetFocalPoint(values + 3);
+  camera->GetViewUp(values + 6);
+  values[9] = camera->GetParallelScale();
+  values[10] = camera->GetViewAngle();
+  values[11] = camera->GetParallelProjection();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::RestoreCamera(const double* values)
+{
+  if (!this->Renderer)
+    {
+    return;
+    }
+
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+  camera->SetPosition(values);
+  camera->SetFocalPoint(values + 3);
+  camera->SetViewUp(values + 6);
+  camera->SetParallelScale(values[9]);
+  camera->SetViewAngle(values[10]);
+  camera->SetParallelProjection(static_cast<int>(values[11]));
+  this->Renderer->ResetCameraClippingRange();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneSessionRecorder::GetNumberOfBones()
+{
+  return static_cast<vtkIdType>(this->ParentIds.size());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneSessionRecorder::GetNumberOfEvents()
+{
+  return static_cast<vtkIdType>(this->Events.size() / 5);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkBoneSessionRecorder::GetEventId(vtkIdType event)
+{
+  return RecordedEventIds[this->Events[5*event]];
+}
+
+//----------------------------------------------------------------------------
+double vtkBoneSessionRecorder::GetEventTime(vtkIdType event)
+{
+  if (event < 0 || event >= static_cast<vtkIdType>(this->EventTimes.size()))
+    {
+    return 0.0;
+    }
+  return this->EventTimes[event];
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneSessionRecorder::Write(const char* fileName)
+{
+  if (this->Recording)
+    {
+    vtkErrorMacro("Stop recording before writing the session.");
+    return 0;
+    }
+
+  std::ofstream file(fileName);
+  if (!file)
+    {
+    vtkErrorMacro("Could not open " << fileName);
+    return 0;
+    }
+
+  // Enough digits for the doubles to be read back exactly
+  file.precision(17);
+  file << FileHeader << " " << FileVersion << "\n";
+  file << "window " << this->WindowSize[0] << " " << this->WindowSize[1]
+       << "\n";
+
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+  file << "bones " << numberOfBones << "\n";
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    file << this->ParentIds[i] << " " << this->Flags[2*i] << " "
+         << this->Flags[2*i + 1];
+    for (int j = 0; j < 6; ++j)
+      {
+      file << " " << this->RestPositions[6*i + j];
+      }
+    for (int j = 0; j < 4; ++j)
+      {
+      file << " " << this->InitialPoseTransforms[4*i + j];
+      }
+    file << "\n";
+    }
+
+  file << "cameras " << this->CameraEvents.size() << "\n";
+  for (size_t i = 0; i < this->CameraEvents.size(); ++i)
+    {
+    file << this->CameraEvents[i];
+    for (int j = 0; j < CameraSize; ++j)
+      {
+      file << " " << this->Cameras[CameraSize*i + j];
+      }
+    file << "\n";
+    }
+
+  file << "states " << this->StateChanges.size() / 3 << "\n";
+  for (size_t i = 0; i < this->StateChanges.size(); i += 3)
+    {
+    file << this->StateChanges[i] << " " << this->StateChanges[i + 1] << " "
+         << this->StateChanges[i + 2] << "\n";
+    }
+
+  file << "events " << this->GetNumberOfEvents() << "\n";
+  for (size_t i = 0; i < this->Events.size(); i += 5)
+    {
+    file << this->Events[i] << " " << this->Events[i + 1] << " "
+         << this->Events[i + 2] << " " << this->Events[i + 3] << " "
+         << this->Events[i + 4] << "\n";
+    }
+
+  file << "final " << this->FinalRestTransforms.size() / 4 << "\n";
+  for (size_t i = 0; i < this->FinalRestTransforms.size(); i += 4)
+    {
+    for (int j = 0; j < 4; ++j)
+      {
+      file << this->FinalRestTransforms[i + j] << " ";
+      }
+    for (int j = 0; j < 4; ++j)
+      {
+      file << this->FinalPoseTransforms[i + j] << (j < 3 ? " " : "\n");
+      }
+    }
+
+  return file ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneSessionRecorder::Read(const char* fileName)
+{
+  this->StopRecording();
+  this->ClearRecording();
+
+  std::ifstream file(fileName);
+  if (!file)
+    {
+    vtkErrorMacro("Could not open " << fileName);
+    return 0;
+    }
+
+  std::string header;
+  int version = 0;
+  std::string window;
+  if (!(file >> header >> version) || header != FileHeader
+      || version != FileVersion
+      || !(file >> window >> this->WindowSize[0] >> this->WindowSize[1])
+      || window != "window")
+    {
+    vtkErrorMacro("Not a bone session file: " << fileName);
+    return 0;
+    }
+
+  bool valid = true;
+  size_t count = 0;
+  valid = ReadSection(file, "bones", count);
+  this->ParentIds.resize(valid ? count : 0);
+  this->Flags.resize(2*this->ParentIds.size());
+  this->RestPositions.resize(6*this->ParentIds.size());
+  this->InitialPoseTransforms.resize(4*this->ParentIds.size());
+  for (size_t i = 0; valid && i < this->ParentIds.size(); ++i)
+    {
+    valid = file >> this->ParentIds[i] >> this->Flags[2*i]
+                 >> this->Flags[2*i + 1];
+    for (int j = 0; valid && j < 6; ++j)
+      {
+      valid = file >> this->RestPositions[6*i + j];
+      }
+    for (int j = 0; valid && j < 4; ++j)
+      {
+      valid = file >> this->InitialPoseTransforms[4*i + j];
+      }
+    }
+
+  valid = valid && ReadSection(file, "cameras", count);
+  this->CameraEvents.resize(valid ? count : 0);
+  this->Cameras.resize(CameraSize*this->CameraEvents.size());
+  for (size_t i = 0; valid && i < this->CameraEvents.size(); ++i)
+    {
+    valid = file >> this->CameraEvents[i];
+    for (int j = 0; valid && j < CameraSize; ++j)
+      {
+      valid = file >> this->Cameras[CameraSize*i + j];
+      }
+    }
+
+  valid = valid && ReadSection(file, "states", count);
+  this->StateChanges.resize(valid ? 3*count : 0);
+  for (size_t i = 0; valid && i < this->StateChanges.size(); ++i)
+    {
+    valid = file >> this->StateChanges[i];
+    }
+
+  valid = valid && ReadSection(file, "events", count);
+  this->Events.resize(valid ? 5*count : 0);
+  for (size_t i = 0; valid && i < this->Events.size(); ++i)
+    {
+    valid = file >> this->Events[i];
+    if (valid && i % 5 == 0)
+      {
+      valid = this->Events[i] >= 0
+        && this->Events[i] < NumberOfRecordedEvents;
+      }
+    }
+
+  valid = valid && ReadSection(file, "final", count)
+    && count == this->ParentIds.size();
+  this->FinalRestTransforms.resize(valid ? 4*count : 0);
+  this->FinalPoseTransforms.resize(this->FinalRestTransforms.size());
+  for (size_t i = 0; valid && i < this->FinalRestTransforms.size(); i += 4)
+    {
+    for (int j = 0; valid && j < 4; ++j)
+      {
+      valid = file >> this->FinalRestTransforms[i + j];
+      }
+    for (int j = 0; valid && j < 4; ++j)
+      {
+      valid = file >> this->FinalPoseTransforms[i + j];
+      }
+    }
+
+  if (!valid)
+    {
+    vtkErrorMacro("Truncated or corrupted bone session file: " << fileName);
+    this->ClearRecording();
+    return 0;
+    }
+
+  this->Modified();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneSkeleton* vtkBoneSessionRecorder::BuildSkeleton()
+{
+  if (!this->Interactor)
+    {
+    vtkErrorMacro("An interactor is needed to create the bones.");
+    return NULL;
+    }
+
+  // The skeleton does not hold its bones
+  this->BuiltBones.clear();
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    vtkSmartPointer<vtkBoneWidget> bone =
+      vtkSmartPointer<vtkBoneWidget>::New();
+    bone->SetInteractor(this->Interactor);
+    bone->SetCurrentRenderer(this->Renderer);
+    bone->CreateDefaultRepresentation();
+    bone->SetWidgetStateToRest();
+    skeleton->AddBone(bone);
+    this->BuiltBones.push_back(bone);
+    }
+
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    if (this->ParentIds[i] >= 0)
+      {
+      vtkBoneWidget* bone = skeleton->GetBone(i);
+      bone->SetBoneParent(skeleton->GetBone(this->ParentIds[i]));
+      bone->SetHeadLinkedToParent(this->Flags[2*i + 1]);
+      }
+    }
+
+  this->SetSkeleton(skeleton);
+  this->RestoreInitialState();
+
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    skeleton->GetBone(i)->On();
+    }
+  return this->Skeleton;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneSessionRecorder::RestoreInitialState()
+{
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+  if (!this->Skeleton || this->Skeleton->GetNumberOfBones() != numberOfBones)
+    {
+    vtkErrorMacro("The skeleton does not match the recording.");
+    return 0;
+    }
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    if (this->Skeleton->GetBoneParentId(i) != this->ParentIds[i])
+      {
+      vtkErrorMacro("The parentage of the skeleton does not match the "
+                    "recording.");
+      return 0;
+      }
+    }
+  if (numberOfBones == 0)
+    {
+    return 1;
+    }
+
+  // Rest positions, parents before children so that the linked heads
+  // end up where they were recorded.
+  vtkIdType* order = this->Skeleton->GetTopologicalOrder();
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    this->Skeleton->GetBone(order[i])->SetWidgetStateToRest();
+    }
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    vtkIdType id = order[i];
+    vtkBoneWidget* bone = this->Skeleton->GetBone(id);
+    bone->SetHeadRestWorldPosition(&this->RestPositions[6*id]);
+    bone->SetTailRestWorldPosition(&this->RestPositions[6*id + 3]);
+    }
+
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    this->Skeleton->GetBone(i)->SetWidgetState(this->Flags[2*i]);
+    }
+  this->Skeleton->SetPoseTransforms(&this->InitialPoseTransforms[0]);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneSessionRecorder::Replay()
+{
+  this->EventTimes.clear();
+  this->ReplayTime = 0.0;
+  this->NumberOfMismatchedBones = 0;
+
+  if (this->Recording)
+    {
+    vtkErrorMacro("Stop recording before replaying the session.");
+    return 0;
+    }
+  if (!this->Interactor)
+    {
+    vtkErrorMacro("An interactor is needed to replay the session.");
+    return 0;
+    }
+  if (!this->RestoreInitialState())
+    {
+    return 0;
+    }
+
+  vtkRenderWindow* renderWindow = this->Interactor->GetRenderWindow();
+  if (renderWindow && this->WindowSize[0] > 0 && this->WindowSize[1] > 0)
+    {
+    renderWindow->SetSize(this->WindowSize[0], this->WindowSize[1]);
+    }
+  if (!this->Interactor->GetEnabled())
+    {
+    // Dispatch the events without starting the event loop
+    this->Interactor->Enable();
+    }
+  this->Interactor->Render();
+
+  vtkIdType numberOfEvents = this->GetNumberOfEvents();
+  this->EventTimes.resize(numberOfEvents);
+  size_t camera = 0;
+  size_t stateChange = 0;
+  for (vtkIdType event = 0; event < numberOfEvents; ++event)
+    {
+    bool cameraChanged = false;
+    for (; camera < this->CameraEvents.size()
+         && this->CameraEvents[camera] == event; ++camera)
+      {
+      this->RestoreCamera(&this->Cameras[CameraSize*camera]);
+      cameraChanged = true;
+      }
+    if (cameraChanged)
+      {
+      // The representations are placed in display coordinates on render
+      this->Interactor->Render();
+      }
+    for (; stateChange < this->StateChanges.size()
+         && this->StateChanges[stateChange] == event; stateChange += 3)
+      {
+      this->Skeleton->GetBone(this->StateChanges[stateChange + 1])
+        ->SetWidgetState(this->StateChanges[stateChange + 2]);
+      }
+
+    const int* values = &this->Events[5*event];
+    this->Interactor->SetEventInformation(values[1], values[2],
+                                          values[3], values[4]);
+    double start = vtkTimerLog::GetCPUTime();
+    this->Interactor->InvokeEvent(RecordedEventIds[values[0]], NULL);
+    this->EventTimes[event] = vtkTimerLog::GetCPUTime() - start;
+    this->ReplayTime += this->EventTimes[event];
+    }
+
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    if (!CompareQuaternions(this->Skeleton->GetRestTransform(i),
+                            &this->FinalRestTransforms[4*i], this->Tolerance)
+        || !CompareQuaternions(this->Skeleton->GetPoseTransform(i),
+                               &this->FinalPoseTransforms[4*i],
+                               this->Tolerance))
+      {
+      ++this->NumberOfMismatchedBones;
+      }
+    }
+  return this->NumberOfMismatchedBones == 0 ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSessionRecorder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Interactor: " << this->Interactor << "\n";
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  os << indent << "Skeleton: " << this->Skeleton << "\n";
+  os << indent << "Recording: " << this->Recording << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "Number Of Bones: " << this->GetNumberOfBones() << "\n";
+  os << indent << "Number Of Events: " << this->GetNumberOfEvents() << "\n";
+  os << indent << "Replay Time: " << this->ReplayTime << "\n";
+  os << indent << "Number Of Mismatched Bones: "
+     << this->NumberOfMismatchedBones << "\n";
+}
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneSessionRecorder_h
+#define __vtkBoneSessionRecorder_h
+
+// .NAME vtkBoneSessionRecorder - Record and replay bone editing sessions
+// .SECTION Description
+// vtkBoneSessionRecorder captures the mouse events handled by the bone
+// widgets (LeftButtonPressEvent, MouseMoveEvent, LeftButtonReleaseEvent)
+// on an interactor while a skeleton is edited, together with:
+// - the state of the skeleton when the recording starts (parentage, rest
+// positions, widget states and pose transforms),
+// - the camera of the renderer, each time it changed between two events,
+// - the widget state changes made by the application (e.g. switching the
+// bones to pose mode from a key press),
+// - the final rest and pose transforms of every bone.
+//
+// The session is saved in a compact text file, one line per event.
+//
+// Replay() restores the initial state and the cameras and invokes the
+// events on the interactor at full speed, so the session runs through
+// the same widget code (vtkBoneWidget::AddPointAction(), MoveAction()
+// and EndSelectAction()). The CPU time of each event is measured and the
+// final transforms of the bones are compared with the recorded ones.
+// This turns editing sessions into reproducible benchmarks.
+//
+// To replay, the interactor must be attached to a render window of the
+// recorded size and the skeleton must have the recorded parentage, e.g.
+// created with BuildSkeleton().
+// .SECTION See Also
+// vtkBoneSkeleton vtkBoneWidget
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vtkSmartPointer.h>
+
+#include <vector>
+//ETX
+
+class vtkBoneSkeleton;
+class vtkBoneWidget;
+class vtkCallbackCommand;
+class vtkRenderer;
+class vtkRenderWindowInteractor;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneSessionRecorder : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneSessionRecorder *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneSessionRecorder, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the interactor the events are recorded from and replayed on.
+  void SetInteractor(vtkRenderWindowInteractor* interactor);
+  vtkGetObjectMacro(Interactor, vtkRenderWindowInteractor);
+
+  // Description:
+  // Set/Get the renderer whose active camera is recorded and restored.
+  void SetRenderer(vtkRenderer* renderer);
+  vtkGetObjectMacro(Renderer, vtkRenderer);
+
+  // Description:
+  // Set/Get the skeleton edited during the session.
+  void SetSkeleton(vtkBoneSkeleton* skeleton);
+  vtkGetObjectMacro(Skeleton, vtkBoneSkeleton);
+
+  // Description:
+  // Start recording: the previous recording is discarded and the state
+  // of the skeleton is captured.
+  void StartRecording();
+
+  // Description:
+  // Stop recording: the final transforms of the bones are captured.
+  void StopRecording();
+
+  // Description:
+  // Return 1 if the recorder is recording.
+  vtkGetMacro(Recording, int);
+
+  // Description:
+  // Save/Load the recording. Return 1 on success.
+  int Write(const char* fileName);
+  int Read(const char* fileName);
+
+  // Description:
+  // Get the number of bones and events recorded.
+  vtkIdType GetNumberOfBones();
+  vtkIdType GetNumberOfEvents();
+
+  // Description:
+  // Create the recorded bones on the interactor and the renderer and add
+  // them to a new skeleton that becomes the skeleton of the recorder.
+  // The bones use the default representation and are enabled. They are
+  // owned by the recorder until the next call.
+  vtkBoneSkeleton* BuildSkeleton();
+
+  // Description:
+  // Put the skeleton back in the state it had when the recording started.
+  // Return 1 on success, 0 if the skeleton does not match the recording.
+  int RestoreInitialState();
+
+  // Description:
+  // Restore the initial state and invoke all the recorded events on the
+  // interactor. Return 1 if the final transforms of all the bones match
+  // the recorded ones (see Tolerance), 0 otherwise.
+  int Replay();
+
+  // Description:
+  // Set/Get the tolerance on the quaternion components used to compare
+  // the replayed transforms with the recorded ones. 1e-6 by default.
+  vtkSetMacro(Tolerance, double);
+  vtkGetMacro(Tolerance, double);
+
+  // Description:
+  // Results of the last replay: CPU time (in seconds) of each event and
+  // in total, number of bones whose final transforms did not match.
+  double GetEventTime(vtkIdType event);
+  vtkGetMacro(ReplayTime, double);
+  vtkGetMacro(NumberOfMismatchedBones, vtkIdType);
+
+  // Description:
+  // Get the event id (e.g. vtkCommand::MouseMoveEvent) of a recorded event.
+  unsigned long GetEventId(vtkIdType event);
+
+protected:
+  vtkBoneSessionRecorder();
+  ~vtkBoneSessionRecorder();
+
+  // Description:
+  // Callback of the interactor events while recording.
+  static void ProcessEvents(vtkObject* caller, unsigned long event,
+                            void* clientdata, void* calldata);
+
+  // Description:
+  // Record an event, with the camera and the widget state changes
+  // that happened since the previous one.
+  void RecordEvent(unsigned long eventId);
+
+  // Description:
+  // Copy the camera of the renderer into the buffer and back.
+  void SaveCamera(double* camera);
+  void RestoreCamera(const double* camera);
+
+  // Description:
+  // Discard the recording.
+  void ClearRecording();
+
+  vtkRenderWindowInteractor* Interactor;
+  vtkRenderer*               Renderer;
+  vtkBoneSkeleton*           Skeleton;
+  vtkCallbackCommand*        EventCallbackCommand;
+
+  int                        Recording;
+  double                     Tolerance;
+  unsigned long              CameraTime;
+
+//BTX
+  // Initial state: 1 parent id, 2 flags (widget state, head linked),
+  // 6 rest world coordinates (head, tail) and 4 pose transform values
+  // per bone.
+  std::vector<vtkIdType>     ParentIds;
+  std::vector<int>           Flags;
+  std::vector<double>        RestPositions;
+  std::vector<double>        InitialPoseTransforms;
+  int                        WindowSize[2];
+
+  // Events: 5 values per event (event type, display x, y, control and
+  // shift keys). The cameras are applied before the event they point to,
+  // as well as the widget state changes (3 values: event, bone, state).
+  std::vector<int>           Events;
+  std::vector<vtkIdType>     CameraEvents;
+  std::vector<double>        Cameras;
+  std::vector<int>           StateChanges;
+  std::vector<int>           CurrentStates;
+
+  // Final state: 4 rest transform and 4 pose transform values per bone.
+  std::vector<double>        FinalRestTransforms;
+  std::vector<double>        FinalPoseTransforms;
+
+  // Replay results
+  std::vector<double>        EventTimes;
+
+  std::vector<vtkSmartPointer<vtkBoneWidget> > BuiltBones;
+//ETX
+  double                     ReplayTime;
+  vtkIdType                  NumberOfMismatchedBones;
+
+private:
+  vtkBoneSessionRecorder(const vtkBoneSessionRecorder&);  //Not implemented
+  void operator=(const vtkBoneSessionRecorder&);  //Not implemented
+};
+
+#endif
@@ -0,0 +1,769 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneSkeleton.h"
+
+//My includes
+#include "vtkBoneBatchMath.h"
+#include "vtkBoneEventDispatcher.h"
+#include "vtkBoneMath.h"
+#include "vtkBonePickingTree.h"
+#include "vtkBoneRenderScheduler.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+
+vtkStandardNewMacro(vtkBoneSkeleton);
+
+namespace
+{
+
+template <class T>
+void CopyTuple(std::vector<T>& buffer, vtkIdType from, vtkIdType to, int size)
+{
+  for (int i = 0; i < size; ++i)
+    {
+    buffer[size*to + i] = buffer[size*from + i];
+    }
+}
+
+template <class T>
+void PopTuple(std::vector<T>& buffer, int size)
+{
+  buffer.resize(buffer.size() - size);
+}
+
+void PushVector3(std::vector<double>& buffer)
+{
+  buffer.push_back(0.0);
+  buffer.push_back(0.0);
+  buffer.push_back(0.0);
+}
+
+void PushQuaternion(std::vector<double>& buffer)
+{
+  buffer.push_back(1.0);
+  buffer.push_back(0.0);
+  buffer.push_back(0.0);
+  buffer.push_back(0.0);
+}
+
+double* GetBuffer(std::vector<double>& buffer)
+{
+  return buffer.empty() ? NULL : &buffer[0];
+}
+
+void MultiplyQuaternion(const double* quad1, const double* quad2,
+                        double resultQuad[4])
+{
+  //Quaternion are (w, x, y, z)
+  (vtkBoneQuaterniond(quad1) * vtkBoneQuaterniond(quad2)).CopyTo(resultQuad);
+}
+
+void NormalizeQuaternion(double* quad)
+{
+  vtkBoneQuaterniond(quad).Normalized().CopyTo(quad);
+}
+
+void CopyQuaternion(const double* quad, double* copyQuad)
+{
+  vtkBoneQuaterniond(quad).CopyTo(copyQuad);
+}
+
+// Compute q*p + t
+void TransformPoint(const double* quad, const double* translation,
+                    const double* point, double result[3])
+{
+  vtkBoneRigidTransform(quad, translation).TransformPoint(point, result);
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBoneSkeleton::vtkBoneSkeleton()
+{
+  this->TopologicalOrderModified = true;
+  this->RenderScheduler = NULL;
+  this->PickingTree = NULL;
+  this->EventDispatcher = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneSkeleton::~vtkBoneSkeleton()
+{
+  this->SetRenderScheduler(NULL);
+  this->SetPickingTree(NULL);
+  this->SetEventDispatcher(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::SetRenderScheduler(vtkBoneRenderScheduler* scheduler)
+{
+  if (scheduler == this->RenderScheduler)
+    {
+    return;
+    }
+
+  if (this->RenderScheduler)
+    {
+    this->RenderScheduler->UnRegister(this);
+    }
+  this->RenderScheduler = scheduler;
+  if (this->RenderScheduler)
+    {
+    this->RenderScheduler->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::SetPickingTree(vtkBonePickingTree* tree)
+{
+  if (tree == this->PickingTree)
+    {
+    return;
+    }
+
+  if (this->PickingTree)
+    {
+    this->PickingTree->Skeleton = NULL;
+    this->PickingTree->UnRegister(this);
+    }
+  this->PickingTree = tree;
+  if (this->PickingTree)
+    {
+    this->PickingTree->Register(this);
+    // The tree does not hold a reference on the skeleton
+    if (this->PickingTree->Skeleton)
+      {
+      this->PickingTree->Skeleton->SetPickingTree(NULL);
+      }
+    this->PickingTree->Skeleton = this;
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::SetEventDispatcher(vtkBoneEventDispatcher* dispatcher)
+{
+  if (dispatcher == this->EventDispatcher)
+    {
+    return;
+    }
+
+  if (this->EventDispatcher)
+    {
+    this->EventDispatcher->SetActiveBone(NULL);
+    this->EventDispatcher->Skeleton = NULL;
+    this->EventDispatcher->UnRegister(this);
+    }
+  this->EventDispatcher = dispatcher;
+  if (this->EventDispatcher)
+    {
+    this->EventDispatcher->Register(this);
+    // The dispatcher does not hold a reference on the skeleton
+    if (this->EventDispatcher->Skeleton)
+      {
+      this->EventDispatcher->Skeleton->SetEventDispatcher(NULL);
+      }
+    this->EventDispatcher->Skeleton = this;
+    }
+
+  for (vtkIdType i = 0; i < this->GetNumberOfBones(); ++i)
+    {
+    this->Bones[i]->UpdateEventObservers();
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneSkeleton::AddBone(vtkBoneWidget* bone)
+{
+  if (!bone)
+    {
+    vtkErrorMacro("Cannot add a NULL bone to the skeleton.");
+    return -1;
+    }
+
+  if (bone->Skeleton == this)
+    {
+    return bone->BoneId;
+    }
+
+  vtkIdType id = this->AllocateBone(bone);
+
+  vtkBoneSkeleton* previousSkeleton = bone->Skeleton;
+  vtkIdType previousId = bone->BoneId;
+  if (previousSkeleton)
+    {
+    this->CopyBone(previousSkeleton, previousId, id);
+    }
+
+  this->Register(bone);
+  bone->Skeleton = this;
+  bone->BoneId = id;
+
+  if (previousSkeleton)
+    {
+    previousSkeleton->ReleaseBone(previousId);
+    previousSkeleton->UnRegister(bone);
+    }
+
+  this->UpdateBoneParentIds(id);
+  bone->UpdateEventObservers();
+  this->Modified();
+  return id;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::RemoveBone(vtkBoneWidget* bone)
+{
+  if (!bone || bone->Skeleton != this)
+    {
+    vtkErrorMacro("The bone does not belong to this skeleton."
+                  "\n ->Doing nothing");
+    return;
+    }
+
+  // Give the bone back a private skeleton
+  vtkBoneSkeleton* privateSkeleton = vtkBoneSkeleton::New();
+  vtkIdType id = privateSkeleton->AllocateBone(bone);
+  privateSkeleton->CopyBone(this, bone->BoneId, id);
+
+  vtkIdType previousId = bone->BoneId;
+  bone->Skeleton = privateSkeleton;
+  bone->BoneId = id;
+
+  this->ReleaseBone(previousId);
+  bone->UpdateEventObservers();
+  this->UnRegister(bone);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneSkeleton::GetNumberOfBones()
+{
+  return static_cast<vtkIdType>(this->Bones.size());
+}
+
+//----------------------------------------------------------------------------
+vtkBoneWidget* vtkBoneSkeleton::GetBone(vtkIdType id)
+{
+  if (id < 0 || id >= this->GetNumberOfBones())
+    {
+    return NULL;
+    }
+  return this->Bones[id];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneSkeleton::GetBoneParentId(vtkIdType id)
+{
+  if (id < 0 || id >= this->GetNumberOfBones())
+    {
+    return -1;
+    }
+  return this->ParentIds[id];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneSkeleton::GetNumberOfBoneChildren(vtkIdType id)
+{
+  if (id < 0 || id >= this->GetNumberOfBones())
+    {
+    return 0;
+    }
+  this->UpdateTopologicalOrder();
+  return this->ChildrenOffsets[id + 1] - this->ChildrenOffsets[id];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType* vtkBoneSkeleton::GetTopologicalOrder()
+{
+  this->UpdateTopologicalOrder();
+  return this->TopologicalOrder.empty() ? NULL : &this->TopologicalOrder[0];
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::UpdateDescendantPoses(vtkIdType id)
+{
+  if (id < 0 || id >= this->GetNumberOfBones()
+      || this->GetNumberOfBoneChildren(id) == 0)
+    {
+    return;
+    }
+
+  this->Evaluated.assign(this->Bones.size(), 0);
+  this->InitializeWorldPose(id);
+  this->Evaluated[id] = 1;
+
+  // Descendants are always after the bone in the topological order
+  this->EvaluatePoses(this->TopologicalIndices[id] + 1);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::UpdatePoses()
+{
+  this->UpdateTopologicalOrder();
+
+  this->Evaluated.assign(this->Bones.size(), 0);
+  for (vtkIdType i = 0; i < this->GetNumberOfBones(); ++i)
+    {
+    if (this->ParentIds[i] < 0)
+      {
+      this->InitializeWorldPose(i);
+      this->Evaluated[i] = 1;
+      }
+    }
+
+  this->EvaluatePoses(0);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::SetPoseTransforms(const double* poseTransforms)
+{
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+  if (numberOfBones == 0)
+    {
+    return;
+    }
+
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    if (this->Bones[i]->WidgetState == vtkBoneWidget::Pose)
+      {
+      CopyQuaternion(poseTransforms + 4*i, &this->PoseTransforms[4*i]);
+      CopyQuaternion(poseTransforms + 4*i, &this->StartPoseTransforms[4*i]);
+      }
+    }
+
+  // World rotations: Pose * Rest
+  this->WorldPoseRotations.resize(4*numberOfBones);
+  vtkBoneBatchMath::MultiplyQuaternions(&this->PoseTransforms[0],
+                                        &this->RestTransforms[0],
+                                        &this->WorldPoseRotations[0],
+                                        numberOfBones);
+  vtkBoneBatchMath::NormalizeQuaternions(&this->WorldPoseRotations[0],
+                                         numberOfBones);
+
+  // Local rotations: ParentWorldRotation^-1 * WorldRotation
+  this->ParentPoseRotations.resize(4*numberOfBones);
+  this->NewLocalPoseRotations.resize(4*numberOfBones);
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    double* parentRotation = &this->ParentPoseRotations[4*i];
+    vtkBoneWidget* parent = this->Bones[i]->GetBoneParent();
+    if (this->ParentIds[i] >= 0)
+      {
+      CopyQuaternion(&this->WorldPoseRotations[4*this->ParentIds[i]],
+                     parentRotation);
+      }
+    else if (parent)
+      {
+      MultiplyQuaternion(parent->GetPoseTransform(),
+                         parent->GetRestTransform(), parentRotation);
+      NormalizeQuaternion(parentRotation);
+      }
+    else
+      {
+      vtkBoneQuaterniond().CopyTo(parentRotation);
+      }
+    }
+  vtkBoneBatchMath::ConjugateQuaternions(&this->ParentPoseRotations[0],
+                                         &this->ParentPoseRotations[0],
+                                         numberOfBones);
+  vtkBoneBatchMath::MultiplyQuaternions(&this->ParentPoseRotations[0],
+                                        &this->WorldPoseRotations[0],
+                                        &this->NewLocalPoseRotations[0],
+                                        numberOfBones);
+
+  // The local tail is on the Y axis of the local rotation
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    vtkBoneWidget* bone = this->Bones[i];
+    if (bone->WidgetState != vtkBoneWidget::Pose)
+      {
+      continue;
+      }
+
+    CopyQuaternion(&this->NewLocalPoseRotations[4*i],
+                   &this->LocalPoseRotations[4*i]);
+    vtkBoneVector3d head(&this->LocalPoseHeads[3*i]);
+    double length = (vtkBoneVector3d(&this->LocalPoseTails[3*i]) - head).Norm();
+    vtkBoneQuaterniond rotation(&this->LocalPoseRotations[4*i]);
+    (head + rotation.Rotate(vtkBoneVector3d(0.0, length, 0.0))).CopyTo(
+      &this->LocalPoseTails[3*i]);
+
+    // The roots are moved here, the forward kinematics moves the others
+    if (this->ParentIds[i] < 0)
+      {
+      vtkBoneRigidTransform transform =
+        bone->GetWorldToBoneParentPoseTransform();
+      double worldHead[3], worldTail[3];
+      transform.TransformPoint(&this->LocalPoseHeads[3*i], worldHead);
+      transform.TransformPoint(&this->LocalPoseTails[3*i], worldTail);
+      bone->ApplyEvaluatedPose(worldHead, worldTail);
+      }
+    }
+
+  this->UpdatePoses();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::UpdateTopologicalOrder()
+{
+  if (!this->TopologicalOrderModified)
+    {
+    return;
+    }
+
+  vtkIdType numberOfBones = this->GetNumberOfBones();
+
+  // Children lists, stored contiguously per parent
+  this->ChildrenOffsets.assign(numberOfBones + 1, 0);
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    if (this->ParentIds[i] >= 0)
+      {
+      ++this->ChildrenOffsets[this->ParentIds[i] + 1];
+      }
+    }
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    this->ChildrenOffsets[i + 1] += this->ChildrenOffsets[i];
+    }
+
+  this->Children.resize(numberOfBones);
+  std::vector<vtkIdType> fill(this->ChildrenOffsets.begin(),
+                              this->ChildrenOffsets.end() - 1);
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    if (this->ParentIds[i] >= 0)
+      {
+      this->Children[fill[this->ParentIds[i]]++] = i;
+      }
+    }
+
+  // Breadth first traversal from the roots
+  this->TopologicalOrder.clear();
+  this->TopologicalOrder.reserve(numberOfBones);
+  for (vtkIdType i = 0; i < numberOfBones; ++i)
+    {
+    if (this->ParentIds[i] < 0)
+      {
+      this->TopologicalOrder.push_back(i);
+      }
+    }
+  for (size_t k = 0; k < this->TopologicalOrder.size(); ++k)
+    {
+    vtkIdType id = this->TopologicalOrder[k];
+    for (vtkIdType c = this->ChildrenOffsets[id];
+         c < this->ChildrenOffsets[id + 1]; ++c)
+      {
+      this->TopologicalOrder.push_back(this->Children[c]);
+      }
+    }
+
+  if (static_cast<vtkIdType>(this->TopologicalOrder.size()) != numberOfBones)
+    {
+    vtkErrorMacro("The bones parentage has a cycle, the bones of the cycle"
+                  " are ignored by the forward kinematics.");
+    }
+
+  this->TopologicalIndices.assign(numberOfBones, numberOfBones);
+  for (size_t k = 0; k < this->TopologicalOrder.size(); ++k)
+    {
+    this->TopologicalIndices[this->TopologicalOrder[k]] =
+      static_cast<vtkIdType>(k);
+    }
+
+  this->TopologicalOrderModified = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::EvaluatePoses(vtkIdType start)
+{
+  vtkIdType numberOfSortedBones =
+    static_cast<vtkIdType>(this->TopologicalOrder.size());
+  std::vector<vtkBoneWidget*> movedBones;
+  for (vtkIdType k = start; k < numberOfSortedBones; ++k)
+    {
+    vtkIdType id = this->TopologicalOrder[k];
+    vtkIdType parentId = this->ParentIds[id];
+    if (parentId < 0 || !this->Evaluated[parentId])
+      {
+      continue;
+      }
+
+    const double* parentRotation = &this->WorldPoseRotations[4*parentId];
+    const double* parentTail = &this->WorldPoseTails[3*parentId];
+
+    double* rotation = &this->WorldPoseRotations[4*id];
+    double* head = &this->WorldPoseHeads[3*id];
+    double* tail = &this->WorldPoseTails[3*id];
+
+    // World frame of the bone from its parent frame
+    MultiplyQuaternion(parentRotation, &this->LocalPoseRotations[4*id],
+                       rotation);
+    NormalizeQuaternion(rotation);
+    TransformPoint(parentRotation, parentTail,
+                   &this->LocalPoseHeads[3*id], head);
+    TransformPoint(parentRotation, parentTail,
+                   &this->LocalPoseTails[3*id], tail);
+    this->Evaluated[id] = 1;
+
+    vtkBoneWidget* bone = this->Bones[id];
+    if (bone->WidgetState != vtkBoneWidget::Pose)
+      {
+      continue;
+      }
+
+    // Pose = (Pose * Rest) * Rest^-1
+    const double* rest = &this->RestTransforms[4*id];
+    double inverseRest[4];
+    inverseRest[0] = rest[0];
+    inverseRest[1] = -rest[1];
+    inverseRest[2] = -rest[2];
+    inverseRest[3] = -rest[3];
+    MultiplyQuaternion(rotation, inverseRest, &this->PoseTransforms[4*id]);
+    NormalizeQuaternion(&this->PoseTransforms[4*id]);
+
+    bone->ApplyEvaluatedPose(head, tail);
+    if (bone->HasExternalBoneChildren())
+      {
+      movedBones.push_back(bone);
+      }
+    }
+
+  // The children in other skeletons follow their parent on
+  // PoseChangedEvent. The events are invoked once the pass is over: the
+  // observers may evaluate this skeleton again.
+  for (size_t i = 0; i < movedBones.size(); ++i)
+    {
+    movedBones[i]->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::InitializeWorldPose(vtkIdType id)
+{
+  vtkBoneWidget* bone = this->Bones[id];
+
+  double* rotation = &this->WorldPoseRotations[4*id];
+  MultiplyQuaternion(&this->PoseTransforms[4*id], &this->RestTransforms[4*id],
+                     rotation);
+  NormalizeQuaternion(rotation);
+
+  bone->GetHeadPoseWorldPosition(&this->WorldPoseHeads[3*id]);
+  bone->GetTailPoseWorldPosition(&this->WorldPoseTails[3*id]);
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneSkeleton::GetLocalRestHeads()
+{
+  return GetBuffer(this->LocalRestHeads);
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneSkeleton::GetLocalRestTails()
+{
+  return GetBuffer(this->LocalRestTails);
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneSkeleton::GetLocalPoseHeads()
+{
+  return GetBuffer(this->LocalPoseHeads);
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneSkeleton::GetLocalPoseTails()
+{
+  return GetBuffer(this->LocalPoseTails);
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneSkeleton::GetRestTransforms()
+{
+  return GetBuffer(this->RestTransforms);
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneSkeleton::GetPoseTransforms()
+{
+  return GetBuffer(this->PoseTransforms);
+}
+
+//----------------------------------------------------------------------------
+double* vtkBoneSkeleton::GetStartPoseTransforms()
+{
+  return GetBuffer(this->StartPoseTransforms);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBoneSkeleton::AllocateBone(vtkBoneWidget* bone)
+{
+  vtkIdType id = this->GetNumberOfBones();
+
+  this->Bones.push_back(bone);
+  this->ParentIds.push_back(-1);
+
+  PushVector3(this->LocalRestHeads);
+  PushVector3(this->LocalRestTails);
+  PushVector3(this->LocalPoseHeads);
+  PushVector3(this->LocalPoseTails);
+  PushQuaternion(this->RestTransforms);
+  PushQuaternion(this->PoseTransforms);
+  PushQuaternion(this->StartPoseTransforms);
+  PushQuaternion(this->LocalPoseRotations);
+  PushQuaternion(this->WorldPoseRotations);
+  PushVector3(this->WorldPoseHeads);
+  PushVector3(this->WorldPoseTails);
+
+  this->TopologicalOrderModified = true;
+  return id;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::ReleaseBone(vtkIdType id)
+{
+  vtkIdType last = this->GetNumberOfBones() - 1;
+  if (id < 0 || id > last)
+    {
+    return;
+    }
+
+  // The children of the released bone become roots of this skeleton
+  for (vtkIdType i = 0; i <= last; ++i)
+    {
+    if (this->ParentIds[i] == id)
+      {
+      this->ParentIds[i] = -1;
+      }
+    }
+
+  // Move the last slot into the freed one
+  if (id != last)
+    {
+    this->Bones[id] = this->Bones[last];
+    this->Bones[id]->BoneId = id;
+    this->ParentIds[id] = this->ParentIds[last];
+
+    CopyTuple(this->LocalRestHeads, last, id, 3);
+    CopyTuple(this->LocalRestTails, last, id, 3);
+    CopyTuple(this->LocalPoseHeads, last, id, 3);
+    CopyTuple(this->LocalPoseTails, last, id, 3);
+    CopyTuple(this->RestTransforms, last, id, 4);
+    CopyTuple(this->PoseTransforms, last, id, 4);
+    CopyTuple(this->StartPoseTransforms, last, id, 4);
+    CopyTuple(this->LocalPoseRotations, last, id, 4);
+    CopyTuple(this->WorldPoseRotations, last, id, 4);
+    CopyTuple(this->WorldPoseHeads, last, id, 3);
+    CopyTuple(this->WorldPoseTails, last, id, 3);
+
+    for (vtkIdType i = 0; i < last; ++i)
+      {
+      if (this->ParentIds[i] == last)
+        {
+        this->ParentIds[i] = id;
+        }
+      }
+    }
+
+  this->Bones.pop_back();
+  this->ParentIds.pop_back();
+
+  PopTuple(this->LocalRestHeads, 3);
+  PopTuple(this->LocalRestTails, 3);
+  PopTuple(this->LocalPoseHeads, 3);
+  PopTuple(this->LocalPoseTails, 3);
+  PopTuple(this->RestTransforms, 4);
+  PopTuple(this->PoseTransforms, 4);
+  PopTuple(this->StartPoseTransforms, 4);
+  PopTuple(this->LocalPoseRotations, 4);
+  PopTuple(this->WorldPoseRotations, 4);
+  PopTuple(this->WorldPoseHeads, 3);
+  PopTuple(this->WorldPoseTails, 3);
+
+  this->TopologicalOrderModified = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::CopyBone(vtkBoneSkeleton* source,
+                               vtkIdType sourceId,
+                               vtkIdType id)
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    this->LocalRestHeads[3*id + i] = source->LocalRestHeads[3*sourceId + i];
+    this->LocalRestTails[3*id + i] = source->LocalRestTails[3*sourceId + i];
+    this->LocalPoseHeads[3*id + i] = source->LocalPoseHeads[3*sourceId + i];
+    this->LocalPoseTails[3*id + i] = source->LocalPoseTails[3*sourceId + i];
+    }
+
+  for (int i = 0; i < 4; ++i)
+    {
+    this->RestTransforms[4*id + i] = source->RestTransforms[4*sourceId + i];
+    this->PoseTransforms[4*id + i] = source->PoseTransforms[4*sourceId + i];
+    this->StartPoseTransforms[4*id + i] =
+      source->StartPoseTransforms[4*sourceId + i];
+    this->LocalPoseRotations[4*id + i] =
+      source->LocalPoseRotations[4*sourceId + i];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::UpdateBoneParentIds(vtkIdType id)
+{
+  vtkBoneWidget* bone = this->Bones[id];
+  vtkBoneWidget* parent = bone->GetBoneParent();
+  this->ParentIds[id] =
+    (parent && parent->Skeleton == this) ? parent->BoneId : -1;
+
+  for (vtkIdType i = 0; i < this->GetNumberOfBones(); ++i)
+    {
+    if (this->Bones[i]->GetBoneParent() == bone)
+      {
+      this->ParentIds[i] = id;
+      }
+    }
+
+  this->TopologicalOrderModified = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkeleton::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Bones: " << this->GetNumberOfBones() << "\n";
+  os << indent << "Render Scheduler: " << this->RenderScheduler << "\n";
+  os << indent << "Picking Tree: " << this->PickingTree << "\n";
+  os << indent << "Event Dispatcher: " << this->EventDispatcher << "\n";
+  for (vtkIdType i = 0; i < this->GetNumberOfBones(); ++i)
+    {
+    os << indent << "  Bone " << i << ": " << this->Bones[i]
+       << "  Parent Id: " << this->ParentIds[i] << "\n";
+    }
+}
@@ -0,0 +1,269 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneSkeleton_h
+#define __vtkBoneSkeleton_h
+
+// .NAME vtkBoneSkeleton - Packed storage for the bones of a skeleton
+// .SECTION Description
+// vtkBoneSkeleton owns the state of a set of bones (local rest and pose
+// points, rest, pose and start pose transforms) in contiguous
+// structure-of-arrays buffers indexed by bone id. Each vtkBoneWidget is a
+// view onto one slot of a skeleton.
+// A bone widget that was never added to a skeleton owns a private skeleton
+// with a single slot. Adding the bone to another skeleton moves its state
+// into a new slot of that skeleton.
+// Removing a bone moves the last bone of the skeleton into the freed slot,
+// so bone ids are only stable as long as no bone is removed.
+//
+// The buffers can be accessed directly for batched computations. The
+// pointers returned are invalidated when bones are added or removed.
+//
+// The skeleton also evaluates the forward kinematics of its bones in pose
+// mode. The bones are sorted parent before children once (the order is
+// only recomputed when the parentage changes), and the world pose of the
+// descendants of a bone is then updated in a single linear pass, without
+// any event dispatch per bone. Only the moved bone invokes PoseChangedEvent:
+// children that belong to another skeleton keep following their parent
+// through that event.
+// .SECTION See Also
+// vtkBoneWidget
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vector>
+//ETX
+
+class vtkBoneEventDispatcher;
+class vtkBonePickingTree;
+class vtkBoneRenderScheduler;
+class vtkBoneWidget;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneSkeleton : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneSkeleton *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneSkeleton, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Add a bone to the skeleton. The state of the bone is moved into a
+  // new slot of the skeleton. Return the id of the new slot.
+  // If the bone already belongs to the skeleton, its id is returned.
+  vtkIdType AddBone(vtkBoneWidget* bone);
+
+  // Description:
+  // Remove a bone from the skeleton. The bone is given back a private
+  // skeleton holding its state. The last bone of the skeleton takes the
+  // slot that was freed.
+  void RemoveBone(vtkBoneWidget* bone);
+
+  // Description:
+  // Get the number of bones in the skeleton.
+  vtkIdType GetNumberOfBones();
+
+  // Description:
+  // Get the bone widget viewing the given slot. NULL if out of range.
+  vtkBoneWidget* GetBone(vtkIdType id);
+
+  // Description:
+  // Get the id of the parent bone of the given bone.
+  // -1 if the bone is a root or if its parent is not in this skeleton.
+  vtkIdType GetBoneParentId(vtkIdType id);
+
+  // Description:
+  // Get the number of children of the given bone in this skeleton.
+  vtkIdType GetNumberOfBoneChildren(vtkIdType id);
+
+  // Description:
+  // Get the bone ids sorted such as every parent comes before its children.
+  // The order is recomputed lazily when the parentage changes.
+  // The returned array holds GetNumberOfBones() ids.
+  vtkIdType* GetTopologicalOrder();
+
+  // Description:
+  // Forward kinematics. Update the world pose of all the descendants of
+  // the given bone from their local pose points in a single pass.
+  // The given bone is not modified, its current world pose is used as the
+  // starting point. Only the bones in pose mode are moved.
+  void UpdateDescendantPoses(vtkIdType id);
+
+  // Description:
+  // Forward kinematics for the whole skeleton: the roots world poses are
+  // used as starting points and all the other bones are updated.
+  void UpdatePoses();
+
+  // Description:
+  // Set the pose transforms (4 values per bone, see GetPoseTransform()) of
+  // all the bones at once, e.g. from an animation. The bones keep their
+  // length and the heads of the roots do not move. The local pose points
+  // are updated with batched quaternion operations and the forward
+  // kinematics is evaluated once for the whole skeleton: no event is
+  // invoked per bone. Only the bones in pose mode are changed.
+  void SetPoseTransforms(const double* poseTransforms);
+
+  // Description:
+  // Per bone access to the local points. The points are expressed in the
+  // bone parent coordinate system.
+  // No bound checking is done.
+  double* GetLocalRestHead(vtkIdType id)
+    { return &this->LocalRestHeads[3*id]; }
+  double* GetLocalRestTail(vtkIdType id)
+    { return &this->LocalRestTails[3*id]; }
+  double* GetLocalPoseHead(vtkIdType id)
+    { return &this->LocalPoseHeads[3*id]; }
+  double* GetLocalPoseTail(vtkIdType id)
+    { return &this->LocalPoseTails[3*id]; }
+
+  // Description:
+  // Per bone access to the transforms. The transforms are quaternions
+  // (w, x, y, z). No bound checking is done.
+  double* GetRestTransform(vtkIdType id)
+    { return &this->RestTransforms[4*id]; }
+  double* GetPoseTransform(vtkIdType id)
+    { return &this->PoseTransforms[4*id]; }
+  double* GetStartPoseTransform(vtkIdType id)
+    { return &this->StartPoseTransforms[4*id]; }
+
+  // Description:
+  // Per bone access to the local pose rotation. It is the rotation of the
+  // bone (pose transform times rest transform) expressed in the bone parent
+  // pose coordinate system. It is captured with the local pose points
+  // and used by the forward kinematics.
+  double* GetLocalPoseRotation(vtkIdType id)
+    { return &this->LocalPoseRotations[4*id]; }
+
+  // Description:
+  // Access to the whole buffers. The points buffers hold 3 values per bone,
+  // the transform buffers 4 values per bone. NULL if the skeleton is empty.
+  double* GetLocalRestHeads();
+  double* GetLocalRestTails();
+  double* GetLocalPoseHeads();
+  double* GetLocalPoseTails();
+  double* GetRestTransforms();
+  double* GetPoseTransforms();
+  double* GetStartPoseTransforms();
+
+  // Description:
+  // Set/Get the scheduler merging and throttling the renders requested by
+  // the bones of the skeleton. NULL (default) means that each bone renders
+  // at each interaction.
+  void SetRenderScheduler(vtkBoneRenderScheduler* scheduler);
+  vtkGetObjectMacro(RenderScheduler, vtkBoneRenderScheduler);
+
+  // Description:
+  // Set/Get the bounding volume hierarchy picking the bones of the
+  // skeleton. NULL (default) means that each bone tests the clicks itself.
+  // A tree picks the bones of a single skeleton.
+  void SetPickingTree(vtkBonePickingTree* tree);
+  vtkGetObjectMacro(PickingTree, vtkBonePickingTree);
+
+  // Description:
+  // Set/Get the dispatcher routing the interactor events to the bones of
+  // the skeleton. With a dispatcher, the bones stop observing the
+  // interactor themselves. NULL (default) means that each bone observes
+  // the interactor. A dispatcher routes the events of a single skeleton.
+  void SetEventDispatcher(vtkBoneEventDispatcher* dispatcher);
+  vtkGetObjectMacro(EventDispatcher, vtkBoneEventDispatcher);
+
+protected:
+  vtkBoneSkeleton();
+  ~vtkBoneSkeleton();
+
+  // Description:
+  // Allocate a new slot initialized to the identity for the given bone.
+  vtkIdType AllocateBone(vtkBoneWidget* bone);
+
+  // Description:
+  // Free the slot. The last slot is moved into the freed one.
+  void ReleaseBone(vtkIdType id);
+
+  // Description:
+  // Copy the state of a slot of another skeleton into a slot of this one.
+  void CopyBone(vtkBoneSkeleton* source, vtkIdType sourceId, vtkIdType id);
+
+  // Description:
+  // Recompute the parent id of the given bone and of its children
+  // from the bone widgets parentage.
+  void UpdateBoneParentIds(vtkIdType id);
+
+  // Description:
+  // Rebuild the topological order and the children lists if needed.
+  void UpdateTopologicalOrder();
+
+  // Description:
+  // Run the forward kinematics on the bones in the topological order,
+  // starting at the given position in the order. Only the descendants
+  // of the bones marked in the Evaluated buffer are updated. The moved
+  // bones with children in other skeletons invoke PoseChangedEvent.
+  void EvaluatePoses(vtkIdType start);
+
+  // Description:
+  // Fill the world pose buffers of a bone from its widget.
+  void InitializeWorldPose(vtkIdType id);
+
+  vtkBoneRenderScheduler* RenderScheduler;
+  vtkBonePickingTree*     PickingTree;
+  vtkBoneEventDispatcher* EventDispatcher;
+
+//BTX
+  std::vector<vtkBoneWidget*> Bones;
+  std::vector<vtkIdType>      ParentIds;
+
+  std::vector<double>         LocalRestHeads;
+  std::vector<double>         LocalRestTails;
+  std::vector<double>         LocalPoseHeads;
+  std::vector<double>         LocalPoseTails;
+  std::vector<double>         RestTransforms;
+  std::vector<double>         PoseTransforms;
+  std::vector<double>         StartPoseTransforms;
+  std::vector<double>         LocalPoseRotations;
+
+  // Forward kinematics
+  bool                        TopologicalOrderModified;
+  std::vector<vtkIdType>      TopologicalOrder;
+  std::vector<vtkIdType>      TopologicalIndices;
+  std::vector<vtkIdType>      ChildrenOffsets;
+  std::vector<vtkIdType>      Children;
+  std::vector<unsigned char>  Evaluated;
+  std::vector<double>         WorldPoseRotations;
+  std::vector<double>         WorldPoseHeads;
+  std::vector<double>         WorldPoseTails;
+
+  // SetPoseTransforms() buffers
+  std::vector<double>         ParentPoseRotations;
+  std::vector<double>         NewLocalPoseRotations;
+
+  friend class vtkBoneWidget;
+//ETX
+
+private:
+  vtkBoneSkeleton(const vtkBoneSkeleton&);  //Not implemented
+  void operator=(const vtkBoneSkeleton&);  //Not implemented
+};
+
+#endif
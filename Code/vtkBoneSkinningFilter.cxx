@@ -0,0 +1,537 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneSkinningFilter.h"
+
+//My includes
+#include "vtkBoneMath.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkDataArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMultiThreader.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+//STL includes
+#include <algorithm>
+
+vtkStandardNewMacro(vtkBoneSkinningFilter);
+
+namespace
+{
+
+// Everything the threads need to deform their range of points
+struct SkinningThreadData
+{
+  int SkinningMode;
+  vtkIdType NumberOfPoints;
+  int NumberOfInfluences;
+  const int* InfluenceBones;
+  const float* InfluenceWeights;
+  const double* BoneTransforms;
+
+  int PointsType;
+  const void* InPoints;
+  void* OutPoints;
+  int NormalsType;
+  const void* InNormals;
+  void* OutNormals;
+};
+
+//----------------------------------------------------------------------------
+template <class TP, class TN>
+void LinearBlendSkinning(const SkinningThreadData* data,
+                         vtkIdType begin, vtkIdType end)
+{
+  const int k = data->NumberOfInfluences;
+  const int* bones = data->InfluenceBones + k*begin;
+  const float* weights = data->InfluenceWeights + k*begin;
+  const TP* inPoints = static_cast<const TP*>(data->InPoints) + 3*begin;
+  TP* outPoints = static_cast<TP*>(data->OutPoints) + 3*begin;
+  const TN* inNormals = static_cast<const TN*>(data->InNormals);
+  TN* outNormals = static_cast<TN*>(data->OutNormals);
+  if (inNormals)
+    {
+    inNormals += 3*begin;
+    outNormals += 3*begin;
+    }
+
+  for (vtkIdType i = begin; i < end; ++i, bones += k, weights += k)
+    {
+    // Blend the 3x4 matrices. Fixed size contiguous loop: vectorized.
+    double m[12] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+                    0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for (int j = 0; j < k; ++j)
+      {
+      const double* t = data->BoneTransforms + 12*bones[j];
+      const double w = weights[j];
+      for (int l = 0; l < 12; ++l)
+        {
+        m[l] += w * t[l];
+        }
+      }
+
+    const double x = inPoints[0], y = inPoints[1], z = inPoints[2];
+    outPoints[0] = static_cast<TP>(m[0]*x + m[1]*y + m[2]*z + m[3]);
+    outPoints[1] = static_cast<TP>(m[4]*x + m[5]*y + m[6]*z + m[7]);
+    outPoints[2] = static_cast<TP>(m[8]*x + m[9]*y + m[10]*z + m[11]);
+    inPoints += 3;
+    outPoints += 3;
+
+    if (inNormals)
+      {
+      vtkBoneVector3d n(m[0]*inNormals[0] + m[1]*inNormals[1] + m[2]*inNormals[2],
+                        m[4]*inNormals[0] + m[5]*inNormals[1] + m[6]*inNormals[2],
+                        m[8]*inNormals[0] + m[9]*inNormals[1] + m[10]*inNormals[2]);
+      n.Normalize();
+      n.CopyTo(outNormals);
+      inNormals += 3;
+      outNormals += 3;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TP, class TN>
+void DualQuaternionSkinning(const SkinningThreadData* data,
+                            vtkIdType begin, vtkIdType end)
+{
+  const int k = data->NumberOfInfluences;
+  const int* bones = data->InfluenceBones + k*begin;
+  const float* weights = data->InfluenceWeights + k*begin;
+  const TP* inPoints = static_cast<const TP*>(data->InPoints) + 3*begin;
+  TP* outPoints = static_cast<TP*>(data->OutPoints) + 3*begin;
+  const TN* inNormals = static_cast<const TN*>(data->InNormals);
+  TN* outNormals = static_cast<TN*>(data->OutNormals);
+  if (inNormals)
+    {
+    inNormals += 3*begin;
+    outNormals += 3*begin;
+    }
+
+  for (vtkIdType i = begin; i < end; ++i, bones += k, weights += k)
+    {
+    // Blend the dual quaternions in the hemisphere of the first one.
+    // Fixed size contiguous loop: vectorized.
+    const double* first = data->BoneTransforms + 8*bones[0];
+    double dq[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for (int j = 0; j < k; ++j)
+      {
+      const double* t = data->BoneTransforms + 8*bones[j];
+      double w = weights[j];
+      if (t[0]*first[0] + t[1]*first[1] + t[2]*first[2] + t[3]*first[3] < 0.0)
+        {
+        w = -w;
+        }
+      for (int l = 0; l < 8; ++l)
+        {
+        dq[l] += w * t[l];
+        }
+      }
+
+    vtkBoneQuaterniond real(dq), dual(dq + 4);
+    double norm = real.Normalize();
+    if (norm <= 0.0)
+      {
+      // Opposite rotations cancelled each other, leave the point
+      real = vtkBoneQuaterniond();
+      dual = vtkBoneQuaterniond(0.0, 0.0, 0.0, 0.0);
+      norm = 1.0;
+      }
+    // translation = 2 * dual * conjugate(real)
+    vtkBoneQuaterniond translation =
+      dual * real.Conjugated();
+    double scale = 2.0 / norm;
+
+    vtkBoneVector3d p(static_cast<double>(inPoints[0]),
+                      static_cast<double>(inPoints[1]),
+                      static_cast<double>(inPoints[2]));
+    p = real.Rotate(p) + translation.GetVector() * scale;
+    p.CopyTo(outPoints);
+    inPoints += 3;
+    outPoints += 3;
+
+    if (inNormals)
+      {
+      vtkBoneVector3d n(static_cast<double>(inNormals[0]),
+                        static_cast<double>(inNormals[1]),
+                        static_cast<double>(inNormals[2]));
+      real.Rotate(n).CopyTo(outNormals);
+      inNormals += 3;
+      outNormals += 3;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TP, class TN>
+void SkinRange(const SkinningThreadData* data, vtkIdType begin, vtkIdType end)
+{
+  if (data->SkinningMode == vtkBoneSkinningFilter::DualQuaternion)
+    {
+    DualQuaternionSkinning<TP, TN>(data, begin, end);
+    }
+  else
+    {
+    LinearBlendSkinning<TP, TN>(data, begin, end);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TP>
+void SkinRange(const SkinningThreadData* data, vtkIdType begin, vtkIdType end)
+{
+  if (data->NormalsType == VTK_DOUBLE)
+    {
+    SkinRange<TP, double>(data, begin, end);
+    }
+  else
+    {
+    SkinRange<TP, float>(data, begin, end);
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE SkinningThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const SkinningThreadData* data =
+    static_cast<const SkinningThreadData*>(info->UserData);
+
+  // Contiguous range of points per thread
+  vtkIdType begin = data->NumberOfPoints * info->ThreadID
+                    / info->NumberOfThreads;
+  vtkIdType end = data->NumberOfPoints * (info->ThreadID + 1)
+                  / info->NumberOfThreads;
+
+  if (data->PointsType == VTK_DOUBLE)
+    {
+    SkinRange<double>(data, begin, end);
+    }
+  else
+    {
+    SkinRange<float>(data, begin, end);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBoneSkinningFilter::vtkBoneSkinningFilter()
+{
+  this->Skeleton = NULL;
+  this->SkinningMode = vtkBoneSkinningFilter::LinearBlend;
+  this->BoneIndicesArrayName = NULL;
+  this->BoneWeightsArrayName = NULL;
+  this->SetBoneIndicesArrayName("BoneIndices");
+  this->SetBoneWeightsArrayName("BoneWeights");
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->Threader = vtkMultiThreader::New();
+
+  this->NumberOfInfluences = 0;
+  this->InfluencesNumberOfPoints = 0;
+  this->InfluencesNumberOfBones = 0;
+  this->InfluencesIndicesArray = NULL;
+  this->InfluencesWeightsArray = NULL;
+  this->InfluencesTime = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneSkinningFilter::~vtkBoneSkinningFilter()
+{
+  this->SetSkeleton(NULL);
+  this->SetBoneIndicesArrayName(NULL);
+  this->SetBoneWeightsArrayName(NULL);
+  this->Threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkinningFilter::SetSkeleton(vtkBoneSkeleton* skeleton)
+{
+  if (skeleton == this->Skeleton)
+    {
+    return;
+    }
+
+  if (this->Skeleton)
+    {
+    this->Skeleton->UnRegister(this);
+    }
+  this->Skeleton = skeleton;
+  if (this->Skeleton)
+    {
+    this->Skeleton->Register(this);
+    }
+
+  this->InfluencesTime = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkBoneSkinningFilter::GetMTime()
+{
+  unsigned long mTime = this->Superclass::GetMTime();
+  if (this->Skeleton)
+    {
+    mTime = std::max(mTime, this->Skeleton->GetMTime());
+    for (vtkIdType i = 0; i < this->Skeleton->GetNumberOfBones(); ++i)
+      {
+      mTime = std::max(mTime, this->Skeleton->GetBone(i)->GetMTime());
+      }
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneSkinningFilter::RequestData(vtkInformation* vtkNotUsed(request),
+                                       vtkInformationVector** inputVector,
+                                       vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkPolyData* input =
+    vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData* output =
+    vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  output->ShallowCopy(input);
+
+  vtkPoints* inPoints = input->GetPoints();
+  vtkIdType numberOfPoints = input->GetNumberOfPoints();
+  if (!inPoints || numberOfPoints == 0
+      || !this->Skeleton || this->Skeleton->GetNumberOfBones() == 0)
+    {
+    return 1;
+    }
+
+  if (inPoints->GetDataType() != VTK_FLOAT
+      && inPoints->GetDataType() != VTK_DOUBLE)
+    {
+    vtkErrorMacro("Only float and double points can be deformed.");
+    return 0;
+    }
+
+  if (!this->UpdateInfluences(input))
+    {
+    return 0;
+    }
+  this->UpdateBoneTransforms();
+
+  SkinningThreadData data;
+  data.SkinningMode = this->SkinningMode;
+  data.NumberOfPoints = numberOfPoints;
+  data.NumberOfInfluences = this->NumberOfInfluences;
+  data.InfluenceBones = &this->InfluenceBones[0];
+  data.InfluenceWeights = &this->InfluenceWeights[0];
+  data.BoneTransforms = &this->BoneTransforms[0];
+
+  vtkSmartPointer<vtkPoints> outPoints = vtkSmartPointer<vtkPoints>::New();
+  outPoints->SetDataType(inPoints->GetDataType());
+  outPoints->SetNumberOfPoints(numberOfPoints);
+  data.PointsType = inPoints->GetDataType();
+  data.InPoints = inPoints->GetData()->GetVoidPointer(0);
+  data.OutPoints = outPoints->GetData()->GetVoidPointer(0);
+
+  data.NormalsType = VTK_FLOAT;
+  data.InNormals = NULL;
+  data.OutNormals = NULL;
+  vtkDataArray* inNormals = input->GetPointData()->GetNormals();
+  vtkSmartPointer<vtkDataArray> outNormals;
+  if (inNormals && inNormals->GetNumberOfComponents() == 3
+      && (inNormals->GetDataType() == VTK_FLOAT
+          || inNormals->GetDataType() == VTK_DOUBLE))
+    {
+    outNormals.TakeReference(inNormals->NewInstance());
+    outNormals->SetName(inNormals->GetName());
+    outNormals->SetNumberOfComponents(3);
+    outNormals->SetNumberOfTuples(numberOfPoints);
+    data.NormalsType = inNormals->GetDataType();
+    data.InNormals = inNormals->GetVoidPointer(0);
+    data.OutNormals = outNormals->GetVoidPointer(0);
+    }
+
+  int numberOfThreads = this->NumberOfThreads;
+  if (numberOfPoints < numberOfThreads)
+    {
+    numberOfThreads = 1;
+    }
+  this->Threader->SetNumberOfThreads(numberOfThreads);
+  this->Threader->SetSingleMethod(SkinningThread, &data);
+  this->Threader->SingleMethodExecute();
+
+  output->SetPoints(outPoints);
+  if (outNormals)
+    {
+    output->GetPointData()->SetNormals(outNormals);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkBoneSkinningFilter::UpdateInfluences(vtkPolyData* input)
+{
+  vtkDataArray* indices =
+    input->GetPointData()->GetArray(this->BoneIndicesArrayName);
+  vtkDataArray* weights =
+    input->GetPointData()->GetArray(this->BoneWeightsArrayName);
+  if (!indices || !weights)
+    {
+    vtkErrorMacro("No bone indices array (" << this->BoneIndicesArrayName
+                  << ") or bone weights array (" << this->BoneWeightsArrayName
+                  << ") in the input point data.");
+    return false;
+    }
+
+  int numberOfInfluences = indices->GetNumberOfComponents();
+  if (numberOfInfluences != weights->GetNumberOfComponents())
+    {
+    vtkErrorMacro("The bone indices and the bone weights arrays must have"
+                  " the same number of components.");
+    return false;
+    }
+
+  vtkIdType numberOfPoints = input->GetNumberOfPoints();
+  vtkIdType numberOfBones = this->Skeleton->GetNumberOfBones();
+  if (indices == this->InfluencesIndicesArray
+      && weights == this->InfluencesWeightsArray
+      && numberOfPoints == this->InfluencesNumberOfPoints
+      && numberOfBones == this->InfluencesNumberOfBones
+      && indices->GetMTime() <= this->InfluencesTime
+      && weights->GetMTime() <= this->InfluencesTime)
+    {
+    return true;
+    }
+
+  // The last bone transform is the identity, it takes the points without
+  // weights and the invalid bone ids.
+  const int identity = static_cast<int>(numberOfBones);
+
+  this->NumberOfInfluences = numberOfInfluences;
+  this->InfluenceBones.resize(numberOfInfluences * numberOfPoints);
+  this->InfluenceWeights.resize(numberOfInfluences * numberOfPoints);
+  std::vector<double> pointIndices(numberOfInfluences);
+  std::vector<double> pointWeights(numberOfInfluences);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    indices->GetTuple(i, &pointIndices[0]);
+    weights->GetTuple(i, &pointWeights[0]);
+
+    double sum = 0.0;
+    for (int j = 0; j < numberOfInfluences; ++j)
+      {
+      sum += pointWeights[j];
+      }
+
+    int* bones = &this->InfluenceBones[numberOfInfluences * i];
+    float* boneWeights = &this->InfluenceWeights[numberOfInfluences * i];
+    for (int j = 0; j < numberOfInfluences; ++j)
+      {
+      vtkIdType bone = static_cast<vtkIdType>(pointIndices[j]);
+      bones[j] = (bone >= 0 && bone < numberOfBones) ?
+        static_cast<int>(bone) : identity;
+      boneWeights[j] = sum > 0.0 ?
+        static_cast<float>(pointWeights[j] / sum) : 0.0f;
+      }
+    if (sum <= 0.0)
+      {
+      bones[0] = identity;
+      boneWeights[0] = 1.0f;
+      }
+    }
+
+  this->InfluencesIndicesArray = indices;
+  this->InfluencesWeightsArray = weights;
+  this->InfluencesNumberOfPoints = numberOfPoints;
+  this->InfluencesNumberOfBones = numberOfBones;
+  this->InfluencesTime = std::max(indices->GetMTime(), weights->GetMTime());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkinningFilter::UpdateBoneTransforms()
+{
+  vtkIdType numberOfBones = this->Skeleton->GetNumberOfBones();
+  int size = this->SkinningMode == vtkBoneSkinningFilter::DualQuaternion ?
+    8 : 12;
+  this->BoneTransforms.resize(size * (numberOfBones + 1));
+
+  for (vtkIdType i = 0; i <= numberOfBones; ++i)
+    {
+    // Rigid motion from the rest position to the pose position:
+    // p' = Pose * (p - RestHead) + PoseHead
+    vtkBoneRigidTransform motion;
+    vtkBoneWidget* bone = i < numberOfBones ? this->Skeleton->GetBone(i) : NULL;
+    if (bone && bone->GetWidgetState() == vtkBoneWidget::Pose)
+      {
+      vtkBoneVector3d restHead(bone->GetHeadRestWorldPosition());
+      vtkBoneVector3d poseHead(bone->GetHeadPoseWorldPosition());
+      motion = vtkBoneRigidTransform(
+        vtkBoneQuaterniond(bone->GetPoseTransform()), poseHead)
+        * vtkBoneRigidTransform(vtkBoneQuaterniond(), -restHead);
+      motion.Normalize();
+      }
+
+    double* transform = &this->BoneTransforms[size * i];
+    if (this->SkinningMode == vtkBoneSkinningFilter::DualQuaternion)
+      {
+      // real = q, dual = 1/2 * (0, t) * q
+      const vtkBoneQuaterniond& real = motion.GetRotationQuaternion();
+      const vtkBoneVector3d& t = motion.GetTranslationVector();
+      vtkBoneQuaterniond dual =
+        vtkBoneQuaterniond(0.0, 0.5*t[0], 0.5*t[1], 0.5*t[2]) * real;
+      real.CopyTo(transform);
+      dual.CopyTo(transform + 4);
+      }
+    else
+      {
+      // The 3 first rows of the matrix
+      double elements[16];
+      motion.GetMatrix(elements);
+      std::copy(elements, elements + 12, transform);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneSkinningFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Skeleton: " << this->Skeleton << "\n";
+  os << indent << "Skinning Mode: "
+     << (this->SkinningMode == vtkBoneSkinningFilter::DualQuaternion ?
+         "DualQuaternion" : "LinearBlend") << "\n";
+  os << indent << "Bone Indices Array Name: "
+     << (this->BoneIndicesArrayName ? this->BoneIndicesArrayName : "(none)")
+     << "\n";
+  os << indent << "Bone Weights Array Name: "
+     << (this->BoneWeightsArrayName ? this->BoneWeightsArrayName : "(none)")
+     << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneSkinningFilter_h
+#define __vtkBoneSkinningFilter_h
+
+// .NAME vtkBoneSkinningFilter - Deform a mesh with the bones of a skeleton
+// .SECTION Description
+// vtkBoneSkinningFilter takes a mesh in the rest position of a skeleton and
+// outputs the mesh deformed by the pose of the bones.
+//
+// Each point is influenced by a fixed number of bones, given by two point
+// data arrays with the same number of components:
+//  - the bone indices array (BoneIndicesArrayName, "BoneIndices" by default)
+//    holds the ids of the influencing bones in the skeleton,
+//  - the bone weights array (BoneWeightsArrayName, "BoneWeights" by default)
+//    holds their weights.
+// The weights are normalized per point. Points without any weight and
+// invalid bone ids are not moved. Bones that are not in pose mode do not
+// move the points they influence.
+//
+// Each bone moves the points rigidly from its rest position to its pose
+// position. The rigid motions are blended with one of two modes:
+//  - LinearBlend: the matrices are averaged (linear blend skinning). It is
+//    the fastest but the mesh collapses around joints with large rotations.
+//  - DualQuaternion: the dual quaternions are averaged (dual quaternion
+//    skinning). It keeps the volume around the joints.
+// The point normals, if any, are rotated as well.
+//
+// The influences are converted once in an internal layout (cached until
+// the arrays, the number of points or the number of bones change), so that
+// moving the bones only costs the blending. The points are split between
+// several threads and the blending loops work on contiguous fixed size
+// arrays the compiler vectorizes.
+// .SECTION See Also
+// vtkBoneSkeleton vtkBoneWidget
+
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vector>
+//ETX
+
+class vtkBoneSkeleton;
+class vtkDataArray;
+class vtkMultiThreader;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneSkinningFilter : public vtkPolyDataAlgorithm
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneSkinningFilter *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneSkinningFilter, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the skeleton whose bones deform the mesh. The bone indices of
+  // the points are ids in this skeleton.
+  void SetSkeleton(vtkBoneSkeleton* skeleton);
+  vtkGetObjectMacro(Skeleton, vtkBoneSkeleton);
+
+  //BTX
+  enum SkinningModeType {LinearBlend = 0, DualQuaternion};
+  //ETX
+
+  // Description:
+  // Set/Get the skinning mode. LinearBlend by default.
+  vtkSetClampMacro(SkinningMode, int, LinearBlend, DualQuaternion);
+  vtkGetMacro(SkinningMode, int);
+  void SetSkinningModeToLinearBlend()
+    { this->SetSkinningMode(vtkBoneSkinningFilter::LinearBlend); }
+  void SetSkinningModeToDualQuaternion()
+    { this->SetSkinningMode(vtkBoneSkinningFilter::DualQuaternion); }
+
+  // Description:
+  // Set/Get the names of the point data arrays holding the bone indices
+  // and the bone weights.
+  vtkSetStringMacro(BoneIndicesArrayName);
+  vtkGetStringMacro(BoneIndicesArrayName);
+  vtkSetStringMacro(BoneWeightsArrayName);
+  vtkGetStringMacro(BoneWeightsArrayName);
+
+  // Description:
+  // Set/Get the number of threads used to deform the points.
+  // By default, vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Overridden to take the bones into account.
+  unsigned long GetMTime();
+
+protected:
+  vtkBoneSkinningFilter();
+  ~vtkBoneSkinningFilter();
+
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  // Description:
+  // Convert the influences of the input into the internal layout if
+  // the arrays changed. Return false if the arrays are invalid.
+  bool UpdateInfluences(vtkPolyData* input);
+
+  // Description:
+  // Compute the per bone matrices (LinearBlend) or dual quaternions
+  // (DualQuaternion) from the bones rest and pose positions.
+  // The last entry is the identity, used for the points without weights.
+  void UpdateBoneTransforms();
+
+  vtkBoneSkeleton* Skeleton;
+  int SkinningMode;
+  char* BoneIndicesArrayName;
+  char* BoneWeightsArrayName;
+  int NumberOfThreads;
+  vtkMultiThreader* Threader;
+
+//BTX
+  // Influences, NumberOfInfluences per point
+  int NumberOfInfluences;
+  std::vector<int> InfluenceBones;
+  std::vector<float> InfluenceWeights;
+
+  // What the influences were computed from
+  vtkIdType InfluencesNumberOfPoints;
+  vtkIdType InfluencesNumberOfBones;
+  vtkDataArray* InfluencesIndicesArray;
+  vtkDataArray* InfluencesWeightsArray;
+  unsigned long InfluencesTime;
+
+  // 12 values per bone (3x4 row major matrix) for the linear blend,
+  // 8 values (real and dual quaternions) for the dual quaternions.
+  std::vector<double> BoneTransforms;
+//ETX
+
+private:
+  vtkBoneSkinningFilter(const vtkBoneSkinningFilter&);  //Not implemented
+  void operator=(const vtkBoneSkinningFilter&);  //Not implemented
+};
+
+#endif
@@ -0,0 +1,214 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneTwoBoneIKSolver.h"
+
+//My includes
+#include "vtkBoneMath.h"
+#include "vtkBoneRepresentation.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkObjectFactory.h>
+
+//STL includes
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(vtkBoneTwoBoneIKSolver);
+
+//----------------------------------------------------------------------------
+vtkBoneTwoBoneIKSolver::vtkBoneTwoBoneIKSolver()
+{
+  this->UpperBone = NULL;
+  this->LowerBone = NULL;
+  this->Target[0] = this->Target[1] = this->Target[2] = 0.0;
+  this->PoleVector[0] = this->PoleVector[1] = this->PoleVector[2] = 0.0;
+  this->TargetReached = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneTwoBoneIKSolver::~vtkBoneTwoBoneIKSolver()
+{
+  this->SetUpperBone(NULL);
+  this->SetLowerBone(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneTwoBoneIKSolver::SetUpperBone(vtkBoneWidget* bone)
+{
+  if (bone == this->UpperBone)
+    {
+    return;
+    }
+
+  if (this->UpperBone)
+    {
+    this->UpperBone->UnRegister(this);
+    }
+  this->UpperBone = bone;
+  if (this->UpperBone)
+    {
+    this->UpperBone->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneTwoBoneIKSolver::SetLowerBone(vtkBoneWidget* bone)
+{
+  if (bone == this->LowerBone)
+    {
+    return;
+    }
+
+  if (this->LowerBone)
+    {
+    this->LowerBone->UnRegister(this);
+    }
+  this->LowerBone = bone;
+  if (this->LowerBone)
+    {
+    this->LowerBone->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneTwoBoneIKSolver::Solve()
+{
+  vtkBoneWidget* upper = this->UpperBone;
+  vtkBoneWidget* lower = this->LowerBone;
+  if (!upper || !lower || lower->GetBoneParent() != upper)
+    {
+    vtkErrorMacro("The lower bone must be a child of the upper bone.");
+    return 0;
+    }
+  if (upper->GetWidgetState() != vtkBoneWidget::Pose
+      || lower->GetWidgetState() != vtkBoneWidget::Pose)
+    {
+    vtkErrorMacro("The bones must be in pose mode.");
+    return 0;
+    }
+
+  vtkBoneRepresentation* upperRep = upper->GetBoneRepresentation();
+  vtkBoneRepresentation* lowerRep = lower->GetBoneRepresentation();
+  vtkBoneVector3d root(upperRep->GetHeadWorldPosition());
+  vtkBoneVector3d upperTail(upperRep->GetTailWorldPosition());
+  vtkBoneVector3d joint(lowerRep->GetHeadWorldPosition());
+  vtkBoneVector3d lowerTail(lowerRep->GetTailWorldPosition());
+
+  // The joint moves with the upper bone, even if the lower bone is not
+  // linked to the upper bone tail.
+  double upperLength = (joint - root).Norm();
+  double lowerLength = (lowerTail - joint).Norm();
+  if (upperLength <= 0.0 || lowerLength <= 0.0)
+    {
+    vtkErrorMacro("The bones have a null length.");
+    return 0;
+    }
+
+  // Direction and distance of the target, clamped to the reach
+  vtkBoneVector3d toTarget = vtkBoneVector3d(this->Target) - root;
+  double distance = toTarget.Norm();
+  vtkBoneVector3d direction =
+    distance > 0.0 ? toTarget * (1.0 / distance) : (lowerTail - root);
+  direction.Normalize();
+  double minimumReach = fabs(upperLength - lowerLength);
+  double maximumReach = upperLength + lowerLength;
+  this->TargetReached =
+    (distance >= minimumReach && distance <= maximumReach) ? 1 : 0;
+  distance = std::min(std::max(distance, minimumReach), maximumReach);
+
+  // Bending direction: the pole vector, or the current joint, orthogonal
+  // to the target direction.
+  const double epsilon = 1e-12;
+  vtkBoneVector3d bend(this->PoleVector);
+  bend = bend - direction * direction.Dot(bend);
+  if (bend.SquaredNorm() <= epsilon)
+    {
+    bend = joint - root;
+    bend = bend - direction * direction.Dot(bend);
+    }
+  if (bend.SquaredNorm() <= epsilon * upperLength * upperLength)
+    {
+    // Straight chain toward the target: any orthogonal direction
+    bend = direction.Cross(vtkBoneVector3d(0.0, 0.0, 1.0));
+    if (bend.SquaredNorm() <= epsilon)
+      {
+      bend = direction.Cross(vtkBoneVector3d(1.0, 0.0, 0.0));
+      }
+    }
+  bend.Normalize();
+
+  // Law of cosines in the triangle root, joint, target
+  double cosine = distance > 0.0 ?
+    (upperLength * upperLength + distance * distance
+     - lowerLength * lowerLength) / (2.0 * upperLength * distance) : 0.0;
+  cosine = std::min(std::max(cosine, -1.0), 1.0);
+  double sine = sqrt(1.0 - cosine * cosine);
+  vtkBoneVector3d newJoint =
+    root + (direction * cosine + bend * sine) * upperLength;
+
+  // The two rotations, in world coordinates
+  vtkBoneQuaterniond upperRotation =
+    vtkBoneQuaterniond::FromTwoVectors(joint - root, newJoint - root);
+  vtkBoneVector3d rotatedLower = upperRotation.Rotate(lowerTail - joint);
+  vtkBoneQuaterniond lowerRotation =
+    vtkBoneQuaterniond::FromTwoVectors(rotatedLower,
+                                       root + direction * distance - newJoint)
+    * upperRotation;
+  lowerRotation.Normalize();
+
+  vtkBoneVector3d newUpperTail = root + upperRotation.Rotate(upperTail - root);
+  vtkBoneVector3d newLowerTail = newJoint + lowerRotation.Rotate(lowerTail - joint);
+
+  vtkBoneQuaterniond upperPose =
+    upperRotation * vtkBoneQuaterniond(upper->GetPoseTransform());
+  vtkBoneQuaterniond lowerPose =
+    lowerRotation * vtkBoneQuaterniond(lower->GetPoseTransform());
+  upperPose.Normalize();
+  lowerPose.Normalize();
+
+  // Both bones are posed before a single propagation from the upper bone.
+  // The local pose points of the lower bone are computed in the new upper
+  // bone frame, so that the lower bone keeps its pose whether it follows
+  // with the forward kinematics of a shared skeleton or on
+  // PoseChangedEvent.
+  upper->SetPose(upperPose.GetData(), root.GetData(), newUpperTail.GetData());
+  lower->SetPose(lowerPose.GetData(),
+                 newJoint.GetData(), newLowerTail.GetData());
+  upper->PropagatePose();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneTwoBoneIKSolver::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Upper Bone: " << this->UpperBone << "\n";
+  os << indent << "Lower Bone: " << this->LowerBone << "\n";
+  os << indent << "Target: " << this->Target[0] << " "
+     << this->Target[1] << " " << this->Target[2] << "\n";
+  os << indent << "Pole Vector: " << this->PoleVector[0] << " "
+     << this->PoleVector[1] << " " << this->PoleVector[2] << "\n";
+  os << indent << "Target Reached: " << this->TargetReached << "\n";
+}
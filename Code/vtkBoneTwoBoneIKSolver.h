@@ -0,0 +1,100 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneTwoBoneIKSolver_h
+#define __vtkBoneTwoBoneIKSolver_h
+
+// .NAME vtkBoneTwoBoneIKSolver - Closed form inverse kinematics of two bones
+// .SECTION Description
+// vtkBoneTwoBoneIKSolver poses a chain of two bones in pose mode, e.g. an
+// arm, such that the tail of the lower bone reaches the Target. The head
+// of the upper bone does not move and the bones keep their length: the
+// joint (the head of the lower bone) is found with the law of cosines, in
+// the plane of the target and of the PoleVector.
+//
+// Solve() sets the pose transforms of both bones directly, from two
+// shortest arc rotations, with vtkBoneWidget::SetPose(). The pose is then
+// propagated once from the upper bone. No iteration
+// is involved: it is cheap enough to run at each mouse move while a
+// target is dragged.
+// .SECTION See Also
+// vtkBoneWidget vtkBoneSkeleton
+
+#include "vtkObject.h"
+#include "vtkBoneWidgetHeader.h"
+
+class vtkBoneWidget;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneTwoBoneIKSolver : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneTwoBoneIKSolver *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneTwoBoneIKSolver, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the bones of the chain. The lower bone must be a child of the
+  // upper bone and both must be in pose mode when solving.
+  void SetUpperBone(vtkBoneWidget* bone);
+  vtkGetObjectMacro(UpperBone, vtkBoneWidget);
+  void SetLowerBone(vtkBoneWidget* bone);
+  vtkGetObjectMacro(LowerBone, vtkBoneWidget);
+
+  // Description:
+  // Set/Get the world position the tail of the lower bone must reach.
+  vtkSetVector3Macro(Target, double);
+  vtkGetVector3Macro(Target, double);
+
+  // Description:
+  // Set/Get the direction, in world coordinates, toward which the joint
+  // bends. A null vector (default) keeps the current bending plane.
+  vtkSetVector3Macro(PoleVector, double);
+  vtkGetVector3Macro(PoleVector, double);
+
+  // Description:
+  // Pose the bones. A target out of reach is approached as much as
+  // possible. Return 1 on success, 0 if the bones cannot be posed.
+  int Solve();
+
+  // Description:
+  // Return 1 if the target was within reach at the last Solve().
+  vtkGetMacro(TargetReached, int);
+
+protected:
+  vtkBoneTwoBoneIKSolver();
+  ~vtkBoneTwoBoneIKSolver();
+
+  vtkBoneWidget* UpperBone;
+  vtkBoneWidget* LowerBone;
+  double Target[3];
+  double PoleVector[3];
+  int TargetReached;
+
+private:
+  vtkBoneTwoBoneIKSolver(const vtkBoneTwoBoneIKSolver&);  //Not implemented
+  void operator=(const vtkBoneTwoBoneIKSolver&);  //Not implemented
+};
+
+#endif
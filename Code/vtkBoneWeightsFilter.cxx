@@ -0,0 +1,719 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkBoneWeightsFilter.h"
+
+//My includes
+#include "vtkBoneMath.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+//VTK Includes
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkIntArray.h>
+#include <vtkMultiThreader.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+//STL includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkBoneWeightsFilter);
+
+namespace
+{
+
+// Symmetric sparse matrix: the diagonal apart, the off diagonal terms
+// in compressed rows.
+struct SparseMatrix
+{
+  std::vector<double>    Diagonal;
+  std::vector<vtkIdType> RowOffsets;
+  std::vector<vtkIdType> Columns;
+  std::vector<double>    Values;
+
+  // y = A x
+  void Multiply(const double* x, double* y) const
+    {
+    vtkIdType n = static_cast<vtkIdType>(this->Diagonal.size());
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      double sum = this->Diagonal[i] * x[i];
+      for (vtkIdType j = this->RowOffsets[i]; j < this->RowOffsets[i + 1]; ++j)
+        {
+        sum += this->Values[j] * x[this->Columns[j]];
+        }
+      y[i] = sum;
+      }
+    }
+};
+
+struct Triplet
+{
+  vtkIdType Row;
+  vtkIdType Column;
+  double Value;
+
+  bool operator<(const Triplet& other) const
+    {
+    return this->Row < other.Row
+      || (this->Row == other.Row && this->Column < other.Column);
+    }
+};
+
+// Everything the threads share
+struct WeightsThreadData
+{
+  int WeightingMode;
+  int NumberOfInfluences;
+  double EnvelopeRadius;
+  double DistancePower;
+  double Tolerance;
+  int MaximumNumberOfIterations;
+
+  vtkIdType NumberOfPoints;
+  const double* Points;
+  int NumberOfBones;
+  const double* Heads;
+  const double* Tails;
+
+  // NumberOfInfluences per point, sorted by decreasing weight
+  int* InfluenceBones;
+  double* InfluenceWeights;
+
+  // HeatDiffusion mode
+  int* ClosestBones;
+  const double* Heat;
+  const SparseMatrix* Matrix;
+  int FirstBone;
+  int NumberOfSolutions;
+  std::vector<double>* Solutions;
+};
+
+//----------------------------------------------------------------------------
+double SquaredDistanceToSegment(const double* p, const double* a,
+                                const double* b)
+{
+  vtkBoneVector3d ab = vtkBoneVector3d(b) - vtkBoneVector3d(a);
+  vtkBoneVector3d ap = vtkBoneVector3d(p) - vtkBoneVector3d(a);
+  double length2 = ab.SquaredNorm();
+  double t = length2 > 0.0 ? ap.Dot(ab) / length2 : 0.0;
+  t = std::max(0.0, std::min(1.0, t));
+  return (ap - ab * t).SquaredNorm();
+}
+
+//----------------------------------------------------------------------------
+int ClosestBone(const WeightsThreadData* data, const double* p,
+                double* distance2)
+{
+  int closest = 0;
+  *distance2 = VTK_DOUBLE_MAX;
+  for (int b = 0; b < data->NumberOfBones; ++b)
+    {
+    double d2 = SquaredDistanceToSegment(p, data->Heads + 3*b,
+                                         data->Tails + 3*b);
+    if (d2 < *distance2)
+      {
+      *distance2 = d2;
+      closest = b;
+      }
+    }
+  return closest;
+}
+
+//----------------------------------------------------------------------------
+// Keep the k largest weights, sorted by decreasing weight
+void InsertInfluence(int* bones, double* weights, int k, int bone,
+                     double weight)
+{
+  if (weight <= weights[k - 1])
+    {
+    return;
+    }
+  int i = k - 1;
+  for (; i > 0 && weights[i - 1] < weight; --i)
+    {
+    bones[i] = bones[i - 1];
+    weights[i] = weights[i - 1];
+    }
+  bones[i] = bone;
+  weights[i] = weight;
+}
+
+//----------------------------------------------------------------------------
+void PointRange(vtkMultiThreader::ThreadInfo* info, vtkIdType n,
+                vtkIdType& begin, vtkIdType& end)
+{
+  begin = n * info->ThreadID / info->NumberOfThreads;
+  end = n * (info->ThreadID + 1) / info->NumberOfThreads;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE EnvelopeThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const WeightsThreadData* data =
+    static_cast<const WeightsThreadData*>(info->UserData);
+  const int k = data->NumberOfInfluences;
+  const double radius2 = data->EnvelopeRadius * data->EnvelopeRadius;
+
+  vtkIdType begin, end;
+  PointRange(info, data->NumberOfPoints, begin, end);
+  std::vector<double> distances2(data->NumberOfBones);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    const double* p = data->Points + 3*i;
+    int* bones = data->InfluenceBones + k*i;
+    double* weights = data->InfluenceWeights + k*i;
+
+    int closest = 0;
+    for (int b = 0; b < data->NumberOfBones; ++b)
+      {
+      distances2[b] = SquaredDistanceToSegment(p, data->Heads + 3*b,
+                                               data->Tails + 3*b);
+      if (distances2[b] < distances2[closest])
+        {
+        closest = b;
+        }
+      }
+
+    // Weights relative to the closest bone, in ]0, 1]
+    double minDistance = std::max(sqrt(distances2[closest]), 1e-12);
+    for (int b = 0; b < data->NumberOfBones; ++b)
+      {
+      if (b != closest && radius2 > 0.0 && distances2[b] > radius2)
+        {
+        continue;
+        }
+      double distance = std::max(sqrt(distances2[b]), minDistance);
+      InsertInfluence(bones, weights, k, b,
+                      pow(minDistance / distance, data->DistancePower));
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE ClosestBoneThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const WeightsThreadData* data =
+    static_cast<const WeightsThreadData*>(info->UserData);
+
+  // The heat is written in the solutions buffer of the first thread
+  double* heat = &(*data->Solutions)[0];
+
+  vtkIdType begin, end;
+  PointRange(info, data->NumberOfPoints, begin, end);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    double distance2;
+    data->ClosestBones[i] = ClosestBone(data, data->Points + 3*i, &distance2);
+    heat[i] = 1.0 / std::max(distance2, 1e-12);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Solve (A) x = b with a Jacobi preconditioned conjugate gradient.
+// x holds the initial guess.
+void SolveConjugateGradient(const SparseMatrix& matrix, const double* b,
+                            double* x, double tolerance, int maxIterations)
+{
+  vtkIdType n = static_cast<vtkIdType>(matrix.Diagonal.size());
+  std::vector<double> r(n), z(n), p(n), ap(n);
+
+  double bNorm2 = 0.0;
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    bNorm2 += b[i] * b[i];
+    }
+  if (bNorm2 <= 0.0)
+    {
+    std::fill(x, x + n, 0.0);
+    return;
+    }
+
+  matrix.Multiply(x, &ap[0]);
+  double rz = 0.0;
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    r[i] = b[i] - ap[i];
+    z[i] = r[i] / matrix.Diagonal[i];
+    p[i] = z[i];
+    rz += r[i] * z[i];
+    }
+
+  const double threshold2 = tolerance * tolerance * bNorm2;
+  for (int iteration = 0; iteration < maxIterations; ++iteration)
+    {
+    matrix.Multiply(&p[0], &ap[0]);
+    double pap = 0.0;
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      pap += p[i] * ap[i];
+      }
+    if (pap <= 0.0)
+      {
+      break;
+      }
+
+    double alpha = rz / pap;
+    double rNorm2 = 0.0;
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * ap[i];
+      rNorm2 += r[i] * r[i];
+      }
+    if (rNorm2 <= threshold2)
+      {
+      break;
+      }
+
+    double newRz = 0.0;
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      z[i] = r[i] / matrix.Diagonal[i];
+      newRz += r[i] * z[i];
+      }
+    double beta = newRz / rz;
+    rz = newRz;
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      p[i] = z[i] + beta * p[i];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE HeatSolveThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const WeightsThreadData* data =
+    static_cast<const WeightsThreadData*>(info->UserData);
+
+  // One bone per thread
+  int bone = data->FirstBone + info->ThreadID;
+  if (info->ThreadID >= data->NumberOfSolutions)
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // b = M H p, p being 1 where the bone is the closest.
+  // The initial guess is p.
+  vtkIdType n = data->NumberOfPoints;
+  std::vector<double> b(n);
+  double* x = &data->Solutions[info->ThreadID][0];
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    double closest = data->ClosestBones[i] == bone ? 1.0 : 0.0;
+    b[i] = data->Heat[i] * closest;
+    x[i] = closest;
+    }
+
+  SolveConjugateGradient(*data->Matrix, &b[0], x, data->Tolerance,
+                         data->MaximumNumberOfIterations);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE MergeSolutionsThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const WeightsThreadData* data =
+    static_cast<const WeightsThreadData*>(info->UserData);
+  const int k = data->NumberOfInfluences;
+
+  vtkIdType begin, end;
+  PointRange(info, data->NumberOfPoints, begin, end);
+  for (int s = 0; s < data->NumberOfSolutions; ++s)
+    {
+    const double* solution = &data->Solutions[s][0];
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      InsertInfluence(data->InfluenceBones + k*i,
+                      data->InfluenceWeights + k*i, k,
+                      data->FirstBone + s, solution[i]);
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Cotangent Laplacian of the polygons (triangulated as fans) and lumped
+// point areas.
+void BuildLaplacian(vtkPolyData* input, const double* points,
+                    SparseMatrix& laplacian, std::vector<double>& areas)
+{
+  vtkIdType n = input->GetNumberOfPoints();
+  laplacian.Diagonal.assign(n, 0.0);
+  areas.assign(n, 0.0);
+
+  std::vector<Triplet> triplets;
+  vtkCellArray* polys = input->GetPolys();
+  vtkIdType npts;
+  vtkIdType* pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+    for (vtkIdType t = 1; t + 1 < npts; ++t)
+      {
+      vtkIdType ids[3] = {pts[0], pts[t], pts[t + 1]};
+      vtkBoneVector3d corners[3];
+      for (int c = 0; c < 3; ++c)
+        {
+        corners[c] = vtkBoneVector3d(points + 3*ids[c]);
+        }
+      double area2 = (corners[1] - corners[0]).Cross(
+        corners[2] - corners[0]).Norm();
+      if (area2 <= 0.0)
+        {
+        continue;
+        }
+
+      for (int c = 0; c < 3; ++c)
+        {
+        areas[ids[c]] += area2 / 6.0;
+
+        // Half the cotangent of the corner weights the opposite edge
+        vtkIdType i = ids[(c + 1) % 3];
+        vtkIdType j = ids[(c + 2) % 3];
+        vtkBoneVector3d u = corners[(c + 1) % 3] - corners[c];
+        vtkBoneVector3d v = corners[(c + 2) % 3] - corners[c];
+        double weight = 0.5 * u.Dot(v) / u.Cross(v).Norm();
+
+        laplacian.Diagonal[i] += weight;
+        laplacian.Diagonal[j] += weight;
+        Triplet ij = {i, j, -weight};
+        Triplet ji = {j, i, -weight};
+        triplets.push_back(ij);
+        triplets.push_back(ji);
+        }
+      }
+    }
+
+  // Compress the rows, merging the duplicated edges
+  std::sort(triplets.begin(), triplets.end());
+  laplacian.RowOffsets.assign(n + 1, 0);
+  laplacian.Columns.clear();
+  laplacian.Values.clear();
+  for (size_t t = 0; t < triplets.size(); ++t)
+    {
+    if (t > 0 && triplets[t].Row == triplets[t - 1].Row
+        && triplets[t].Column == triplets[t - 1].Column)
+      {
+      laplacian.Values.back() += triplets[t].Value;
+      continue;
+      }
+    laplacian.Columns.push_back(triplets[t].Column);
+    laplacian.Values.push_back(triplets[t].Value);
+    ++laplacian.RowOffsets[triplets[t].Row + 1];
+    }
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    laplacian.RowOffsets[i + 1] += laplacian.RowOffsets[i];
+    }
+}
+
+}// end namespace
+
+//----------------------------------------------------------------------------
+vtkBoneWeightsFilter::vtkBoneWeightsFilter()
+{
+  this->Skeleton = NULL;
+  this->WeightingMode = vtkBoneWeightsFilter::Envelope;
+  this->MaximumNumberOfInfluences = 4;
+  this->EnvelopeRadius = 0.0;
+  this->DistancePower = 2.0;
+  this->Tolerance = 1e-6;
+  this->MaximumNumberOfIterations = 1000;
+  this->BoneIndicesArrayName = NULL;
+  this->BoneWeightsArrayName = NULL;
+  this->SetBoneIndicesArrayName("BoneIndices");
+  this->SetBoneWeightsArrayName("BoneWeights");
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->Threader = vtkMultiThreader::New();
+  this->BoneIndices = vtkIntArray::New();
+  this->BoneWeights = vtkFloatArray::New();
+  this->WeightsTime = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBoneWeightsFilter::~vtkBoneWeightsFilter()
+{
+  this->SetSkeleton(NULL);
+  this->SetBoneIndicesArrayName(NULL);
+  this->SetBoneWeightsArrayName(NULL);
+  this->Threader->Delete();
+  this->BoneIndices->Delete();
+  this->BoneWeights->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneWeightsFilter::SetSkeleton(vtkBoneSkeleton* skeleton)
+{
+  if (skeleton == this->Skeleton)
+    {
+    return;
+    }
+
+  if (this->Skeleton)
+    {
+    this->Skeleton->UnRegister(this);
+    }
+  this->Skeleton = skeleton;
+  if (this->Skeleton)
+    {
+    this->Skeleton->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkBoneWeightsFilter::GetMTime()
+{
+  unsigned long mTime = this->Superclass::GetMTime();
+  if (this->Skeleton)
+    {
+    mTime = std::max(mTime, this->Skeleton->GetMTime());
+    for (vtkIdType i = 0; i < this->Skeleton->GetNumberOfBones(); ++i)
+      {
+      mTime = std::max(mTime, this->Skeleton->GetBone(i)->GetMTime());
+      }
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkBoneWeightsFilter::RequestData(vtkInformation* vtkNotUsed(request),
+                                      vtkInformationVector** inputVector,
+                                      vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkPolyData* input =
+    vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData* output =
+    vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  output->ShallowCopy(input);
+
+  vtkIdType numberOfPoints = input->GetNumberOfPoints();
+  if (!this->Skeleton || this->Skeleton->GetNumberOfBones() == 0)
+    {
+    vtkErrorMacro("No bones to compute the weights from.");
+    return 0;
+    }
+  if (numberOfPoints == 0)
+    {
+    return 1;
+    }
+
+  // Rest segments of the bones
+  int numberOfBones = static_cast<int>(this->Skeleton->GetNumberOfBones());
+  std::vector<double> heads(3*numberOfBones), tails(3*numberOfBones);
+  std::vector<double> restSegments(6*numberOfBones);
+  for (int b = 0; b < numberOfBones; ++b)
+    {
+    this->Skeleton->GetBone(b)->GetHeadRestWorldPosition(&heads[3*b]);
+    this->Skeleton->GetBone(b)->GetTailRestWorldPosition(&tails[3*b]);
+    std::copy(&heads[3*b], &heads[3*b] + 3, &restSegments[6*b]);
+    std::copy(&tails[3*b], &tails[3*b] + 3, &restSegments[6*b + 3]);
+    }
+
+  // Posing the bones does not change the weights
+  if (restSegments == this->RestSegments
+      && input->GetMTime() <= this->WeightsTime
+      && this->Superclass::GetMTime() <= this->WeightsTime
+      && this->BoneIndices->GetNumberOfTuples() == numberOfPoints)
+    {
+    output->GetPointData()->AddArray(this->BoneIndices);
+    output->GetPointData()->AddArray(this->BoneWeights);
+    return 1;
+    }
+
+  std::vector<double> points(3*numberOfPoints);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    input->GetPoint(i, &points[3*i]);
+    }
+
+  const int k = this->MaximumNumberOfInfluences;
+  std::vector<int> influenceBones(k*numberOfPoints, 0);
+  std::vector<double> influenceWeights(k*numberOfPoints, 0.0);
+
+  WeightsThreadData data;
+  data.WeightingMode = this->WeightingMode;
+  data.NumberOfInfluences = k;
+  data.EnvelopeRadius = this->EnvelopeRadius;
+  data.DistancePower = this->DistancePower;
+  data.Tolerance = this->Tolerance;
+  data.MaximumNumberOfIterations = this->MaximumNumberOfIterations;
+  data.NumberOfPoints = numberOfPoints;
+  data.Points = &points[0];
+  data.NumberOfBones = numberOfBones;
+  data.Heads = &heads[0];
+  data.Tails = &tails[0];
+  data.InfluenceBones = &influenceBones[0];
+  data.InfluenceWeights = &influenceWeights[0];
+  data.ClosestBones = NULL;
+  data.Heat = NULL;
+  data.Matrix = NULL;
+  data.FirstBone = 0;
+  data.NumberOfSolutions = 0;
+  data.Solutions = NULL;
+
+  int numberOfThreads = numberOfPoints < this->NumberOfThreads ?
+    1 : this->NumberOfThreads;
+  this->Threader->SetNumberOfThreads(numberOfThreads);
+
+  std::vector<int> closestBones;
+  if (this->WeightingMode == vtkBoneWeightsFilter::Envelope)
+    {
+    this->Threader->SetSingleMethod(EnvelopeThread, &data);
+    this->Threader->SingleMethodExecute();
+    }
+  else
+    {
+    int numberOfSolutions = std::min(this->NumberOfThreads, numberOfBones);
+    std::vector<std::vector<double> > solutions(numberOfSolutions,
+      std::vector<double>(numberOfPoints));
+    data.Solutions = &solutions[0];
+
+    // Closest bones and heat (written in the first solution)
+    closestBones.resize(numberOfPoints);
+    data.ClosestBones = &closestBones[0];
+    this->Threader->SetSingleMethod(ClosestBoneThread, &data);
+    this->Threader->SingleMethodExecute();
+    this->UpdateProgress(0.1);
+
+    // A = L + M H. The isolated points (no area) take the closest bone:
+    // their row is the identity.
+    SparseMatrix matrix;
+    std::vector<double> areas;
+    BuildLaplacian(input, &points[0], matrix, areas);
+    std::vector<double> heat(numberOfPoints);
+    for (vtkIdType i = 0; i < numberOfPoints; ++i)
+      {
+      heat[i] = areas[i] > 0.0 ? areas[i] * solutions[0][i] : 1.0;
+      matrix.Diagonal[i] += heat[i];
+      }
+    data.Heat = &heat[0];
+    data.Matrix = &matrix;
+    this->UpdateProgress(0.2);
+
+    // Solve the bones by batches of one bone per thread
+    for (int bone = 0; bone < numberOfBones; bone += numberOfSolutions)
+      {
+      data.FirstBone = bone;
+      data.NumberOfSolutions = std::min(numberOfSolutions,
+                                        numberOfBones - bone);
+      this->Threader->SetNumberOfThreads(data.NumberOfSolutions);
+      this->Threader->SetSingleMethod(HeatSolveThread, &data);
+      this->Threader->SingleMethodExecute();
+
+      this->Threader->SetNumberOfThreads(numberOfThreads);
+      this->Threader->SetSingleMethod(MergeSolutionsThread, &data);
+      this->Threader->SingleMethodExecute();
+      this->UpdateProgress(0.2 + 0.8 * (bone + data.NumberOfSolutions)
+                           / numberOfBones);
+      }
+    }
+
+  // Normalize. Points without any positive weight take the closest bone.
+  // New arrays: the previous ones may still be used downstream.
+  this->BoneIndices->Delete();
+  this->BoneIndices = vtkIntArray::New();
+  this->BoneIndices->SetName(this->BoneIndicesArrayName);
+  this->BoneIndices->SetNumberOfComponents(k);
+  this->BoneIndices->SetNumberOfTuples(numberOfPoints);
+  this->BoneWeights->Delete();
+  this->BoneWeights = vtkFloatArray::New();
+  this->BoneWeights->SetName(this->BoneWeightsArrayName);
+  this->BoneWeights->SetNumberOfComponents(k);
+  this->BoneWeights->SetNumberOfTuples(numberOfPoints);
+  int* outIndices = this->BoneIndices->GetPointer(0);
+  float* outWeights = this->BoneWeights->GetPointer(0);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    const int* bones = &influenceBones[k*i];
+    const double* boneWeights = &influenceWeights[k*i];
+    double sum = 0.0;
+    for (int j = 0; j < k; ++j)
+      {
+      sum += boneWeights[j];
+      }
+    for (int j = 0; j < k; ++j)
+      {
+      outIndices[k*i + j] = bones[j];
+      outWeights[k*i + j] =
+        sum > 0.0 ? static_cast<float>(boneWeights[j] / sum) : 0.0f;
+      }
+    if (sum <= 0.0)
+      {
+      double distance2;
+      outIndices[k*i] = ClosestBone(&data, &points[3*i], &distance2);
+      outWeights[k*i] = 1.0f;
+      }
+    }
+
+  this->RestSegments = restSegments;
+  this->WeightsTime =
+    std::max(input->GetMTime(), this->Superclass::GetMTime());
+  output->GetPointData()->AddArray(this->BoneIndices);
+  output->GetPointData()->AddArray(this->BoneWeights);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkBoneWeightsFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Skeleton: " << this->Skeleton << "\n";
+  os << indent << "Weighting Mode: "
+     << (this->WeightingMode == vtkBoneWeightsFilter::HeatDiffusion ?
+         "HeatDiffusion" : "Envelope") << "\n";
+  os << indent << "Maximum Number Of Influences: "
+     << this->MaximumNumberOfInfluences << "\n";
+  os << indent << "Envelope Radius: " << this->EnvelopeRadius << "\n";
+  os << indent << "Distance Power: " << this->DistancePower << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "Maximum Number Of Iterations: "
+     << this->MaximumNumberOfIterations << "\n";
+  os << indent << "Bone Indices Array Name: "
+     << (this->BoneIndicesArrayName ? this->BoneIndicesArrayName : "(none)")
+     << "\n";
+  os << indent << "Bone Weights Array Name: "
+     << (this->BoneWeightsArrayName ? this->BoneWeightsArrayName : "(none)")
+     << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+}
@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneWeightsFilter_h
+#define __vtkBoneWeightsFilter_h
+
+// .NAME vtkBoneWeightsFilter - Compute the bone influences of a mesh
+// .SECTION Description
+// vtkBoneWeightsFilter computes, for each point of a mesh in the rest
+// position of a skeleton, the bones influencing the point and their
+// weights. The output is the input mesh with two more point data arrays,
+// ready for vtkBoneSkinningFilter:
+//  - the bone indices array (BoneIndicesArrayName, "BoneIndices" by default)
+//    holds the ids of the influencing bones in the skeleton,
+//  - the bone weights array (BoneWeightsArrayName, "BoneWeights" by default)
+//    holds their normalized weights.
+// Both have MaximumNumberOfInfluences components. Unused influences have
+// a null weight. The bones are the segments between the rest head and
+// the rest tail of the bones of the skeleton.
+//
+// Two weighting modes are available:
+//  - Envelope: the weight of a bone is the inverse of the distance from the
+//    point to the bone to the power DistancePower. Bones farther than
+//    EnvelopeRadius are ignored (if positive), the closest bone always
+//    influences the point. It is fast but ignores the shape of the mesh.
+//  - HeatDiffusion: the weights of each bone diffuse on the surface like
+//    heat, from the points the bone is the closest to ("bone heat"). For each
+//    bone, the sparse system (L + M H) w = M H p is solved, where L is the
+//    cotangent Laplacian, M the lumped point areas, H = 1/d^2 with d the
+//    distance to the closest bone and p is 1 where the bone is the closest.
+//    It follows the shape of the mesh. Only the polygons are used
+//    (triangulated as fans); isolated points take the closest bone.
+//
+// The points are split between threads for the distance computations. In
+// HeatDiffusion mode, each thread solves the systems of different bones
+// with a Jacobi preconditioned conjugate gradient on the shared matrix.
+//
+// Posing the bones modifies the filter but the weights only depend on the
+// rest positions: they are not computed again unless the rest positions,
+// the input or the parameters changed.
+// .SECTION See Also
+// vtkBoneSkinningFilter vtkBoneSkeleton
+
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vector>
+//ETX
+
+class vtkBoneSkeleton;
+class vtkFloatArray;
+class vtkIntArray;
+class vtkMultiThreader;
+
+class VTK_BONEWIDGETS_EXPORT vtkBoneWeightsFilter : public vtkPolyDataAlgorithm
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkBoneWeightsFilter *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkBoneWeightsFilter, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the skeleton whose rest bones influence the mesh.
+  void SetSkeleton(vtkBoneSkeleton* skeleton);
+  vtkGetObjectMacro(Skeleton, vtkBoneSkeleton);
+
+  //BTX
+  enum WeightingModeType {Envelope = 0, HeatDiffusion};
+  //ETX
+
+  // Description:
+  // Set/Get the weighting mode. Envelope by default.
+  vtkSetClampMacro(WeightingMode, int, Envelope, HeatDiffusion);
+  vtkGetMacro(WeightingMode, int);
+  void SetWeightingModeToEnvelope()
+    { this->SetWeightingMode(vtkBoneWeightsFilter::Envelope); }
+  void SetWeightingModeToHeatDiffusion()
+    { this->SetWeightingMode(vtkBoneWeightsFilter::HeatDiffusion); }
+
+  // Description:
+  // Set/Get the maximum number of bones influencing a point, i.e. the
+  // number of components of the output arrays. 4 by default.
+  vtkSetClampMacro(MaximumNumberOfInfluences, int, 1, 64);
+  vtkGetMacro(MaximumNumberOfInfluences, int);
+
+  // Description:
+  // Envelope mode: bones farther than the radius do not influence the
+  // points. 0 (the default) means no limit.
+  vtkSetClampMacro(EnvelopeRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(EnvelopeRadius, double);
+
+  // Description:
+  // Envelope mode: power of the inverse distance. 2 by default.
+  vtkSetClampMacro(DistancePower, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(DistancePower, double);
+
+  // Description:
+  // HeatDiffusion mode: relative residual at which the conjugate gradient
+  // stops (1e-6 by default) and maximum number of iterations per bone
+  // (1000 by default).
+  vtkSetClampMacro(Tolerance, double, 0.0, 1.0);
+  vtkGetMacro(Tolerance, double);
+  vtkSetClampMacro(MaximumNumberOfIterations, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfIterations, int);
+
+  // Description:
+  // Set/Get the names of the output point data arrays.
+  vtkSetStringMacro(BoneIndicesArrayName);
+  vtkGetStringMacro(BoneIndicesArrayName);
+  vtkSetStringMacro(BoneWeightsArrayName);
+  vtkGetStringMacro(BoneWeightsArrayName);
+
+  // Description:
+  // Set/Get the number of threads.
+  // By default, vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Overridden to take the bones into account.
+  unsigned long GetMTime();
+
+protected:
+  vtkBoneWeightsFilter();
+  ~vtkBoneWeightsFilter();
+
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  vtkBoneSkeleton* Skeleton;
+  int WeightingMode;
+  int MaximumNumberOfInfluences;
+  double EnvelopeRadius;
+  double DistancePower;
+  double Tolerance;
+  int MaximumNumberOfIterations;
+  char* BoneIndicesArrayName;
+  char* BoneWeightsArrayName;
+  int NumberOfThreads;
+  vtkMultiThreader* Threader;
+
+//BTX
+  // Last computed weights and the rest segments (head and tail per bone)
+  // they were computed from.
+  vtkIntArray* BoneIndices;
+  vtkFloatArray* BoneWeights;
+  std::vector<double> RestSegments;
+  unsigned long WeightsTime;
+//ETX
+
+private:
+  vtkBoneWeightsFilter(const vtkBoneWeightsFilter&);  //Not implemented
+  void operator=(const vtkBoneWeightsFilter&);  //Not implemented
+};
+
+#endif
@@ -21,6 +21,9 @@
 #include "vtkBoneWidget.h"
 
 //My includes
+#include "vtkBonePickingTree.h"
+#include "vtkBoneProfiler.h"
+#include "vtkBoneRenderScheduler.h"
 #include "vtkBoneRepresentation.h"
 
 //VTK Includes
@@ -35,6 +38,7 @@
 #include <vtkLineWidget2.h>
 #include <vtkMath.h>
 #include <vtkMatrix3x3.h>
+#include <vtkMatrix4x4.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointHandleRepresentation3D.h>
 #include <vtkProperty.h>
@@ -45,6 +49,10 @@
 #include <vtkTransform.h>
 #include <vtkWidgetCallbackMapper.h>
 #include <vtkWidgetEvent.h>
+#include <vtkWidgetEventTranslator.h>
+
+//STL includes
+#include <algorithm>
 
 vtkStandardNewMacro(vtkBoneWidget);
 
@@ -56,36 +64,17 @@ static const double Z[3] = {0.0, 0.0, 1.0};
 namespace
 {
 
-void MultiplyQuaternion(double* quad1, double* quad2, double resultQuad[4])
+void MultiplyQuaternion(const double* quad1, const double* quad2,
+                        double resultQuad[4])
 {
   //Quaternion are (w, x, y, z)
-  //The multiplication is given by :
-  //(Q1 * Q2).w = (w1w2 - x1x2 - y1y2 - z1z2)
-  //(Q1 * Q2).x = (w1x2 + x1w2 + y1z2 - z1y2)
-  //(Q1 * Q2).y = (w1y2 - x1z2 + y1w2 + z1x2)
-  //(Q1 * Q2).z = (w1z2 + x1y2 - y1x2 + z1w2)
-
-  resultQuad[0] = quad1[0]*quad2[0] - quad1[1]*quad2[1]
-                  - quad1[2]*quad2[2] - quad1[3]*quad2[3];
-
-  resultQuad[1] = quad1[0]*quad2[1] + quad1[1]*quad2[0]
-                  + quad1[2]*quad2[3] - quad1[3]*quad2[2];
-
-  resultQuad[2] = quad1[0]*quad2[2] + quad1[2]*quad2[0]
-                  + quad1[3]*quad2[1] - quad1[1]*quad2[3];
-
-  resultQuad[3] = quad1[0]*quad2[3] + quad1[3]*quad2[0]
-                  + quad1[1]*quad2[2] - quad1[2]*quad2[1];
+  //The result can be one of the inputs
+  (vtkBoneQuaterniond(quad1) * vtkBoneQuaterniond(quad2)).CopyTo(resultQuad);
 }
 
 void NormalizeQuaternion(double* quad)
 {
-  double mag2 = quad[0]*quad[0] + quad[1]*quad[1] + quad[2]*quad[2] + quad[3]*quad[3];
-  double mag = sqrt(mag2);
-  quad[0] /= mag;
-  quad[1] /= mag;
-  quad[2] /= mag;
-  quad[3] /= mag;
+  vtkBoneQuaterniond(quad).Normalized().CopyTo(quad);
 }
 
 void InitializeQuaternion(double* quad)
@@ -118,6 +107,18 @@ void CopyVector3(double* vec, double* copyVec)
   copyVec[2] = vec[2];
 }
 
+vtkSmartPointer<vtkTransform> CreateTransform(
+  const vtkBoneRigidTransform& rigidTransform)
+{
+  double elements[16];
+  rigidTransform.GetMatrix(elements);
+
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  transform->SetMatrix(elements);
+  return transform;
+}
+
 }// end namespace
 
 
@@ -128,8 +129,10 @@ public:
     { return new vtkBoneWidgetCallback; }
   vtkBoneWidgetCallback()
     { this->BoneWidget = 0; }
-  virtual void Execute(vtkObject* caller, unsigned long eventId, void*)
+  virtual void Execute(vtkObject* caller, unsigned long eventId,
+                       void* callData)
     {
+      vtkBoneProfileScopeMacro(this->BoneWidget->Profiler, ObserverDispatch);
       switch (eventId)
         {
         case vtkCommand::StartInteractionEvent:
@@ -153,8 +156,12 @@ public:
           }
         case vtkBoneWidget::PoseChangedEvent:
           {
+          // Children sharing the parent skeleton are already updated by
+          // the skeleton forward kinematics.
           if (this->BoneWidget->BoneParent ==
-                vtkBoneWidget::SafeDownCast(caller))
+                vtkBoneWidget::SafeDownCast(caller)
+              && this->BoneWidget->BoneParent->Skeleton !=
+                this->BoneWidget->Skeleton)
             {
             this->BoneWidget->BoneParentPoseChanged();
             }
@@ -169,6 +176,20 @@ public:
             }
           break;
           }
+        case vtkCommand::StartEvent:
+          {
+          // The renderer is about to render
+          this->BoneWidget->ProcessPendingMove();
+          break;
+          }
+        case vtkCommand::TimerEvent:
+          {
+          if (callData)
+            {
+            this->BoneWidget->RenderTimerExpired(*static_cast<int*>(callData));
+            }
+          break;
+          }
         }
     }
   vtkBoneWidget *BoneWidget;
@@ -229,16 +250,19 @@ vtkBoneWidget::vtkBoneWidget()
                                           vtkWidgetEvent::EndSelect,
                                           this, vtkBoneWidget::EndSelectAction);
 
-  //Init bone variables
-  InitializeVector3(this->LocalRestHead);
-  InitializeVector3(this->LocalRestTail);
-  InitializeVector3(this->LocalPoseHead);
-  InitializeVector3(this->LocalPoseTail);
+  //Init bone variables. The bone owns a private skeleton until it is
+  //added to another one. The slot is initialized to identity.
+  this->Skeleton = vtkBoneSkeleton::New();
+  this->BoneId = this->Skeleton->AllocateBone(this);
   InitializeVector3(this->InteractionWorldHead);
   InitializeVector3(this->InteractionWorldTail);
+  InitializeVector3(this->WorldRestHead);
+  InitializeVector3(this->WorldRestTail);
+  InitializeVector3(this->WorldPoseHead);
+  InitializeVector3(this->WorldPoseTail);
+  this->WorldRestFrameModified = 1;
+  this->WorldPoseFrameModified = 1;
   this->Roll = 0.0;
-  InitializeQuaternion(this->RestTransform);
-  InitializeQuaternion(this->PoseTransform);
 
   //parentage link init
   this->HeadLinkedToParent = 0;
@@ -249,19 +273,42 @@ vtkBoneWidget::vtkBoneWidget()
   this->AxesVisibility = vtkBoneWidget::Nothing;
   this->AxesActor = vtkAxesActor::New();
   this->AxesActor->SetAxisLabels(0);
+  this->AxesMatrix = vtkMatrix4x4::New();
+  this->AxesActor->SetUserMatrix(this->AxesMatrix);
   this->AxesSize = 0.2;
 
+  this->Profiler = NULL;
+#ifdef VTK_BONE_WIDGET_ENABLE_PROFILING
+  this->Profiler = vtkBoneProfiler::New();
+#endif
+
+  //Deferred update init
+  this->UpdateMode = vtkBoneWidget::ImmediateUpdate;
+  this->MovePending = 0;
+  this->PendingEventPosition[0] = this->PendingEventPosition[1] = 0.0;
+  this->PendingLastEventPosition[0] = this->PendingLastEventPosition[1] = 0.0;
+  this->PendingRenderer = NULL;
+  this->PendingRendererObserverTag = 0;
+  this->RenderTimerId = 0;
+  this->RenderTimerObserverTag = 0;
+  this->DeferredUpdateCallback = vtkBoneWidgetCallback::New();
+  this->DeferredUpdateCallback->BoneWidget = this;
+
   this->UpdateAxesVisibility();
 }
 
 //----------------------------------------------------------------------
 vtkBoneWidget::~vtkBoneWidget()
 {
+  this->RemovePendingMoveObservers();
+  this->DeferredUpdateCallback->Delete();
+
   if(this->CurrentRenderer)
     {
     this->CurrentRenderer->RemoveActor(this->AxesActor);
     }
   this->AxesActor->Delete();
+  this->AxesMatrix->Delete();
 
   this->ParentageLink->Delete();
 
@@ -274,6 +321,25 @@ vtkBoneWidget::~vtkBoneWidget()
   this->BoneWidgetCallback2->Delete();
 
   this->BoneWidgetChildrenCallback->Delete();
+
+  // The children do not keep a dangling parent
+  for (size_t i = 0; i < this->BoneChildren.size(); ++i)
+    {
+    this->BoneChildren[i]->BoneParent = NULL;
+    this->BoneChildren[i]->InvalidateWorldFrames();
+    }
+  if (this->BoneParent)
+    {
+    this->BoneParent->RemoveBoneChild(this);
+    }
+
+  this->Skeleton->ReleaseBone(this->BoneId);
+  this->Skeleton->UnRegister(this);
+
+  if (this->Profiler)
+    {
+    this->Profiler->Delete();
+    }
 }
 
 //----------------------------------------------------------------------
@@ -287,6 +353,8 @@ void vtkBoneWidget::CreateDefaultRepresentation()
 
   vtkBoneRepresentation::SafeDownCast(this->WidgetRep)->
     InstantiateHandleRepresentation();
+  vtkBoneRepresentation::SafeDownCast(this->WidgetRep)->
+    SetProfiler(this->Profiler);
 
   //
   //The parent line
@@ -310,10 +378,8 @@ void vtkBoneWidget::GetHeadRestWorldPosition(double head[3])
     }
   else
     {
-    vtkSmartPointer<vtkTransform> restTransform =
-      this->CreateWorldToBoneParentRestTransform();
-    double* restHead = restTransform->TransformDoublePoint(this->LocalRestHead);
-    CopyVector3(restHead, head);
+    this->UpdateWorldRestFrame();
+    CopyVector3(this->WorldRestHead, head);
     }
 }
 
@@ -326,9 +392,8 @@ double* vtkBoneWidget::GetHeadRestWorldPosition()
     }
   else
     {
-    vtkSmartPointer<vtkTransform> restTransform =
-      this->CreateWorldToBoneParentRestTransform();
-    return restTransform->TransformDoublePoint(this->LocalRestHead);
+    this->UpdateWorldRestFrame();
+    return this->WorldRestHead;
     }
 }
 
@@ -341,10 +406,8 @@ void vtkBoneWidget::GetHeadPoseWorldPosition(double head[3])
     }
   else
     {
-    vtkSmartPointer<vtkTransform> poseTransform =
-      this->CreateWorldToBoneParentPoseTransform();
-    double* poseHead = poseTransform->TransformDoublePoint(this->LocalPoseHead);
-    CopyVector3(poseHead, head);
+    this->UpdateWorldPoseFrame();
+    CopyVector3(this->WorldPoseHead, head);
     }
 }
 
@@ -357,9 +420,8 @@ double* vtkBoneWidget::GetHeadPoseWorldPosition()
     }
   else
     {
-    vtkSmartPointer<vtkTransform> poseTransform =
-      this->CreateWorldToBoneParentPoseTransform();
-    return poseTransform->TransformDoublePoint(this->LocalPoseHead);
+    this->UpdateWorldPoseFrame();
+    return this->WorldPoseHead;
     }
 }
 
@@ -399,28 +461,21 @@ void vtkBoneWidget::SetHeadRestWorldPosition(double head[3])
     // 2- Get the previous line directionnal vector and the new line vector
     double previousLineVect[3], newLineVect[3];
     vtkMath::Subtract(tail, oldHead, previousLineVect);
-    vtkMath::Normalize(previousLineVect);
     vtkMath::Subtract(tail, head, newLineVect);
-    vtkMath::Normalize(newLineVect);
 
     //This is our best bet, since we cannot be sure that the new point
     //is in the camera plan
-    // 4- Compute Rotation Axis
-    double rotationAxis[3];
-    vtkMath::Cross(previousLineVect, newLineVect, rotationAxis);
-    vtkMath::Normalize(rotationAxis);
-
-    // 5- Compute Angle
-    double angle = acos(vtkMath::Dot(newLineVect, previousLineVect));
-
-    // 6- Update Pose transform and start pose transform
+    // 4- Compute the shortest arc rotation between the lines
     double quad[4];
-    AxisAngleToQuaternion(rotationAxis, -1.0*angle, quad); //INVERSE ROTATION !
-    NormalizeQuaternion(quad);
-    MultiplyQuaternion(quad, this->StartPoseTransform, this->PoseTransform);
-    NormalizeQuaternion(this->PoseTransform);
+    vtkBoneQuaterniond::FromTwoVectors(
+      vtkBoneVector3d(newLineVect),
+      vtkBoneVector3d(previousLineVect)).CopyTo(quad); //INVERSE ROTATION !
+
+    // 5- Update Pose transform and start pose transform
+    MultiplyQuaternion(quad, this->GetStartPoseTransform(), this->GetPoseTransform());
+    NormalizeQuaternion(this->GetPoseTransform());
 
-    CopyQuaternion(this->PoseTransform, this->StartPoseTransform);
+    CopyQuaternion(this->GetPoseTransform(), this->GetStartPoseTransform());
 
     //Set the point
     this->GetBoneRepresentation()->SetHeadWorldPosition(head);
@@ -428,7 +483,7 @@ void vtkBoneWidget::SetHeadRestWorldPosition(double head[3])
     //Rebuilds local pose points
     this->RebuildLocalPosePoints();
 
-    this->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
+    this->InvokePoseChangedEvent();
     }
   else //other states
     {
@@ -457,10 +512,8 @@ void vtkBoneWidget::GetTailRestWorldPosition(double tail[3])
     }
   else
     {
-    vtkSmartPointer<vtkTransform> restTransform =
-      this->CreateWorldToBoneParentRestTransform();
-    double* restTail = restTransform->TransformDoublePoint(this->LocalRestTail);
-    CopyVector3(restTail, tail);
+    this->UpdateWorldRestFrame();
+    CopyVector3(this->WorldRestTail, tail);
     }
 }
 
@@ -473,9 +526,8 @@ double* vtkBoneWidget::GetTailRestWorldPosition()
     }
   else
     {
-    vtkSmartPointer<vtkTransform> restTransform =
-      this->CreateWorldToBoneParentRestTransform();
-    return restTransform->TransformDoublePoint(this->LocalRestTail);
+    this->UpdateWorldRestFrame();
+    return this->WorldRestTail;
     }
 }
 
@@ -488,10 +540,8 @@ void vtkBoneWidget::GetTailPoseWorldPosition(double tail[3])
     }
   else
     {
-    vtkSmartPointer<vtkTransform> poseTransform =
-      this->CreateWorldToBoneParentPoseTransform();
-    double* poseTail = poseTransform->TransformDoublePoint(this->LocalPoseTail);
-    CopyVector3(poseTail, tail);
+    this->UpdateWorldPoseFrame();
+    CopyVector3(this->WorldPoseTail, tail);
     }
 }
 
@@ -504,9 +554,8 @@ double* vtkBoneWidget::GetTailPoseWorldPosition()
     }
   else
     {
-    vtkSmartPointer<vtkTransform> poseTransform =
-      this->CreateWorldToBoneParentPoseTransform();
-    return poseTransform->TransformDoublePoint(this->LocalPoseTail);
+    this->UpdateWorldPoseFrame();
+    return this->WorldPoseTail;
     }
 }
 
@@ -555,33 +604,28 @@ void vtkBoneWidget::RotateTailWXYZ(double angle, double axis[3])
   double head[3];
   this->GetBoneRepresentation()->GetHeadWorldPosition(head);
 
-  //Make transform
-  vtkSmartPointer<vtkTransform> T = vtkSmartPointer<vtkTransform>::New();
-  T->Translate(head); //last transform: Translate back to Head origin
-  T->RotateWXYZ(vtkMath::DegreesFromRadians(angle), axis); //middle rotatation
-  double minusHead[3];
-  CopyVector3(head, minusHead);
-  vtkMath::MultiplyScalar(minusHead, -1.0);
-  T->Translate(minusHead);//first transform: translate to origin
+  //Rotate the tail around the head
+  vtkBoneRigidTransform rotation;
+  rotation.SetRotationWXYZ(angle, axis);
 
-  //Compute and place new tail position
-  double* newTail = T->TransformDoublePoint(
-    this->GetBoneRepresentation()->GetTailWorldPosition());
+  double newTail[3];
+  vtkMath::Subtract(this->GetBoneRepresentation()->GetTailWorldPosition(),
+                    head, newTail);
+  rotation.TransformVector(newTail, newTail);
+  vtkMath::Add(head, newTail, newTail);
 
   if (this->WidgetState == vtkBoneWidget::Pose)
     {
     this->GetBoneRepresentation()->SetTailWorldPosition(newTail);
 
     //Update pose transform
-    double rotation[4];
-    this->AxisAngleToQuaternion(axis, angle, rotation);
-    NormalizeQuaternion(rotation);
+    MultiplyQuaternion(rotation.GetRotation(), this->GetPoseTransform(),
+                       this->GetPoseTransform());
+    NormalizeQuaternion(this->GetPoseTransform());
 
-    MultiplyQuaternion(rotation, this->PoseTransform, this->PoseTransform);
-    NormalizeQuaternion(this->PoseTransform);
-
-    CopyQuaternion(this->PoseTransform, this->StartPoseTransform);
-    this->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
+    CopyQuaternion(this->GetPoseTransform(), this->GetStartPoseTransform());
+    this->RebuildLocalPosePoints();
+    this->InvokePoseChangedEvent();
 
     this->RebuildAxes();
     this->RebuildParentageLink();
@@ -594,6 +638,45 @@ void vtkBoneWidget::RotateTailWXYZ(double angle, double axis[3])
   this->Modified();
 }
 
+//----------------------------------------------------------------------
+void vtkBoneWidget::SetPose(double poseTransform[4],
+                            double head[3], double tail[3])
+{
+  if (this->WidgetState != vtkBoneWidget::Pose)
+    {
+    vtkErrorMacro("Cannot set the pose outside of pose mode."
+                  "\n ->Doing nothing");
+    return;
+    }
+
+  this->GetBoneRepresentation()->SetHeadWorldPosition(head);
+  this->GetBoneRepresentation()->SetTailWorldPosition(tail);
+
+  CopyQuaternion(poseTransform, this->GetPoseTransform());
+  CopyQuaternion(poseTransform, this->GetStartPoseTransform());
+  CopyVector3(head, this->InteractionWorldHead);
+  CopyVector3(tail, this->InteractionWorldTail);
+
+  this->RebuildLocalPosePoints();
+  this->RebuildAxes();
+  this->RebuildParentageLink();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------
+void vtkBoneWidget::PropagatePose()
+{
+  if (this->WidgetState != vtkBoneWidget::Pose)
+    {
+    vtkErrorMacro("Cannot propagate the pose outside of pose mode."
+                  "\n ->Doing nothing");
+    return;
+    }
+
+  this->InvokePoseChangedEvent();
+}
+
 //----------------------------------------------------------------------
 void vtkBoneWidget::SetTailRestWorldPosition(double tail[3])
 {
@@ -620,28 +703,21 @@ void vtkBoneWidget::SetTailRestWorldPosition(double tail[3])
     // 2- Get the previous line directionnal vector and the new line vector
     double previousLineVect[3], newLineVect[3];
     vtkMath::Subtract(oldTail, head, previousLineVect);
-    vtkMath::Normalize(previousLineVect);
     vtkMath::Subtract(tail, head, newLineVect);
-    vtkMath::Normalize(newLineVect);
 
     //This is our best bet, since we cannot be sure that the new point
     //is in the camera plan
-    // 4- Compute Rotation Axis
-    double rotationAxis[3];
-    vtkMath::Cross(previousLineVect, newLineVect, rotationAxis);
-    vtkMath::Normalize(rotationAxis);
-
-    // 5- Compute Angle
-    double angle = acos(vtkMath::Dot(newLineVect, previousLineVect));
-
-    // 6- Update Pose transform and start pose transform
+    // 4- Compute the shortest arc rotation between the lines
     double quad[4];
-    AxisAngleToQuaternion(rotationAxis, angle, quad);
-    NormalizeQuaternion(quad);
-    MultiplyQuaternion(quad, this->StartPoseTransform, this->PoseTransform);
-    NormalizeQuaternion(this->PoseTransform);
+    vtkBoneQuaterniond::FromTwoVectors(
+      vtkBoneVector3d(previousLineVect),
+      vtkBoneVector3d(newLineVect)).CopyTo(quad);
+
+    // 5- Update Pose transform and start pose transform
+    MultiplyQuaternion(quad, this->GetStartPoseTransform(), this->GetPoseTransform());
+    NormalizeQuaternion(this->GetPoseTransform());
 
-    CopyQuaternion(this->PoseTransform, this->StartPoseTransform);
+    CopyQuaternion(this->GetPoseTransform(), this->GetStartPoseTransform());
 
     //Set the point
     this->GetBoneRepresentation()->SetTailWorldPosition(tail);
@@ -649,7 +725,7 @@ void vtkBoneWidget::SetTailRestWorldPosition(double tail[3])
     //Rebuilds local pose points
     this->RebuildLocalPosePoints();
 
-    this->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
+    this->InvokePoseChangedEvent();
     }
   else  //Other states than pose
     {
@@ -685,12 +761,16 @@ void vtkBoneWidget::SetBoneParent(vtkBoneWidget* parent)
     this->BoneParent->RemoveObserver(vtkBoneWidget::RestChangedEvent);
     this->BoneParent->RemoveObserver(vtkBoneWidget::PoseChangedEvent);
     this->BoneParent->RemoveObserver(vtkBoneWidget::PoseInteractionStoppedEvent);
+    this->BoneParent->RemoveBoneChild(this);
     }
 
   this->BoneParent = parent;
+  this->Skeleton->UpdateBoneParentIds(this->BoneId);
+  this->InvalidateWorldFrames();
 
   if (parent)
     {
+    parent->BoneChildren.push_back(this);
     parent->AddObserver(vtkBoneWidget::RestChangedEvent,
                         this->BoneWidgetChildrenCallback,
                         this->Priority);
@@ -711,8 +791,8 @@ void vtkBoneWidget::SetBoneParent(vtkBoneWidget* parent)
     }
   else
     {
-    this->GetBoneRepresentation()->GetHeadWorldPosition(this->LocalRestHead);
-    this->GetBoneRepresentation()->GetTailWorldPosition(this->LocalRestTail);
+    this->GetBoneRepresentation()->GetHeadWorldPosition(this->GetLocalRestHead());
+    this->GetBoneRepresentation()->GetTailWorldPosition(this->GetLocalRestTail());
     }
 
   this->Modified();
@@ -724,156 +804,153 @@ vtkBoneWidget* vtkBoneWidget::GetBoneParent()
   return this->BoneParent;
 }
 
+//----------------------------------------------------------------------
+void vtkBoneWidget::RemoveBoneChild(vtkBoneWidget* child)
+{
+  std::vector<vtkBoneWidget*>::iterator it =
+    std::find(this->BoneChildren.begin(), this->BoneChildren.end(), child);
+  if (it != this->BoneChildren.end())
+    {
+    this->BoneChildren.erase(it);
+    }
+}
+
+//----------------------------------------------------------------------
+int vtkBoneWidget::HasExternalBoneChildren()
+{
+  for (size_t i = 0; i < this->BoneChildren.size(); ++i)
+    {
+    if (this->BoneChildren[i]->Skeleton != this->Skeleton)
+      {
+      return 1;
+      }
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------
 void vtkBoneWidget::GetRestTransform(double restTransform[4])
 {
-  CopyQuaternion(this->RestTransform, restTransform);
+  CopyQuaternion(this->GetRestTransform(), restTransform);
 }
 
 //----------------------------------------------------------------------
 double* vtkBoneWidget::GetPoseTransform()
 {
-  return this->PoseTransform;
+  return this->Skeleton->GetPoseTransform(this->BoneId);
 }
 
 //----------------------------------------------------------------------
 void vtkBoneWidget::GetPoseTransform(double poseTransform[4])
 {
-  CopyQuaternion(this->PoseTransform, poseTransform);
+  CopyQuaternion(this->GetPoseTransform(), poseTransform);
 }
 
 //----------------------------------------------------------------------
 double* vtkBoneWidget::GetRestTransform()
 {
-  return this->RestTransform;
+  return this->Skeleton->GetRestTransform(this->BoneId);
 }
 
 //----------------------------------------------------------------------
 void vtkBoneWidget::RebuildRestTransform()
 {
-  //Code greatly inspired by: http://www.fastgraph.com/makegames/3drotation/
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildRestTransform);
+
+  this->InvalidateWorldFrames();
 
   double head[3], tail[3];
   this->GetBoneRepresentation()->GetHeadWorldPosition( head );
   this->GetBoneRepresentation()->GetTailWorldPosition( tail );
 
-  double viewOut[3];      // the View or "new Z" vector
-  double viewUp[3];       // the Up or "new Y" vector
-  double viewRight[3];    // the Right or "new X" vector
-
-  double upMagnitude;     // for normalizing the Up vector
-  double upProjection;    // magnitude of projection of View Vector on World UP
-
-  // first, calculate and normalize the view vector
+  // the bone direction
+  double viewOut[3];
   vtkMath::Subtract(tail, head, viewOut);
 
-  // normalize. This is the unit vector in the "new Z" direction
   // invalid points (not far enough apart)
-  if (vtkMath::Normalize(viewOut) < 0.000001)
+  if (vtkMath::Dot(viewOut, viewOut) < 0.000001 * 0.000001)
     {
     vtkErrorMacro("Tail and Head are not enough apart,"
                   " could not rebuild rest Transform");
-    InitializeQuaternion(this->RestTransform);
+    InitializeQuaternion(this->GetRestTransform());
     return;
     }
 
-  // Now the hard part: The ViewUp or "new Y" vector
-
-  // dot product of ViewOut vector and World Up vector gives projection of
-  // of ViewOut on WorldUp
-  upProjection = vtkMath::Dot(viewOut, Y);
-
-  // first try at making a View Up vector: use World Up
-  viewUp[0] = Y[0] - upProjection*viewOut[0];
-  viewUp[1] = Y[1] - upProjection*viewOut[1];
-  viewUp[2] = Y[2] - upProjection*viewOut[2];
-
-  // Check for validity:
-  upMagnitude = vtkMath::Norm(viewUp);
-
-  if (upMagnitude < 0.0000001)
-    {
-    //Second try at making a View Up vector: Use Y axis default  (0,1,0)
-    viewUp[0] = -viewOut[1]*viewOut[0];
-    viewUp[1] = 1-viewOut[1]*viewOut[1];
-    viewUp[2] = -viewOut[1]*viewOut[2];
-
-    // Check for validity:
-    upMagnitude = vtkMath::Norm(viewUp);
-
-    if (upMagnitude < 0.0000001)
-      {
-      //Final try at making a View Up vector: Use Z axis default  (0,0,1)
-      viewUp[0] = -viewOut[2]*viewOut[0];
-      viewUp[1] = -viewOut[2]*viewOut[1];
-      viewUp[2] = 1-viewOut[2]*viewOut[2];
-
-      // Check for validity:
-      upMagnitude = vtkMath::Norm(viewUp);
-
-      if (upMagnitude < 0.0000001)
-        {
-        vtkErrorMacro("Could not fin a vector perpendiculare to the bone,"
-                      " check the bone values. This should not be happening.");
-        return;
-        }
-      }
-    }
-
-  // normalize the Up Vector
-  upMagnitude = vtkMath::Normalize(viewUp);
-
-  // Calculate the Right Vector. Use cross product of Out and Up.
-  vtkMath::Cross(viewUp, viewOut,  viewRight);
-  vtkMath::Normalize(viewRight); //Let's be paranoid about the normalization
-
-  //Get the rest transform matrix
-  AxisAngleToQuaternion(viewRight, acos(upProjection) , this->RestTransform);
-  NormalizeQuaternion(this->RestTransform);
+  // The rest transform is the shortest arc rotation from the world Y axis
+  // to the bone. When the bone points down, it is the half turn around X.
+  vtkBoneQuaterniond restTransform = vtkBoneQuaterniond::FromTwoVectors(
+    vtkBoneVector3d(Y), vtkBoneVector3d(viewOut), vtkBoneVector3d(X));
 
   if (this->Roll != 0.0)
     {
-    //Get the roll matrix
-    double rollQuad[4];
-    AxisAngleToQuaternion(viewOut, this->Roll , rollQuad);
-    NormalizeQuaternion(rollQuad);
+    //Get the roll around the bone
+    vtkBoneQuaterniond rollQuad =
+      vtkBoneQuaterniond::FromAxisAngle(this->Roll, vtkBoneVector3d(viewOut));
 
-    //Get final matrix
-    MultiplyQuaternion(rollQuad, this->RestTransform, this->RestTransform);
-    NormalizeQuaternion(this->RestTransform);
+    //Get final rotation
+    restTransform = (rollQuad * restTransform).Normalized();
     }
+
+  restTransform.CopyTo(this->GetRestTransform());
 }
 
 //----------------------------------------------------------------------
 void vtkBoneWidget::RebuildLocalRestPoints()
 {
-  vtkSmartPointer<vtkTransform> transform =
-    this->CreateWorldToBoneParentTransform();
-  transform->Inverse();
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildLocalRestPoints);
 
-  double* head = transform->TransformDoublePoint(
-    this->GetBoneRepresentation()->GetHeadWorldPosition());
-  CopyVector3(head, this->LocalRestHead);
+  this->InvalidateWorldFrames();
 
-  double* tail = transform->TransformDoublePoint(
-    this->GetBoneRepresentation()->GetTailWorldPosition());
-  CopyVector3(tail, this->LocalRestTail);
+  vtkBoneRigidTransform transform =
+    this->GetWorldToBoneParentTransform().GetInverse();
+
+  transform.TransformPoint(
+    this->GetBoneRepresentation()->GetHeadWorldPosition(),
+    this->GetLocalRestHead());
+  transform.TransformPoint(
+    this->GetBoneRepresentation()->GetTailWorldPosition(),
+    this->GetLocalRestTail());
 }
 
 //----------------------------------------------------------------------
 void vtkBoneWidget::RebuildLocalPosePoints()
 {
-  vtkSmartPointer<vtkTransform> transform =
-    this->CreateWorldToBoneParentTransform();
-  transform->Inverse();
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildLocalPosePoints);
+
+  this->InvalidateWorldFrames();
 
-  double* head = transform->TransformDoublePoint(
-    this->GetBoneRepresentation()->GetHeadWorldPosition());
-  CopyVector3(head, this->LocalPoseHead);
+  vtkBoneRigidTransform transform =
+    this->GetWorldToBoneParentTransform().GetInverse();
 
-  double* tail = transform->TransformDoublePoint(
-    this->GetBoneRepresentation()->GetTailWorldPosition());
-  CopyVector3(tail, this->LocalPoseTail);
+  transform.TransformPoint(
+    this->GetBoneRepresentation()->GetHeadWorldPosition(),
+    this->GetLocalPoseHead());
+  transform.TransformPoint(
+    this->GetBoneRepresentation()->GetTailWorldPosition(),
+    this->GetLocalPoseTail());
+
+  // Rotation of the bone in its parent pose coordinate system:
+  // (ParentPose * ParentRest)^-1 * (Pose * Rest)
+  double worldRotation[4];
+  MultiplyQuaternion(this->GetPoseTransform(), this->GetRestTransform(),
+                     worldRotation);
+  NormalizeQuaternion(worldRotation);
+  if (this->BoneParent)
+    {
+    double parentRotation[4];
+    MultiplyQuaternion(this->BoneParent->GetPoseTransform(),
+                       this->BoneParent->GetRestTransform(),
+                       parentRotation);
+    NormalizeQuaternion(parentRotation);
+    parentRotation[1] *= -1.0;
+    parentRotation[2] *= -1.0;
+    parentRotation[3] *= -1.0;
+
+    double localRotation[4];
+    MultiplyQuaternion(parentRotation, worldRotation, localRotation);
+    CopyQuaternion(localRotation, worldRotation);
+    }
+  CopyQuaternion(worldRotation, this->GetLocalPoseRotation());
 }
 
 //----------------------------------------------------------------------
@@ -900,17 +977,22 @@ void vtkBoneWidget::SetEnabled(int enabling)
       }
     else
       {
+      int handlesVisibility = 1;
       if (this->WidgetRep)
         {
         this->WidgetRep->SetVisibility(1);
+        handlesVisibility =
+          this->GetBoneRepresentation()->GetHandlesVisibility();
         }
       if (this->HeadWidget)
         {
-        this->HeadWidget->GetRepresentation()->SetVisibility(1);
+        this->HeadWidget->GetRepresentation()->SetVisibility(
+          handlesVisibility);
         }
       if (this->TailWidget)
         {
-        this->TailWidget->GetRepresentation()->SetVisibility(1);
+        this->TailWidget->GetRepresentation()->SetVisibility(
+          handlesVisibility);
         }
       // The interactor must be set prior to enabling the widget.
       if (this->Interactor)
@@ -953,6 +1035,9 @@ void vtkBoneWidget::SetEnabled(int enabling)
     }
   else //disabling widget
     {
+    this->ProcessPendingMove();
+    this->RemovePendingMoveObservers();
+
     if (this->HeadWidget)
       {
       this->HeadWidget->SetEnabled(0);
@@ -968,6 +1053,10 @@ void vtkBoneWidget::SetEnabled(int enabling)
     }
 
   this->Superclass::SetEnabled(enabling);
+  if (enabling)
+    {
+    this->UpdateEventObservers();
+    }
 
   // Add/Remove the actor
   // This needs to be done after enabling the superclass
@@ -1005,6 +1094,7 @@ void vtkBoneWidget::SetRepresentation(vtkBoneRepresentation* r)
       this->GetBoneRepresentation()->GetHeadWorldPosition());
     }
 
+  r->SetProfiler(this->Profiler);
   this->Superclass::SetWidgetRepresentation(
     reinterpret_cast<vtkWidgetRepresentation*>(r));
 }
@@ -1015,6 +1105,13 @@ vtkBoneRepresentation* vtkBoneWidget::GetBoneRepresentation()
   return vtkBoneRepresentation::SafeDownCast(this->WidgetRep);
 }
 
+//-------------------------------------------------------------------------
+vtkLineRepresentation* vtkBoneWidget::GetParentageLinkRepresentation()
+{
+  return vtkLineRepresentation::SafeDownCast(
+    this->ParentageLink->GetRepresentation());
+}
+
 //-------------------------------------------------------------------------
 void vtkBoneWidget::AddPointAction(vtkAbstractWidget *w)
 {
@@ -1056,7 +1153,8 @@ void vtkBoneWidget::AddPointAction(vtkAbstractWidget *w)
 
     vtkBoneRepresentation::SafeDownCast(self->WidgetRep)->SetTailDisplayPosition(e);
     self->TailWidget->SetEnabled(1);
-    self->TailWidget->GetRepresentation()->SetVisibility(1);
+    self->TailWidget->GetRepresentation()->SetVisibility(
+      self->GetBoneRepresentation()->GetHandlesVisibility());
     self->WidgetRep->SetVisibility(1);
 
     self->RebuildRestTransform();
@@ -1075,7 +1173,14 @@ void vtkBoneWidget::AddPointAction(vtkAbstractWidget *w)
     self->TailSelected = 0;
 
     int modifier = self->Interactor->GetShiftKey() | self->Interactor->GetControlKey();
-    int state = self->WidgetRep->ComputeInteractionState(X,Y,modifier);
+    int state = vtkBoneRepresentation::Outside;
+    // With a picking tree, only the bone it picked for this click tests it
+    vtkBonePickingTree* pickingTree = self->Skeleton->GetPickingTree();
+    if ( !pickingTree || pickingTree->GetInteractor() != self->Interactor
+         || pickingTree->GetPickedBoneId() == self->BoneId )
+      {
+      state = self->WidgetRep->ComputeInteractionState(X,Y,modifier);
+      }
     if ( state == vtkBoneRepresentation::Outside )
       {
       return;
@@ -1108,7 +1213,7 @@ void vtkBoneWidget::AddPointAction(vtkAbstractWidget *w)
     }
 
   self->EventCallbackCommand->SetAbortFlag(1);
-  self->Render();
+  self->RequestRender();
 }
 
 //-------------------------------------------------------------------------
@@ -1136,56 +1241,82 @@ void vtkBoneWidget::MoveAction(vtkAbstractWidget *w)
     self->EventCallbackCommand->SetAbortFlag(1);
     }
 
-  else if (self->WidgetState == vtkBoneWidget::Rest)
+  else
+    {
+    double lastE[2];
+    lastE[0] = static_cast<double>(self->Interactor->GetLastEventPosition()[0]);
+    lastE[1] = static_cast<double>(self->Interactor->GetLastEventPosition()[1]);
+
+    if ( self->UpdateMode == vtkBoneWidget::DeferredUpdate )
+      {
+      // Nothing to rebuild nor to render until the next frame
+      if ( self->HeadSelected || self->TailSelected || self->BoneSelected )
+        {
+        self->DeferMove(e, lastE);
+        }
+      return;
+      }
+
+    self->ProcessMove(e, lastE);
+    }
+
+  self->WidgetRep->BuildRepresentation();
+  self->RequestRender();
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::ProcessMove(double e[2], double lastE[2])
+{
+  if (this->WidgetState == vtkBoneWidget::Rest)
     {
-    if ( self->HeadSelected )
+    if ( this->HeadSelected )
       {
-      self->GetBoneRepresentation()->SetHeadDisplayPosition(e);
-      self->RebuildRestTransform();
-      self->RebuildLocalRestPoints();
-      self->RebuildAxes();
-      self->RebuildParentageLink();
+      this->GetBoneRepresentation()->SetHeadDisplayPosition(e);
+      this->RebuildRestTransform();
+      this->RebuildLocalRestPoints();
+      this->RebuildAxes();
+      this->RebuildParentageLink();
 
-      //self->InvokeEvent(vtkBoneWidget::RestChangedEvent, NULL);
+      //this->InvokeEvent(vtkBoneWidget::RestChangedEvent, NULL);
       }
 
-    else if ( self->TailSelected )
+    else if ( this->TailSelected )
       {
-      self->GetBoneRepresentation()->SetTailDisplayPosition(e);
-      self->RebuildRestTransform();
-      self->RebuildLocalRestPoints();
-      self->RebuildAxes();
-      self->RebuildParentageLink();
+      this->GetBoneRepresentation()->SetTailDisplayPosition(e);
+      this->RebuildRestTransform();
+      this->RebuildLocalRestPoints();
+      this->RebuildAxes();
+      this->RebuildParentageLink();
 
-      self->InvokeEvent(vtkBoneWidget::RestChangedEvent, NULL);
+      this->InvokeEvent(vtkBoneWidget::RestChangedEvent, NULL);
       }
 
-    else if ( self->BoneSelected )
+    else if ( this->BoneSelected )
       {
-      self->GetBoneRepresentation()->GetLineHandleRepresentation()->SetDisplayPosition(e);
-      vtkBoneRepresentation::SafeDownCast(self->WidgetRep)->WidgetInteraction(e);
-      self->RebuildRestTransform();
-      self->RebuildLocalRestPoints();
-      self->RebuildAxes();
-      self->RebuildParentageLink();
-
-      if (self->HeadLinkedToParent && self->BoneParent)
+      this->GetBoneRepresentation()->GetLineHandleRepresentation()->SetDisplayPosition(e);
+      vtkBoneRepresentation::SafeDownCast(this->WidgetRep)->WidgetInteraction(e);
+      this->RebuildRestTransform();
+      this->RebuildLocalRestPoints();
+      this->RebuildAxes();
+      this->RebuildParentageLink();
+
+      if (this->HeadLinkedToParent && this->BoneParent)
         {
-        self->BoneParent->LinkTailToChild(self);
+        this->BoneParent->LinkTailToChild(this);
         }
 
-      self->InvokeEvent(vtkBoneWidget::RestChangedEvent, NULL);
+      this->InvokeEvent(vtkBoneWidget::RestChangedEvent, NULL);
       }
 
-    self->InvokeEvent(vtkCommand::InteractionEvent,NULL);
-    self->Modified();
+    this->InvokeEvent(vtkCommand::InteractionEvent,NULL);
+    this->Modified();
     }
 
-  else if (self->WidgetState == vtkBoneWidget::Pose)
+  else if (this->WidgetState == vtkBoneWidget::Pose)
     {
     //Cannot move Head in pose mode
 
-    if ( self->TailSelected )
+    if ( this->TailSelected )
       {
       //
       //Make rotation in camera view plane center on Head
@@ -1193,109 +1324,252 @@ void vtkBoneWidget::MoveAction(vtkAbstractWidget *w)
 
       // Get display positions
       double e1[2], e2[2];
-      self->GetBoneRepresentation()->GetHeadDisplayPosition(e1);
-      self->GetBoneRepresentation()->GetTailDisplayPosition(e2);
+      this->GetBoneRepresentation()->GetHeadDisplayPosition(e1);
+      this->GetBoneRepresentation()->GetTailDisplayPosition(e2);
 
       // Get the current line -> the line between Head and the event
       //in display coordinates
       double currentLine[2], oldLine[2];
       currentLine[0] = e[0] - e1[0];currentLine[1] = e[1] - e1[1];
-      vtkMath::Normalize2D(currentLine);
 
       // Get the old line -> the line between Head and the LAST event
       //in display coordinates
-      int lastX = self->Interactor->GetLastEventPosition()[0];
-      int lastY = self->Interactor->GetLastEventPosition()[1];
-      double lastE[2];
-      lastE[0] = static_cast<double>(lastX);
-      lastE[1] = static_cast<double>(lastY);
       oldLine[0] = lastE[0] - e1[0]; oldLine[1] = lastE[1] - e1[1];
-      vtkMath::Normalize2D(oldLine);
 
-      // Get the angle between those two lines
-      double angle = vtkMath::DegreesFromRadians(
-                       acos(vtkMath::Dot2D(currentLine, oldLine)));
+      // Get the rotation between those two lines. It is around Z in the
+      // display plane.
+      vtkBoneQuaterniond displayRotation =
+        vtkBoneQuaterniond::FromTwoVectors(
+          vtkBoneVector3d(oldLine[0], oldLine[1], 0.0),
+          vtkBoneVector3d(currentLine[0], currentLine[1], 0.0),
+          vtkBoneVector3d(Z));
 
       // Get the world coordinate of the line before anything moves
       double head[3], tail[3];
-      self->GetBoneRepresentation()->GetHeadWorldPosition(head);
-      self->GetBoneRepresentation()->GetTailWorldPosition(tail);
+      this->GetBoneRepresentation()->GetHeadWorldPosition(head);
+      this->GetBoneRepresentation()->GetTailWorldPosition(tail);
 
       //Get the camera vector
       double cameraVec[3];
-      if (!self->GetCurrentRenderer()
-          || !self->GetCurrentRenderer()->GetActiveCamera())
+      if (!this->GetCurrentRenderer()
+          || !this->GetCurrentRenderer()->GetActiveCamera())
         {
-        vtkErrorWithObjectMacro(self, "There should be a renderer and a camera."
-                                      " Make sure to set these !"
-                                      "\n ->Cannot move Tail in pose mode");
+        vtkErrorMacro("There should be a renderer and a camera."
+                      " Make sure to set these !"
+                      "\n ->Cannot move Tail in pose mode");
         return;
         }
-      self->GetCurrentRenderer()->GetActiveCamera()->GetDirectionOfProjection(cameraVec);
-
-      //Need to figure if the rotation is clockwise or counterclowise
-      double spaceCurrentLine[3], spaceOldLine[3];
-      spaceCurrentLine[0] = currentLine[0];
-      spaceCurrentLine[1] = currentLine[1];
-      spaceCurrentLine[2] = 0.0;
-
-      spaceOldLine[0] = oldLine[0];
-      spaceOldLine[1] = oldLine[1];
-      spaceOldLine[2] = 0.0;
-
-      double handenessVec[3];
-      vtkMath::Cross(spaceOldLine, spaceCurrentLine, handenessVec);
-
-      //handeness is oppostie beacuse camera is toward the focal point
-      double handeness = vtkMath::Dot(handenessVec, Z) > 0 ? -1.0: 1.0;
-      angle *= handeness;
-
-      //Finally rotate Tail
-      vtkSmartPointer<vtkTransform> T = vtkSmartPointer<vtkTransform>::New();
-      T->Translate(head); //last transform: Translate back to Head origin
-      T->RotateWXYZ(angle, cameraVec); //middle transform: rotate
-      //first transform: Translate to world origin
-      double minusHead[3];
-      CopyVector3(head, minusHead);
-      vtkMath::MultiplyScalar(minusHead, -1.0);
-      T->Translate(minusHead);
-
-      self->GetBoneRepresentation()->SetTailWorldPosition(
-        T->TransformDoublePoint(tail));
-
-      self->RebuildPoseTransform();
-      self->RebuildLocalPosePoints();
-      self->RebuildAxes();
-      self->RebuildParentageLink();
-
-      self->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
-      self->InvokeEvent(vtkCommand::InteractionEvent,NULL);
-      self->Modified();
+      this->GetCurrentRenderer()->GetActiveCamera()->GetDirectionOfProjection(cameraVec);
+
+      //Same rotation around the camera vector. The handeness is opposite
+      //beacuse the camera is toward the focal point
+      vtkBoneVector3d rotationAxis =
+        vtkBoneVector3d(cameraVec).Normalized() * (-displayRotation[3]);
+      vtkBoneRigidTransform rotation;
+      rotation.SetRotation(vtkBoneQuaterniond(displayRotation[0],
+        rotationAxis[0], rotationAxis[1], rotationAxis[2]));
+
+      //Finally rotate Tail around Head
+      double newTail[3];
+      vtkMath::Subtract(tail, head, newTail);
+      rotation.TransformVector(newTail, newTail);
+      vtkMath::Add(head, newTail, newTail);
+      this->GetBoneRepresentation()->SetTailWorldPosition(newTail);
+
+      this->RebuildPoseTransform();
+      this->RebuildLocalPosePoints();
+      this->RebuildAxes();
+      this->RebuildParentageLink();
+
+      this->InvokePoseChangedEvent();
+      this->InvokeEvent(vtkCommand::InteractionEvent,NULL);
+      this->Modified();
       }
-    else if ( self->BoneSelected )
+    else if ( this->BoneSelected )
       {
-      if (!self->BoneParent) //shouldn't be necessary since the
+      if (!this->BoneParent) //shouldn't be necessary since the
                              //sorting is done in AddAction but just in case
         {
         // moving outer portion of line -- rotating
-        self->GetBoneRepresentation()
+        this->GetBoneRepresentation()
           ->GetLineHandleRepresentation()->SetDisplayPosition(e);
-        vtkBoneRepresentation::SafeDownCast(self->WidgetRep)->WidgetInteraction(e);
+        vtkBoneRepresentation::SafeDownCast(this->WidgetRep)->WidgetInteraction(e);
 
-        self->RebuildPoseTransform();
-        self->RebuildLocalPosePoints();
-        self->RebuildAxes();
-        self->RebuildParentageLink();
+        this->RebuildPoseTransform();
+        this->RebuildLocalPosePoints();
+        this->RebuildAxes();
+        this->RebuildParentageLink();
 
-        self->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
-        self->InvokeEvent(vtkCommand::InteractionEvent,NULL);
-        self->Modified();
+        this->InvokePoseChangedEvent();
+        this->InvokeEvent(vtkCommand::InteractionEvent,NULL);
+        this->Modified();
         }
       }
     }
+}
 
-  self->WidgetRep->BuildRepresentation();
-  self->Render();
+//-------------------------------------------------------------------------
+void vtkBoneWidget::DeferMove(double e[2], double lastE[2])
+{
+  // The rotations of the pose mode start from the last processed position
+  if ( !this->MovePending )
+    {
+    this->PendingLastEventPosition[0] = lastE[0];
+    this->PendingLastEventPosition[1] = lastE[1];
+    this->MovePending = 1;
+
+    if ( this->CurrentRenderer )
+      {
+      this->PendingRenderer = this->CurrentRenderer;
+      this->PendingRenderer->Register(this);
+      this->PendingRendererObserverTag =
+        this->PendingRenderer->AddObserver(vtkCommand::StartEvent,
+                                           this->DeferredUpdateCallback,
+                                           this->Priority);
+      }
+    }
+  this->PendingEventPosition[0] = e[0];
+  this->PendingEventPosition[1] = e[1];
+
+  // A single render is scheduled for all the moves of the frame
+  vtkBoneRenderScheduler* scheduler = this->Skeleton->GetRenderScheduler();
+  if ( scheduler )
+    {
+    scheduler->RequestRender(this->Interactor);
+    }
+  else if ( this->RenderTimerId == 0 && this->Interactor
+            && this->Interactor->GetInitialized() )
+    {
+    this->RenderTimerId = this->Interactor->CreateOneShotTimer(1);
+    if ( this->RenderTimerId != 0 )
+      {
+      this->RenderTimerObserverTag =
+        this->Interactor->AddObserver(vtkCommand::TimerEvent,
+                                      this->DeferredUpdateCallback,
+                                      this->Priority);
+      }
+    }
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::ProcessPendingMove()
+{
+  if ( !this->MovePending )
+    {
+    return;
+    }
+
+  this->MovePending = 0;
+  if ( this->PendingRenderer )
+    {
+    this->PendingRenderer->RemoveObserver(this->PendingRendererObserverTag);
+    this->PendingRenderer->UnRegister(this);
+    this->PendingRenderer = NULL;
+    }
+
+  this->ProcessMove(this->PendingEventPosition,
+                    this->PendingLastEventPosition);
+  this->WidgetRep->BuildRepresentation();
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::RenderTimerExpired(int timerId)
+{
+  if ( timerId != this->RenderTimerId )
+    {
+    return;
+    }
+
+  this->Interactor->RemoveObserver(this->RenderTimerObserverTag);
+  this->RenderTimerId = 0;
+
+  this->ProcessPendingMove();
+  this->Render();
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::RequestRender()
+{
+  vtkBoneRenderScheduler* scheduler = this->Skeleton->GetRenderScheduler();
+  if ( !scheduler )
+    {
+    this->Render();
+    }
+  else if ( !this->Parent )
+    {
+    scheduler->RequestRender(this->Interactor);
+    }
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::FlushRender()
+{
+  vtkBoneRenderScheduler* scheduler = this->Skeleton->GetRenderScheduler();
+  if ( !scheduler )
+    {
+    this->Render();
+    }
+  else if ( !this->Parent )
+    {
+    scheduler->RequestRender(this->Interactor);
+    scheduler->Flush();
+    }
+}
+
+//-------------------------------------------------------------------------
+int vtkBoneWidget::ProcessEvent(unsigned long event)
+{
+  // The actions abort the events they process
+  this->EventCallbackCommand->SetAbortFlag(0);
+  switch (event)
+    {
+    case vtkCommand::LeftButtonPressEvent:
+      vtkBoneWidget::AddPointAction(this);
+      break;
+    case vtkCommand::MouseMoveEvent:
+      vtkBoneWidget::MoveAction(this);
+      break;
+    case vtkCommand::LeftButtonReleaseEvent:
+      vtkBoneWidget::EndSelectAction(this);
+      break;
+    default:
+      return 0;
+    }
+  return this->EventCallbackCommand->GetAbortFlag();
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::UpdateEventObservers()
+{
+  if ( !this->Enabled || !this->Interactor || this->Parent )
+    {
+    return;
+    }
+
+  this->Interactor->RemoveObserver(this->EventCallbackCommand);
+  if ( !this->Skeleton->GetEventDispatcher() )
+    {
+    this->EventTranslator->AddEventsToInteractor(this->Interactor,
+      this->EventCallbackCommand, this->Priority);
+    }
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::RemovePendingMoveObservers()
+{
+  if ( this->PendingRenderer )
+    {
+    this->PendingRenderer->RemoveObserver(this->PendingRendererObserverTag);
+    this->PendingRenderer->UnRegister(this);
+    this->PendingRenderer = NULL;
+    }
+  if ( this->RenderTimerId != 0 && this->Interactor )
+    {
+    this->Interactor->DestroyTimer(this->RenderTimerId);
+    this->Interactor->RemoveObserver(this->RenderTimerObserverTag);
+    }
+  this->RenderTimerId = 0;
+  this->MovePending = 0;
 }
 
 //-------------------------------------------------------------------------
@@ -1310,6 +1584,9 @@ void vtkBoneWidget::EndSelectAction(vtkAbstractWidget *w)
     return;
     }
 
+  // The last move of the interaction must not wait for the next render
+  self->ProcessPendingMove();
+
   if ( self->WidgetState == vtkBoneWidget::Pose )
     {
     self->BoneParentInteractionStopped();
@@ -1332,14 +1609,14 @@ void vtkBoneWidget::EndSelectAction(vtkAbstractWidget *w)
     self->EndBoneInteraction();
     }
   self->EventCallbackCommand->SetAbortFlag(1);
-  self->Render();
+  self->FlushRender();
 }
 
 //-------------------------------------------------------------------------
 void vtkBoneWidget::BoneParentInteractionStopped()
 {
   //If the movement is finished, store the pose transform
-  CopyQuaternion(this->PoseTransform, this->StartPoseTransform);
+  CopyQuaternion(this->GetPoseTransform(), this->GetStartPoseTransform());
 
   //And update the pose point
   this->GetBoneRepresentation()->GetHeadWorldPosition(this->InteractionWorldHead);
@@ -1348,28 +1625,163 @@ void vtkBoneWidget::BoneParentInteractionStopped()
   this->InvokeEvent(vtkBoneWidget::PoseInteractionStoppedEvent, NULL);
 }
 
+//-------------------------------------------------------------------------
+void vtkBoneWidget::Modified()
+{
+  this->InvalidateWorldFrames();
+  this->Superclass::Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::InvalidateWorldFrames()
+{
+  // A modified cache has modified descendants: the propagation stops there.
+  std::vector<vtkBoneWidget*> bones(1, this);
+  while (!bones.empty())
+    {
+    vtkBoneWidget* bone = bones.back();
+    bones.pop_back();
+    if (bone->WorldRestFrameModified && bone->WorldPoseFrameModified)
+      {
+      continue;
+      }
+
+    bone->WorldRestFrameModified = 1;
+    bone->WorldPoseFrameModified = 1;
+    bones.insert(bones.end(),
+      bone->BoneChildren.begin(), bone->BoneChildren.end());
+    }
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::UpdateWorldRestFrame()
+{
+  if (!this->WorldRestFrameModified)
+    {
+    return;
+    }
+
+  std::vector<vtkBoneWidget*> chain;
+  for (vtkBoneWidget* bone = this; bone && bone->WorldRestFrameModified;
+       bone = bone->BoneParent)
+    {
+    chain.push_back(bone);
+    }
+
+  // The parent of each bone is up to date when the bone is computed
+  for (std::vector<vtkBoneWidget*>::reverse_iterator it = chain.rbegin();
+       it != chain.rend(); ++it)
+    {
+    vtkBoneWidget* bone = *it;
+    vtkBoneRigidTransform transform =
+      bone->GetWorldToBoneParentRestTransform();
+    transform.TransformPoint(bone->GetLocalRestHead(), bone->WorldRestHead);
+    transform.TransformPoint(bone->GetLocalRestTail(), bone->WorldRestTail);
+    bone->WorldRestFrameModified = 0;
+    }
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::UpdateWorldPoseFrame()
+{
+  if (!this->WorldPoseFrameModified)
+    {
+    return;
+    }
+
+  std::vector<vtkBoneWidget*> chain;
+  for (vtkBoneWidget* bone = this; bone && bone->WorldPoseFrameModified;
+       bone = bone->BoneParent)
+    {
+    chain.push_back(bone);
+    }
+
+  // The parent of each bone is up to date when the bone is computed
+  for (std::vector<vtkBoneWidget*>::reverse_iterator it = chain.rbegin();
+       it != chain.rend(); ++it)
+    {
+    vtkBoneWidget* bone = *it;
+    vtkBoneRigidTransform transform =
+      bone->GetWorldToBoneParentPoseTransform();
+    transform.TransformPoint(bone->GetLocalPoseHead(), bone->WorldPoseHead);
+    transform.TransformPoint(bone->GetLocalPoseTail(), bone->WorldPoseTail);
+    bone->WorldPoseFrameModified = 0;
+    }
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::InvokePoseChangedEvent()
+{
+  this->Skeleton->UpdateDescendantPoses(this->BoneId);
+  this->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
+}
+
+//-------------------------------------------------------------------------
+void vtkBoneWidget::ApplyEvaluatedPose(double head[3], double tail[3])
+{
+  this->InvalidateWorldFrames();
+
+  this->GetBoneRepresentation()->SetHeadWorldPosition(head);
+  this->GetBoneRepresentation()->SetTailWorldPosition(tail);
+
+  this->RebuildAxes();
+  this->RebuildParentageLink();
+  this->Modified();
+}
+
 //-------------------------------------------------------------------------
 void vtkBoneWidget::BoneParentPoseChanged()
 {
-  vtkSmartPointer<vtkTransform> transform =
-    this->CreateWorldToBoneParentTransform();
+  vtkBoneRigidTransform transform = this->GetWorldToBoneParentTransform();
 
-  double* newHead = transform->TransformDoublePoint(this->LocalPoseHead);
+  double newHead[3], newTail[3];
+  transform.TransformPoint(this->GetLocalPoseHead(), newHead);
   this->GetBoneRepresentation()->SetHeadWorldPosition(newHead);
 
-  double* newTail = transform->TransformDoublePoint(this->LocalPoseTail);
+  transform.TransformPoint(this->GetLocalPoseTail(), newTail);
   this->GetBoneRepresentation()->SetTailWorldPosition(newTail);
 
-  this->RebuildPoseTransform();
+  this->InvalidateWorldFrames();
+  if (this->WidgetState == vtkBoneWidget::Pose)
+    {
+    // Same composition as the forward kinematics of the skeleton:
+    // Pose = (ParentPose * ParentRest * LocalPoseRotation) * Rest^-1
+    double worldRotation[4];
+    CopyQuaternion(this->GetLocalPoseRotation(), worldRotation);
+    if (this->BoneParent)
+      {
+      double parentRotation[4];
+      MultiplyQuaternion(this->BoneParent->GetPoseTransform(),
+                         this->BoneParent->GetRestTransform(),
+                         parentRotation);
+      NormalizeQuaternion(parentRotation);
+      MultiplyQuaternion(parentRotation, this->GetLocalPoseRotation(),
+                         worldRotation);
+      NormalizeQuaternion(worldRotation);
+      }
+
+    double inverseRest[4];
+    CopyQuaternion(this->GetRestTransform(), inverseRest);
+    inverseRest[1] *= -1.0;
+    inverseRest[2] *= -1.0;
+    inverseRest[3] *= -1.0;
+    MultiplyQuaternion(worldRotation, inverseRest, this->GetPoseTransform());
+    NormalizeQuaternion(this->GetPoseTransform());
+    }
+
   this->RebuildAxes();
   this->RebuildParentageLink();
-  this->InvokeEvent(vtkBoneWidget::PoseChangedEvent, NULL);
+  this->InvokePoseChangedEvent();
   this->Modified();
 }
 
 //-------------------------------------------------------------------------
 void vtkBoneWidget::RebuildPoseTransform()
 {
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildPoseTransform);
+
+  this->InvalidateWorldFrames();
+
   if (this->WidgetState != vtkBoneWidget::Pose)
     {
     return;
@@ -1380,58 +1792,48 @@ void vtkBoneWidget::RebuildPoseTransform()
   // The old pose transform represents the sum of all the other
   // previous transformations.
 
-  double head[3], tail[3], previousLineVect[3], newLineVect[3], rotationAxis[3], poseAngle;
+  double head[3], tail[3], previousLineVect[3], newLineVect[3];
   // 1- Get Head, Tail, Old Tail
   this->GetBoneRepresentation()->GetHeadWorldPosition( head );
   this->GetBoneRepresentation()->GetTailWorldPosition( tail );
 
   // 2- Get the previous line directionnal vector
   vtkMath::Subtract(this->InteractionWorldTail, this->InteractionWorldHead, previousLineVect);
-  vtkMath::Normalize(previousLineVect);
 
   // 3- Get the new line vector
   vtkMath::Subtract(tail, head, newLineVect);
-    vtkMath::Normalize(newLineVect);
 
+  vtkBoneQuaterniond rotation;
   if (this->GetCurrentRenderer() && this->GetCurrentRenderer()->GetActiveCamera())
     {
-    // 4- Compute Rotation Axis
+    // 4- Get Rotation Axis
+    double rotationAxis[3];
     this->GetCurrentRenderer()->GetActiveCamera()->GetDirectionOfProjection(rotationAxis);
-    vtkMath::Normalize(rotationAxis);//Let's be paranoid about normalization
-
-    // 4- Compute Angle
-    double rotationPlaneAxis1[3], rotationPlaneAxis2[3];
-    vtkMath::Perpendiculars(rotationAxis, rotationPlaneAxis1, rotationPlaneAxis2, 0.0);
-    vtkMath::Normalize(rotationPlaneAxis1);//Let's be paranoid about normalization
-    vtkMath::Normalize(rotationPlaneAxis2);
-
-    //The angle is the difference between the old angle and the new angle.
-    //Doing this difference enables us to not care about the possible roll
-    //of the camera
-    double newVectAngle = atan2(vtkMath::Dot(newLineVect, rotationPlaneAxis2),
-                                vtkMath::Dot(newLineVect, rotationPlaneAxis1));
-    double previousVectAngle = atan2(vtkMath::Dot(previousLineVect, rotationPlaneAxis2),
-                                     vtkMath::Dot(previousLineVect, rotationPlaneAxis1));
-    poseAngle = newVectAngle - previousVectAngle;
+    vtkBoneVector3d axis(rotationAxis);
+    axis.Normalize();//Let's be paranoid about normalization
+
+    // 5- Compute the rotation between the projections of the lines in the
+    //rotation plane. Projecting the lines lets us not care about the
+    //possible roll of the camera.
+    vtkBoneVector3d previousLine(previousLineVect), newLine(newLineVect);
+    previousLine = previousLine - axis * axis.Dot(previousLine);
+    newLine = newLine - axis * axis.Dot(newLine);
+    rotation =
+      vtkBoneQuaterniond::FromTwoVectors(previousLine, newLine, axis);
     }
   else //this else is here for now but maybe we should just output an error message ?
        //beacuse I do not think this code would work properly.
     {
-    // 4- Compute Rotation Axis
-    vtkMath::Cross(previousLineVect, newLineVect, rotationAxis);
-    vtkMath::Normalize(rotationAxis);
-
-    // 4- Compute Angle
-    poseAngle = acos(vtkMath::Dot(newLineVect, previousLineVect));
+    // 4- Compute the shortest arc rotation between the lines
+    rotation = vtkBoneQuaterniond::FromTwoVectors(
+      vtkBoneVector3d(previousLineVect), vtkBoneVector3d(newLineVect));
     }
 
   // PoseTransform is the sum of the transform applied to the bone in
   // pose mode. The previous transform are stored in StartPoseTransform
-  double quad[4];
-  AxisAngleToQuaternion(rotationAxis, poseAngle, quad);
-  NormalizeQuaternion(quad);
-  MultiplyQuaternion(quad, this->StartPoseTransform, this->PoseTransform);
-  NormalizeQuaternion(this->PoseTransform);
+  MultiplyQuaternion(rotation.GetData(), this->GetStartPoseTransform(),
+                     this->GetPoseTransform());
+  NormalizeQuaternion(this->GetPoseTransform());
 }
 
 //-------------------------------------------------------------------------
@@ -1463,6 +1865,13 @@ void vtkBoneWidget::EndBoneInteraction()
 {
   this->Superclass::EndInteraction();
   this->InvokeEvent(vtkCommand::EndInteractionEvent,NULL);
+
+  // The last pose of the interaction is not left pending
+  vtkBoneRenderScheduler* scheduler = this->Skeleton->GetRenderScheduler();
+  if ( scheduler )
+    {
+    scheduler->Flush();
+    }
 }
 
 //----------------------------------------------------------------------
@@ -1482,8 +1891,11 @@ void vtkBoneWidget::SetWidgetState(int state)
     return;
     }
 
+  this->ProcessPendingMove();
+
   int previousState = this->WidgetState;
   this->WidgetState = state;
+  this->InvalidateWorldFrames();
 
   switch (this->WidgetState)
     {
@@ -1509,7 +1921,7 @@ void vtkBoneWidget::SetWidgetState(int state)
       this->TailSelected = 0;
 
       //Initialize pose variable used for computations positions
-      InitializeQuaternion(this->StartPoseTransform);
+      InitializeQuaternion(this->GetStartPoseTransform());
       InitializeVector3(this->InteractionWorldHead);
       InitializeVector3(this->InteractionWorldTail);
 
@@ -1522,12 +1934,14 @@ void vtkBoneWidget::SetWidgetState(int state)
       else // previous state was pose
         {
         //We need to reset the points to their original rest position
-        vtkSmartPointer<vtkTransform> transform = this->CreateWorldToBoneParentTransform();
+        vtkBoneRigidTransform transform =
+          this->GetWorldToBoneParentTransform();
 
-        double* newHead = transform->TransformDoublePoint(this->LocalRestHead);
+        double newHead[3], newTail[3];
+        transform.TransformPoint(this->GetLocalRestHead(), newHead);
         this->GetBoneRepresentation()->SetHeadWorldPosition(newHead);
 
-        double* newTail = transform->TransformDoublePoint(this->LocalRestTail);
+        transform.TransformPoint(this->GetLocalRestTail(), newTail);
         this->GetBoneRepresentation()->SetTailWorldPosition(newTail);
         }
 
@@ -1545,9 +1959,9 @@ void vtkBoneWidget::SetWidgetState(int state)
       this->TailSelected = 0;
 
       //Update local pose
-      CopyVector3(this->LocalRestHead, this->LocalPoseHead);
-      CopyVector3(this->LocalRestTail, this->LocalPoseTail);
-      CopyQuaternion(this->PoseTransform, this->StartPoseTransform);
+      CopyVector3(this->GetLocalRestHead(), this->GetLocalPoseHead());
+      CopyVector3(this->GetLocalRestTail(), this->GetLocalPoseTail());
+      CopyQuaternion(this->GetPoseTransform(), this->GetStartPoseTransform());
 
       //Update/Rebuild variables
       if (previousState != vtkBoneWidget::Rest)
@@ -1558,7 +1972,9 @@ void vtkBoneWidget::SetWidgetState(int state)
       else //previous state was rest
         {
         //Need to rebuild the pose mode as a function of the the rest mode.
-        double distance = this->GetBoneRepresentation()->GetDistance();
+        double distance = sqrt(vtkMath::Distance2BetweenPoints(
+          this->GetBoneRepresentation()->GetHeadWorldPosition(),
+          this->GetBoneRepresentation()->GetTailWorldPosition()));
 
         //Let's create the Y directionnal vector of the bone
         double rotateWorldYQuaternion[4];
@@ -1567,33 +1983,24 @@ void vtkBoneWidget::SetWidgetState(int state)
                            rotateWorldYQuaternion);
         NormalizeQuaternion(rotateWorldYQuaternion);
 
-        //Convert transform to rotation axis
-        double worldYRotationAxis[3];
-        double worldYRotationAngle =
-          QuaternionToAxisAngle(rotateWorldYQuaternion, worldYRotationAxis);
-
-        //Create transform
-        vtkSmartPointer<vtkTransform> rotateWorldYTransform =
-          vtkSmartPointer<vtkTransform>::New();
-       rotateWorldYTransform->RotateWXYZ(
-         vtkMath::DegreesFromRadians(worldYRotationAngle),
-         worldYRotationAxis);
-
         //Rotate Y
-        double* newY = rotateWorldYTransform->TransformDoubleVector(Y);
+        double newY[3];
+        vtkBoneRigidTransform rotateWorldYTransform;
+        rotateWorldYTransform.SetRotation(rotateWorldYQuaternion);
+        rotateWorldYTransform.TransformVector(Y, newY);
 
         if (!this->BoneParent)
           {
           //Head is local rest position
-          this->GetBoneRepresentation()->SetHeadWorldPosition(this->LocalRestHead);
+          this->GetBoneRepresentation()->SetHeadWorldPosition(this->GetLocalRestHead());
           }
         else //Has bone parent
           {
           //Head is given by the position of the local rest in the father
           //coordinates sytem (pose+rest !)
-          vtkSmartPointer<vtkTransform> headT =
-            this->CreateWorldToBoneParentPoseTransform();
-          double* newHead = headT->TransformDoublePoint(this->LocalRestHead);
+          double newHead[3];
+          this->GetWorldToBoneParentPoseTransform().TransformPoint(
+            this->GetLocalRestHead(), newHead);
           this->GetBoneRepresentation()->SetHeadWorldPosition(newHead);
           }
 
@@ -1645,6 +2052,35 @@ void vtkBoneWidget::SetWidgetStateToRest()
   this->SetWidgetState(vtkBoneWidget::Rest);
 }
 
+//----------------------------------------------------------------------
+void vtkBoneWidget::SetUpdateMode(int mode)
+{
+  if ( mode == this->UpdateMode )
+    {
+    return;
+    }
+
+  if ( this->MovePending )
+    {
+    this->ProcessPendingMove();
+    this->Render();
+    }
+  this->UpdateMode = mode;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------
+void vtkBoneWidget::SetUpdateModeToImmediate()
+{
+  this->SetUpdateMode(vtkBoneWidget::ImmediateUpdate);
+}
+
+//----------------------------------------------------------------------
+void vtkBoneWidget::SetUpdateModeToDeferred()
+{
+  this->SetUpdateMode(vtkBoneWidget::DeferredUpdate);
+}
+
 //----------------------------------------------------------------------
 void vtkBoneWidget::SetAxesVisibility(int visibility)
 {
@@ -1695,6 +2131,8 @@ void vtkBoneWidget::UpdateAxesVisibility()
 //----------------------------------------------------------------------
 void vtkBoneWidget::RebuildParentageLink()
 {
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildParentageLink);
+
   if (this->ParentageLink->GetLineRepresentation()->GetVisibility())
     {
     this->ParentageLink->GetLineRepresentation()->SetPoint1WorldPosition(
@@ -1708,6 +2146,8 @@ void vtkBoneWidget::RebuildParentageLink()
 //----------------------------------------------------------------------
 void vtkBoneWidget::RebuildAxes()
 {
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildAxes);
+
   // only update axes if they are visible to prevent unecessary computation
   if (this->AxesActor->GetVisibility())
     {
@@ -1715,14 +2155,14 @@ void vtkBoneWidget::RebuildAxes()
       this->GetBoneRepresentation()->GetDistance() * this->AxesSize;
     this->AxesActor->SetTotalLength(distance, distance, distance);
 
-    double axis[3], angle;
+    vtkBoneRigidTransform axesTransform;
     if (this->AxesVisibility == vtkBoneWidget::ShowRestTransform)
       {
-      angle = vtkBoneWidget::QuaternionToAxisAngle(this->RestTransform, axis);
+      axesTransform.SetRotation(this->GetRestTransform());
       }
     else if (this->AxesVisibility == vtkBoneWidget::ShowPoseTransform)
       {
-      angle = vtkBoneWidget::QuaternionToAxisAngle(this->PoseTransform, axis);
+      axesTransform.SetRotation(this->GetPoseTransform());
       }
     else if (this->AxesVisibility == vtkBoneWidget::ShowPoseTransformAndRestTransform)
       {
@@ -1731,15 +2171,26 @@ void vtkBoneWidget::RebuildAxes()
                          this->GetRestTransform(),
                           resultTransform);
       NormalizeQuaternion(resultTransform);
-
-      angle = vtkBoneWidget::QuaternionToAxisAngle(resultTransform, axis);
+      axesTransform.SetRotation(resultTransform);
       }
 
-    vtkSmartPointer<vtkTransform> transform = vtkSmartPointer<vtkTransform>::New();
-    transform->Translate( this->GetBoneRepresentation()->GetTailWorldPosition() );
-    transform->RotateWXYZ( vtkMath::DegreesFromRadians(angle), axis );
-
-    this->AxesActor->SetUserTransform(transform);
+    // The columns of the user matrix are the rotated world axes, the
+    // translation is the tail. The matrix is updated in place.
+    const double* axes[3] = {X, Y, Z};
+    for (int i = 0; i < 3; ++i)
+      {
+      double axis[3];
+      axesTransform.TransformVector(axes[i], axis);
+      for (int j = 0; j < 3; ++j)
+        {
+        this->AxesMatrix->SetElement(j, i, axis[j]);
+        }
+      }
+    const double* tail = this->GetBoneRepresentation()->GetTailWorldPosition();
+    for (int j = 0; j < 3; ++j)
+      {
+      this->AxesMatrix->SetElement(j, 3, tail[j]);
+      }
     }
 }
 
@@ -1819,62 +2270,83 @@ void vtkBoneWidget::SetShowParentage(int parentage)
 
 //----------------------------------------------------------------------
 vtkSmartPointer<vtkTransform> vtkBoneWidget::CreateWorldToBoneParentTransform()
+{
+  if (this->WidgetState != vtkBoneWidget::Rest
+      && this->WidgetState != vtkBoneWidget::Pose)
+    {
+    //Start or define mode
+    return NULL;
+    }
+
+  return CreateTransform(this->GetWorldToBoneParentTransform());
+}
+
+//----------------------------------------------------------------------
+vtkSmartPointer<vtkTransform> vtkBoneWidget::CreateWorldToBoneParentPoseTransform()
+{
+  return CreateTransform(this->GetWorldToBoneParentPoseTransform());
+}
+
+//----------------------------------------------------------------------
+vtkSmartPointer<vtkTransform> vtkBoneWidget::CreateWorldToBoneParentRestTransform()
+{
+  return CreateTransform(this->GetWorldToBoneParentRestTransform());
+}
+
+//----------------------------------------------------------------------
+vtkBoneRigidTransform vtkBoneWidget::GetWorldToBoneParentTransform()
 {
   if (this->WidgetState == vtkBoneWidget::Rest)
     {
-    return this->CreateWorldToBoneParentRestTransform();
+    return this->GetWorldToBoneParentRestTransform();
     }
   else if (this->WidgetState == vtkBoneWidget::Pose)
     {
-    return this->CreateWorldToBoneParentPoseTransform();
+    return this->GetWorldToBoneParentPoseTransform();
     }
 
   //Start or define mode
-  return NULL;
+  return vtkBoneRigidTransform();
 }
 
 //----------------------------------------------------------------------
-vtkSmartPointer<vtkTransform> vtkBoneWidget::CreateWorldToBoneParentPoseTransform()
+vtkBoneRigidTransform vtkBoneWidget::GetWorldToBoneParentPoseTransform()
 {
-  vtkSmartPointer<vtkTransform> poseTransform
-    = vtkSmartPointer<vtkTransform>::New();
+  vtkBoneRigidTransform poseTransform;
   if (!this->BoneParent)
     {
     return poseTransform;
     }
 
-  poseTransform->Translate(this->BoneParent->GetTailPoseWorldPosition());
-
   double resultTransform[4];
   MultiplyQuaternion(this->BoneParent->GetPoseTransform(),
                      this->BoneParent->GetRestTransform(),
                      resultTransform);
   NormalizeQuaternion(resultTransform);
+  poseTransform.SetRotation(resultTransform);
 
-  double axis[3];
-  double angle = QuaternionToAxisAngle(resultTransform, axis);
-  poseTransform->RotateWXYZ(vtkMath::DegreesFromRadians(angle), axis);
+  double tail[3];
+  this->BoneParent->GetTailPoseWorldPosition(tail);
+  poseTransform.SetTranslation(tail);
   return poseTransform;
 }
 
 //----------------------------------------------------------------------
-vtkSmartPointer<vtkTransform> vtkBoneWidget::CreateWorldToBoneParentRestTransform()
+vtkBoneRigidTransform vtkBoneWidget::GetWorldToBoneParentRestTransform()
 {
-  vtkSmartPointer<vtkTransform> restTransform
-    = vtkSmartPointer<vtkTransform>::New();
+  vtkBoneRigidTransform restTransform;
   if (!this->BoneParent)
     {
     return restTransform;
     }
 
-  //Translation
-  restTransform->Translate(this->BoneParent->GetTailRestWorldPosition());
-
   //Rotation
-  double axis[3];
-  double angle =
-    QuaternionToAxisAngle(this->BoneParent->GetRestTransform(), axis);
-  restTransform->RotateWXYZ(vtkMath::DegreesFromRadians(angle), axis);
+  restTransform.SetRotation(this->BoneParent->GetRestTransform());
+
+  //Translation
+  double tail[3];
+  this->BoneParent->GetTailRestWorldPosition(tail);
+  restTransform.SetTranslation(tail);
 
   return restTransform;
 }
@@ -1909,18 +2381,7 @@ double vtkBoneWidget::QuaternionToAxisAngle(double quad[4], double axis[3])
 //----------------------------------------------------------------------
 void vtkBoneWidget::AxisAngleToQuaternion(double axis[3], double angle, double quad[4])
 {
-  quad[0] = cos( angle / 2.0 );
-
-  double vec[3];
-  vec[0] = axis[0];
-  vec[1] = axis[1];
-  vec[2] = axis[2];
-  vtkMath::Normalize(vec);
-
-  double f = sin( angle / 2.0);
-  quad[1] =  vec[0] * f;
-  quad[2] =  vec[1] * f;
-  quad[3] =  vec[2] * f;
+  vtkBoneQuaterniond::FromAxisAngle(angle, vtkBoneVector3d(axis)).CopyTo(quad);
 }
 
 //----------------------------------------------------------------------
@@ -1942,19 +2403,22 @@ void vtkBoneWidget::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "Bone Parent: "<< this->BoneParent << "\n";
     }
 
+  os << indent << "Skeleton: "<< this->Skeleton << "\n";
+  os << indent << "Bone Id: "<< this->BoneId << "\n";
+
   os << indent << "Local Points:" << "\n";
-  os << indent << "  Local Rest Head: "<< this->LocalRestHead[0]
-                                << "  " << this->LocalRestHead[1]
-                                << "  " << this->LocalRestHead[2]<< "\n";
-  os << indent << "  Local Rest Tail: "<< this->LocalRestTail[0]
-                                << "  " << this->LocalRestTail[1]
-                                << "  " << this->LocalRestTail[2]<< "\n";
-  os << indent << "  Local Pose Head: "<< this->LocalPoseHead[0]
-                                << "  " << this->LocalPoseHead[1]
-                                << "  " << this->LocalPoseHead[2]<< "\n";
-  os << indent << "  Local Pose Tail: "<< this->LocalPoseTail[0]
-                                << "  " << this->LocalPoseTail[1]
-                                << "  " << this->LocalPoseTail[2]<< "\n";
+  os << indent << "  Local Rest Head: "<< this->GetLocalRestHead()[0]
+                                << "  " << this->GetLocalRestHead()[1]
+                                << "  " << this->GetLocalRestHead()[2]<< "\n";
+  os << indent << "  Local Rest Tail: "<< this->GetLocalRestTail()[0]
+                                << "  " << this->GetLocalRestTail()[1]
+                                << "  " << this->GetLocalRestTail()[2]<< "\n";
+  os << indent << "  Local Pose Head: "<< this->GetLocalPoseHead()[0]
+                                << "  " << this->GetLocalPoseHead()[1]
+                                << "  " << this->GetLocalPoseHead()[2]<< "\n";
+  os << indent << "  Local Pose Tail: "<< this->GetLocalPoseTail()[0]
+                                << "  " << this->GetLocalPoseTail()[1]
+                                << "  " << this->GetLocalPoseTail()[2]<< "\n";
 
   os << indent << "Temporary Points:" << "\n";
   os << indent << "  Interaction World Head: "<< this->InteractionWorldHead[0]
@@ -1965,18 +2429,18 @@ void vtkBoneWidget::PrintSelf(ostream& os, vtkIndent indent)
                                 << "  " << this->InteractionWorldTail[2]<< "\n";
 
   os << indent << "Tranforms:" << "\n";
-  os << indent << "  Rest Transform: "<< this->RestTransform[0]
-                                << "  " << this->RestTransform[1]
-                                << "  " << this->RestTransform[2]
-                                << "  " << this->RestTransform[3]<< "\n";
-  os << indent << "  Pose Transform: "<< this->PoseTransform[0]
-                                << "  " << this->PoseTransform[1]
-                                << "  " << this->PoseTransform[2]
-                                << "  " << this->PoseTransform[3]<< "\n";
-  os << indent << "  Start PoseTransform: "<< this->StartPoseTransform[0]
-                                << "  " << this->StartPoseTransform[1]
-                                << "  " << this->StartPoseTransform[2]
-                                << "  " << this->StartPoseTransform[3]<< "\n";
+  os << indent << "  Rest Transform: "<< this->GetRestTransform()[0]
+                                << "  " << this->GetRestTransform()[1]
+                                << "  " << this->GetRestTransform()[2]
+                                << "  " << this->GetRestTransform()[3]<< "\n";
+  os << indent << "  Pose Transform: "<< this->GetPoseTransform()[0]
+                                << "  " << this->GetPoseTransform()[1]
+                                << "  " << this->GetPoseTransform()[2]
+                                << "  " << this->GetPoseTransform()[3]<< "\n";
+  os << indent << "  Start PoseTransform: "<< this->GetStartPoseTransform()[0]
+                                << "  " << this->GetStartPoseTransform()[1]
+                                << "  " << this->GetStartPoseTransform()[2]
+                                << "  " << this->GetStartPoseTransform()[3]<< "\n";
 
   os << indent << "Roll: "<< this->Roll << "\n";
 
@@ -1986,6 +2450,11 @@ void vtkBoneWidget::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Axes:" << "\n";
   os << indent << "  Axes Actor: "<< this->AxesActor << "\n";
+  os << indent << "  Axes Matrix: "<< this->AxesMatrix << "\n";
   os << indent << "  Axes Visibility: "<< this->AxesVisibility << "\n";
   os << indent << "  Axes Size: "<< this->AxesSize << "\n";
+
+  os << indent << "Profiler: "<< this->Profiler << "\n";
+  os << indent << "UpdateMode: "<< this->UpdateMode << "\n";
+  os << indent << "MovePending: "<< this->MovePending << "\n";
 }
@@ -55,17 +55,25 @@
 // a line).
 
 #include "vtkAbstractWidget.h"
+#include "vtkBoneRigidTransform.h"
+#include "vtkBoneSkeleton.h"
 #include "vtkBoneWidgetHeader.h"
 
 #include <vtkCommand.h>
 #include <vtkSmartPointer.h>
 
+#include <vector>
+
 class vtkAxesActor;
+class vtkBoneProfiler;
 class vtkBoneRepresentation;
 class vtkBoneWidgetCallback;
 class vtkHandleWidget;
+class vtkLineRepresentation;
 class vtkLineWidget2;
+class vtkMatrix4x4;
 class vtkPolyDataMapper;
+class vtkRenderer;
 class vtkTransform;
 
 class VTK_BONEWIDGETS_EXPORT vtkBoneWidget : public vtkAbstractWidget
@@ -80,6 +88,10 @@ public:
   vtkTypeMacro(vtkBoneWidget, vtkAbstractWidget);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Overridden to invalidate the cached world positions of the bones.
+  virtual void Modified();
+
   // Description:
   // The method for activiating and deactiviating this widget. This method
   // must be overridden because it is a composite widget and does more than
@@ -140,6 +152,8 @@ public:
 
   // Description:
   // Get the head rest position in world coordinates
+  // Outside of their own mode, the world positions are computed from the
+  // local points and the parent frame, and cached until a bone changes.
   void GetHeadRestWorldPosition(double Head[3]);
   double* GetHeadRestWorldPosition();
 
@@ -177,6 +191,18 @@ public:
   void RotateTailWXYZ(double angle, double x, double y, double z);
   void RotateTailWXYZ(double angle, double axis[3]);
 
+  // Description:
+  // Move the bone to head and tail with the given pose transform, as at
+  // the end of an interaction. Pose mode only. The descendants are not
+  // updated and no event is invoked, so that several bones can be posed
+  // before a single PropagatePose().
+  void SetPose(double poseTransform[4], double head[3], double tail[3]);
+
+  // Description:
+  // Move the descendants of the bone to its pose and invoke
+  // PoseChangedEvent. Pose mode only.
+  void PropagatePose();
+
   // Descritption:
   // Helper function for conversion quaternion conversion
   // to and from rotation/axis
@@ -204,6 +230,15 @@ public:
   void SetBoneParent(vtkBoneWidget* parent);
   vtkBoneWidget* GetBoneParent();
 
+  // Description:
+  // Get the skeleton holding the bone's state and the bone's slot in it.
+  // A bone that was never added to a skeleton owns a private one.
+  // See vtkBoneSkeleton::AddBone() to share a skeleton between bones.
+  vtkBoneSkeleton* GetSkeleton()
+    { return this->Skeleton; };
+  vtkIdType GetBoneId()
+    { return this->BoneId; };
+
   // Description:
   // Get/Set the bone's RestTransform. The RestTransform is updated in rest mode
   // and fixed in pose mode. It is undefined in the other modes.
@@ -274,6 +309,16 @@ public:
   //    T = BonreParentRestTransform*BoneParentPoseTransform + Translation
   vtkSmartPointer<vtkTransform> CreateWorldToBoneParentPoseTransform();
 
+  //BTX
+  // Description:
+  // Same as the Create...Transform() methods but return a lightweight
+  // rigid transform by value, without allocating any VTK object.
+  // GetWorldToBoneParentTransform() returns identity in Start/Define mode.
+  vtkBoneRigidTransform GetWorldToBoneParentTransform();
+  vtkBoneRigidTransform GetWorldToBoneParentRestTransform();
+  vtkBoneRigidTransform GetWorldToBoneParentPoseTransform();
+  //ETX
+
   // Description:
   // Set/Get if the bone Head is linked, i.e merged. with the parent Tail
   // When setting this to true, the bone Head is automatically snapped
@@ -295,6 +340,62 @@ public:
   vtkAxesActor* GetAxesActor()
   { return this->AxesActor; };
 
+  // Description:
+  // Get the representation of the link between the bone and its parent.
+  // This is meant for the user to modify the rendering properties of the
+  // link. The other properties must be left unchanged.
+  vtkLineRepresentation* GetParentageLinkRepresentation();
+
+  // Description:
+  // Get the profiler of the bone. It counts and times the rebuilds of the
+  // bone and of its representation and the dispatch of the observed
+  // events. NULL unless the VTK_BONE_WIDGET_ENABLE_PROFILING option is ON.
+  // See vtkBoneProfiler::GetGlobalProfiler() for the sum over all bones.
+  vtkBoneProfiler* GetProfiler()
+  { return this->Profiler; };
+
+  // Description:
+  // Set/Get how the mouse moves are processed in Rest and Pose mode.
+  // ImmediateUpdate (default): each move rebuilds the bone, updates its
+  // children, invokes the events and renders.
+  // DeferredUpdate: a move only stores the event position and schedules a
+  // render. The last stored move is processed once, right before the next
+  // render of the renderer (or when the button is released), so the moves
+  // received during a frame cost one rebuild. The render is requested to
+  // the render scheduler of the skeleton if any, otherwise it is scheduled
+  // with a one shot interactor timer. If the interactor is not initialized
+  // the application is responsible for rendering.
+  //BTX
+  enum UpdateModeType {ImmediateUpdate = 0, DeferredUpdate};
+  //ETX
+  vtkGetMacro(UpdateMode, int);
+  void SetUpdateMode(int mode);
+  void SetUpdateModeToImmediate();
+  void SetUpdateModeToDeferred();
+
+  // Description:
+  // Run the action of the bone for a LeftButtonPressEvent, MouseMoveEvent
+  // or LeftButtonReleaseEvent of its interactor, as if the bone observed
+  // the event. Return 1 if the bone consumed the event, 0 otherwise.
+  // Used by vtkBoneEventDispatcher to route the events.
+  int ProcessEvent(unsigned long event);
+
+  // Description:
+  // Process the move stored in DeferredUpdate mode, if any.
+  // It is automatically called before rendering.
+  void ProcessPendingMove();
+
+  // Description:
+  // Return 1 if a move is waiting to be processed.
+  vtkGetMacro(MovePending, int);
+
+  // Description:
+  // Return 1 if the cached world rest (resp. pose) positions of the bone are
+  // out of date. They are invalidated with the bone's descendants when the
+  // bone changes, and recomputed the next time they are queried.
+  vtkGetMacro(WorldRestFrameModified, int);
+  vtkGetMacro(WorldPoseFrameModified, int);
+
 protected:
   vtkBoneWidget();
   ~vtkBoneWidget();
@@ -325,16 +426,41 @@ protected:
   // Bone widget essentials
   vtkBoneWidget*              BoneParent;
   vtkBoneWidgetCallback*      BoneWidgetChildrenCallback;
-  double                      LocalRestHead[3];
-  double                      LocalRestTail[3];
-  double                      LocalPoseHead[3];
-  double                      LocalPoseTail[3];
+  //BTX
+  // The children of the bone, whatever their skeleton
+  std::vector<vtkBoneWidget*> BoneChildren;
+  //ETX
   double                      InteractionWorldHead[3];
   double                      InteractionWorldTail[3];
-  double                      StartPoseTransform[4];
+
+  // Cached world positions, used when the bone is not in the corresponding
+  // mode. A change of the bone flags its cache and the caches of its
+  // descendants as modified. A modified cache is lazily recomputed.
+  // A cache is never valid while the cache of an ancestor is modified.
+  double                      WorldRestHead[3];
+  double                      WorldRestTail[3];
+  double                      WorldPoseHead[3];
+  double                      WorldPoseTail[3];
+  int                         WorldRestFrameModified;
+  int                         WorldPoseFrameModified;
   double                      Roll; // in radians
-  double                      RestTransform[4];
-  double                      PoseTransform[4];
+
+  // The local points and the transforms are stored in the skeleton slot
+  vtkBoneSkeleton*            Skeleton;
+  vtkIdType                   BoneId;
+
+  double* GetLocalRestHead()
+    { return this->Skeleton->GetLocalRestHead(this->BoneId); };
+  double* GetLocalRestTail()
+    { return this->Skeleton->GetLocalRestTail(this->BoneId); };
+  double* GetLocalPoseHead()
+    { return this->Skeleton->GetLocalPoseHead(this->BoneId); };
+  double* GetLocalPoseTail()
+    { return this->Skeleton->GetLocalPoseTail(this->BoneId); };
+  double* GetStartPoseTransform()
+    { return this->Skeleton->GetStartPoseTransform(this->BoneId); };
+  double* GetLocalPoseRotation()
+    { return this->Skeleton->GetLocalPoseRotation(this->BoneId); };
 
   // For the link between parent and child
   int                         HeadLinkedToParent;
@@ -344,8 +470,23 @@ protected:
   // For an easier debug and understanding
   int                         AxesVisibility;
   vtkAxesActor*               AxesActor;
+  vtkMatrix4x4*               AxesMatrix;
   double                      AxesSize;
 
+  // Instrumentation, NULL when compiled out
+  vtkBoneProfiler*            Profiler;
+
+  // Deferred update
+  int                         UpdateMode;
+  int                         MovePending;
+  double                      PendingEventPosition[2];
+  double                      PendingLastEventPosition[2];
+  vtkRenderer*                PendingRenderer;
+  unsigned long               PendingRendererObserverTag;
+  int                         RenderTimerId;
+  unsigned long               RenderTimerObserverTag;
+  vtkBoneWidgetCallback*      DeferredUpdateCallback;
+
   // Essentials functions
   // Recompute transforms:
   void RebuildRestTransform();
@@ -359,6 +500,27 @@ protected:
   void RebuildAxes();
   void RebuildParentageLink();
 
+  // Move the bone as the mouse moved from lastE to e, in display
+  // coordinates, and invoke the corresponding events.
+  void ProcessMove(double e[2], double lastE[2]);
+
+  // Store the move for DeferredUpdate mode and schedule a render.
+  void DeferMove(double e[2], double lastE[2]);
+  void RenderTimerExpired(int timerId);
+  void RemovePendingMoveObservers();
+
+  // Render through the render scheduler of the skeleton if any,
+  // immediately otherwise.
+  void RequestRender();
+
+  // Render now, along with the render pending in the render scheduler of
+  // the skeleton if any.
+  void FlushRender();
+
+  // Observe the interactor events, unless the event dispatcher of the
+  // skeleton routes them to the bone.
+  void UpdateEventObservers();
+
   // Those methods change the visibility of the features
   // and call the corresponding Rebuild...()
   void UpdateParentageLinkVisibility();
@@ -371,6 +533,32 @@ protected:
   // Move this Tail to the child's Head. Used for translations.
   void LinkTailToChild(vtkBoneWidget* child);
 
+  // Invalidate the cached world frames of the bone and of its descendants.
+  // Must be called whenever the state of the bone changes, Modified() does
+  // it.
+  void InvalidateWorldFrames();
+
+  // Recompute the cached world frames if needed. The modified ancestors
+  // are recomputed first, from the root down, so each bone of the chain is
+  // computed once from its parent's cached frame.
+  void UpdateWorldRestFrame();
+  void UpdateWorldPoseFrame();
+
+  // Update the descendants sharing the skeleton with the forward
+  // kinematics, then invoke PoseChangedEvent for the other observers.
+  void InvokePoseChangedEvent();
+
+  // Move the bone to a pose computed by the skeleton forward kinematics.
+  // No event is invoked.
+  void ApplyEvaluatedPose(double head[3], double tail[3]);
+
+  // Forget a child, when it is deleted or changes parent.
+  void RemoveBoneChild(vtkBoneWidget* child);
+
+  // Return 1 if a child of the bone belongs to another skeleton. Such a
+  // child follows the bone on PoseChangedEvent only.
+  int HasExternalBoneChildren();
+
   // Function called upon Parent events
   void BoneParentPoseChanged();
   void BoneParentInteractionStopped();
@@ -378,6 +566,7 @@ protected:
 
 //BTX
   friend class vtkBoneWidgetCallback;
+  friend class vtkBoneSkeleton;
 //ETX
 
 private:
@@ -19,6 +19,8 @@
 =========================================================================*/
 #include "vtkCylinderBoneRepresentation.h"
 
+#include "vtkBoneProfiler.h"
+
 #include "vtkActor.h"
 #include "vtkAppendPolyData.h"
 #include "vtkBox.h"
@@ -27,47 +29,128 @@
 #include "vtkCylinderSource.h"
 #include "vtkInteractorObserver.h"
 #include "vtkLineSource.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPolyDataMapper.h"
 #include "vtkProperty.h"
 #include "vtkRenderer.h"
 #include "vtkSmartPointer.h"
-#include "vtkTransformPolydataFilter.h"
+#include "vtkTransform.h"
+#include "vtkTransformPolyDataFilter.h"
 #include "vtkTubeFilter.h"
 #include "vtkWindow.h"
 
+#include <utility>
+
 vtkStandardNewMacro(vtkCylinderBoneRepresentation);
 
+namespace
+{
+
+// The unit meshes of the levels of detail are shared by all the
+// representations. A mesh is generated for the first representation that
+// renders the level and deleted with the last one.
+struct SharedMesh
+{
+  vtkPolyData* Mesh;
+  int          Users;
+};
+
+// Keyed by number of sides and capping
+typedef std::map<std::pair<int, int>, SharedMesh> SharedMeshMap;
+
+SharedMeshMap& GetSharedMeshes()
+{
+  static SharedMeshMap meshes;
+  return meshes;
+}
+
+vtkPolyData* AcquireUnitCylinder(int numberOfSides, int capping)
+{
+  SharedMeshMap& meshes = GetSharedMeshes();
+  std::pair<int, int> key(numberOfSides, capping);
+  SharedMeshMap::iterator it = meshes.find(key);
+  if (it == meshes.end())
+    {
+    vtkSmartPointer<vtkLineSource> line =
+      vtkSmartPointer<vtkLineSource>::New();
+    line->SetPoint1(0.0, 0.0, 0.0);
+    line->SetPoint2(1.0, 0.0, 0.0);
+    vtkSmartPointer<vtkTubeFilter> tube =
+      vtkSmartPointer<vtkTubeFilter>::New();
+    tube->SetInput(line->GetOutput());
+    tube->SetRadius(0.1);
+    tube->SetCapping(capping);
+    tube->SetNumberOfSides(numberOfSides);
+    tube->Update();
+
+    SharedMesh mesh;
+    mesh.Mesh = vtkPolyData::New();
+    mesh.Mesh->ShallowCopy(tube->GetOutput());
+    mesh.Users = 0;
+    it = meshes.insert(SharedMeshMap::value_type(key, mesh)).first;
+    }
+  ++it->second.Users;
+  return it->second.Mesh;
+}
+
+void ReleaseUnitCylinder(vtkPolyData* mesh)
+{
+  SharedMeshMap& meshes = GetSharedMeshes();
+  for (SharedMeshMap::iterator it = meshes.begin(); it != meshes.end(); ++it)
+    {
+    if (it->second.Mesh == mesh)
+      {
+      if (--it->second.Users == 0)
+        {
+        it->second.Mesh->Delete();
+        meshes.erase(it);
+        }
+      return;
+      }
+    }
+}
+
+}// end namespace
+
 //----------------------------------------------------------------------------
 vtkCylinderBoneRepresentation::vtkCylinderBoneRepresentation()
 {
   this->InstantiateHandleRepresentation();
 
-  // Represent the Cylinder
-  this->CylinderGenerator= vtkTubeFilter::New();
+  this->NumberOfSides = 5;
+  this->Radius = 0.0;
+
+  // Represent the Cylinder. The mesh is set by RebuildCylinder().
   this->CylinderMapper = vtkPolyDataMapper::New();
-  this->CylinderMapper->SetInput(this->CylinderGenerator->GetOutput());
+  this->CylinderMatrix = vtkMatrix4x4::New();
   this->CylinderActor = vtkActor::New();
   this->CylinderActor->SetMapper(this->CylinderMapper);
+  this->CylinderActor->SetUserMatrix(this->CylinderMatrix);
 
   // Set up the initial properties
   this->CreateDefaultProperties();
 
   this->CylinderActor->SetProperty(this->CylinderProperty);
 
+  this->RebuildCylinder();
   this->BuildRepresentation();
 }
 
 //----------------------------------------------------------------------------
 vtkCylinderBoneRepresentation::~vtkCylinderBoneRepresentation()
 {
+  this->ClearLevelOfDetailMappers();
+
   if (this->CylinderProperty)
     {
     this->CylinderProperty->Delete();
     }
 
-  this->CylinderGenerator->Delete();
+  ReleaseUnitCylinder(this->CylinderMapper->GetInput());
+  this->CylinderMatrix->Delete();
   this->CylinderActor->Delete();
   this->CylinderMapper->Delete();
 }
@@ -77,14 +160,14 @@ vtkCylinderBoneRepresentation::~vtkCylinderBoneRepresentation()
 void vtkCylinderBoneRepresentation::SetPoint1WorldPosition(double x[3])
 {
   this->Superclass::SetPoint1WorldPosition(x);
-  this->RebuildCylinder();
+  this->UpdateCylinderMatrix();
 }
 
 //----------------------------------------------------------------------
 void vtkCylinderBoneRepresentation::SetPoint2WorldPosition(double x[3])
 {
   this->Superclass::SetPoint2WorldPosition(x);
-  this->RebuildCylinder();
+  this->UpdateCylinderMatrix();
 }
 
 //----------------------------------------------------------------------
@@ -115,8 +198,17 @@ void vtkCylinderBoneRepresentation::GetPolyData(vtkPolyData *pd)
 
   vtkPolyData* superclassPd = 0;
   this->Superclass::GetPolyData(superclassPd);
-  
-  append->AddInput( this->CylinderGenerator->GetOutput() );
+
+  // The cylinder mesh is in the bone unit frame
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  transform->SetMatrix(this->CylinderMatrix);
+  vtkSmartPointer<vtkTransformPolyDataFilter> cylinder =
+    vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  cylinder->SetInput( this->CylinderMapper->GetInput() );
+  cylinder->SetTransform( transform );
+
+  append->AddInput( cylinder->GetOutput() );
   append->AddInput( superclassPd );
   append->Update();
   pd->ShallowCopy( append->GetOutput() );
@@ -145,27 +237,93 @@ void vtkCylinderBoneRepresentation::CreateDefaultProperties()
 //----------------------------------------------------------------------------
 void vtkCylinderBoneRepresentation::BuildRepresentation()
 {
-  // Rebuild only if necessary
+  // The handles and the line depend on the view: rebuild them when the
+  // camera or the window change
   if ( this->GetMTime() > this->BuildTime ||
        (this->Renderer && this->Renderer->GetVTKWindow() &&
         (this->Renderer->GetVTKWindow()->GetMTime() > this->BuildTime ||
         this->Renderer->GetActiveCamera()->GetMTime() > this->BuildTime)) )
     {
     this->Superclass::BuildRepresentation();
-    this->RebuildCylinder();   
 
     this->BuildTime.Modified();
     }
+
+  // The cylinder does not, it only depends on the bone end points
+  this->UpdateCylinderMatrix();
 }
 
 //----------------------------------------------------------------------
 void vtkCylinderBoneRepresentation::RebuildCylinder()
 {
-  this->CylinderGenerator->SetCapping( this->Capping );
-  this->CylinderGenerator->SetRadius( this->Distance / 10 );
-  this->CylinderGenerator->SetInput( this->LineSource->GetOutput() );
-  this->CylinderGenerator->SetNumberOfSides( this->NumberOfSides );
-  this->CylinderGenerator->Update();
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildCylinder);
+
+  this->ClearLevelOfDetailMappers();
+
+  // Acquired before the release: the mesh is kept if it did not change
+  vtkPolyData* mesh = AcquireUnitCylinder(this->NumberOfSides, this->Capping);
+  ReleaseUnitCylinder(this->CylinderMapper->GetInput());
+  this->CylinderMapper->SetInput(mesh);
+}
+
+//----------------------------------------------------------------------
+void vtkCylinderBoneRepresentation::UpdateCylinderMatrix()
+{
+  if (!this->UnitBoneMatrixNeedsUpdate())
+    {
+    return;
+    }
+
+  this->GetUnitBoneMatrix(this->CylinderMatrix);
+
+  double head[3], tail[3];
+  this->GetHeadWorldPosition(head);
+  this->GetTailWorldPosition(tail);
+  this->Radius = sqrt(vtkMath::Distance2BetweenPoints(head, tail)) / 10;
+}
+
+//----------------------------------------------------------------------
+vtkPolyDataMapper* vtkCylinderBoneRepresentation
+::GetLevelOfDetailMapper(int numberOfSides)
+{
+  if (numberOfSides == this->NumberOfSides)
+    {
+    return this->CylinderMapper;
+    }
+
+  std::map<int, vtkPolyDataMapper*>::iterator it =
+    this->LevelOfDetailMappers.find(numberOfSides);
+  if (it != this->LevelOfDetailMappers.end())
+    {
+    return it->second;
+    }
+
+  vtkPolyData* mesh = AcquireUnitCylinder(numberOfSides, this->Capping);
+
+  vtkPolyDataMapper* mapper = vtkPolyDataMapper::New();
+  mapper->SetInput(mesh);
+  this->LevelOfDetailMappers[numberOfSides] = mapper;
+  return mapper;
+}
+
+//----------------------------------------------------------------------
+void vtkCylinderBoneRepresentation::ClearLevelOfDetailMappers()
+{
+  for (std::map<int, vtkPolyDataMapper*>::iterator it =
+         this->LevelOfDetailMappers.begin();
+       it != this->LevelOfDetailMappers.end(); ++it)
+    {
+    ReleaseUnitCylinder(it->second->GetInput());
+    it->second->Delete();
+    }
+  this->LevelOfDetailMappers.clear();
+  this->CylinderActor->SetMapper(this->CylinderMapper);
+}
+
+//----------------------------------------------------------------------
+int vtkCylinderBoneRepresentation::GetNumberOfLevelOfDetailMeshes()
+{
+  return static_cast<int>(GetSharedMeshes().size());
 }
 
 //----------------------------------------------------------------------
@@ -180,6 +338,12 @@ void vtkCylinderBoneRepresentation::ReleaseGraphicsResources(vtkWindow *w)
 {
   this->Superclass::ReleaseGraphicsResources(w);
   this->CylinderActor->ReleaseGraphicsResources(w);
+  for (std::map<int, vtkPolyDataMapper*>::iterator it =
+         this->LevelOfDetailMappers.begin();
+       it != this->LevelOfDetailMappers.end(); ++it)
+    {
+    it->second->ReleaseGraphicsResources(w);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -187,8 +351,20 @@ int vtkCylinderBoneRepresentation::RenderOpaqueGeometry(vtkViewport *v)
 {
   this->BuildRepresentation();
 
-  return  this->CylinderActor->RenderOpaqueGeometry(v)
-          + this->Superclass::RenderOpaqueGeometry(v);
+  int numberOfSides = this->ComputeLevelOfDetail(v, this->NumberOfSides);
+  if (numberOfSides < 0)
+    {
+    // Too small to be seen
+    return 0;
+    }
+
+  int count = this->Superclass::RenderOpaqueGeometry(v);
+  if (numberOfSides > 0)
+    {
+    this->CylinderActor->SetMapper(this->GetLevelOfDetailMapper(numberOfSides));
+    count += this->CylinderActor->RenderOpaqueGeometry(v);
+    }
+  return count;
 }
 
 //----------------------------------------------------------------------------
@@ -196,8 +372,20 @@ int vtkCylinderBoneRepresentation::RenderTranslucentPolygonalGeometry(vtkViewpor
 {
   this->BuildRepresentation();
 
-  return  this->CylinderActor->RenderTranslucentPolygonalGeometry(v)
-          + this->Superclass::RenderTranslucentPolygonalGeometry(v);
+  int numberOfSides = this->ComputeLevelOfDetail(v, this->NumberOfSides);
+  if (numberOfSides < 0)
+    {
+    // Too small to be seen
+    return 0;
+    }
+
+  int count = this->Superclass::RenderTranslucentPolygonalGeometry(v);
+  if (numberOfSides > 0)
+    {
+    this->CylinderActor->SetMapper(this->GetLevelOfDetailMapper(numberOfSides));
+    count += this->CylinderActor->RenderTranslucentPolygonalGeometry(v);
+    }
+  return count;
 }
 
 //----------------------------------------------------------------------------
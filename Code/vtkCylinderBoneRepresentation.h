@@ -24,7 +24,12 @@
 #include "vtkBoneRepresentation.h"
 #include "vtkBoneWidgetHeader.h"
 
+//BTX
+#include <map>
+//ETX
+
 class vtkActor;
+class vtkMatrix4x4;
 class vtkPolyDataMapper;
 class vtkPolyData;
 class vtkProperty;
@@ -51,6 +56,7 @@ public:
   virtual void SetPoint2WorldPosition(double pos[3]);
 
   // Description:
+  // Get the cylinder and the line in world coordinates.
   virtual void GetPolyData(vtkPolyData *pd);
 
   // Description:
@@ -82,15 +88,21 @@ public:
   virtual int RenderOpaqueGeometry(vtkViewport*);
   virtual int RenderTranslucentPolygonalGeometry(vtkViewport*);
   virtual int HasTranslucentPolygonalGeometry();
+
+  // Description:
+  // Return the number of unit cylinder meshes of the levels of detail
+  // currently shared by the representations.
+  static int GetNumberOfLevelOfDetailMeshes();
   
 protected:
   vtkCylinderBoneRepresentation();
   ~vtkCylinderBoneRepresentation();
 
-  // the Cylinder
+  // the Cylinder. The mesh is a unit cylinder, along X from 0 to 1, placed
+  // on the bone by the actor matrix.
   vtkActor*          CylinderActor;
   vtkPolyDataMapper* CylinderMapper;
-  vtkTubeFilter*     CylinderGenerator;
+  vtkMatrix4x4*      CylinderMatrix;
 
   // Properties used to control the appearance of selected objects and
   // the manipulator in general.
@@ -102,8 +114,27 @@ protected:
   int    Capping;
   int    NumberOfSides;
 
+  // Description:
+  // Pick the shared unit cylinder mesh. Only needed when the capping or the
+  // number of sides change.
   void RebuildCylinder();
 
+  // Description:
+  // Return the mapper of the unit mesh with the given number of sides.
+  // The mappers are cached until the shape parameters change. Their meshes
+  // are shared with the other representations of the same shape.
+  vtkPolyDataMapper* GetLevelOfDetailMapper(int numberOfSides);
+  void ClearLevelOfDetailMappers();
+
+//BTX
+  std::map<int, vtkPolyDataMapper*> LevelOfDetailMappers;
+//ETX
+
+  // Description:
+  // Place the cylinder on the bone if the end points moved. No pipeline is
+  // executed.
+  void UpdateCylinderMatrix();
+
 private:
   vtkCylinderBoneRepresentation(const vtkCylinderBoneRepresentation&);  //Not implemented
   void operator=(const vtkCylinderBoneRepresentation&);  //Not implemented
@@ -20,63 +20,132 @@
 
 #include "vtkDoubleConeBoneRepresentation.h"
 
+#include "vtkBoneProfiler.h"
+#include "vtkDoubleConeSource.h"
+
 #include "vtkActor.h"
 #include "vtkAppendPolyData.h"
 #include "vtkBox.h"
 #include "vtkCamera.h"
-#include "vtkConeSource.h"
 #include "vtkLineSource.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPolyDataMapper.h"
 #include "vtkProperty.h"
 #include "vtkRenderer.h"
 #include "vtkSmartPointer.h"
+#include "vtkTransform.h"
+#include "vtkTransformPolyDataFilter.h"
 #include "vtkTubeFilter.h"
 #include "vtkWindow.h"
 
+#include <utility>
+
 vtkStandardNewMacro(vtkDoubleConeBoneRepresentation);
 
+namespace
+{
+
+// The unit meshes of the levels of detail are shared by all the
+// representations. A mesh is generated for the first representation that
+// renders the level and deleted with the last one.
+struct SharedMesh
+{
+  vtkPolyData* Mesh;
+  int          Users;
+};
+
+// Keyed by number of sides and ratio
+typedef std::map<std::pair<int, double>, SharedMesh> SharedMeshMap;
+
+SharedMeshMap& GetSharedMeshes()
+{
+  static SharedMeshMap meshes;
+  return meshes;
+}
+
+vtkPolyData* AcquireUnitCones(int numberOfSides, double ratio)
+{
+  SharedMeshMap& meshes = GetSharedMeshes();
+  std::pair<int, double> key(numberOfSides, ratio);
+  SharedMeshMap::iterator it = meshes.find(key);
+  if (it == meshes.end())
+    {
+    vtkSmartPointer<vtkDoubleConeSource> cones =
+      vtkSmartPointer<vtkDoubleConeSource>::New();
+    cones->SetRatio(ratio);
+    cones->SetNumberOfSides(numberOfSides);
+    cones->Update();
+
+    SharedMesh mesh;
+    mesh.Mesh = vtkPolyData::New();
+    mesh.Mesh->ShallowCopy(cones->GetOutput());
+    mesh.Users = 0;
+    it = meshes.insert(SharedMeshMap::value_type(key, mesh)).first;
+    }
+  ++it->second.Users;
+  return it->second.Mesh;
+}
+
+void ReleaseUnitCones(vtkPolyData* mesh)
+{
+  SharedMeshMap& meshes = GetSharedMeshes();
+  for (SharedMeshMap::iterator it = meshes.begin(); it != meshes.end(); ++it)
+    {
+    if (it->second.Mesh == mesh)
+      {
+      if (--it->second.Users == 0)
+        {
+        it->second.Mesh->Delete();
+        meshes.erase(it);
+        }
+      return;
+      }
+    }
+}
+
+}// end namespace
+
 //----------------------------------------------------------------------------
 vtkDoubleConeBoneRepresentation::vtkDoubleConeBoneRepresentation()
 {
   this->InstantiateHandleRepresentation();
 
   // Represent the Cone
-  this->Cone1 = vtkConeSource::New();
-  this->Cone2 = vtkConeSource::New();
   this->Ratio = 0.25;
   this->NumberOfSides = 5;
   this->Capping = 1;
+  this->Radius = 0.0;
 
-  this->GlueFilter = vtkAppendPolyData::New();
-  this->GlueFilter->AddInput( this->Cone1->GetOutput() );
-  this->GlueFilter->AddInput( this->Cone2->GetOutput() );
-  this->GlueFilter->Update();
-
+  // The mesh is set by RebuildCones()
   this->ConesMapper = vtkPolyDataMapper::New();
-  this->ConesMapper->SetInput(this->GlueFilter->GetOutput());
+  this->ConesMatrix = vtkMatrix4x4::New();
   this->ConesActor = vtkActor::New();
   this->ConesActor->SetMapper(this->ConesMapper);
+  this->ConesActor->SetUserMatrix(this->ConesMatrix);
 
   // Set up the initial properties
   this->CreateDefaultProperties();
 
   this->ConesActor->SetProperty(this->ConesProperty);
+
+  this->RebuildCones();
 }
 
 //----------------------------------------------------------------------------
 vtkDoubleConeBoneRepresentation::~vtkDoubleConeBoneRepresentation()
 {
+  this->ClearLevelOfDetailMappers();
+
   if (this->ConesProperty)
     {
     this->ConesProperty->Delete();
     }
 
-  this->Cone1->Delete();
-  this->Cone2->Delete();
-
-  this->GlueFilter->Delete();
+  ReleaseUnitCones(this->ConesMapper->GetInput());
+  this->ConesMatrix->Delete();
   this->ConesActor->Delete();
   this->ConesMapper->Delete();
 }
@@ -86,14 +155,14 @@ vtkDoubleConeBoneRepresentation::~vtkDoubleConeBoneRepresentation()
 void vtkDoubleConeBoneRepresentation::SetPoint1WorldPosition(double x[3])
 {
   this->Superclass::SetPoint1WorldPosition(x);
-  this->RebuildCones();
+  this->UpdateConesMatrix();
 }
 
 //----------------------------------------------------------------------
 void vtkDoubleConeBoneRepresentation::SetPoint2WorldPosition(double x[3])
 {
   this->Superclass::SetPoint2WorldPosition(x);
-  this->RebuildCones();
+  this->UpdateConesMatrix();
 }
 
 //----------------------------------------------------------------------
@@ -102,9 +171,8 @@ void vtkDoubleConeBoneRepresentation::SetRatio(double ratio)
   if (ratio > 0.0001 && ratio <= 1.0 && this->Ratio != ratio)
     {
     this->Ratio = ratio;
-    
+
     this->RebuildCones();
-    this->GlueFilter->Update();
     }
 }
 
@@ -114,10 +182,7 @@ void vtkDoubleConeBoneRepresentation::SetCapping(int capping)
   if (this->Capping != capping)
     {
     this->Capping = capping;
-    
-    this->Cone1->SetCapping(capping);
-    this->Cone2->SetCapping(capping);
-    this->GlueFilter->Update();
+    this->Modified();
     }
 }
 
@@ -127,10 +192,8 @@ void vtkDoubleConeBoneRepresentation::SetNumberOfSides(int numberOfSides)
   if (numberOfSides >= 3 && this->NumberOfSides != numberOfSides)
     {
     this->NumberOfSides = numberOfSides;
-    
-    this->Cone1->SetResolution(numberOfSides);
-    this->Cone2->SetResolution(numberOfSides);
-    this->GlueFilter->Update();
+
+    this->RebuildCones();
     }
 }
 
@@ -142,8 +205,17 @@ void vtkDoubleConeBoneRepresentation::GetPolyData(vtkPolyData *pd)
 
   vtkPolyData* superclassPd = 0;
   this->Superclass::GetPolyData(superclassPd);
-  
-  append->AddInput( this->GlueFilter->GetOutput() );
+
+  // The cones mesh is in the bone unit frame
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  transform->SetMatrix(this->ConesMatrix);
+  vtkSmartPointer<vtkTransformPolyDataFilter> cones =
+    vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  cones->SetInput( this->ConesMapper->GetInput() );
+  cones->SetTransform( transform );
+
+  append->AddInput( cones->GetOutput() );
   append->AddInput( superclassPd );
   append->Update();
   pd->ShallowCopy( append->GetOutput() );
@@ -170,55 +242,94 @@ void vtkDoubleConeBoneRepresentation::CreateDefaultProperties()
 //----------------------------------------------------------------------------
 void vtkDoubleConeBoneRepresentation::BuildRepresentation()
 {
-  // Rebuild only if necessary
+  // The handles and the line depend on the view: rebuild them when the
+  // camera or the window change
   if ( this->GetMTime() > this->BuildTime ||
        (this->Renderer && this->Renderer->GetVTKWindow() &&
         (this->Renderer->GetVTKWindow()->GetMTime() > this->BuildTime ||
         this->Renderer->GetActiveCamera()->GetMTime() > this->BuildTime)) )
     {
     this->Superclass::BuildRepresentation();
-    this->RebuildCones();
 
     this->BuildTime.Modified();
     }
+
+  // The cones do not, they only depend on the bone end points
+  this->UpdateConesMatrix();
 }
 
 //----------------------------------------------------------------------
 void vtkDoubleConeBoneRepresentation::RebuildCones()
 {
-  double x1[3], x2[3], vect[3];
-  this->GetPoint1WorldPosition(x1);
-  this->GetPoint2WorldPosition(x2);
-  vect[0] = x2[0] - x1[0];
-  vect[1] = x2[1] - x1[1];
-  vect[2] = x2[2] - x1[2];
-
-  double cone1Ratio = this->Ratio * 0.5;
-  double cone2Ratio = (1 + this->Ratio) * 0.5;
-  this->Cone1->SetCenter( x1[0] + (vect[0] * cone1Ratio),
-                          x1[1] + (vect[1] * cone1Ratio),
-                          x1[2] + (vect[2] * cone1Ratio) );
-  this->Cone1->SetDirection(-vect[0], -vect[1], -vect[2]);
-  this->Cone1->SetHeight( this->Distance * this->Ratio );
-  this->Cone1->SetRadius( this->Distance / 10 );
-
-  this->Cone2->SetCenter( x1[0] + (vect[0] * cone2Ratio),
-                          x1[1] + (vect[1] * cone2Ratio),
-                          x1[2] + (vect[2] * cone2Ratio) );
-
-  this->Cone2->SetDirection(vect);
-  this->Cone2->SetHeight( this->Distance * (1 - this->Ratio));
-  this->Cone2->SetRadius( this->Distance / 10 );
-
-  this->GlueFilter->Update();
+  vtkBoneProfileScopeMacro(this->Profiler, RebuildCones);
+
+  this->ClearLevelOfDetailMappers();
+
+  // Unit double cone, the cones are glued at Ratio along the bone.
+  // Acquired before the release: the mesh is kept if it did not change.
+  vtkPolyData* mesh = AcquireUnitCones(this->NumberOfSides, this->Ratio);
+  ReleaseUnitCones(this->ConesMapper->GetInput());
+  this->ConesMapper->SetInput(mesh);
 }
 
 //----------------------------------------------------------------------
-void vtkDoubleConeBoneRepresentation::GlueCones()
+void vtkDoubleConeBoneRepresentation::UpdateConesMatrix()
 {
-  this->GlueFilter->AddInput( this->Cone1->GetOutput() );
-  this->GlueFilter->AddInput( this->Cone2->GetOutput() );
-  this->GlueFilter->Update();
+  if (!this->UnitBoneMatrixNeedsUpdate())
+    {
+    return;
+    }
+
+  this->GetUnitBoneMatrix(this->ConesMatrix);
+
+  double head[3], tail[3];
+  this->GetHeadWorldPosition(head);
+  this->GetTailWorldPosition(tail);
+  this->Radius = sqrt(vtkMath::Distance2BetweenPoints(head, tail)) / 10;
+}
+
+//----------------------------------------------------------------------
+vtkPolyDataMapper* vtkDoubleConeBoneRepresentation
+::GetLevelOfDetailMapper(int numberOfSides)
+{
+  if (numberOfSides == this->NumberOfSides)
+    {
+    return this->ConesMapper;
+    }
+
+  std::map<int, vtkPolyDataMapper*>::iterator it =
+    this->LevelOfDetailMappers.find(numberOfSides);
+  if (it != this->LevelOfDetailMappers.end())
+    {
+    return it->second;
+    }
+
+  vtkPolyData* mesh = AcquireUnitCones(numberOfSides, this->Ratio);
+
+  vtkPolyDataMapper* mapper = vtkPolyDataMapper::New();
+  mapper->SetInput(mesh);
+  this->LevelOfDetailMappers[numberOfSides] = mapper;
+  return mapper;
+}
+
+//----------------------------------------------------------------------
+void vtkDoubleConeBoneRepresentation::ClearLevelOfDetailMappers()
+{
+  for (std::map<int, vtkPolyDataMapper*>::iterator it =
+         this->LevelOfDetailMappers.begin();
+       it != this->LevelOfDetailMappers.end(); ++it)
+    {
+    ReleaseUnitCones(it->second->GetInput());
+    it->second->Delete();
+    }
+  this->LevelOfDetailMappers.clear();
+  this->ConesActor->SetMapper(this->ConesMapper);
+}
+
+//----------------------------------------------------------------------
+int vtkDoubleConeBoneRepresentation::GetNumberOfLevelOfDetailMeshes()
+{
+  return static_cast<int>(GetSharedMeshes().size());
 }
 
 //----------------------------------------------------------------------
@@ -233,6 +344,12 @@ void vtkDoubleConeBoneRepresentation::ReleaseGraphicsResources(vtkWindow *w)
 {
   this->Superclass::ReleaseGraphicsResources(w);
   this->ConesActor->ReleaseGraphicsResources(w);
+  for (std::map<int, vtkPolyDataMapper*>::iterator it =
+         this->LevelOfDetailMappers.begin();
+       it != this->LevelOfDetailMappers.end(); ++it)
+    {
+    it->second->ReleaseGraphicsResources(w);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -240,8 +357,20 @@ int vtkDoubleConeBoneRepresentation::RenderOpaqueGeometry(vtkViewport *v)
 {
   this->BuildRepresentation();
 
-  return  this->ConesActor->RenderOpaqueGeometry(v)
-          + this->Superclass::RenderOpaqueGeometry(v);
+  int numberOfSides = this->ComputeLevelOfDetail(v, this->NumberOfSides);
+  if (numberOfSides < 0)
+    {
+    // Too small to be seen
+    return 0;
+    }
+
+  int count = this->Superclass::RenderOpaqueGeometry(v);
+  if (numberOfSides > 0)
+    {
+    this->ConesActor->SetMapper(this->GetLevelOfDetailMapper(numberOfSides));
+    count += this->ConesActor->RenderOpaqueGeometry(v);
+    }
+  return count;
 }
 
 //----------------------------------------------------------------------------
@@ -249,8 +378,20 @@ int vtkDoubleConeBoneRepresentation::RenderTranslucentPolygonalGeometry(vtkViewp
 {
   this->BuildRepresentation();
 
-  return  this->ConesActor->RenderTranslucentPolygonalGeometry(v)
-          + this->Superclass::RenderTranslucentPolygonalGeometry(v);
+  int numberOfSides = this->ComputeLevelOfDetail(v, this->NumberOfSides);
+  if (numberOfSides < 0)
+    {
+    // Too small to be seen
+    return 0;
+    }
+
+  int count = this->Superclass::RenderTranslucentPolygonalGeometry(v);
+  if (numberOfSides > 0)
+    {
+    this->ConesActor->SetMapper(this->GetLevelOfDetailMapper(numberOfSides));
+    count += this->ConesActor->RenderTranslucentPolygonalGeometry(v);
+    }
+  return count;
 }
 
 //----------------------------------------------------------------------------
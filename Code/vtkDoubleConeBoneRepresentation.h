@@ -26,9 +26,12 @@
 #include "vtkBoneRepresentation.h"
 #include "vtkBoneWidgetHeader.h"
 
+//BTX
+#include <map>
+//ETX
+
 class vtkActor;
-class vtkAppendPolyData;
-class vtkConeSource;
+class vtkMatrix4x4;
 class vtkPolyDataMapper;
 class vtkPolyData;
 class vtkProperty;
@@ -55,6 +58,7 @@ public:
   virtual void SetPoint2WorldPosition(double pos[3]);
 
   // Description:
+  // Get the cones and the line in world coordinates.
   virtual void GetPolyData(vtkPolyData *pd);
 
   // Description:
@@ -65,7 +69,8 @@ public:
   vtkGetMacro(Radius,double);
 
   // Description:
-  // Min 0.0001
+  // The cones share their base ring: the surface is closed whatever the
+  // capping.
   void SetCapping (int capping);
   vtkGetMacro(Capping, int);
   
@@ -92,17 +97,21 @@ public:
   virtual int RenderOpaqueGeometry(vtkViewport*);
   virtual int RenderTranslucentPolygonalGeometry(vtkViewport*);
   virtual int HasTranslucentPolygonalGeometry();
+
+  // Description:
+  // Return the number of unit double cone meshes of the levels of detail
+  // currently shared by the representations.
+  static int GetNumberOfLevelOfDetailMeshes();
   
 protected:
   vtkDoubleConeBoneRepresentation();
   ~vtkDoubleConeBoneRepresentation();
 
-  // the Cylinder
+  // the Cones. The mesh is a unit double cone, along X from 0 to 1, placed
+  // on the bone by the actor matrix.
   vtkActor*          ConesActor;
   vtkPolyDataMapper* ConesMapper;
-  vtkConeSource*     Cone1;
-  vtkConeSource*     Cone2;
-  vtkAppendPolyData* GlueFilter;
+  vtkMatrix4x4*      ConesMatrix;
 
   // Properties used to control the appearance of selected objects and
   // the manipulator in general.
@@ -115,9 +124,27 @@ protected:
   double Ratio;
   int    Capping;
 
-  void GlueCones();
+  // Description:
+  // Pick the shared unit double cone mesh. Only needed when the ratio, the
+  // capping or the number of sides change.
   void RebuildCones();
 
+  // Description:
+  // Return the mapper of the unit mesh with the given number of sides.
+  // The mappers are cached until the shape parameters change. Their meshes
+  // are shared with the other representations of the same shape.
+  vtkPolyDataMapper* GetLevelOfDetailMapper(int numberOfSides);
+  void ClearLevelOfDetailMappers();
+
+//BTX
+  std::map<int, vtkPolyDataMapper*> LevelOfDetailMappers;
+//ETX
+
+  // Description:
+  // Place the cones on the bone if the end points moved. No pipeline is
+  // executed.
+  void UpdateConesMatrix();
+
 private:
   vtkDoubleConeBoneRepresentation(const vtkDoubleConeBoneRepresentation&);  //Not implemented
   void operator=(const vtkDoubleConeBoneRepresentation&);  //Not implemented
@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkDoubleConeSource.h"
+
+//VTK Includes
+#include <vtkCellArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+//STL includes
+#include <cmath>
+
+vtkStandardNewMacro(vtkDoubleConeSource);
+
+//----------------------------------------------------------------------------
+vtkDoubleConeSource::vtkDoubleConeSource()
+{
+  this->SetNumberOfInputPorts(0);
+
+  this->Point1[0] = this->Point1[1] = this->Point1[2] = 0.0;
+  this->Point2[0] = 1.0;
+  this->Point2[1] = this->Point2[2] = 0.0;
+  this->Radius = 0.1;
+  this->Ratio = 0.25;
+  this->NumberOfSides = 5;
+
+  this->Points = vtkPoints::New();
+  this->Points->SetDataTypeToDouble();
+  this->Triangles = vtkCellArray::New();
+  this->TopologyNumberOfSides = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDoubleConeSource::~vtkDoubleConeSource()
+{
+  this->Points->Delete();
+  this->Triangles->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkDoubleConeSource::BuildTopology()
+{
+  const int n = this->NumberOfSides;
+
+  this->Cosines.resize(n);
+  this->Sines.resize(n);
+  for (int i = 0; i < n; ++i)
+    {
+    double angle = 2.0 * vtkMath::Pi() * i / n;
+    this->Cosines[i] = cos(angle);
+    this->Sines[i] = sin(angle);
+    }
+
+  this->Points->SetNumberOfPoints(n + 2);
+
+  // Reset() keeps the memory of the previous triangles
+  this->Triangles->Reset();
+  for (int i = 0; i < n; ++i)
+    {
+    vtkIdType current = 2 + i;
+    vtkIdType next = 2 + (i + 1) % n;
+    vtkIdType cone1Triangle[3] = {0, next, current};
+    vtkIdType cone2Triangle[3] = {1, current, next};
+    this->Triangles->InsertNextCell(3, cone1Triangle);
+    this->Triangles->InsertNextCell(3, cone2Triangle);
+    }
+  this->Triangles->Modified();
+
+  this->TopologyNumberOfSides = n;
+}
+
+//----------------------------------------------------------------------------
+int vtkDoubleConeSource::RequestData(vtkInformation* vtkNotUsed(request),
+                                     vtkInformationVector** vtkNotUsed(inputVector),
+                                     vtkInformationVector* outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkPolyData* output =
+    vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  if (this->TopologyNumberOfSides != this->NumberOfSides)
+    {
+    this->BuildTopology();
+    }
+
+  // Frame of the ring
+  double axis[3], u[3], v[3];
+  vtkMath::Subtract(this->Point2, this->Point1, axis);
+  if (vtkMath::Normalize(axis) == 0.0)
+    {
+    axis[0] = 1.0;
+    axis[1] = axis[2] = 0.0;
+    }
+  vtkMath::Perpendiculars(axis, u, v, 0.0);
+
+  double center[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    center[i] = this->Point1[i]
+      + this->Ratio * (this->Point2[i] - this->Point1[i]);
+    }
+
+  // Rewrite the coordinates in place
+  double* points = static_cast<double*>(
+    this->Points->GetData()->GetVoidPointer(0));
+  for (int i = 0; i < 3; ++i)
+    {
+    points[i] = this->Point1[i];
+    points[3 + i] = this->Point2[i];
+    }
+  for (int side = 0; side < this->NumberOfSides; ++side)
+    {
+    double c = this->Radius * this->Cosines[side];
+    double s = this->Radius * this->Sines[side];
+    double* point = points + 3 * (2 + side);
+    for (int i = 0; i < 3; ++i)
+      {
+      point[i] = center[i] + c * u[i] + s * v[i];
+      }
+    }
+  this->Points->Modified();
+
+  output->SetPoints(this->Points);
+  output->SetPolys(this->Triangles);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkDoubleConeSource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Point1: (" << this->Point1[0] << ", "
+     << this->Point1[1] << ", " << this->Point1[2] << ")\n";
+  os << indent << "Point2: (" << this->Point2[0] << ", "
+     << this->Point2[1] << ", " << this->Point2[2] << ")\n";
+  os << indent << "Radius: " << this->Radius << "\n";
+  os << indent << "Ratio: " << this->Ratio << "\n";
+  os << indent << "Number Of Sides: " << this->NumberOfSides << "\n";
+}
@@ -0,0 +1,118 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkDoubleConeSource_h
+#define __vtkDoubleConeSource_h
+
+// .NAME vtkDoubleConeSource - Two cones glued by their base
+// .SECTION Description
+// vtkDoubleConeSource generates two cones sharing their base ring: the
+// first one goes from Point1 to the ring, the second one from the ring to
+// Point2. The ring is at Ratio along the segment. The output is a closed
+// surface of NumberOfSides + 2 points and 2 * NumberOfSides triangles:
+// point 0 is Point1, point 1 is Point2 and the others are the ring.
+//
+// The points and the triangles are kept from one execution to the next:
+// changing Ratio, Radius or the end points only rewrites the point
+// coordinates in place, the triangles are rebuilt (without reallocation
+// if the number of sides decreases) only when NumberOfSides changes. The
+// sines and cosines of the ring are tabulated per NumberOfSides.
+// .SECTION See Also
+// vtkDoubleConeBoneRepresentation vtkBoneGlyphInstancer
+
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkBoneWidgetHeader.h"
+
+//BTX
+#include <vector>
+//ETX
+
+class vtkCellArray;
+class vtkPoints;
+
+class VTK_BONEWIDGETS_EXPORT vtkDoubleConeSource : public vtkPolyDataAlgorithm
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkDoubleConeSource *New();
+
+  // Description:
+  // Standard methods for a VTK class.
+  vtkTypeMacro(vtkDoubleConeSource, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the apexes of the cones. Default is (0,0,0) and (1,0,0).
+  vtkSetVector3Macro(Point1, double);
+  vtkGetVector3Macro(Point1, double);
+  vtkSetVector3Macro(Point2, double);
+  vtkGetVector3Macro(Point2, double);
+
+  // Description:
+  // Set/Get the radius of the shared base ring. Default is 0.1.
+  vtkSetClampMacro(Radius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Radius, double);
+
+  // Description:
+  // Set/Get the position of the ring between Point1 (0) and Point2 (1).
+  // Default is 0.25.
+  vtkSetClampMacro(Ratio, double, 0.0, 1.0);
+  vtkGetMacro(Ratio, double);
+
+  // Description:
+  // Set/Get the number of sides of the cones. Minimum 3, default is 5.
+  vtkSetClampMacro(NumberOfSides, int, 3, VTK_INT_MAX);
+  vtkGetMacro(NumberOfSides, int);
+
+protected:
+  vtkDoubleConeSource();
+  ~vtkDoubleConeSource();
+
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  // Description:
+  // Tabulate the ring and rebuild the triangles for NumberOfSides.
+  void BuildTopology();
+
+  double Point1[3];
+  double Point2[3];
+  double Radius;
+  double Ratio;
+  int NumberOfSides;
+
+  // Kept between executions
+  vtkPoints* Points;
+  vtkCellArray* Triangles;
+  int TopologyNumberOfSides;
+
+//BTX
+  std::vector<double> Cosines;
+  std::vector<double> Sines;
+//ETX
+
+private:
+  vtkDoubleConeSource(const vtkDoubleConeSource&);  //Not implemented
+  void operator=(const vtkDoubleConeSource&);  //Not implemented
+};
+
+#endif
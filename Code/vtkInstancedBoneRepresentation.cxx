@@ -0,0 +1,287 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include "vtkInstancedBoneRepresentation.h"
+
+#include "vtkBoneGlyphInstancer.h"
+
+#include "vtkBox.h"
+#include "vtkLine.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointHandleRepresentation3D.h"
+
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(vtkInstancedBoneRepresentation);
+
+//----------------------------------------------------------------------------
+vtkInstancedBoneRepresentation::vtkInstancedBoneRepresentation()
+{
+  this->InstantiateHandleRepresentation();
+
+  // The handles are only used for picking
+  this->HandlesVisibility = 0;
+
+  this->Instancer = NULL;
+  this->InstanceId = -1;
+  this->Color[0] = this->Color[1] = this->Color[2] = 1.0;
+  this->SelectedColor[0] = 0.0;
+  this->SelectedColor[1] = 1.0;
+  this->SelectedColor[2] = 0.0;
+  this->Highlighted = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkInstancedBoneRepresentation::~vtkInstancedBoneRepresentation()
+{
+  this->SetInstancer(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation
+::SetInstancer(vtkBoneGlyphInstancer* instancer)
+{
+  if (instancer == this->Instancer)
+    {
+    return;
+    }
+
+  if (this->Instancer)
+    {
+    this->Instancer->RemoveInstance(this->InstanceId);
+    this->Instancer->UnRegister(this);
+    this->InstanceId = -1;
+    }
+  this->Instancer = instancer;
+  if (this->Instancer)
+    {
+    this->Instancer->Register(this);
+    this->InstanceId = this->Instancer->AddInstance(this);
+    this->UpdateInstance();
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetColor(double r, double g, double b)
+{
+  this->Color[0] = r;
+  this->Color[1] = g;
+  this->Color[2] = b;
+  this->UpdateInstance();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation
+::SetSelectedColor(double r, double g, double b)
+{
+  this->SelectedColor[0] = r;
+  this->SelectedColor[1] = g;
+  this->SelectedColor[2] = b;
+  this->UpdateInstance();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetHeadWorldPosition(double pos[3])
+{
+  this->Superclass::SetHeadWorldPosition(pos);
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetHeadDisplayPosition(double pos[3])
+{
+  this->Superclass::SetHeadDisplayPosition(pos);
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetTailWorldPosition(double pos[3])
+{
+  this->Superclass::SetTailWorldPosition(pos);
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetTailDisplayPosition(double pos[3])
+{
+  this->Superclass::SetTailDisplayPosition(pos);
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetPoint1WorldPosition(double pos[3])
+{
+  this->Superclass::SetPoint1WorldPosition(pos);
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetPoint2WorldPosition(double pos[3])
+{
+  this->Superclass::SetPoint2WorldPosition(pos);
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::SetVisibility(int visible)
+{
+  this->Superclass::SetVisibility(visible);
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::Highlight(int highlight)
+{
+  this->Superclass::Highlight(highlight);
+  this->Highlighted = highlight;
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+int vtkInstancedBoneRepresentation
+::ComputeInteractionState(int X, int Y, int modify)
+{
+  int state = this->Superclass::ComputeInteractionState(X, Y, modify);
+
+  if (state == vtkLineRepresentation::Outside)
+    {
+    // The glyph is wider than the line tolerance: its radius is a tenth
+    // of the bone length.
+    double p1[3], p2[3], x[3], closest[3], t;
+    this->GetPoint1DisplayPosition(p1);
+    this->GetPoint2DisplayPosition(p2);
+    p1[2] = p2[2] = 0.0;
+    x[0] = X;
+    x[1] = Y;
+    x[2] = 0.0;
+    double tolerance = std::max(static_cast<double>(this->Tolerance),
+                                0.1 * sqrt(vtkMath::Distance2BetweenPoints(p1, p2)));
+    if (vtkLine::DistanceToLine(x, p1, p2, t, closest)
+          <= tolerance * tolerance)
+      {
+      // Grab the bone where it was clicked
+      t = std::min(std::max(t, 0.0), 1.0);
+      double head[3], tail[3], handle[3];
+      this->GetHeadWorldPosition(head);
+      this->GetTailWorldPosition(tail);
+      for (int i = 0; i < 3; ++i)
+        {
+        handle[i] = head[i] + t * (tail[i] - head[i]);
+        }
+      this->LineHandleRepresentation->SetWorldPosition(handle);
+
+      state = vtkLineRepresentation::OnLine;
+      this->InteractionState = state;
+      this->SetRepresentationState(state);
+      }
+    }
+
+  this->Highlighted = (state != vtkLineRepresentation::Outside);
+  this->UpdateInstance();
+  return state;
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::BuildRepresentation()
+{
+  this->Superclass::BuildRepresentation();
+  this->UpdateInstance();
+}
+
+//----------------------------------------------------------------------------
+double *vtkInstancedBoneRepresentation::GetBounds()
+{
+  double head[3], tail[3], bounds[6];
+  this->GetHeadWorldPosition(head);
+  this->GetTailWorldPosition(tail);
+  double radius = 0.1 * sqrt(vtkMath::Distance2BetweenPoints(head, tail));
+  for (int i = 0; i < 3; ++i)
+    {
+    bounds[2*i] = std::min(head[i], tail[i]) - radius;
+    bounds[2*i+1] = std::max(head[i], tail[i]) + radius;
+    }
+  this->BoundingBox->SetBounds(bounds);
+  return this->BoundingBox->GetBounds();
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::UpdateInstance()
+{
+  if (!this->Instancer)
+    {
+    return;
+    }
+
+  double head[3], tail[3];
+  this->GetHeadWorldPosition(head);
+  this->GetTailWorldPosition(tail);
+  this->Instancer->SetInstance(this->InstanceId, head, tail,
+    this->Highlighted ? this->SelectedColor : this->Color,
+    this->GetVisibility());
+}
+
+//----------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::GetActors(vtkPropCollection*)
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkInstancedBoneRepresentation::RenderOpaqueGeometry(vtkViewport*)
+{
+  this->BuildRepresentation();
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkInstancedBoneRepresentation
+::RenderTranslucentPolygonalGeometry(vtkViewport*)
+{
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkInstancedBoneRepresentation::RenderOverlay(vtkViewport*)
+{
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkInstancedBoneRepresentation::HasTranslucentPolygonalGeometry()
+{
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkInstancedBoneRepresentation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Instancer: " << this->Instancer << "\n";
+  os << indent << "Instance Id: " << this->InstanceId << "\n";
+  os << indent << "Color: " << this->Color[0] << " "
+     << this->Color[1] << " " << this->Color[2] << "\n";
+  os << indent << "Selected Color: " << this->SelectedColor[0] << " "
+     << this->SelectedColor[1] << " " << this->SelectedColor[2] << "\n";
+}
@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkInstancedBoneRepresentation_h
+#define __vtkInstancedBoneRepresentation_h
+
+// .NAME vtkInstancedBoneRepresentation - Bone drawn by a shared instancer
+// .SECTION Description
+// vtkInstancedBoneRepresentation is a drop-in alternative to
+// vtkCylinderBoneRepresentation and vtkDoubleConeBoneRepresentation for
+// large skeletons. It renders nothing by itself: the bone is an instance
+// of the vtkBoneGlyphInstancer shared by all the bones, which draws them
+// all with a single actor. The line and the handles of the bone are not
+// rendered either, they are only used for picking.
+// Clicking anywhere on the glyph selects the bone (OnLine state) and the
+// selected bone is drawn with the SelectedColor.
+// .SECTION See Also
+// vtkBoneGlyphInstancer vtkBoneWidget
+
+#include "vtkBoneRepresentation.h"
+#include "vtkBoneWidgetHeader.h"
+
+class vtkBoneGlyphInstancer;
+
+class VTK_BONEWIDGETS_EXPORT vtkInstancedBoneRepresentation
+  : public vtkBoneRepresentation
+{
+public:
+  // Description:
+  // Instantiate this class.
+  static vtkInstancedBoneRepresentation *New();
+
+  // Description:
+  // Standard methods for the class.
+  vtkTypeMacro(vtkInstancedBoneRepresentation, vtkBoneRepresentation);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the instancer drawing the bone. The bone is not drawn without
+  // instancer.
+  void SetInstancer(vtkBoneGlyphInstancer* instancer);
+  vtkGetObjectMacro(Instancer, vtkBoneGlyphInstancer);
+
+  // Description:
+  // Get the id of the bone instance in the instancer. -1 if none.
+  vtkGetMacro(InstanceId, vtkIdType);
+
+  // Description:
+  // Set/Get the color of the bone, and when it is selected.
+  void SetColor(double r, double g, double b);
+  vtkGetVector3Macro(Color, double);
+  void SetSelectedColor(double r, double g, double b);
+  vtkGetVector3Macro(SelectedColor, double);
+
+  // Description:
+  // Overridden to update the instance.
+  virtual void SetHeadWorldPosition(double pos[3]);
+  virtual void SetHeadDisplayPosition(double pos[3]);
+  virtual void SetTailWorldPosition(double pos[3]);
+  virtual void SetTailDisplayPosition(double pos[3]);
+  virtual void SetPoint1WorldPosition(double pos[3]);
+  virtual void SetPoint2WorldPosition(double pos[3]);
+  virtual void SetVisibility(int visible);
+  virtual void Highlight(int highlight);
+
+  // Description:
+  // Overridden to also select the bone when clicking on its glyph.
+  virtual int ComputeInteractionState(int X, int Y, int modify = 0);
+
+  // Description:
+  // These are methods that satisfy vtkWidgetRepresentation's API.
+  virtual void BuildRepresentation();
+  virtual double *GetBounds();
+
+  // Description:
+  // Methods supporting the rendering process. Nothing is rendered, the
+  // instancer actor draws the bone.
+  virtual void GetActors(vtkPropCollection *pc);
+  virtual int RenderOpaqueGeometry(vtkViewport*);
+  virtual int RenderTranslucentPolygonalGeometry(vtkViewport*);
+  virtual int RenderOverlay(vtkViewport*);
+  virtual int HasTranslucentPolygonalGeometry();
+
+protected:
+  vtkInstancedBoneRepresentation();
+  ~vtkInstancedBoneRepresentation();
+
+  vtkBoneGlyphInstancer* Instancer;
+  vtkIdType              InstanceId;
+  double                 Color[3];
+  double                 SelectedColor[3];
+  int                    Highlighted;
+
+  // Push the bone into its instance.
+  void UpdateInstance();
+
+//BTX
+  friend class vtkBoneGlyphInstancer;
+//ETX
+
+private:
+  vtkInstancedBoneRepresentation(const vtkInstancedBoneRepresentation&);  //Not implemented
+  void operator=(const vtkInstancedBoneRepresentation&);  //Not implemented
+};
+
+#endif
@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkMath.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneAnimationTrack.h"
+#include "vtkBoneMath.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+#include <vector>
+
+using namespace vtkBoneTestingUtilities;
+
+namespace
+{
+
+bool CompareVectors(const double* values, const double* expectedValues,
+                    int size, const char* what)
+{
+  for (int i = 0; i < size; ++i)
+    {
+    if (fabs(values[i] - expectedValues[i]) > 1e-6)
+      {
+      std::cout<<what<<" different at index "<<i<<" !"<<std::endl
+        <<"Expected:  "<<expectedValues[i]<<std::endl
+        <<" - Got:    "<<values[i]<<std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}// end namespace
+
+int vtkBoneAnimationTrackTest(int, char *[])
+{
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {0.1, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> fatherBone = CreateBone(head, tail);
+
+  head[0] = 0.1; tail[0] = 0.1; tail[2] = -0.1;
+  vtkSmartPointer<vtkBoneWidget> sonBone = CreateBone(head, tail);
+  sonBone->SetBoneParent(fatherBone);
+
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  skeleton->AddBone(fatherBone);
+  skeleton->AddBone(sonBone);
+
+  fatherBone->SetWidgetStateToPose();
+  sonBone->SetWidgetStateToPose();
+
+  // Keyframes: the rest pose at 0, rotated bones at 1
+  vtkSmartPointer<vtkBoneAnimationTrack> track =
+    vtkSmartPointer<vtkBoneAnimationTrack>::New();
+  track->AddKeyframes(0.0, skeleton);
+  fatherBone->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+  sonBone->RotateTailWXYZ(vtkMath::Pi() / 2.0, 1.0, 0.0, 0.0);
+  track->AddKeyframes(1.0, skeleton);
+
+  double range[2];
+  track->GetTimeRange(range);
+  if (track->GetNumberOfBones() != 2 || track->GetNumberOfKeyframes(0) != 2
+      || range[0] != 0.0 || range[1] != 1.0)
+    {
+    std::cout<<"Wrong keyframes."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Halfway, the father turned by 45 degrees
+  double poseTransforms[8];
+  double expectedPoseTransform[4];
+  vtkBoneQuaterniond::FromAxisAngle(vtkMath::Pi() / 4.0,
+    vtkBoneVector3d(0.0, 0.0, 1.0)).CopyTo(expectedPoseTransform);
+  for (int mode = vtkBoneAnimationTrack::Slerp;
+       mode <= vtkBoneAnimationTrack::Nlerp; ++mode)
+    {
+    track->SetInterpolationMode(mode);
+    track->Evaluate(0.5, poseTransforms);
+    if (!CompareVectors(poseTransforms, expectedPoseTransform, 4,
+                        "Interpolated pose transform"))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Slerp has a constant angular speed
+  track->SetInterpolationModeToSlerp();
+  track->Evaluate(0.25, poseTransforms);
+  vtkBoneQuaterniond::FromAxisAngle(vtkMath::Pi() / 8.0,
+    vtkBoneVector3d(0.0, 0.0, 1.0)).CopyTo(expectedPoseTransform);
+  if (!CompareVectors(poseTransforms, expectedPoseTransform, 4,
+                      "Slerp pose transform"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Sequential playback gives the same result as jumping in time
+  vtkSmartPointer<vtkBoneAnimationTrack> denseTrack =
+    vtkSmartPointer<vtkBoneAnimationTrack>::New();
+  for (int i = 0; i <= 10; ++i)
+    {
+    double quad[4];
+    vtkBoneQuaterniond::FromAxisAngle(0.3 * i * i,
+      vtkBoneVector3d(0.0, 1.0, 1.0).Normalized()).CopyTo(quad);
+    denseTrack->AddKeyframe(0, 0.1 * i, quad);
+    }
+  std::vector<double> played(4*101), jumped(4*101);
+  for (int i = 0; i <= 100; ++i)
+    {
+    denseTrack->Evaluate(0.01 * i, &played[4*i]);
+    }
+  for (int i = 100; i >= 0; i -= 7)
+    {
+    denseTrack->Evaluate(0.01 * i, &jumped[4*i]);
+    if (!CompareVectors(&played[4*i], &jumped[4*i], 4, "Sequential playback"))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Apply to the skeleton
+  track->ApplyToSkeleton(0.0, skeleton);
+  double expectedTail[3] = {0.1, 0.0, -0.1};
+  if (!CompareVectors(sonBone->GetTailPoseWorldPosition(), expectedTail, 3,
+                      "Son tail at the first keyframe"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  track->ApplyToSkeleton(0.5, skeleton);
+  double halfway = 0.1 * sqrt(0.5);
+  double expectedFatherTail[3] = {halfway, halfway, 0.0};
+  if (!CompareVectors(fatherBone->GetTailPoseWorldPosition(),
+                      expectedFatherTail, 3, "Father tail halfway")
+      || !CompareVectors(sonBone->GetHeadPoseWorldPosition(),
+                         expectedFatherTail, 3, "Son head halfway"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  track->ApplyToSkeleton(1.0, skeleton);
+  expectedTail[0] = 0.0; expectedTail[1] = 0.2; expectedTail[2] = 0.0;
+  if (!CompareVectors(sonBone->GetTailPoseWorldPosition(), expectedTail, 3,
+                      "Son tail at the last keyframe"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
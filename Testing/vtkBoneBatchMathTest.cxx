@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkMath.h>
+
+#include "vtkBoneBatchMath.h"
+#include "vtkBoneRigidTransform.h"
+
+#include <vector>
+
+namespace
+{
+
+// Not a multiple of the vector width to exercise the scalar remainders
+const int NumberOfElements = 11;
+
+bool CompareArrays(const std::vector<double>& values,
+                   const std::vector<double>& expectedValues,
+                   const char* operation, int instructionSet)
+{
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    if (fabs(values[i] - expectedValues[i]) > 1e-12)
+      {
+      std::cout<<operation<<" failed with "
+        <<vtkBoneBatchMath::GetInstructionSetAsString(instructionSet)
+        <<" at index "<<i<<std::endl
+        <<"Expected:  "<<expectedValues[i]<<std::endl
+        <<" - Got:    "<<values[i]<<std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+void FillRandom(std::vector<double>& values)
+{
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    values[i] = vtkMath::Random(-1.0, 1.0);
+    }
+}
+
+}// end namespace
+
+int vtkBoneBatchMathTest(int, char *[])
+{
+  vtkMath::RandomSeed(42);
+
+  const int n = NumberOfElements;
+  std::vector<double> quads1(4*n), quads2(4*n), points(3*n), translations(3*n);
+  FillRandom(quads1);
+  FillRandom(quads2);
+  FillRandom(points);
+  FillRandom(translations);
+
+  // A null quaternion must survive the normalization
+  quads1[4] = quads1[5] = quads1[6] = quads1[7] = 0.0;
+
+  std::vector<double> unitQuads(quads2);
+  vtkBoneBatchMath::SetInstructionSet(vtkBoneBatchMath::Scalar);
+  vtkBoneBatchMath::NormalizeQuaternions(&unitQuads[0], n);
+
+  // Reference results, computed element by element
+  std::vector<double> expectedTransformedPoints(3*n);
+  std::vector<double> expectedRotatedPoints(3*n);
+  std::vector<double> expectedComposedQuads(4*n);
+  std::vector<double> expectedComposedTranslations(3*n);
+  for (int i = 0; i < n; ++i)
+    {
+    vtkBoneRigidTransform parent(&unitQuads[4*i], &translations[3*i]);
+    parent.TransformPoint(&points[3*i], &expectedTransformedPoints[3*i]);
+    parent.TransformVector(&points[3*i], &expectedRotatedPoints[3*i]);
+
+    vtkBoneRigidTransform local(&quads1[4*i], &points[3*i]);
+    vtkBoneRigidTransform composed = parent * local;
+    for (int j = 0; j < 4; ++j)
+      {
+      expectedComposedQuads[4*i + j] = composed.GetRotation()[j];
+      }
+    for (int j = 0; j < 3; ++j)
+      {
+      expectedComposedTranslations[3*i + j] = composed.GetTranslation()[j];
+      }
+    }
+
+  std::vector<double> expectedProducts(4*n), expectedNormalized(quads1);
+  std::vector<double> expectedConjugates(4*n), expectedNlerps(4*n);
+  vtkBoneBatchMath::MultiplyQuaternions(&quads1[0], &quads2[0],
+                                        &expectedProducts[0], n);
+  vtkBoneBatchMath::NormalizeQuaternions(&expectedNormalized[0], n);
+  vtkBoneBatchMath::ConjugateQuaternions(&quads1[0], &expectedConjugates[0], n);
+
+  std::vector<double> unitQuads1(quads1), alphas(n);
+  unitQuads1[4] = 1.0;
+  vtkBoneBatchMath::NormalizeQuaternions(&unitQuads1[0], n);
+  for (int i = 0; i < n; ++i)
+    {
+    alphas[i] = vtkMath::Random(0.0, 1.0);
+    }
+  vtkBoneBatchMath::NlerpQuaternions(&unitQuads1[0], &unitQuads[0],
+                                     &alphas[0], &expectedNlerps[0], n);
+
+  // Slerp: the ends are the inputs (on the shortest path) and the middle
+  // is the normalized average.
+  std::vector<double> slerps(4*n), halves(n, 0.5), ends(n, 1.0);
+  std::vector<double> expectedEnds(unitQuads), nlerpHalves(4*n);
+  for (int i = 0; i < n; ++i)
+    {
+    double dot = 0.0;
+    for (int j = 0; j < 4; ++j)
+      {
+      dot += unitQuads1[4*i + j] * unitQuads[4*i + j];
+      }
+    for (int j = 0; dot < 0.0 && j < 4; ++j)
+      {
+      expectedEnds[4*i + j] *= -1.0;
+      }
+    }
+  vtkBoneBatchMath::SlerpQuaternions(&unitQuads1[0], &unitQuads[0],
+                                     &ends[0], &slerps[0], n);
+  if (!CompareArrays(slerps, expectedEnds, "Slerp",
+                     vtkBoneBatchMath::Scalar))
+    {
+    return EXIT_FAILURE;
+    }
+  vtkBoneBatchMath::SlerpQuaternions(&unitQuads1[0], &unitQuads[0],
+                                     &halves[0], &slerps[0], n);
+  vtkBoneBatchMath::NlerpQuaternions(&unitQuads1[0], &unitQuads[0],
+                                     &halves[0], &nlerpHalves[0], n);
+  if (!CompareArrays(slerps, nlerpHalves, "Slerp", vtkBoneBatchMath::Scalar))
+    {
+    return EXIT_FAILURE;
+    }
+
+  double norm2 = 0.0;
+  for (int j = 0; j < 4; ++j)
+    {
+    norm2 += expectedNormalized[j] * expectedNormalized[j];
+    }
+  if (fabs(norm2 - 1.0) > 1e-12 || expectedNormalized[4] != 0.0)
+    {
+    std::cout<<"Scalar normalization failed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // All the available instruction sets must match the references
+  int best = vtkBoneBatchMath::GetBestInstructionSet();
+  std::cout<<"Best instruction set: "
+    <<vtkBoneBatchMath::GetInstructionSetAsString(best)<<std::endl;
+  for (int instructionSet = vtkBoneBatchMath::Scalar;
+       instructionSet <= best; ++instructionSet)
+    {
+    vtkBoneBatchMath::SetInstructionSet(instructionSet);
+    if (vtkBoneBatchMath::GetInstructionSet() != instructionSet)
+      {
+      std::cout<<"Could not set the instruction set."<<std::endl;
+      return EXIT_FAILURE;
+      }
+
+    std::vector<double> quads(4*n), result(3*n), resultTranslations(3*n);
+    vtkBoneBatchMath::MultiplyQuaternions(&quads1[0], &quads2[0],
+                                          &quads[0], n);
+    if (!CompareArrays(quads, expectedProducts, "Multiply", instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+
+    quads = quads1;
+    vtkBoneBatchMath::NormalizeQuaternions(&quads[0], n);
+    if (!CompareArrays(quads, expectedNormalized, "Normalize", instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+
+    // In place
+    quads = quads1;
+    vtkBoneBatchMath::ConjugateQuaternions(&quads[0], &quads[0], n);
+    if (!CompareArrays(quads, expectedConjugates, "Conjugate", instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+
+    vtkBoneBatchMath::NlerpQuaternions(&unitQuads1[0], &unitQuads[0],
+                                       &alphas[0], &quads[0], n);
+    if (!CompareArrays(quads, expectedNlerps, "Nlerp", instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+
+    vtkBoneBatchMath::RotatePoints(&unitQuads[0], &points[0], &result[0], n);
+    if (!CompareArrays(result, expectedRotatedPoints, "Rotate",
+                       instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+
+    vtkBoneBatchMath::TransformPoints(&unitQuads[0], &translations[0],
+                                      &points[0], &result[0], n);
+    if (!CompareArrays(result, expectedTransformedPoints, "Transform",
+                       instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+
+    vtkBoneBatchMath::ComposeRigidTransforms(&unitQuads[0], &translations[0],
+                                             &quads1[0], &points[0],
+                                             &quads[0], &resultTranslations[0],
+                                             n);
+    if (!CompareArrays(quads, expectedComposedQuads, "Compose",
+                       instructionSet)
+        || !CompareArrays(resultTranslations, expectedComposedTranslations,
+                          "Compose", instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+
+    // Without parent translations, the local translations are rotated
+    vtkBoneBatchMath::ComposeRigidTransforms(&unitQuads[0], NULL,
+                                             &quads1[0], &points[0],
+                                             &quads[0], &resultTranslations[0],
+                                             n);
+    if (!CompareArrays(quads, expectedComposedQuads, "Compose", instructionSet)
+        || !CompareArrays(resultTranslations, expectedRotatedPoints,
+                          "Compose", instructionSet))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Unavailable instruction sets fall back to the best one
+  vtkBoneBatchMath::SetInstructionSet(vtkBoneBatchMath::AVX2 + 1);
+  if (vtkBoneBatchMath::GetInstructionSet() != best)
+    {
+    std::cout<<"Wrong instruction set fallback."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
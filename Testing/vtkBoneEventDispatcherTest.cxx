@@ -0,0 +1,133 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCommand.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneEventDispatcher.h"
+#include "vtkBonePickingTree.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+int vtkBoneEventDispatcherTest(int, char *[])
+{
+  // A world unit is 20 pixels, (3.5, 3.5) is at the center of the window
+  Scene scene;
+  scene.SetView(3.5, 3.5, 10.0);
+  scene.Renderer->ResetCameraClippingRange();
+
+  // A grid of 4x4 bones of length 1 along X, 2 apart
+  const int numberOfBones = 16;
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  vtkSmartPointer<vtkBoneWidget> bones[numberOfBones];
+  vtkSmartPointer<EventCounter> interactions =
+    vtkSmartPointer<EventCounter>::New();
+  for (int i = 0; i < numberOfBones; ++i)
+    {
+    double head[3] = {2.0 * (i % 4), 2.0 * (i / 4), 0.0};
+    double tail[3] = {2.0 * (i % 4) + 1.0, 2.0 * (i / 4), 0.0};
+    bones[i] = scene.CreateBone(head, tail);
+    skeleton->AddBone(bones[i]);
+    bones[i]->On();
+    bones[i]->AddObserver(vtkCommand::InteractionEvent, interactions);
+    }
+  scene.RenderWindow->Render();
+
+  vtkSmartPointer<vtkBonePickingTree> tree =
+    vtkSmartPointer<vtkBonePickingTree>::New();
+  skeleton->SetPickingTree(tree);
+  vtkSmartPointer<vtkBoneEventDispatcher> dispatcher =
+    vtkSmartPointer<vtkBoneEventDispatcher>::New();
+  dispatcher->SetInteractor(scene.Interactor);
+  skeleton->SetEventDispatcher(dispatcher);
+  if (dispatcher->GetSkeleton() != skeleton)
+    {
+    std::cout<<"The dispatcher is not attached to the skeleton."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Hovering reaches no bone
+  for (int i = 0; i < 20; ++i)
+    {
+    scene.InvokeEvent(vtkCommand::MouseMoveEvent, 10 * i, 10 * i);
+    }
+  if (dispatcher->GetNumberOfEvents() != 20
+      || dispatcher->GetNumberOfRoutedEvents() != 0
+      || interactions->Count != 0)
+    {
+    std::cout<<"The hover was routed: "
+      <<dispatcher->GetNumberOfRoutedEvents()<<" routed events, "
+      <<interactions->Count<<" interactions."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Drag the tail of the bone 5, from (3, 2) to (3, 2.5): from (190, 170)
+  // to (190, 180) in display coordinates.
+  dispatcher->ResetStatistics();
+  scene.InvokeEvent(vtkCommand::LeftButtonPressEvent, 190, 170);
+  if (dispatcher->GetActiveBone() != bones[5])
+    {
+    std::cout<<"The press did not activate the bone."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  scene.InvokeEvent(vtkCommand::MouseMoveEvent, 190, 175);
+  scene.InvokeEvent(vtkCommand::MouseMoveEvent, 190, 180);
+  scene.InvokeEvent(vtkCommand::LeftButtonReleaseEvent, 190, 180);
+
+  double* tail = bones[5]->GetTailRestWorldPosition();
+  if (fabs(tail[0] - 3.0) > 1e-6 || fabs(tail[1] - 2.5) > 1e-6
+      || dispatcher->GetActiveBone() != NULL
+      || dispatcher->GetNumberOfRoutedEvents() != 4
+      || interactions->Count != 2)
+    {
+    std::cout<<"Wrong drag: tail at "<<tail[0]<<" "<<tail[1]<<", "
+      <<dispatcher->GetNumberOfRoutedEvents()<<" routed events, "
+      <<interactions->Count<<" interactions."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  tail = bones[6]->GetTailRestWorldPosition();
+  if (fabs(tail[0] - 5.0) > 1e-6 || fabs(tail[1] - 2.0) > 1e-6)
+    {
+    std::cout<<"Another bone moved."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without dispatcher, the bones observe the interactor again
+  skeleton->SetEventDispatcher(NULL);
+  dispatcher->ResetStatistics();
+  double start[2] = {230.0, 170.0};
+  double end[2] = {230.0, 180.0};
+  scene.Drag(start, end, 2);
+  tail = bones[6]->GetTailRestWorldPosition();
+  if (dispatcher->GetSkeleton() != NULL
+      || dispatcher->GetNumberOfRoutedEvents() != 0
+      || fabs(tail[1] - 2.5) > 1e-6)
+    {
+    std::cout<<"The bones do not process the events themselves."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCamera.h>
+#include <vtkCullerCollection.h>
+#include <vtkFrustumCoverageCuller.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneFrustumCuller.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+int vtkBoneFrustumCullerTest(int, char *[])
+{
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  vtkSmartPointer<vtkRenderWindow> renderWindow =
+    vtkSmartPointer<vtkRenderWindow>::New();
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->SetSize(400, 400);
+  renderWindow->AddRenderer(renderer);
+  vtkSmartPointer<vtkRenderWindowInteractor> interactor =
+    vtkSmartPointer<vtkRenderWindowInteractor>::New();
+  interactor->SetRenderWindow(renderWindow);
+  interactor->Enable();
+
+  // Look at the first bone only
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetParallelProjection(1);
+  camera->SetParallelScale(1.0);
+  camera->SetFocalPoint(0.5, 0.0, 0.0);
+  camera->SetPosition(0.5, 0.0, 10.0);
+  camera->SetViewUp(0.0, 1.0, 0.0);
+
+  // A chain of 10 bones along X, 1 apart
+  const int numberOfBones = 10;
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  vtkSmartPointer<vtkBoneWidget> bones[numberOfBones];
+  for (int i = 0; i < numberOfBones; ++i)
+    {
+    bones[i] = vtkSmartPointer<vtkBoneWidget>::New();
+    bones[i]->SetInteractor(interactor);
+    bones[i]->SetCurrentRenderer(renderer);
+    bones[i]->CreateDefaultRepresentation();
+    bones[i]->SetWidgetStateToRest();
+    bones[i]->SetHeadRestWorldPosition(i, 0.0, 0.0);
+    bones[i]->SetTailRestWorldPosition(i + 1.0, 0.0, 0.0);
+    if (i > 0)
+      {
+      bones[i]->SetBoneParent(bones[i - 1]);
+      }
+    skeleton->AddBone(bones[i]);
+    bones[i]->On();
+    }
+
+  // The bone culler goes first
+  vtkSmartPointer<vtkBoneFrustumCuller> culler =
+    vtkSmartPointer<vtkBoneFrustumCuller>::New();
+  culler->SetSkeleton(skeleton);
+  vtkSmartPointer<vtkFrustumCoverageCuller> coverageCuller =
+    vtkSmartPointer<vtkFrustumCoverageCuller>::New();
+  renderer->GetCullers()->RemoveAllItems();
+  renderer->AddCuller(culler);
+  renderer->AddCuller(coverageCuller);
+  renderWindow->Render();
+
+  // The view spans [-0.5, 1.5] along X
+  if (culler->GetBoneCulled(0) || culler->GetBoneCulled(1)
+      || !culler->GetBoneCulled(3) || !culler->GetBoneCulled(9)
+      || culler->GetNumberOfCulledBones() != numberOfBones - 2)
+    {
+    std::cout<<"Wrong culling: "<<culler->GetNumberOfCulledBones()
+      <<" culled bones."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  double* bounds = culler->GetBoneBounds(9);
+  if (fabs(bounds[0] - 8.75) > 1e-9 || fabs(bounds[1] - 10.25) > 1e-9)
+    {
+    std::cout<<"Wrong bone bounds: "<<bounds[0]<<" "<<bounds[1]<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Moving a bone into the view updates its bounds
+  bones[9]->SetHeadRestWorldPosition(0.5, 0.5, 0.0);
+  bones[9]->SetTailRestWorldPosition(0.5, 0.8, 0.0);
+  renderWindow->Render();
+  if (culler->GetBoneCulled(9)
+      || culler->GetNumberOfCulledBones() != numberOfBones - 3)
+    {
+    std::cout<<"The moved bone is still culled."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Zoomed out, nothing is culled
+  camera->SetParallelScale(20.0);
+  renderWindow->Render();
+  if (culler->GetNumberOfCulledBones() != 0)
+    {
+    std::cout<<"Visible bones are culled."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkMath.h>
+
+#include "vtkBoneMath.h"
+
+#include <iostream>
+
+namespace
+{
+
+// Float and double results are expected to agree up to the float rounding
+const double FloatTolerance = 1e-5;
+
+template <class T1, class T2>
+bool CompareArrays(const T1* values, const T2* expectedValues, int size,
+                   double tolerance, const char* operation)
+{
+  for (int i = 0; i < size; ++i)
+    {
+    if (fabs(static_cast<double>(values[i])
+             - static_cast<double>(expectedValues[i])) > tolerance)
+      {
+      std::cout<<operation<<" failed at index "<<i<<std::endl
+        <<"Expected:  "<<expectedValues[i]<<std::endl
+        <<" - Got:    "<<values[i]<<std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}// end namespace
+
+int vtkBoneMathTest(int, char *[])
+{
+  double axis[3] = {1.0, 2.0, -0.5};
+  double angle = 0.7;
+  double point[3] = {-0.4, 0.8, 1.5};
+  double translation[3] = {0.3, -1.2, 2.0};
+
+  float axisf[3], pointf[3], translationf[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    axisf[i] = static_cast<float>(axis[i]);
+    pointf[i] = static_cast<float>(point[i]);
+    translationf[i] = static_cast<float>(translation[i]);
+    }
+
+  // Axis angle against vtkMath
+  vtkBoneQuaterniond q =
+    vtkBoneQuaterniond::FromAxisAngle(angle, vtkBoneVector3d(axis));
+  vtkBoneQuaternionf qf =
+    vtkBoneQuaternionf::FromAxisAngle(static_cast<float>(angle),
+                                      vtkBoneVector3f(axisf));
+
+  double matrix[3][3], expectedMatrix[3][3];
+  float matrixf[3][3];
+  q.ToMatrix3x3(matrix);
+  qf.ToMatrix3x3(matrixf);
+  vtkMath::QuaternionToMatrix3x3(q.GetData(), expectedMatrix);
+  for (int i = 0; i < 3; ++i)
+    {
+    if (!CompareArrays(matrix[i], expectedMatrix[i], 3, 1e-12, "ToMatrix3x3")
+        || !CompareArrays(matrixf[i], matrix[i], 3, FloatTolerance,
+                          "Float ToMatrix3x3"))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkBoneVector3d resultAxis;
+  double resultAngle = q.GetAxisAngle(resultAxis);
+  vtkBoneVector3d expectedAxis = vtkBoneVector3d(axis).Normalized();
+  if (fabs(resultAngle - angle) > 1e-12
+      || !CompareArrays(resultAxis.GetData(), expectedAxis.GetData(), 3,
+                        1e-12, "GetAxisAngle"))
+    {
+    std::cout<<"Wrong axis angle: "<<resultAngle<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Rotation against the matrix
+  vtkBoneVector3d rotated = q.Rotate(vtkBoneVector3d(point));
+  vtkBoneVector3f rotatedf = qf.Rotate(vtkBoneVector3f(pointf));
+  double expectedRotated[3];
+  vtkMath::Multiply3x3(expectedMatrix, point, expectedRotated);
+  if (!CompareArrays(rotated.GetData(), expectedRotated, 3, 1e-12, "Rotate")
+      || !CompareArrays(rotatedf.GetData(), expectedRotated, 3,
+                        FloatTolerance, "Float Rotate"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // q * conjugate(q) is the identity
+  vtkBoneQuaterniond identity;
+  vtkBoneQuaterniond product = q * q.Conjugated();
+  vtkBoneQuaternionf productf = qf * qf.Conjugated();
+  if (!CompareArrays(product.GetData(), identity.GetData(), 4, 1e-12,
+                     "Conjugate")
+      || !CompareArrays(productf.GetData(), identity.GetData(), 4,
+                        FloatTolerance, "Float Conjugate"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Normalization
+  vtkBoneQuaterniond scaled(2.0*q[0], 2.0*q[1], 2.0*q[2], 2.0*q[3]);
+  if (fabs(scaled.Normalize() - 2.0) > 1e-12
+      || !CompareArrays(scaled.GetData(), q.GetData(), 4, 1e-12, "Normalize"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Shortest arc rotations
+  vtkBoneVector3d from(axis), to(-0.3, 0.4, 2.0);
+  vtkBoneQuaterniond arc = vtkBoneQuaterniond::FromTwoVectors(from, to);
+  vtkBoneVector3d arcRotated = arc.Rotate(from.Normalized());
+  vtkBoneVector3d arcAxis = from.Cross(to).Normalized();
+  vtkBoneVector3d arcRotatedAxis = arc.Rotate(arcAxis);
+  if (fabs(arc.Norm() - 1.0) > 1e-12
+      || !CompareArrays(arcRotated.GetData(), to.Normalized().GetData(), 3,
+                        1e-12, "FromTwoVectors")
+      || !CompareArrays(arcRotatedAxis.GetData(), arcAxis.GetData(), 3,
+                        1e-12, "FromTwoVectors axis"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  double halfTurnX[4] = {0.0, 1.0, 0.0, 0.0};
+  double halfTurnY[4] = {0.0, 0.0, 1.0, 0.0};
+  arc = vtkBoneQuaterniond::FromTwoVectors(vtkBoneVector3d(0.0, 1.0, 0.0),
+                                           vtkBoneVector3d(0.0, -3.0, 0.0),
+                                           vtkBoneVector3d(1.0, 1.0, 0.0));
+  if (!CompareArrays(arc.GetData(), halfTurnX, 4, 1e-12,
+                     "FromTwoVectors half turn"))
+    {
+    return EXIT_FAILURE;
+    }
+  arc = vtkBoneQuaterniond::FromTwoVectors(vtkBoneVector3d(0.0, 0.0, 1.0),
+                                           vtkBoneVector3d(0.0, 0.0, -1.0));
+  if (!CompareArrays(arc.GetData(), halfTurnY, 4, 1e-12,
+                     "FromTwoVectors default half turn"))
+    {
+    return EXIT_FAILURE;
+    }
+  arc = vtkBoneQuaterniond::FromTwoVectors(vtkBoneVector3d(), to);
+  if (!CompareArrays(arc.GetData(), identity.GetData(), 4, 1e-12,
+                     "FromTwoVectors null vector"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Rigid motions: composition with the inverse and float/double agreement
+  vtkBoneRigidMotiond motion(q, vtkBoneVector3d(translation));
+  vtkBoneRigidMotionf motionf(qf, vtkBoneVector3f(translationf));
+
+  double transformed[3];
+  float transformedf[3];
+  motion.TransformPoint(point, transformed);
+  motionf.TransformPoint(pointf, transformedf);
+  for (int i = 0; i < 3; ++i)
+    {
+    expectedRotated[i] += translation[i];
+    }
+  if (!CompareArrays(transformed, expectedRotated, 3, 1e-12,
+                     "TransformPoint")
+      || !CompareArrays(transformedf, transformed, 3, FloatTolerance,
+                        "Float TransformPoint"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkBoneRigidMotiond composed = motion.GetInverse() * motion;
+  vtkBoneRigidMotionf composedf = motionf.GetInverse() * motionf;
+  double zero[3] = {0.0, 0.0, 0.0};
+  if (!CompareArrays(composed.GetRotation(), identity.GetData(), 4, 1e-12,
+                     "Inverse")
+      || !CompareArrays(composed.GetTranslation(), zero, 3, 1e-12, "Inverse")
+      || !CompareArrays(composedf.GetRotation(), identity.GetData(), 4,
+                        FloatTolerance, "Float Inverse")
+      || !CompareArrays(composedf.GetTranslation(), zero, 3,
+                        FloatTolerance, "Float Inverse"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  double elements[16];
+  float elementsf[16];
+  motion.GetMatrix(elements);
+  motionf.GetMatrix(elementsf);
+  if (!CompareArrays(elementsf, elements, 16, FloatTolerance,
+                     "Float GetMatrix"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
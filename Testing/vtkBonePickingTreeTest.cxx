@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBonePickingTree.h"
+#include "vtkBoneRepresentation.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneWidget.h"
+
+namespace
+{
+
+bool CheckPick(vtkBonePickingTree* tree, vtkRenderer* renderer,
+               int X, int Y, vtkIdType expectedId, int expectedState)
+{
+  int state = tree->Pick(renderer, X, Y);
+  if (state != expectedState || tree->GetPickedBoneId() != expectedId)
+    {
+    std::cout<<"Wrong pick at "<<X<<" "<<Y<<": bone "
+      <<tree->GetPickedBoneId()<<" state "<<state<<" instead of bone "
+      <<expectedId<<" state "<<expectedState<<std::endl;
+    return false;
+    }
+  return true;
+}
+
+}// end namespace
+
+int vtkBonePickingTreeTest(int, char *[])
+{
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  vtkSmartPointer<vtkRenderWindow> renderWindow =
+    vtkSmartPointer<vtkRenderWindow>::New();
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->SetSize(400, 400);
+  renderWindow->AddRenderer(renderer);
+  vtkSmartPointer<vtkRenderWindowInteractor> interactor =
+    vtkSmartPointer<vtkRenderWindowInteractor>::New();
+  interactor->SetRenderWindow(renderWindow);
+  interactor->Enable();
+
+  // A world unit is 20 pixels, (7.5, 7.5) is at the center of the window
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetParallelProjection(1);
+  camera->SetParallelScale(10.0);
+  camera->SetFocalPoint(7.5, 7.5, 0.0);
+  camera->SetPosition(7.5, 7.5, 50.0);
+  camera->SetViewUp(0.0, 1.0, 0.0);
+  renderer->ResetCameraClippingRange();
+
+  // A grid of 8x8 bones of length 1 along X, 2 apart
+  const int numberOfBones = 64;
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  vtkSmartPointer<vtkBoneWidget> bones[numberOfBones];
+  for (int i = 0; i < numberOfBones; ++i)
+    {
+    bones[i] = vtkSmartPointer<vtkBoneWidget>::New();
+    bones[i]->SetInteractor(interactor);
+    bones[i]->SetCurrentRenderer(renderer);
+    bones[i]->CreateDefaultRepresentation();
+    bones[i]->SetWidgetStateToRest();
+    bones[i]->SetHeadRestWorldPosition(2.0 * (i % 8), 2.0 * (i / 8), 0.0);
+    bones[i]->SetTailRestWorldPosition(2.0 * (i % 8) + 1.0, 2.0 * (i / 8), 0.0);
+    skeleton->AddBone(bones[i]);
+    bones[i]->On();
+    }
+  renderWindow->Render();
+
+  vtkSmartPointer<vtkBonePickingTree> tree =
+    vtkSmartPointer<vtkBonePickingTree>::New();
+  skeleton->SetPickingTree(tree);
+  if (tree->GetSkeleton() != skeleton)
+    {
+    std::cout<<"The tree is not attached to the skeleton."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The bone 10 (row 1, column 2) goes from (4, 2) to (5, 2): from
+  // (130, 90) to (150, 90) in display coordinates.
+  vtkIdType id = bones[10]->GetBoneId();
+  if (!CheckPick(tree, renderer, 131, 91, id, vtkBoneRepresentation::OnP1)
+      || !CheckPick(tree, renderer, 149, 90, id, vtkBoneRepresentation::OnP2)
+      || !CheckPick(tree, renderer, 140, 92, id, vtkBoneRepresentation::OnLine)
+      || !CheckPick(tree, renderer, 160, 90, -1, vtkBoneRepresentation::Outside))
+    {
+    return EXIT_FAILURE;
+    }
+  if (tree->GetNumberOfNodes() != 2 * numberOfBones - 1
+      || tree->GetNumberOfBuilds() != 1)
+    {
+    std::cout<<"Wrong tree: "<<tree->GetNumberOfNodes()<<" nodes, "
+      <<tree->GetNumberOfBuilds()<<" builds."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Only the bones near the ray are tested
+  tree->Pick(renderer, 140, 92);
+  if (tree->GetNumberOfTestedBones() > 4
+      || tree->GetNumberOfVisitedNodes() >= tree->GetNumberOfNodes())
+    {
+    std::cout<<"The pick tested "<<tree->GetNumberOfTestedBones()
+      <<" bones and visited "<<tree->GetNumberOfVisitedNodes()
+      <<" nodes."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A moved bone is refit, the tree is not rebuilt
+  bones[10]->SetHeadRestWorldPosition(7.0, 7.0, 0.0);
+  bones[10]->SetTailRestWorldPosition(8.0, 7.0, 0.0);
+  if (!CheckPick(tree, renderer, 140, 92, -1, vtkBoneRepresentation::Outside)
+      || !CheckPick(tree, renderer, 200, 190, id, vtkBoneRepresentation::OnLine)
+      || tree->GetNumberOfBuilds() != 1)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Removing a bone rebuilds the tree
+  skeleton->RemoveBone(bones[0]);
+  if (!CheckPick(tree, renderer, 50, 50, -1, vtkBoneRepresentation::Outside)
+      || tree->GetNumberOfNodes() != 2 * (numberOfBones - 1) - 1
+      || tree->GetNumberOfBuilds() != 2)
+    {
+    std::cout<<"The tree is not rebuilt."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  id = bones[10]->GetBoneId();
+  if (!CheckPick(tree, renderer, 200, 190, id, vtkBoneRepresentation::OnLine))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The presses are picked ahead of the widgets. The head of the bone 11
+  // is at (170, 90).
+  tree->SetInteractor(interactor);
+  interactor->SetEventInformation(170, 90);
+  interactor->InvokeEvent(vtkCommand::LeftButtonPressEvent, NULL);
+  if (tree->GetPickedBoneId() != bones[11]->GetBoneId()
+      || tree->GetPickedState() != vtkBoneRepresentation::OnP1)
+    {
+    std::cout<<"The press is not picked."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneProfiler.h"
+#include "vtkBoneWidget.h"
+
+int vtkBoneProfilerTest(int, char *[])
+{
+  // Statistics and histogram
+  vtkSmartPointer<vtkBoneProfiler> profiler =
+    vtkSmartPointer<vtkBoneProfiler>::New();
+  profiler->AddSample(vtkBoneProfiler::RebuildAxes, 3e-9);
+  profiler->AddSample(vtkBoneProfiler::RebuildAxes, 1e-6);
+  profiler->AddSample(vtkBoneProfiler::RebuildAxes, 10.0);
+
+  if (profiler->GetCount(vtkBoneProfiler::RebuildAxes) != 3
+      || profiler->GetCount(vtkBoneProfiler::RebuildCones) != 0
+      || profiler->GetMinimumTime(vtkBoneProfiler::RebuildAxes) != 3e-9
+      || profiler->GetMaximumTime(vtkBoneProfiler::RebuildAxes) != 10.0
+      || fabs(profiler->GetTotalTime(vtkBoneProfiler::RebuildAxes)
+              - (10.0 + 1e-6 + 3e-9)) > 1e-12)
+    {
+    std::cout<<"Wrong statistics."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // 3 ns is in [2, 4[, 1000 ns in [512, 1024[, 10 s in the last bin
+  if (profiler->GetHistogramBin(vtkBoneProfiler::RebuildAxes, 2) != 1
+      || profiler->GetHistogramBin(vtkBoneProfiler::RebuildAxes, 10) != 1
+      || profiler->GetHistogramBin(vtkBoneProfiler::RebuildAxes,
+                                   vtkBoneProfiler::NumberOfBins - 1) != 1)
+    {
+    std::cout<<"Wrong histogram."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (fabs(vtkBoneProfiler::GetBinUpperBound(10) - 1024e-9) > 1e-15)
+    {
+    std::cout<<"Wrong bin bounds."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  profiler->Reset();
+  if (profiler->GetCount(vtkBoneProfiler::RebuildAxes) != 0
+      || profiler->GetHistogramBin(vtkBoneProfiler::RebuildAxes, 2) != 0)
+    {
+    std::cout<<"Reset failed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Instrumented bones
+  vtkSmartPointer<vtkBoneWidget> bone = vtkSmartPointer<vtkBoneWidget>::New();
+  bone->CreateDefaultRepresentation();
+  bone->SetWidgetStateToRest();
+  bone->SetHeadRestWorldPosition(0.0, 0.0, 0.0);
+  bone->SetTailRestWorldPosition(0.0, 1.0, 0.0);
+
+  if (!vtkBoneProfiler::IsProfilingCompiledIn())
+    {
+    if (bone->GetProfiler())
+      {
+      std::cout<<"The bone is profiled while profiling is compiled out."
+        <<std::endl;
+      return EXIT_FAILURE;
+      }
+    return EXIT_SUCCESS;
+    }
+
+  vtkBoneProfiler* boneProfiler = bone->GetProfiler();
+  vtkBoneProfiler* globalProfiler = vtkBoneProfiler::GetGlobalProfiler();
+  if (!boneProfiler
+      || boneProfiler->GetCount(vtkBoneProfiler::RebuildRestTransform) == 0
+      || globalProfiler->GetCount(vtkBoneProfiler::RebuildRestTransform)
+           < boneProfiler->GetCount(vtkBoneProfiler::RebuildRestTransform))
+    {
+    std::cout<<"The rest transform rebuilds were not counted."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  bone->SetWidgetStateToPose();
+  vtkIdType poseRebuilds =
+    boneProfiler->GetCount(vtkBoneProfiler::RebuildLocalPosePoints);
+  bone->RotateTailX(0.1);
+  if (boneProfiler->GetCount(vtkBoneProfiler::RebuildLocalPosePoints)
+        <= poseRebuilds)
+    {
+    std::cout<<"The local pose points rebuilds were not counted."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCommand.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneRenderScheduler.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+namespace
+{
+
+// Initialized interactor whose one shot timers are expired by hand
+class TimerInteractor : public vtkRenderWindowInteractor
+{
+public:
+  static TimerInteractor *New()
+    { return new TimerInteractor; }
+  vtkTypeMacro(TimerInteractor, vtkRenderWindowInteractor);
+
+  void SetInitialized(int initialized)
+    { this->Initialized = initialized; }
+
+  // Invoke the TimerEvent of the last timer created, if any
+  void ExpireTimer()
+    {
+    int timerId = this->LastTimerId;
+    this->LastTimerId = 0;
+    if (timerId != 0)
+      {
+      this->InvokeEvent(vtkCommand::TimerEvent, &timerId);
+      }
+    }
+
+  int LastTimerId;
+  int TimersEnabled;
+
+protected:
+  TimerInteractor()
+    {
+    this->Initialized = 1;
+    this->LastTimerId = 0;
+    this->TimersEnabled = 1;
+    }
+
+  virtual int InternalCreateTimer(int timerId, int, unsigned long)
+    {
+    if (!this->TimersEnabled)
+      {
+      return 0;
+      }
+    this->LastTimerId = timerId;
+    return timerId;
+    }
+  virtual int InternalDestroyTimer(int)
+    { return 1; }
+};
+
+}// end namespace
+
+int vtkBoneRenderSchedulerTest(int, char *[])
+{
+  Scene scene;
+  vtkSmartPointer<TimerInteractor> interactor =
+    vtkSmartPointer<TimerInteractor>::New();
+  interactor->SetRenderWindow(scene.RenderWindow);
+  interactor->Enable();
+  scene.Interactor = interactor.GetPointer();
+
+  // A chain of 3 bones along X
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  vtkSmartPointer<vtkBoneWidget> bones[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    double head[3] = {0.1 * i - 0.05, 0.0, 0.0};
+    double tail[3] = {0.1 * i + 0.05, 0.0, 0.0};
+    bones[i] = scene.CreateBone(head, tail);
+    if (i > 0)
+      {
+      bones[i]->SetBoneParent(bones[i - 1]);
+      }
+    skeleton->AddBone(bones[i]);
+    bones[i]->On();
+    }
+  scene.RenderWindow->Render();
+
+  // At most one render every 1000 s
+  vtkSmartPointer<vtkBoneRenderScheduler> scheduler =
+    vtkSmartPointer<vtkBoneRenderScheduler>::New();
+  scheduler->SetMaximumFrameRate(1e-3);
+  skeleton->SetRenderScheduler(scheduler);
+
+  vtkSmartPointer<EventCounter> renders =
+    vtkSmartPointer<EventCounter>::New();
+  scene.RenderWindow->AddObserver(vtkCommand::EndEvent, renders);
+
+  // Drag the tail of the last bone
+  double start[2], position[2];
+  scene.WorldToDisplay(0.25, 0.0, 0.0, start);
+  scene.InvokeEvent(vtkCommand::LeftButtonPressEvent, start);
+  for (int i = 1; i <= 10; ++i)
+    {
+    position[0] = start[0];
+    position[1] = start[1] + 3.0 * i;
+    scene.InvokeEvent(vtkCommand::MouseMoveEvent, position);
+    }
+
+  // The press rendered, the moves were merged into a pending render
+  if (scheduler->GetNumberOfRequests() < 11
+      || scheduler->GetNumberOfRenders() != 1
+      || renders->Count != 1
+      || !scheduler->GetRenderPending()
+      || interactor->LastTimerId == 0)
+    {
+    std::cout<<"The renders were not merged: "
+      <<scheduler->GetNumberOfRequests()<<" requests, "
+      <<scheduler->GetNumberOfRenders()<<" renders."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The timer runs the pending render
+  interactor->ExpireTimer();
+  if (scheduler->GetNumberOfRenders() != 2
+      || renders->Count != 2
+      || scheduler->GetRenderPending())
+    {
+    std::cout<<"The timer did not run the pending render."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  position[1] += 3.0;
+  scene.InvokeEvent(vtkCommand::MouseMoveEvent, position);
+  scheduler->Flush();
+  if (scheduler->GetNumberOfRenders() != 3
+      || renders->Count != 3
+      || scheduler->GetRenderPending())
+    {
+    std::cout<<"The pending render was not flushed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The release is rendered at once, nothing is left pending
+  position[1] += 3.0;
+  scene.InvokeEvent(vtkCommand::MouseMoveEvent, position);
+  scene.InvokeEvent(vtkCommand::LeftButtonReleaseEvent, position);
+  if (scheduler->GetNumberOfRenders() < 4
+      || renders->Count != scheduler->GetNumberOfRenders()
+      || scheduler->GetRenderPending())
+    {
+    std::cout<<"The release was not rendered: "
+      <<scheduler->GetNumberOfRenders()<<" renders."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without timer, the requests are rendered immediately
+  scheduler->ResetStatistics();
+  interactor->TimersEnabled = 0;
+  scheduler->RequestRender(interactor);
+  interactor->TimersEnabled = 1;
+  interactor->SetInitialized(0);
+  scheduler->RequestRender(interactor);
+  interactor->SetInitialized(1);
+  if (scheduler->GetNumberOfRequests() != 2
+      || scheduler->GetNumberOfRenders() != 2
+      || scheduler->GetRenderPending())
+    {
+    std::cout<<"The requests without timer were not rendered."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without throttling, every request renders
+  scheduler->SetMaximumFrameRate(0.0);
+  scheduler->ResetStatistics();
+  scheduler->RequestRender(interactor);
+  scheduler->RequestRender(interactor);
+  if (scheduler->GetNumberOfRequests() != 2
+      || scheduler->GetNumberOfRenders() != 2
+      || scheduler->GetRenderPending())
+    {
+    std::cout<<"Unthrottled requests were not rendered."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCamera.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkCylinderBoneRepresentation.h"
+#include "vtkDoubleConeBoneRepresentation.h"
+
+namespace
+{
+
+// Return the number of sides picked for a bone along X of the given length
+int LevelOfDetail(vtkBoneRepresentation* rep, vtkRenderer* renderer,
+                  double length, int maximumNumberOfSides)
+{
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {length, 0.0, 0.0};
+  rep->SetPoint1WorldPosition(head);
+  rep->SetPoint2WorldPosition(tail);
+  return rep->ComputeLevelOfDetail(renderer, maximumNumberOfSides);
+}
+
+int TestLevelOfDetail(vtkBoneRepresentation* rep, vtkRenderer* renderer)
+{
+  renderer->AddViewProp(rep);
+  rep->SetRenderer(renderer);
+
+  // Without level of detail, the maximum is always used
+  if (LevelOfDetail(rep, renderer, 0.001, 64) != 64)
+    {
+    std::cout<<rep->GetClassName()<<": level of detail is on by default."
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  rep->LevelOfDetailOn();
+
+  // 200 pixels per world unit: a bone of length 1 has a circumference of
+  // about 126 pixels, 48 sides of 4 pixels at most.
+  int numberOfSides = LevelOfDetail(rep, renderer, 1.0, 64);
+  if (numberOfSides != 48
+      || LevelOfDetail(rep, renderer, 1.0, 20) != 20
+      || LevelOfDetail(rep, renderer, 0.1, 64) != 6)
+    {
+    std::cout<<rep->GetClassName()<<": wrong number of sides "
+      <<numberOfSides<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // 4 pixels long: only the line, 0.4 pixel: nothing
+  if (LevelOfDetail(rep, renderer, 0.02, 64) != 0
+      || LevelOfDetail(rep, renderer, 0.002, 64) != -1)
+    {
+    std::cout<<rep->GetClassName()<<": small bones are not simplified."
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Nothing is rendered for a hidden bone
+  if (rep->RenderOpaqueGeometry(renderer) != 0)
+    {
+    std::cout<<rep->GetClassName()<<": a hidden bone is rendered."
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  renderer->RemoveViewProp(rep);
+  return EXIT_SUCCESS;
+}
+
+}// end namespace
+
+int vtkBoneRepresentationLevelOfDetailTest(int, char *[])
+{
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  vtkSmartPointer<vtkRenderWindow> renderWindow =
+    vtkSmartPointer<vtkRenderWindow>::New();
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->SetSize(400, 400);
+  renderWindow->AddRenderer(renderer);
+
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetParallelProjection(1);
+  camera->SetParallelScale(1.0);
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+  camera->SetPosition(0.0, 0.0, 10.0);
+  camera->SetViewUp(0.0, 1.0, 0.0);
+
+  vtkSmartPointer<vtkCylinderBoneRepresentation> cylinder =
+    vtkSmartPointer<vtkCylinderBoneRepresentation>::New();
+  cylinder->SetNumberOfSides(64);
+  if (TestLevelOfDetail(cylinder, renderer) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkDoubleConeBoneRepresentation> cones =
+    vtkSmartPointer<vtkDoubleConeBoneRepresentation>::New();
+  cones->SetNumberOfSides(64);
+  if (TestLevelOfDetail(cones, renderer) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Render a bone with a cached level of detail (48 sides)
+  cylinder->LevelOfDetailOn();
+  renderer->AddViewProp(cylinder);
+  double tail[3] = {1.0, 0.0, 0.0};
+  cylinder->SetPoint2WorldPosition(tail);
+  renderWindow->Render();
+
+  // The unit meshes are shared: the 64 and 48 sides meshes only, whatever
+  // the number of bones rendered at these levels
+  int numberOfMeshes =
+    vtkCylinderBoneRepresentation::GetNumberOfLevelOfDetailMeshes();
+  vtkSmartPointer<vtkCylinderBoneRepresentation> otherCylinder =
+    vtkSmartPointer<vtkCylinderBoneRepresentation>::New();
+  otherCylinder->SetNumberOfSides(64);
+  otherCylinder->LevelOfDetailOn();
+  renderer->AddViewProp(otherCylinder);
+  double head[3] = {0.0, 0.0, 0.0};
+  otherCylinder->SetPoint1WorldPosition(head);
+  otherCylinder->SetPoint2WorldPosition(tail);
+  renderWindow->Render();
+  if (numberOfMeshes != 2
+      || vtkCylinderBoneRepresentation::GetNumberOfLevelOfDetailMeshes() != 2)
+    {
+    std::cout<<"The cylinder meshes are not shared: "<<numberOfMeshes
+      <<" "<<vtkCylinderBoneRepresentation::GetNumberOfLevelOfDetailMeshes()
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A mesh is released with its last user
+  renderer->RemoveViewProp(otherCylinder);
+  otherCylinder = NULL;
+  renderer->RemoveViewProp(cylinder);
+  cylinder = NULL;
+  if (vtkCylinderBoneRepresentation::GetNumberOfLevelOfDetailMeshes() != 0
+      || vtkDoubleConeBoneRepresentation::GetNumberOfLevelOfDetailMeshes() != 1)
+    {
+    std::cout<<"The unused meshes were not released."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
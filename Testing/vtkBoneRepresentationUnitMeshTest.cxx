@@ -0,0 +1,126 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkActor.h>
+#include <vtkCamera.h>
+#include <vtkDataSet.h>
+#include <vtkMapper.h>
+#include <vtkMatrix4x4.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkCylinderBoneRepresentation.h"
+#include "vtkDoubleConeBoneRepresentation.h"
+
+namespace
+{
+
+// Move a bone and check that its mesh is placed by the actor matrix only.
+int TestUnitMesh(vtkBoneRepresentation* rep, vtkRenderer* renderer)
+{
+  rep->SetRenderer(renderer);
+
+  double head[3] = {1.0, 0.0, 0.0};
+  double tail[3] = {1.0, 2.0, 0.0};
+  rep->SetPoint1WorldPosition(head);
+  rep->SetPoint2WorldPosition(tail);
+
+  // The bone actor is the last one
+  vtkSmartPointer<vtkPropCollection> actors =
+    vtkSmartPointer<vtkPropCollection>::New();
+  rep->GetActors(actors);
+  vtkActor* actor = vtkActor::SafeDownCast(
+    actors->GetItemAsObject(actors->GetNumberOfItems() - 1));
+  vtkDataSet* mesh = actor->GetMapper()->GetInputAsDataSet();
+  unsigned long meshTime = mesh->GetMTime();
+
+  double* bounds = rep->GetBounds();
+  if (fabs(bounds[2]) > 1e-9 || fabs(bounds[3] - 2.0) > 1e-9
+      || bounds[0] < 0.8 - 1e-9 || bounds[1] > 1.2 + 1e-9)
+    {
+    std::cout<<rep->GetClassName()<<": wrong bounds "
+      <<bounds[0]<<" "<<bounds[1]<<" "<<bounds[2]<<" "<<bounds[3]<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Point the bone along -X, half as long
+  tail[0] = 0.0;
+  tail[1] = 0.0;
+  rep->SetPoint2WorldPosition(tail);
+  rep->BuildRepresentation();
+  bounds = rep->GetBounds();
+  if (fabs(bounds[0]) > 1e-9 || fabs(bounds[1] - 1.0) > 1e-9
+      || bounds[2] < -0.1 - 1e-9 || bounds[3] > 0.1 + 1e-9)
+    {
+    std::cout<<rep->GetClassName()<<": wrong bounds after move "
+      <<bounds[0]<<" "<<bounds[1]<<" "<<bounds[2]<<" "<<bounds[3]<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (mesh != actor->GetMapper()->GetInputAsDataSet()
+      || mesh->GetMTime() != meshTime)
+    {
+    std::cout<<rep->GetClassName()<<": the mesh was rebuilt."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Orbiting the camera leaves the bone geometry untouched
+  unsigned long matrixTime = actor->GetUserMatrix()->GetMTime();
+  renderer->GetActiveCamera()->Azimuth(30.0);
+  rep->BuildRepresentation();
+  if (actor->GetUserMatrix()->GetMTime() != matrixTime
+      || mesh->GetMTime() != meshTime)
+    {
+    std::cout<<rep->GetClassName()<<": the geometry was rebuilt by a camera"
+      <<" move."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+}// end namespace
+
+int vtkBoneRepresentationUnitMeshTest(int, char *[])
+{
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  vtkSmartPointer<vtkRenderWindow> renderWindow =
+    vtkSmartPointer<vtkRenderWindow>::New();
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->AddRenderer(renderer);
+
+  vtkSmartPointer<vtkCylinderBoneRepresentation> cylinder =
+    vtkSmartPointer<vtkCylinderBoneRepresentation>::New();
+  if (TestUnitMesh(cylinder, renderer) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkDoubleConeBoneRepresentation> cones =
+    vtkSmartPointer<vtkDoubleConeBoneRepresentation>::New();
+  if (TestUnitMesh(cones, renderer) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
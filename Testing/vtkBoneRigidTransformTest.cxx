@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkMath.h>
+#include <vtkSmartPointer.h>
+#include <vtkTransform.h>
+
+#include "vtkBoneRigidTransform.h"
+
+namespace
+{
+
+bool ComparePoint(const double* point, const double* expectedPoint)
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    if (fabs(point[i] - expectedPoint[i]) > 1e-6)
+      {
+      std::cout<<"Point different !"<<std::endl
+        <<"Expected:  "<<expectedPoint[0]<<" "<<expectedPoint[1]<<" "
+                       <<expectedPoint[2]<<std::endl
+        <<" - Got:    "<<point[0]<<" "<<point[1]<<" "
+                       <<point[2]<<std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}// end namespace
+
+int vtkBoneRigidTransformTest(int, char *[])
+{
+  double axis[3] = {1.0, 2.0, -0.5};
+  double angle = 0.7;
+  double translation[3] = {0.3, -1.2, 2.0};
+
+  vtkBoneRigidTransform rigidTransform;
+  rigidTransform.SetRotationWXYZ(angle, axis);
+  rigidTransform.SetTranslation(translation);
+
+  // Same transform with vtkTransform
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  transform->Translate(translation);
+  transform->RotateWXYZ(vtkMath::DegreesFromRadians(angle), axis);
+
+  double point[3] = {0.5, 0.25, -3.0};
+  double result[3];
+  rigidTransform.TransformPoint(point, result);
+  if (!ComparePoint(result, transform->TransformDoublePoint(point)))
+    {
+    std::cout<<"TransformPoint failed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  rigidTransform.TransformVector(point, result);
+  if (!ComparePoint(result, transform->TransformDoubleVector(point)))
+    {
+    std::cout<<"TransformVector failed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Inverse
+  double back[3];
+  rigidTransform.TransformPoint(point, result);
+  rigidTransform.GetInverse().TransformPoint(result, back);
+  if (!ComparePoint(back, point))
+    {
+    std::cout<<"Inverse failed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Composition: the right hand side is applied first
+  vtkBoneRigidTransform other;
+  double otherAxis[3] = {0.0, 0.0, 1.0};
+  double otherTranslation[3] = {-2.0, 0.0, 1.0};
+  other.SetRotationWXYZ(vtkMath::Pi() / 3.0, otherAxis);
+  other.SetTranslation(otherTranslation);
+
+  double expected[3];
+  other.TransformPoint(point, expected);
+  rigidTransform.TransformPoint(expected, expected);
+  (rigidTransform * other).TransformPoint(point, result);
+  if (!ComparePoint(result, expected))
+    {
+    std::cout<<"Composition failed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Matrix
+  double elements[16];
+  rigidTransform.GetMatrix(elements);
+  vtkSmartPointer<vtkTransform> matrixTransform =
+    vtkSmartPointer<vtkTransform>::New();
+  matrixTransform->SetMatrix(elements);
+  rigidTransform.TransformPoint(point, expected);
+  if (!ComparePoint(matrixTransform->TransformDoublePoint(point), expected))
+    {
+    std::cout<<"GetMatrix failed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCommand.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneSessionRecorder.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+int vtkBoneSessionRecorderTest(int, char *[])
+{
+  Scene scene;
+
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {0.1, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> fatherBone = scene.CreateBone(head, tail);
+  head[0] = 0.1; tail[0] = 0.2;
+  vtkSmartPointer<vtkBoneWidget> sonBone = scene.CreateBone(head, tail);
+  sonBone->SetBoneParent(fatherBone);
+  sonBone->SetHeadLinkedToParent(1);
+
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  skeleton->AddBone(fatherBone);
+  skeleton->AddBone(sonBone);
+  fatherBone->On();
+  sonBone->On();
+  scene.RenderWindow->Render();
+
+  vtkSmartPointer<vtkBoneSessionRecorder> recorder =
+    vtkSmartPointer<vtkBoneSessionRecorder>::New();
+  recorder->SetInteractor(scene.Interactor);
+  recorder->SetRenderer(scene.Renderer);
+  recorder->SetSkeleton(skeleton);
+  recorder->StartRecording();
+
+  // Rest mode: drag the tail of the son up
+  double start[2], end[2];
+  scene.WorldToDisplay(0.2, 0.0, 0.0, start);
+  end[0] = start[0]; end[1] = start[1] + 50.0;
+  scene.Drag(start, end);
+
+  // Pose mode, as an application would switch it: rotate the father
+  fatherBone->SetWidgetStateToPose();
+  sonBone->SetWidgetStateToPose();
+  scene.WorldToDisplay(0.1, 0.0, 0.0, start);
+  end[0] = start[0] - 20.0; end[1] = start[1] + 40.0;
+  scene.Drag(start, end);
+
+  recorder->StopRecording();
+
+  if (recorder->GetNumberOfBones() != 2
+      || recorder->GetNumberOfEvents() != 24)
+    {
+    std::cout<<"Wrong recording: "<<recorder->GetNumberOfBones()
+      <<" bones, "<<recorder->GetNumberOfEvents()<<" events."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  double poseTransform[4];
+  fatherBone->GetPoseTransform(poseTransform);
+  if (fabs(poseTransform[0] - 1.0) < 1e-6)
+    {
+    std::cout<<"The recorded drag did not rotate the father."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Replay in the same scene
+  if (!recorder->Replay())
+    {
+    std::cout<<"The replay did not match the recording: "
+      <<recorder->GetNumberOfMismatchedBones()<<" bones differ."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Save, load and replay in a new scene
+  const char* fileName = "vtkBoneSessionRecorderTest.session";
+  if (!recorder->Write(fileName))
+    {
+    std::cout<<"Could not write the session."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  Scene replayScene;
+  vtkSmartPointer<vtkBoneSessionRecorder> player =
+    vtkSmartPointer<vtkBoneSessionRecorder>::New();
+  player->SetInteractor(replayScene.Interactor);
+  player->SetRenderer(replayScene.Renderer);
+  if (!player->Read(fileName) || !player->BuildSkeleton())
+    {
+    std::cout<<"Could not load the session."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (player->GetNumberOfEvents() != recorder->GetNumberOfEvents()
+      || player->GetSkeleton()->GetBoneParentId(1) != 0)
+    {
+    std::cout<<"Wrong session loaded."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!player->Replay())
+    {
+    std::cout<<"The loaded session did not replay: "
+      <<player->GetNumberOfMismatchedBones()<<" bones differ."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  double totalTime = 0.0;
+  for (vtkIdType i = 0; i < player->GetNumberOfEvents(); ++i)
+    {
+    totalTime += player->GetEventTime(i);
+    }
+  if (fabs(totalTime - player->GetReplayTime()) > 1e-9)
+    {
+    std::cout<<"Wrong replay time."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkMath.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+int vtkBoneSkeletonTest(int, char *[])
+{
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {0.1, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> fatherBone = CreateBone(head, tail);
+
+  head[0] = 0.1; tail[0] = 0.1; tail[2] = -0.1;
+  vtkSmartPointer<vtkBoneWidget> sonBone = CreateBone(head, tail);
+  sonBone->SetBoneParent(fatherBone);
+
+  // Each bone starts with a private skeleton
+  if (fatherBone->GetSkeleton() == sonBone->GetSkeleton()
+      || fatherBone->GetSkeleton()->GetNumberOfBones() != 1)
+    {
+    std::cout<<"Bones should start with a private skeleton."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  double fatherRest[4], sonRest[4];
+  fatherBone->GetRestTransform(fatherRest);
+  sonBone->GetRestTransform(sonRest);
+
+  // Move the bones into a shared skeleton, the state must follow
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  vtkIdType fatherId = skeleton->AddBone(fatherBone);
+  vtkIdType sonId = skeleton->AddBone(sonBone);
+
+  if (skeleton->GetNumberOfBones() != 2
+      || fatherBone->GetSkeleton() != skeleton
+      || sonBone->GetSkeleton() != skeleton
+      || skeleton->GetBone(fatherId) != fatherBone
+      || skeleton->GetBone(sonId) != sonBone)
+    {
+    std::cout<<"Bones were not added to the skeleton."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (skeleton->GetBoneParentId(sonId) != fatherId
+      || skeleton->GetBoneParentId(fatherId) != -1)
+    {
+    std::cout<<"Wrong parent ids: "<< skeleton->GetBoneParentId(sonId)
+      <<" "<< skeleton->GetBoneParentId(fatherId) <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (!CompareQuaternion(fatherBone->GetRestTransform(), fatherRest)
+      || !CompareQuaternion(sonBone->GetRestTransform(), sonRest)
+      || !CompareQuaternion(skeleton->GetRestTransform(sonId), sonRest))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The bone is a view on the skeleton slot
+  if (sonBone->GetPoseTransform() != skeleton->GetPoseTransform(sonId)
+      || skeleton->GetRestTransforms() + 4*sonId != skeleton->GetRestTransform(sonId))
+    {
+    std::cout<<"Bone transforms are not stored in the skeleton."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Forward kinematics: the son follows the father in a single pass
+  vtkIdType* order = skeleton->GetTopologicalOrder();
+  if (!order || order[0] != fatherId || order[1] != sonId
+      || skeleton->GetNumberOfBoneChildren(fatherId) != 1
+      || skeleton->GetNumberOfBoneChildren(sonId) != 0)
+    {
+    std::cout<<"Wrong topological order."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The grandson stays in its own skeleton
+  head[0] = 0.1; head[2] = -0.1;
+  tail[0] = 0.2; tail[2] = -0.1;
+  vtkSmartPointer<vtkBoneWidget> grandsonBone = CreateBone(head, tail);
+  grandsonBone->SetBoneParent(sonBone);
+
+  fatherBone->SetWidgetStateToPose();
+  sonBone->SetWidgetStateToPose();
+  grandsonBone->SetWidgetStateToPose();
+  fatherBone->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+
+  double expectedHead[3] = {0.0, 0.1, 0.0};
+  double expectedTail[3] = {0.0, 0.1, -0.1};
+  double sonHead[3], sonTail[3];
+  sonBone->GetHeadPoseWorldPosition(sonHead);
+  sonBone->GetTailPoseWorldPosition(sonTail);
+  if (!ComparePoint(sonHead, expectedHead)
+      || !ComparePoint(sonTail, expectedTail)
+      || !CompareQuaternion(sonBone->GetPoseTransform(),
+                            fatherBone->GetPoseTransform()))
+    {
+    std::cout<<"The son pose was not updated."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The son moved by the forward kinematics notifies the grandson
+  double grandsonHead[3], grandsonTail[3];
+  grandsonBone->GetHeadPoseWorldPosition(grandsonHead);
+  grandsonBone->GetTailPoseWorldPosition(grandsonTail);
+  if (!ComparePoint(grandsonHead, sonTail)
+      || !ComparePoint(grandsonTail, 0.0, 0.2, -0.1)
+      || !CompareQuaternion(grandsonBone->GetPoseTransform(),
+                            fatherBone->GetPoseTransform()))
+    {
+    std::cout<<"The grandson in another skeleton did not follow."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  fatherBone->SetWidgetStateToRest();
+  sonBone->SetWidgetStateToRest();
+  grandsonBone->SetWidgetStateToRest();
+
+  // Removing the father moves the son in the first slot
+  skeleton->RemoveBone(fatherBone);
+  if (skeleton->GetNumberOfBones() != 1
+      || sonBone->GetBoneId() != 0
+      || skeleton->GetBoneParentId(0) != -1
+      || fatherBone->GetSkeleton() == skeleton.GetPointer()
+      || fatherBone->GetSkeleton()->GetNumberOfBones() != 1)
+    {
+    std::cout<<"Bone was not removed correctly."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (!CompareQuaternion(fatherBone->GetRestTransform(), fatherRest)
+      || !CompareQuaternion(sonBone->GetRestTransform(), sonRest))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // A chain of 3 bones along X. The rotation of a bone in pose mode is
+  // kept when its parent rotates: RotateTailWXYZ updates the local pose
+  // points used by the forward kinematics.
+  vtkSmartPointer<vtkBoneSkeleton> chain =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  vtkSmartPointer<vtkBoneWidget> chainBones[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    double chainHead[3] = {static_cast<double>(i), 0.0, 0.0};
+    double chainTail[3] = {i + 1.0, 0.0, 0.0};
+    chainBones[i] = CreateBone(chainHead, chainTail);
+    if (i > 0)
+      {
+      chainBones[i]->SetBoneParent(chainBones[i - 1]);
+      }
+    chain->AddBone(chainBones[i]);
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    chainBones[i]->SetWidgetStateToPose();
+    }
+
+  chainBones[1]->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+  chainBones[0]->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+
+  if (!ComparePoint(chainBones[0]->GetTailPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(chainBones[1]->GetHeadPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(chainBones[1]->GetTailPoseWorldPosition(), -1.0, 1.0, 0.0)
+      || !ComparePoint(chainBones[2]->GetHeadPoseWorldPosition(), -1.0, 1.0, 0.0)
+      || !ComparePoint(chainBones[2]->GetTailPoseWorldPosition(), -2.0, 1.0, 0.0))
+    {
+    std::cout<<"The rotation of the child was lost."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The same chain with a private skeleton per bone follows through
+  // PoseChangedEvent. It must pose the bones like the forward kinematics,
+  // even when the child rotated out of the plane of the parent rotation.
+  vtkSmartPointer<vtkBoneWidget> sharedBones[3];
+  vtkSmartPointer<vtkBoneWidget> privateBones[3];
+  vtkSmartPointer<vtkBoneSkeleton> sharedChain =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  for (int i = 0; i < 3; ++i)
+    {
+    double chainHead[3] = {static_cast<double>(i), 0.0, 0.0};
+    double chainTail[3] = {i + 1.0, 0.0, 0.0};
+    sharedBones[i] = CreateBone(chainHead, chainTail);
+    privateBones[i] = CreateBone(chainHead, chainTail);
+    if (i > 0)
+      {
+      sharedBones[i]->SetBoneParent(sharedBones[i - 1]);
+      privateBones[i]->SetBoneParent(privateBones[i - 1]);
+      }
+    sharedChain->AddBone(sharedBones[i]);
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    sharedBones[i]->SetWidgetStateToPose();
+    privateBones[i]->SetWidgetStateToPose();
+    }
+
+  sharedBones[1]->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 1.0, 0.0);
+  privateBones[1]->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 1.0, 0.0);
+  sharedBones[0]->RotateTailWXYZ(vtkMath::Pi() / 3.0, 0.0, 0.0, 1.0);
+  privateBones[0]->RotateTailWXYZ(vtkMath::Pi() / 3.0, 0.0, 0.0, 1.0);
+
+  for (int i = 0; i < 3; ++i)
+    {
+    if (!CompareQuaternion(privateBones[i]->GetPoseTransform(),
+                           sharedBones[i]->GetPoseTransform())
+        || !ComparePoint(privateBones[i]->GetHeadPoseWorldPosition(),
+                         sharedBones[i]->GetHeadPoseWorldPosition())
+        || !ComparePoint(privateBones[i]->GetTailPoseWorldPosition(),
+                         sharedBones[i]->GetTailPoseWorldPosition()))
+      {
+      std::cout<<"Bone #"<<i<<" in its own skeleton is not posed like "
+        <<"in a shared skeleton."<<std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
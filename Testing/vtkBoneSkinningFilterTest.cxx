@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneSkinningFilter.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+namespace
+{
+
+bool CheckPoints(vtkBoneSkinningFilter* filter, double expectedPoints[][3],
+                 int numberOfPoints)
+{
+  filter->Update();
+  vtkPolyData* output = filter->GetOutput();
+  if (output->GetNumberOfPoints() != numberOfPoints)
+    {
+    std::cout<<"Wrong number of points."<<std::endl;
+    return false;
+    }
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    if (!ComparePoint(output->GetPoint(i), expectedPoints[i]))
+      {
+      std::cout<<"Wrong point "<<i<<" with the skinning mode "
+        <<filter->GetSkinningMode()<<std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}// end namespace
+
+int vtkBoneSkinningFilterTest(int, char *[])
+{
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {0.1, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> fatherBone = CreateBone(head, tail);
+
+  head[0] = 0.1; tail[0] = 0.1; tail[2] = -0.1;
+  vtkSmartPointer<vtkBoneWidget> sonBone = CreateBone(head, tail);
+  sonBone->SetBoneParent(fatherBone);
+
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  int fatherId = static_cast<int>(skeleton->AddBone(fatherBone));
+  int sonId = static_cast<int>(skeleton->AddBone(sonBone));
+
+  // Mesh: a point on each bone, one at the joint and one without weights
+  const int numberOfPoints = 4;
+  double restPoints[numberOfPoints][3] = {{0.05, 0.0, 0.0},
+                                          {0.1, 0.0, -0.05},
+                                          {0.1, 0.0, 0.0},
+                                          {1.0, 1.0, 1.0}};
+  int boneIndices[numberOfPoints][2] = {{fatherId, sonId},
+                                        {sonId, fatherId},
+                                        {fatherId, sonId},
+                                        {fatherId, sonId}};
+  float boneWeights[numberOfPoints][2] = {{2.0f, 0.0f},
+                                          {1.0f, 0.0f},
+                                          {0.5f, 0.5f},
+                                          {0.0f, 0.0f}};
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkIntArray> indices = vtkSmartPointer<vtkIntArray>::New();
+  indices->SetName("BoneIndices");
+  indices->SetNumberOfComponents(2);
+  vtkSmartPointer<vtkFloatArray> weights =
+    vtkSmartPointer<vtkFloatArray>::New();
+  weights->SetName("BoneWeights");
+  weights->SetNumberOfComponents(2);
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    points->InsertNextPoint(restPoints[i]);
+    indices->InsertNextTupleValue(boneIndices[i]);
+    weights->InsertNextTupleValue(boneWeights[i]);
+    }
+
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->GetPointData()->AddArray(indices);
+  mesh->GetPointData()->AddArray(weights);
+
+  vtkSmartPointer<vtkBoneSkinningFilter> filter =
+    vtkSmartPointer<vtkBoneSkinningFilter>::New();
+  filter->SetInput(mesh);
+  filter->SetSkeleton(skeleton);
+
+  // In rest mode, the mesh does not move
+  if (!CheckPoints(filter, restPoints, numberOfPoints))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Rotate the father around the Z axis, the son follows
+  fatherBone->SetWidgetStateToPose();
+  sonBone->SetWidgetStateToPose();
+  fatherBone->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+
+  double posedPoints[numberOfPoints][3] = {{0.0, 0.05, 0.0},
+                                           {0.0, 0.1, -0.05},
+                                           {0.0, 0.1, 0.0},
+                                           {1.0, 1.0, 1.0}};
+  if (!CheckPoints(filter, posedPoints, numberOfPoints))
+    {
+    return EXIT_FAILURE;
+    }
+
+  filter->SetSkinningModeToDualQuaternion();
+  if (!CheckPoints(filter, posedPoints, numberOfPoints))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Single threaded gives the same result
+  filter->SetNumberOfThreads(1);
+  if (!CheckPoints(filter, posedPoints, numberOfPoints))
+    {
+    return EXIT_FAILURE;
+    }
+
+  fatherBone->SetWidgetStateToRest();
+  sonBone->SetWidgetStateToRest();
+  if (!CheckPoints(filter, restPoints, numberOfPoints))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
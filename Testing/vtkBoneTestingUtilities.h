@@ -0,0 +1,218 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#ifndef __vtkBoneTestingUtilities_h
+#define __vtkBoneTestingUtilities_h
+
+// Helpers shared by the tests: bone creation, comparisons printing the
+// values that differ and an offscreen scene whose interactor events are
+// invoked by hand.
+
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkInteractorObserver.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneWidget.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace vtkBoneTestingUtilities
+{
+
+//----------------------------------------------------------------------------
+inline bool ComparePoint(const double* point, const double* expectedPoint)
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    if (fabs(point[i] - expectedPoint[i]) > 1e-6)
+      {
+      std::cout<<"Point different !"<<std::endl
+        <<"Expected:  "<<expectedPoint[0]<<" "<<expectedPoint[1]<<" "
+                       <<expectedPoint[2]<<std::endl
+        <<" - Got:    "<<point[0]<<" "<<point[1]<<" "
+                       <<point[2]<<std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+inline bool ComparePoint(const double* point, double x, double y, double z)
+{
+  double expectedPoint[3] = {x, y, z};
+  return ComparePoint(point, expectedPoint);
+}
+
+//----------------------------------------------------------------------------
+inline bool CompareQuaternion(const double* quad, const double* expectedQuad)
+{
+  for (int i = 0; i < 4; ++i)
+    {
+    if (fabs(quad[i] - expectedQuad[i]) > 1e-6)
+      {
+      std::cout<<"Quaternion different !"<<std::endl
+        <<"Expected:  "<<expectedQuad[0]<<" "<<expectedQuad[1]<<" "
+                       <<expectedQuad[2]<<" "<<expectedQuad[3]<<std::endl
+        <<" - Got:    "<<quad[0]<<" "<<quad[1]<<" "
+                       <<quad[2]<<" "<<quad[3]<<std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Bone in rest mode, without interactor nor renderer.
+inline vtkSmartPointer<vtkBoneWidget> CreateBone(double head[3],
+                                                 double tail[3])
+{
+  vtkSmartPointer<vtkBoneWidget> bone = vtkSmartPointer<vtkBoneWidget>::New();
+  bone->CreateDefaultRepresentation();
+  bone->SetWidgetStateToRest();
+  bone->SetHeadRestWorldPosition(head);
+  bone->SetTailRestWorldPosition(tail);
+  return bone;
+}
+
+//----------------------------------------------------------------------------
+// Count the events observed.
+class EventCounter : public vtkCommand
+{
+public:
+  static EventCounter *New()
+    { return new EventCounter; }
+  EventCounter()
+    { this->Count = 0; }
+  virtual void Execute(vtkObject*, unsigned long, void*)
+    { ++this->Count; }
+  int Count;
+};
+
+//----------------------------------------------------------------------------
+// Invoke an event at the given display position.
+inline void InvokeEvent(vtkRenderWindowInteractor* interactor,
+                        unsigned long event, int X, int Y)
+{
+  interactor->SetEventInformation(X, Y, 0, 0);
+  interactor->InvokeEvent(event, NULL);
+}
+
+//----------------------------------------------------------------------------
+inline void InvokeEvent(vtkRenderWindowInteractor* interactor,
+                        unsigned long event, const double position[2])
+{
+  InvokeEvent(interactor, event,
+              static_cast<int>(position[0]), static_cast<int>(position[1]));
+}
+
+//----------------------------------------------------------------------------
+// Offscreen 400x400 window with a parallel camera looking along -Z.
+// By default the center of the window is (0.1, 0, 0) and a world unit is
+// 1000 pixels.
+struct Scene
+{
+  Scene()
+    {
+    this->Renderer = vtkSmartPointer<vtkRenderer>::New();
+    this->RenderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    this->RenderWindow->SetOffScreenRendering(1);
+    this->RenderWindow->SetSize(400, 400);
+    this->RenderWindow->AddRenderer(this->Renderer);
+    this->Interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+    this->Interactor->SetRenderWindow(this->RenderWindow);
+    this->Interactor->Enable();
+
+    this->SetView(0.1, 0.0, 0.2);
+    }
+
+  // Center the view on (x, y, 0). The window is 2 * parallelScale high.
+  void SetView(double x, double y, double parallelScale)
+    {
+    vtkCamera* camera = this->Renderer->GetActiveCamera();
+    camera->SetParallelProjection(1);
+    camera->SetParallelScale(parallelScale);
+    camera->SetFocalPoint(x, y, 0.0);
+    camera->SetPosition(x, y, 5.0 * parallelScale);
+    camera->SetViewUp(0.0, 1.0, 0.0);
+    }
+
+  void WorldToDisplay(double x, double y, double z, double display[2])
+    {
+    double displayPoint[4];
+    vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer,
+                                                 x, y, z, displayPoint);
+    display[0] = displayPoint[0];
+    display[1] = displayPoint[1];
+    }
+
+  void InvokeEvent(unsigned long event, const double position[2])
+    {
+    vtkBoneTestingUtilities::InvokeEvent(this->Interactor, event, position);
+    }
+
+  void InvokeEvent(unsigned long event, int X, int Y)
+    {
+    vtkBoneTestingUtilities::InvokeEvent(this->Interactor, event, X, Y);
+    }
+
+  // Press at start, move to end in numberOfMoves steps and release.
+  void Drag(const double start[2], const double end[2],
+            int numberOfMoves = 10)
+    {
+    this->InvokeEvent(vtkCommand::LeftButtonPressEvent, start);
+    for (int i = 1; i <= numberOfMoves; ++i)
+      {
+      double position[2];
+      position[0] = start[0] + i * (end[0] - start[0]) / numberOfMoves;
+      position[1] = start[1] + i * (end[1] - start[1]) / numberOfMoves;
+      this->InvokeEvent(vtkCommand::MouseMoveEvent, position);
+      }
+    this->InvokeEvent(vtkCommand::LeftButtonReleaseEvent, end);
+    }
+
+  // Bone in rest mode on the interactor and the renderer of the scene.
+  // It is not enabled.
+  vtkSmartPointer<vtkBoneWidget> CreateBone(double head[3], double tail[3])
+    {
+    vtkSmartPointer<vtkBoneWidget> bone =
+      vtkSmartPointer<vtkBoneWidget>::New();
+    bone->SetInteractor(this->Interactor);
+    bone->SetCurrentRenderer(this->Renderer);
+    bone->CreateDefaultRepresentation();
+    bone->SetWidgetStateToRest();
+    bone->SetHeadRestWorldPosition(head);
+    bone->SetTailRestWorldPosition(tail);
+    return bone;
+    }
+
+  vtkSmartPointer<vtkRenderer> Renderer;
+  vtkSmartPointer<vtkRenderWindow> RenderWindow;
+  vtkSmartPointer<vtkRenderWindowInteractor> Interactor;
+};
+
+}// end namespace
+
+#endif
@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneMath.h"
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneTwoBoneIKSolver.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+namespace
+{
+
+// The pose transform must rotate the rest Y axis along the bone
+bool CheckPoseTransform(vtkBoneWidget* bone)
+{
+  vtkBoneQuaterniond rotation =
+    vtkBoneQuaterniond(bone->GetPoseTransform())
+    * vtkBoneQuaterniond(bone->GetRestTransform());
+  vtkBoneVector3d axis = rotation.Rotate(vtkBoneVector3d(0.0, 1.0, 0.0));
+  vtkBoneVector3d direction =
+    vtkBoneVector3d(bone->GetTailPoseWorldPosition())
+    - vtkBoneVector3d(bone->GetHeadPoseWorldPosition());
+  direction.Normalize();
+  if ((axis - direction).Norm() > 1e-6)
+    {
+    std::cout<<"The pose transform does not follow the bone."<<std::endl;
+    return false;
+    }
+  return true;
+}
+
+// Bone of length 1 along X, from x
+vtkSmartPointer<vtkBoneWidget> CreateBone(double x, vtkBoneWidget* parent)
+{
+  double head[3] = {x, 0.0, 0.0};
+  double tail[3] = {x + 1.0, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> bone =
+    vtkBoneTestingUtilities::CreateBone(head, tail);
+  if (parent)
+    {
+    bone->SetBoneParent(parent);
+    bone->SetHeadLinkedToParent(1);
+    }
+  return bone;
+}
+
+}// end namespace
+
+int vtkBoneTwoBoneIKSolverTest(int, char *[])
+{
+  // A straight arm along X with a hand
+  vtkSmartPointer<vtkBoneWidget> upper = CreateBone(0.0, NULL);
+  vtkSmartPointer<vtkBoneWidget> lower = CreateBone(1.0, upper);
+  vtkSmartPointer<vtkBoneWidget> hand = CreateBone(2.0, lower);
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  skeleton->AddBone(upper);
+  skeleton->AddBone(lower);
+  skeleton->AddBone(hand);
+
+  vtkSmartPointer<vtkBoneTwoBoneIKSolver> solver =
+    vtkSmartPointer<vtkBoneTwoBoneIKSolver>::New();
+  solver->SetUpperBone(upper);
+  solver->SetLowerBone(lower);
+  solver->SetTarget(1.0, 1.0, 0.0);
+  solver->SetPoleVector(0.0, 1.0, 0.0);
+
+  // Nothing is solved in rest mode
+  if (solver->Solve() != 0)
+    {
+    std::cout<<"The solver should fail in rest mode."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  upper->SetWidgetStateToPose();
+  lower->SetWidgetStateToPose();
+  hand->SetWidgetStateToPose();
+
+  // The elbow bends toward the pole: the upper bone turns by 90 degrees
+  // around Z and the lower bone keeps its direction.
+  if (solver->Solve() != 1 || !solver->GetTargetReached())
+    {
+    std::cout<<"The target should be reached."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!ComparePoint(upper->GetHeadPoseWorldPosition(), 0.0, 0.0, 0.0)
+      || !ComparePoint(upper->GetTailPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(lower->GetHeadPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(lower->GetTailPoseWorldPosition(), 1.0, 1.0, 0.0))
+    {
+    std::cout<<"Wrong arm pose."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!CheckPoseTransform(upper) || !CheckPoseTransform(lower))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The hand follows the forward kinematics
+  if (!ComparePoint(hand->GetHeadPoseWorldPosition(), 1.0, 1.0, 0.0)
+      || !ComparePoint(hand->GetTailPoseWorldPosition(), 2.0, 1.0, 0.0)
+      || !CheckPoseTransform(hand))
+    {
+    std::cout<<"The hand did not follow the arm."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Out of reach: the arm is straight toward the target
+  solver->SetTarget(0.0, 5.0, 0.0);
+  solver->SetPoleVector(0.0, 0.0, 0.0);
+  if (solver->Solve() != 1 || solver->GetTargetReached())
+    {
+    std::cout<<"The target should be out of reach."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!ComparePoint(upper->GetHeadPoseWorldPosition(), 0.0, 0.0, 0.0)
+      || !ComparePoint(lower->GetHeadPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(lower->GetTailPoseWorldPosition(), 0.0, 2.0, 0.0)
+      || !ComparePoint(hand->GetTailPoseWorldPosition(), 0.0, 3.0, 0.0)
+      || !CheckPoseTransform(upper) || !CheckPoseTransform(lower)
+      || !CheckPoseTransform(hand))
+    {
+    std::cout<<"Wrong straight arm pose."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Back within reach, the elbow keeps bending in the current plane
+  solver->SetTarget(1.0, 1.0, 0.0);
+  if (solver->Solve() != 1 || !solver->GetTargetReached()
+      || !ComparePoint(lower->GetTailPoseWorldPosition(), 1.0, 1.0, 0.0)
+      || fabs(lower->GetHeadPoseWorldPosition()[2]) > 1e-6)
+    {
+    std::cout<<"Wrong pose after the straight arm."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Bones in different skeletons: the lower bone follows on
+  // PoseChangedEvent and keeps the solved pose.
+  vtkSmartPointer<vtkBoneWidget> otherUpper = CreateBone(0.0, NULL);
+  vtkSmartPointer<vtkBoneWidget> otherLower = CreateBone(1.0, otherUpper);
+  otherUpper->SetWidgetStateToPose();
+  otherLower->SetWidgetStateToPose();
+  solver->SetUpperBone(otherUpper);
+  solver->SetLowerBone(otherLower);
+  solver->SetTarget(1.0, 1.0, 0.0);
+  solver->SetPoleVector(0.0, 1.0, 0.0);
+  if (solver->Solve() != 1 || !solver->GetTargetReached()
+      || !ComparePoint(otherUpper->GetTailPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(otherLower->GetHeadPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(otherLower->GetTailPoseWorldPosition(), 1.0, 1.0, 0.0)
+      || !CheckPoseTransform(otherUpper) || !CheckPoseTransform(otherLower))
+    {
+    std::cout<<"Wrong pose of the bones in different skeletons."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
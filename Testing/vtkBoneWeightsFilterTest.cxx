@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneSkeleton.h"
+#include "vtkBoneSkinningFilter.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWeightsFilter.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+namespace
+{
+
+// Triangulated strip around the X axis, from x = 0 to x = 2
+vtkSmartPointer<vtkPolyData> CreateStrip(int numberOfColumns)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i < numberOfColumns; ++i)
+    {
+    double x = 2.0 * i / (numberOfColumns - 1);
+    points->InsertNextPoint(x, -0.2, 0.0);
+    points->InsertNextPoint(x, 0.2, 0.0);
+    if (i > 0)
+      {
+      vtkIdType first[3] = {2*i - 2, 2*i, 2*i + 1};
+      vtkIdType second[3] = {2*i - 2, 2*i + 1, 2*i - 1};
+      polys->InsertNextCell(3, first);
+      polys->InsertNextCell(3, second);
+      }
+    }
+
+  vtkSmartPointer<vtkPolyData> strip = vtkSmartPointer<vtkPolyData>::New();
+  strip->SetPoints(points);
+  strip->SetPolys(polys);
+  return strip;
+}
+
+bool CheckWeights(vtkBoneWeightsFilter* filter, int fatherId, int sonId)
+{
+  filter->Update();
+  vtkPolyData* output = filter->GetOutput();
+  vtkIntArray* indices = vtkIntArray::SafeDownCast(
+    output->GetPointData()->GetArray("BoneIndices"));
+  vtkFloatArray* weights = vtkFloatArray::SafeDownCast(
+    output->GetPointData()->GetArray("BoneWeights"));
+  if (!indices || !weights
+      || indices->GetNumberOfComponents() != 2
+      || weights->GetNumberOfComponents() != 2
+      || weights->GetNumberOfTuples() != output->GetNumberOfPoints())
+    {
+    std::cout<<"Wrong output arrays with the weighting mode "
+      <<filter->GetWeightingMode()<<std::endl;
+    return false;
+    }
+
+  vtkIdType lastPoint = output->GetNumberOfPoints() - 1;
+  for (vtkIdType i = 0; i <= lastPoint; ++i)
+    {
+    float sum = weights->GetComponent(i, 0) + weights->GetComponent(i, 1);
+    if (fabs(sum - 1.0) > 1e-5
+        || weights->GetComponent(i, 0) < weights->GetComponent(i, 1))
+      {
+      std::cout<<"Wrong weights for the point "<<i<<" with the weighting mode "
+        <<filter->GetWeightingMode()<<std::endl;
+      return false;
+      }
+    }
+
+  // The ends of the strip follow the closest bone
+  if (indices->GetComponent(0, 0) != fatherId
+      || indices->GetComponent(lastPoint, 0) != sonId
+      || weights->GetComponent(0, 0) < 0.9
+      || weights->GetComponent(lastPoint, 0) < 0.9)
+    {
+    std::cout<<"Wrong influences at the ends of the strip with the"
+      <<" weighting mode "<<filter->GetWeightingMode()<<std::endl;
+    return false;
+    }
+  return true;
+}
+
+}// end namespace
+
+int vtkBoneWeightsFilterTest(int, char *[])
+{
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {1.0, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> fatherBone = CreateBone(head, tail);
+
+  head[0] = 1.0; tail[0] = 2.0;
+  vtkSmartPointer<vtkBoneWidget> sonBone = CreateBone(head, tail);
+  sonBone->SetBoneParent(fatherBone);
+
+  vtkSmartPointer<vtkBoneSkeleton> skeleton =
+    vtkSmartPointer<vtkBoneSkeleton>::New();
+  int fatherId = static_cast<int>(skeleton->AddBone(fatherBone));
+  int sonId = static_cast<int>(skeleton->AddBone(sonBone));
+
+  vtkSmartPointer<vtkPolyData> strip = CreateStrip(17);
+
+  vtkSmartPointer<vtkBoneWeightsFilter> filter =
+    vtkSmartPointer<vtkBoneWeightsFilter>::New();
+  filter->SetInput(strip);
+  filter->SetSkeleton(skeleton);
+  filter->SetMaximumNumberOfInfluences(2);
+
+  if (!CheckWeights(filter, fatherId, sonId))
+    {
+    return EXIT_FAILURE;
+    }
+
+  filter->SetWeightingModeToHeatDiffusion();
+  if (!CheckWeights(filter, fatherId, sonId))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Single threaded gives the same result
+  filter->SetNumberOfThreads(1);
+  if (!CheckWeights(filter, fatherId, sonId))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The weights drive the skinning: rotating the father around the Z axis
+  // (the son follows) rotates the whole strip.
+  vtkSmartPointer<vtkBoneSkinningFilter> skinning =
+    vtkSmartPointer<vtkBoneSkinningFilter>::New();
+  skinning->SetInputConnection(filter->GetOutputPort());
+  skinning->SetSkeleton(skeleton);
+
+  fatherBone->SetWidgetStateToPose();
+  sonBone->SetWidgetStateToPose();
+  fatherBone->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+  skinning->Update();
+
+  double expectedFirst[3] = {0.2, 0.0, 0.0};
+  double* first = skinning->GetOutput()->GetPoint(0);
+  if (sqrt(vtkMath::Distance2BetweenPoints(first, expectedFirst)) > 0.05)
+    {
+    std::cout<<"The skinned strip does not follow the father bone: "
+      <<first[0]<<" "<<first[1]<<" "<<first[2]<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCommand.h>
+#include <vtkMath.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+namespace
+{
+
+// A bone of the scene in pose mode, from (0, 0, 0) to (0.1, 0, 0)
+vtkSmartPointer<vtkBoneWidget> CreatePoseBone(Scene& scene, int updateMode)
+{
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {0.1, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> bone = scene.CreateBone(head, tail);
+  bone->SetWidgetStateToPose();
+  bone->SetUpdateMode(updateMode);
+  bone->On();
+  scene.RenderWindow->Render();
+  return bone;
+}
+
+// Move from start toward end, the i-th of 10 steps
+void Move(Scene& scene, const double start[2], const double end[2], int i)
+{
+  double position[2];
+  position[0] = start[0] + i * (end[0] - start[0]) / 10.0;
+  position[1] = start[1] + i * (end[1] - start[1]) / 10.0;
+  scene.InvokeEvent(vtkCommand::MouseMoveEvent, position);
+}
+
+}// end namespace
+
+int vtkBoneWidgetDeferredUpdateTest(int, char *[])
+{
+  Scene immediate;
+  immediate.SetView(0.0, 0.0, 0.2);
+  vtkSmartPointer<vtkBoneWidget> immediateBone =
+    CreatePoseBone(immediate, vtkBoneWidget::ImmediateUpdate);
+  vtkSmartPointer<EventCounter> immediatePoseChanged =
+    vtkSmartPointer<EventCounter>::New();
+  immediateBone->AddObserver(vtkBoneWidget::PoseChangedEvent,
+                             immediatePoseChanged);
+
+  Scene deferred;
+  deferred.SetView(0.0, 0.0, 0.2);
+  vtkSmartPointer<vtkBoneWidget> deferredBone =
+    CreatePoseBone(deferred, vtkBoneWidget::DeferredUpdate);
+  vtkSmartPointer<EventCounter> deferredPoseChanged =
+    vtkSmartPointer<EventCounter>::New();
+  deferredBone->AddObserver(vtkBoneWidget::PoseChangedEvent,
+                            deferredPoseChanged);
+
+  // Rotate the tail around the head
+  double start[2], end[2];
+  immediate.WorldToDisplay(0.1, 0.0, 0.0, start);
+  end[0] = start[0] - 20.0;
+  end[1] = start[1] + 40.0;
+
+  immediate.InvokeEvent(vtkCommand::LeftButtonPressEvent, start);
+  for (int i = 1; i <= 10; ++i)
+    {
+    Move(immediate, start, end, i);
+    }
+  immediate.InvokeEvent(vtkCommand::LeftButtonReleaseEvent, end);
+
+  if (immediatePoseChanged->Count != 10)
+    {
+    std::cout<<"Immediate mode: expected 10 pose changes, got "
+      <<immediatePoseChanged->Count<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The deferred bone does not move until it is rendered
+  deferred.InvokeEvent(vtkCommand::LeftButtonPressEvent, start);
+  for (int i = 1; i <= 5; ++i)
+    {
+    Move(deferred, start, end, i);
+    }
+  if (deferredPoseChanged->Count != 0 || !deferredBone->GetMovePending())
+    {
+    std::cout<<"Deferred mode: the moves were processed before rendering."
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  deferred.RenderWindow->Render();
+  if (deferredPoseChanged->Count != 1 || deferredBone->GetMovePending())
+    {
+    std::cout<<"Deferred mode: the moves were not coalesced in the render, "
+      <<deferredPoseChanged->Count<<" pose changes."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The release processes the last moves
+  for (int i = 6; i <= 10; ++i)
+    {
+    Move(deferred, start, end, i);
+    }
+  deferred.InvokeEvent(vtkCommand::LeftButtonReleaseEvent, end);
+  if (deferredPoseChanged->Count != 2 || deferredBone->GetMovePending())
+    {
+    std::cout<<"Deferred mode: the release did not process the moves, "
+      <<deferredPoseChanged->Count<<" pose changes."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  double restTail[3] = {0.1, 0.0, 0.0};
+  double immediateTail[3], deferredTail[3];
+  immediateBone->GetTailPoseWorldPosition(immediateTail);
+  deferredBone->GetTailPoseWorldPosition(deferredTail);
+  if (vtkMath::Distance2BetweenPoints(immediateTail, restTail) < 1e-6
+      || vtkMath::Distance2BetweenPoints(immediateTail, deferredTail) > 1e-12)
+    {
+    std::cout<<"The deferred bone does not match the immediate bone: "
+      <<deferredTail[0]<<" "<<deferredTail[1]<<" "<<deferredTail[2]
+      <<" instead of "
+      <<immediateTail[0]<<" "<<immediateTail[1]<<" "<<immediateTail[2]
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
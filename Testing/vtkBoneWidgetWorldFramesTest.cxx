@@ -0,0 +1,116 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkMath.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBoneTestingUtilities.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+int vtkBoneWidgetWorldFramesTest(int, char *[])
+{
+  // A father and its son along X, an unrelated bone above them
+  double head[3] = {0.0, 0.0, 0.0};
+  double tail[3] = {1.0, 0.0, 0.0};
+  vtkSmartPointer<vtkBoneWidget> fatherBone = CreateBone(head, tail);
+
+  head[0] = 1.0; tail[0] = 2.0;
+  vtkSmartPointer<vtkBoneWidget> sonBone = CreateBone(head, tail);
+  sonBone->SetBoneParent(fatherBone);
+
+  head[0] = 0.0; head[1] = 1.0; tail[0] = 1.0; tail[1] = 1.0;
+  vtkSmartPointer<vtkBoneWidget> otherBone = CreateBone(head, tail);
+
+  fatherBone->SetWidgetStateToPose();
+  sonBone->SetWidgetStateToPose();
+  otherBone->SetWidgetStateToPose();
+
+  // The rest positions are cached in pose mode
+  if (!ComparePoint(sonBone->GetHeadRestWorldPosition(), 1.0, 0.0, 0.0)
+      || !ComparePoint(sonBone->GetTailRestWorldPosition(), 2.0, 0.0, 0.0))
+    {
+    std::cout<<"Wrong cached rest positions."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (fatherBone->GetWorldRestFrameModified()
+      || sonBone->GetWorldRestFrameModified())
+    {
+    std::cout<<"The rest caches were not updated."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A change of an unrelated bone keeps the caches valid
+  otherBone->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+  if (fatherBone->GetWorldRestFrameModified()
+      || sonBone->GetWorldRestFrameModified()
+      || !otherBone->GetWorldRestFrameModified())
+    {
+    std::cout<<"The frames of an unrelated bone invalidated the cache."
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A change of the father invalidates the son cache
+  fatherBone->RotateTailWXYZ(vtkMath::Pi() / 2.0, 0.0, 0.0, 1.0);
+  if (!sonBone->GetWorldRestFrameModified()
+      || !sonBone->GetWorldPoseFrameModified())
+    {
+    std::cout<<"The father did not invalidate the son cache."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!ComparePoint(sonBone->GetHeadPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(sonBone->GetTailPoseWorldPosition(), 0.0, 2.0, 0.0)
+      || !ComparePoint(sonBone->GetHeadRestWorldPosition(), 1.0, 0.0, 0.0)
+      || !ComparePoint(sonBone->GetTailRestWorldPosition(), 2.0, 0.0, 0.0))
+    {
+    std::cout<<"The son cache did not follow its father."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Querying the son recomputed its ancestors too
+  if (fatherBone->GetWorldRestFrameModified()
+      || sonBone->GetWorldRestFrameModified())
+    {
+    std::cout<<"The chain was not recomputed."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Back in rest mode, the pose positions are cached
+  fatherBone->SetWidgetStateToRest();
+  sonBone->SetWidgetStateToRest();
+  if (!ComparePoint(sonBone->GetHeadPoseWorldPosition(), 0.0, 1.0, 0.0)
+      || !ComparePoint(sonBone->GetTailPoseWorldPosition(), 0.0, 2.0, 0.0))
+    {
+    std::cout<<"Wrong cached pose positions."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Releasing the father invalidates the son cache
+  sonBone->SetBoneParent(NULL);
+  if (!sonBone->GetWorldPoseFrameModified())
+    {
+    std::cout<<"The removal of the parent kept the son cache."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
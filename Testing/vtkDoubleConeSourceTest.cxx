@@ -0,0 +1,95 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkDoubleConeSource.h"
+
+int vtkDoubleConeSourceTest(int, char *[])
+{
+  vtkSmartPointer<vtkDoubleConeSource> cones =
+    vtkSmartPointer<vtkDoubleConeSource>::New();
+  cones->SetNumberOfSides(8);
+  cones->Update();
+
+  vtkPolyData* output = cones->GetOutput();
+  if (output->GetNumberOfPoints() != 10 || output->GetNumberOfPolys() != 16)
+    {
+    std::cout<<"Wrong double cone: "<<output->GetNumberOfPoints()
+      <<" points, "<<output->GetNumberOfPolys()<<" triangles."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The ring is shared, at Ratio and Radius from the axis
+  for (vtkIdType i = 2; i < 10; ++i)
+    {
+    double* point = output->GetPoint(i);
+    if (fabs(point[0] - 0.25) > 1e-12
+        || fabs(sqrt(point[1] * point[1] + point[2] * point[2]) - 0.1) > 1e-12)
+      {
+      std::cout<<"Wrong ring point "<<i<<std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Moving the ring and the end points only rewrites the coordinates
+  vtkPoints* points = output->GetPoints();
+  void* coordinates = points->GetData()->GetVoidPointer(0);
+  vtkCellArray* triangles = output->GetPolys();
+  cones->SetRatio(0.5);
+  cones->SetPoint1(0.0, 0.0, 1.0);
+  cones->SetPoint2(0.0, 0.0, 3.0);
+  cones->Update();
+  output = cones->GetOutput();
+  if (output->GetPoints() != points
+      || points->GetData()->GetVoidPointer(0) != coordinates
+      || output->GetPolys() != triangles
+      || output->GetNumberOfPoints() != 10)
+    {
+    std::cout<<"The double cone was reallocated."<<std::endl;
+    return EXIT_FAILURE;
+    }
+  double* point = output->GetPoint(5);
+  if (fabs(point[2] - 2.0) > 1e-12
+      || fabs(sqrt(point[0] * point[0] + point[1] * point[1]) - 0.1) > 1e-12
+      || output->GetPoint(1)[2] != 3.0)
+    {
+    std::cout<<"Wrong moved double cone."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Changing the number of sides rebuilds the triangles
+  cones->SetNumberOfSides(4);
+  cones->Update();
+  output = cones->GetOutput();
+  if (output->GetNumberOfPoints() != 6 || output->GetNumberOfPolys() != 8)
+    {
+    std::cout<<"Wrong double cone after changing the number of sides."
+      <<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program: Bender
+
+  Copyright (c) Kitware Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=========================================================================*/
+
+#include <vtkActor.h>
+#include <vtkCommand.h>
+#include <vtkDoubleArray.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include "vtkBoneGlyphInstancer.h"
+#include "vtkBoneTestingUtilities.h"
+#include "vtkInstancedBoneRepresentation.h"
+#include "vtkBoneWidget.h"
+
+using namespace vtkBoneTestingUtilities;
+
+namespace
+{
+
+int CheckColor(vtkBoneGlyphInstancer* instancer, vtkIdType id,
+               unsigned char r, unsigned char g, unsigned char b)
+{
+  vtkUnsignedCharArray* colors = vtkUnsignedCharArray::SafeDownCast(
+    instancer->GetInstances()->GetPointData()->GetArray("Colors"));
+  unsigned char* color = colors->GetPointer(3 * id);
+  return color[0] == r && color[1] == g && color[2] == b;
+}
+
+}// end namespace
+
+int vtkInstancedBoneRepresentationTest(int, char *[])
+{
+  Scene scene;
+
+  vtkSmartPointer<vtkBoneGlyphInstancer> instancer =
+    vtkSmartPointer<vtkBoneGlyphInstancer>::New();
+  scene.Renderer->AddActor(instancer->GetActor());
+
+  // A chain of 3 bones along X, 100 pixels long
+  vtkSmartPointer<vtkBoneWidget> bones[3];
+  vtkSmartPointer<vtkInstancedBoneRepresentation> reps[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    reps[i] = vtkSmartPointer<vtkInstancedBoneRepresentation>::New();
+    reps[i]->SetInstancer(instancer);
+
+    bones[i] = vtkSmartPointer<vtkBoneWidget>::New();
+    bones[i]->SetInteractor(scene.Interactor);
+    bones[i]->SetCurrentRenderer(scene.Renderer);
+    bones[i]->SetRepresentation(reps[i]);
+    bones[i]->SetWidgetStateToRest();
+    bones[i]->SetHeadRestWorldPosition(0.1 * i - 0.05, 0.0, 0.0);
+    bones[i]->SetTailRestWorldPosition(0.1 * i + 0.05, 0.0, 0.0);
+    bones[i]->On();
+    }
+  scene.RenderWindow->Render();
+
+  vtkPolyData* instances = instancer->GetInstances();
+  vtkDoubleArray* lengths = vtkDoubleArray::SafeDownCast(
+    instances->GetPointData()->GetArray("Lengths"));
+  if (instancer->GetNumberOfInstances() != 3
+      || instances->GetNumberOfPoints() != 3
+      || fabs(instances->GetPoint(2)[0] - 0.15) > 1e-9
+      || fabs(lengths->GetValue(2) - 0.1) > 1e-9
+      || !CheckColor(instancer, 1, 255, 255, 255))
+    {
+    std::cout<<"Wrong instances."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Click on the glyph of the middle bone, 7 pixels away from its axis:
+  // outside of the line tolerance but inside the glyph.
+  double position[2];
+  scene.WorldToDisplay(0.1, 0.007, 0.0, position);
+  scene.InvokeEvent(vtkCommand::LeftButtonPressEvent, position);
+  if (reps[1]->GetInteractionState() != vtkLineRepresentation::OnLine
+      || !CheckColor(instancer, 1, 0, 255, 0)
+      || !CheckColor(instancer, 0, 255, 255, 255))
+    {
+    std::cout<<"The bone was not picked by its glyph."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Drag it up
+  position[1] += 20.0;
+  scene.InvokeEvent(vtkCommand::MouseMoveEvent, position);
+  scene.InvokeEvent(vtkCommand::LeftButtonReleaseEvent, position);
+  if (!CheckColor(instancer, 1, 255, 255, 255)
+      || fabs(instances->GetPoint(1)[1] - 0.02) > 1e-3)
+    {
+    std::cout<<"The instance did not follow the bone: "
+      <<instances->GetPoint(1)[1]<<std::endl;
+    return EXIT_FAILURE;
+    }
+  scene.RenderWindow->Render();
+
+  // Removing a bone moves the last instance into its slot
+  reps[0]->SetInstancer(NULL);
+  if (instancer->GetNumberOfInstances() != 2
+      || reps[2]->GetInstanceId() != 0
+      || instancer->GetRepresentation(0) != reps[2]
+      || fabs(instances->GetPoint(0)[0] - 0.15) > 1e-9)
+    {
+    std::cout<<"Wrong instances after removal."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Hidden bones have a null length
+  reps[1]->SetVisibility(0);
+  if (lengths->GetValue(reps[1]->GetInstanceId()) != 0.0)
+    {
+    std::cout<<"The hidden bone is drawn."<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}